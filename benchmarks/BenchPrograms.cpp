@@ -0,0 +1,203 @@
+#include "BenchPrograms.hpp"
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "Core/Instruction.h"
+
+static constexpr uint32_t GPU_IO_PAGE = 0x1F80;
+static constexpr uint16_t GP0_OFFSET = 0x1810;
+static constexpr uint16_t GPUSTAT_OFFSET = 0x1814;
+
+static uint8_t reg(CpuReg r)
+{
+    return static_cast<uint8_t>(r);
+}
+
+static uint32_t special(SecondaryOpCode funct, CpuReg rd, CpuReg rs, CpuReg rt, uint8_t shamt = 0)
+{
+    Instruction i{};
+    i.r.opcode = static_cast<uint8_t>(PrimaryOpCode::SPECIAL);
+    i.r.funct = static_cast<uint8_t>(funct);
+    i.r.rd = reg(rd);
+    i.r.rs = reg(rs);
+    i.r.rt = reg(rt);
+    i.r.shamt = shamt;
+    return i.raw;
+}
+
+static uint32_t immediate(PrimaryOpCode opcode, CpuReg rt, CpuReg rs, uint16_t value)
+{
+    Instruction i{};
+    i.i.opcode = static_cast<uint8_t>(opcode);
+    i.i.rt = reg(rt);
+    i.i.rs = reg(rs);
+    i.i.immediate = value;
+    return i.raw;
+}
+
+static uint32_t jump(uint32_t target)
+{
+    Instruction i{};
+    i.j.opcode = static_cast<uint8_t>(PrimaryOpCode::J);
+    i.j.address = (target >> 2) & 0x3FFFFFF;
+    return i.raw;
+}
+
+// Branch offsets are counted in instructions from the delay slot
+static uint32_t branch(PrimaryOpCode opcode, CpuReg rs, CpuReg rt, int16_t offset)
+{
+    return immediate(opcode, rt, rs, static_cast<uint16_t>(offset));
+}
+
+static void loopBack(std::vector<uint32_t> &program)
+{
+    program.push_back(jump(BENCH_PROGRAM_ADDRESS));
+    program.push_back(0);
+}
+
+static std::vector<uint32_t> aluLoop()
+{
+    using enum CpuReg;
+    std::vector<uint32_t> program = {
+        immediate(PrimaryOpCode::ADDIU, T0, T0, 3),
+        immediate(PrimaryOpCode::LUI, T1, ZERO, 0x1234),
+        immediate(PrimaryOpCode::ORI, T1, T1, 0x5678),
+        special(SecondaryOpCode::ADDU, T2, T0, T1),
+        special(SecondaryOpCode::SUBU, T3, T1, T0),
+        special(SecondaryOpCode::AND, T4, T2, T3),
+        special(SecondaryOpCode::OR, T5, T2, T3),
+        special(SecondaryOpCode::XOR, T6, T4, T5),
+        special(SecondaryOpCode::NOR, T7, T6, T0),
+        special(SecondaryOpCode::SLL, T2, ZERO, T7, 3),
+        special(SecondaryOpCode::SRL, T3, ZERO, T2, 5),
+        special(SecondaryOpCode::SRA, T4, ZERO, T1, 7),
+        special(SecondaryOpCode::SLT, T5, T3, T4),
+        special(SecondaryOpCode::SLTU, T6, T4, T3),
+        immediate(PrimaryOpCode::ANDI, T7, T2, 0xFF0F),
+        immediate(PrimaryOpCode::SLTIU, T2, T7, 0x100),
+    };
+    loopBack(program);
+    return program;
+}
+
+static std::vector<uint32_t> branchLoop()
+{
+    using enum CpuReg;
+    std::vector<uint32_t> program = {
+        immediate(PrimaryOpCode::ADDIU, T0, T0, 1),
+        immediate(PrimaryOpCode::ANDI, T1, T0, 1),
+        // Taken every other iteration
+        branch(PrimaryOpCode::BEQ, T1, ZERO, 2),
+        0,
+        immediate(PrimaryOpCode::ADDIU, T2, T2, 1),
+        immediate(PrimaryOpCode::ANDI, T1, T0, 3),
+        // Never taken
+        branch(PrimaryOpCode::BNE, ZERO, ZERO, 1),
+        0,
+        // Always taken
+        branch(PrimaryOpCode::BEQ, ZERO, ZERO, 1),
+        immediate(PrimaryOpCode::ADDIU, T3, T3, 1),
+        immediate(PrimaryOpCode::ADDIU, T4, T4, 1),
+        branch(PrimaryOpCode::BNE, T1, ZERO, 1),
+        0,
+        immediate(PrimaryOpCode::ADDIU, T5, T5, 1),
+    };
+    loopBack(program);
+    return program;
+}
+
+static std::vector<uint32_t> loadLoop()
+{
+    using enum CpuReg;
+    std::vector<uint32_t> program = {
+        immediate(PrimaryOpCode::LUI, T0, ZERO, BENCH_DATA_ADDRESS >> 16),
+        immediate(PrimaryOpCode::LW, T1, T0, 0),
+        immediate(PrimaryOpCode::LW, T2, T0, 4),
+        immediate(PrimaryOpCode::LH, T3, T0, 8),
+        special(SecondaryOpCode::ADDU, T4, T1, T2),
+        immediate(PrimaryOpCode::LBU, T5, T0, 12),
+        immediate(PrimaryOpCode::SW, T4, T0, 16),
+        special(SecondaryOpCode::ADDU, T6, T3, T5),
+        immediate(PrimaryOpCode::LHU, T7, T0, 18),
+        immediate(PrimaryOpCode::SH, T6, T0, 20),
+        immediate(PrimaryOpCode::LW, T1, T0, 16),
+        immediate(PrimaryOpCode::SB, T7, T0, 24),
+        immediate(PrimaryOpCode::LB, T2, T0, 24),
+        special(SecondaryOpCode::XOR, T3, T1, T7),
+    };
+    loopBack(program);
+    return program;
+}
+
+std::vector<uint32_t> benchLoop(BenchLoop loop)
+{
+    switch (loop) {
+        case BenchLoop::Alu:
+            return aluLoop();
+        case BenchLoop::Branch:
+            return branchLoop();
+        case BenchLoop::Load:
+            return loadLoop();
+    }
+    return {};
+}
+
+std::vector<uint32_t> benchDrawLoop()
+{
+    using enum CpuReg;
+    const uint32_t loopAddress = BENCH_PROGRAM_ADDRESS + 11 * 4;
+    auto gp0 = [](CpuReg value) {
+        return immediate(PrimaryOpCode::SW, value, T0, GP0_OFFSET);
+    };
+
+    std::vector<uint32_t> program = {
+        immediate(PrimaryOpCode::LUI, T0, ZERO, GPU_IO_PAGE),
+        // Drawing area covers the whole VRAM
+        immediate(PrimaryOpCode::LUI, T3, ZERO, 0xE300),
+        gp0(T3),
+        immediate(PrimaryOpCode::LUI, T3, ZERO, 0xE407),
+        immediate(PrimaryOpCode::ORI, T3, T3, 0xFFFF),
+        gp0(T3),
+        // Flat triangle command, then the three colors of the shaded one
+        immediate(PrimaryOpCode::LUI, T1, ZERO, 0x2040),
+        immediate(PrimaryOpCode::ORI, T1, T1, 0x8040),
+        immediate(PrimaryOpCode::ORI, T5, ZERO, 0x00FF),
+        immediate(PrimaryOpCode::ORI, T6, ZERO, 0xFF00),
+        immediate(PrimaryOpCode::LUI, T7, ZERO, 0x00FF),
+        // loopAddress: x position in t2
+        immediate(PrimaryOpCode::LW, T3, T0, GPUSTAT_OFFSET),
+        gp0(T1),
+        gp0(T2),
+        immediate(PrimaryOpCode::ADDIU, T3, T2, 32),
+        gp0(T3),
+        immediate(PrimaryOpCode::LUI, T4, ZERO, 32),
+        special(SecondaryOpCode::OR, T4, T4, T2),
+        gp0(T4),
+        immediate(PrimaryOpCode::LUI, T8, ZERO, 0x3000),
+        special(SecondaryOpCode::OR, T8, T8, T5),
+        gp0(T8),
+        gp0(T4),
+        gp0(T6),
+        gp0(T3),
+        gp0(T7),
+        immediate(PrimaryOpCode::ADDIU, T3, T4, 32),
+        gp0(T3),
+        immediate(PrimaryOpCode::ADDIU, T2, T2, 1),
+        immediate(PrimaryOpCode::ANDI, T2, T2, 0x1FF),
+        // Game logic stand-in between two draws
+        immediate(PrimaryOpCode::ADDIU, T9, ZERO, 1000),
+        immediate(PrimaryOpCode::ADDIU, T9, T9, -1),
+        branch(PrimaryOpCode::BNE, T9, ZERO, -2),
+        special(SecondaryOpCode::ADDU, S0, S0, T9),
+        jump(loopAddress),
+        0,
+    };
+    return program;
+}
+
+void loadBenchProgram(Bus &bus, const std::vector<uint32_t> &program)
+{
+    for (size_t i = 0; i < program.size(); i++) {
+        bus.storeWord(BENCH_PROGRAM_ADDRESS + static_cast<uint32_t>(i * 4), program[i]);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef BENCHPROGRAMS_HPP_
+#define BENCHPROGRAMS_HPP_
+
+#include <cstdint>
+#include <vector>
+
+class Bus;
+
+// Straight-line loops run by the CPU benchmarks, each one jumps back to its start
+enum class BenchLoop
+{
+    Alu,
+    Branch,
+    Load,
+};
+
+// Address the programs are written at, data used by the load loop follows them
+static constexpr uint32_t BENCH_PROGRAM_ADDRESS = 0x80010000;
+static constexpr uint32_t BENCH_DATA_ADDRESS = 0x80020000;
+
+std::vector<uint32_t> benchLoop(BenchLoop loop);
+
+// Homebrew frame loop drawing flat and shaded triangles through GP0 while
+// polling GPUSTAT, it never calls the BIOS so it runs without one
+std::vector<uint32_t> benchDrawLoop();
+
+// Writes a program to RAM at BENCH_PROGRAM_ADDRESS
+void loadBenchProgram(Bus &bus, const std::vector<uint32_t> &program);
+
+#endif /* !BENCHPROGRAMS_HPP_ */
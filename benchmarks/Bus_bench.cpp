@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/Bus.hpp"
+
+// One address per kind of page: host memory, shared I/O page and device registers
+static void BM_BusLoadWord(benchmark::State &state, uint32_t address)
+{
+    Bus bus;
+    uint32_t sum = 0;
+
+    for (auto _ : state) {
+        sum += bus.loadWord(address);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_BusLoadWord, Ram, 0x80001000u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, RamUncached, 0xA0001000u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, Bios, 0xBFC00100u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, ScratchPad, 0x1F800100u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, InterruptController, 0x1F801070u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, Dma, 0x1F8010F0u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, Timers, 0x1F801100u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, GpuStat, 0x1F801814u);
+BENCHMARK_CAPTURE(BM_BusLoadWord, Spu, 0x1F801C00u);
+
+static void BM_BusStoreWord(benchmark::State &state, uint32_t address)
+{
+    Bus bus;
+    uint32_t value = 0;
+
+    for (auto _ : state) {
+        bus.storeWord(address, value++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_BusStoreWord, Ram, 0x80001000u);
+BENCHMARK_CAPTURE(BM_BusStoreWord, ScratchPad, 0x1F800100u);
@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "BenchPrograms.hpp"
+
+static void BM_CpuStep(benchmark::State &state, BenchLoop loop)
+{
+    Bus bus;
+    CPU cpu(&bus);
+
+    loadBenchProgram(bus, benchLoop(loop));
+    cpu.setReg(CpuReg::PC, BENCH_PROGRAM_ADDRESS);
+    for (auto _ : state) {
+        cpu.step();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_CpuStep, Alu, BenchLoop::Alu);
+BENCHMARK_CAPTURE(BM_CpuStep, Branch, BenchLoop::Branch);
+BENCHMARK_CAPTURE(BM_CpuStep, Load, BenchLoop::Load);
+
+// Same loops run block by block on every engine, items are instructions
+static void BM_CpuRunBlock(benchmark::State &state, BenchLoop loop)
+{
+    Bus bus;
+    CPU cpu(&bus);
+    uint64_t instructions = 0;
+
+    cpu.setEngine(static_cast<CpuEngine>(state.range(0)));
+    loadBenchProgram(bus, benchLoop(loop));
+    cpu.setReg(CpuReg::PC, BENCH_PROGRAM_ADDRESS);
+    for (auto _ : state) {
+        instructions += cpu.runBlock();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(instructions));
+}
+
+static void cpuEngines(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgName("engine");
+    for (CpuEngine engine : {CpuEngine::Interpreter, CpuEngine::CachedInterpreter, CpuEngine::Recompiler}) {
+        bench->Arg(static_cast<int64_t>(engine));
+    }
+}
+BENCHMARK_CAPTURE(BM_CpuRunBlock, Alu, BenchLoop::Alu)->Apply(cpuEngines);
+BENCHMARK_CAPTURE(BM_CpuRunBlock, Branch, BenchLoop::Branch)->Apply(cpuEngines);
+BENCHMARK_CAPTURE(BM_CpuRunBlock, Load, BenchLoop::Load)->Apply(cpuEngines);
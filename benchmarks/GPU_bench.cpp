@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <vector>
+
+#include "Core/Bus.hpp"
+#include "Core/GPU.hpp"
+
+constexpr uint32_t GP0 = 0x1F801810;
+
+enum class TextureMode
+{
+    None,
+    Gouraud,
+    Bits4,
+    Bits8,
+    Bits15,
+};
+
+// Texture page at (640, 0), CLUT on line 480
+static constexpr uint32_t TEXTURE_CLUT = 480 << 6;
+static constexpr uint32_t TEXTURE_PAGE = 640 / 64;
+
+static uint32_t vertex(int x, int y)
+{
+    return ((static_cast<uint32_t>(y) & 0x7FF) << 16) | (static_cast<uint32_t>(x) & 0x7FF);
+}
+
+static uint32_t texturePage(TextureMode mode)
+{
+    uint32_t depth = mode == TextureMode::Bits4 ? 0 : mode == TextureMode::Bits8 ? 1 : 2;
+    return TEXTURE_PAGE | (depth << 7);
+}
+
+class GpuBench
+{
+    public:
+        GpuBench() :
+            m_gpu(m_bus.getDevice<GPU>())
+        {
+            send({0xE3000000, 0xE4000000 | (511 << 10) | 1023, 0xE5000000});
+            // Non-transparent texels and CLUT entries
+            send({0x02336699, vertex(640, 0), vertex(256, 256)});
+            send({0x02996633, vertex(0, 480), vertex(256, 1)});
+        }
+
+        void send(const std::vector<uint32_t> &words)
+        {
+            for (uint32_t word : words) {
+                m_gpu->write32(word, GP0);
+            }
+        }
+
+        // Waits for the queued draws, returns the pixels drawn so far
+        uint64_t pixels()
+        {
+            (void)m_gpu->getVram();
+            const auto &counted = m_bus.getPerfCounters().frame().pixels;
+            return std::accumulate(counted.begin(), counted.end(), uint64_t{0});
+        }
+
+    private:
+        Bus m_bus;
+        GPU *m_gpu;
+};
+
+static std::vector<uint32_t> triangle(TextureMode mode, int size)
+{
+    switch (mode) {
+        case TextureMode::None:
+            return {0x20408040, vertex(0, 0), vertex(size, 0), vertex(0, size)};
+        case TextureMode::Gouraud:
+            return {0x300000FF, vertex(0, 0), 0x00FF00, vertex(size, 0), 0xFF0000, vertex(0, size)};
+        default:
+            return {0x24808080, vertex(0, 0), TEXTURE_CLUT << 16,
+                    vertex(size, 0), texturePage(mode) << 16 | 0xFF,
+                    vertex(0, size), 0xFF00};
+    }
+}
+
+static std::vector<uint32_t> rectangle(TextureMode mode, int size)
+{
+    switch (mode) {
+        case TextureMode::None:
+            return {0x60408040, vertex(0, 0), vertex(size, size)};
+        default:
+            return {0xE1000000 | texturePage(mode), 0x64808080, vertex(0, 0), TEXTURE_CLUT << 16, vertex(size, size)};
+    }
+}
+
+static std::vector<uint32_t> line(TextureMode mode, int size)
+{
+    if (mode == TextureMode::Gouraud) {
+        return {0x500000FF, vertex(0, 0), 0xFF0000, vertex(size, size / 3)};
+    }
+    return {0x40408040, vertex(0, 0), vertex(size, size / 3)};
+}
+
+// Items are drawn pixels, so the rate reads as the fill rate
+template<typename Primitive>
+static void BM_GpuFill(benchmark::State &state, Primitive primitive, TextureMode mode)
+{
+    GpuBench bench;
+    std::vector<uint32_t> words = primitive(mode, static_cast<int>(state.range(0)));
+    uint64_t start = bench.pixels();
+
+    for (auto _ : state) {
+        bench.send(words);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(bench.pixels() - start));
+}
+
+#define GPU_FILL_BENCHMARK(primitive, mode, size) \
+    BENCHMARK_CAPTURE(BM_GpuFill, primitive##_##mode, primitive, TextureMode::mode)->ArgName("size")->Arg(size)
+
+GPU_FILL_BENCHMARK(triangle, None, 128);
+GPU_FILL_BENCHMARK(triangle, Gouraud, 128);
+GPU_FILL_BENCHMARK(triangle, Bits4, 128);
+GPU_FILL_BENCHMARK(triangle, Bits8, 128);
+GPU_FILL_BENCHMARK(triangle, Bits15, 128);
+GPU_FILL_BENCHMARK(rectangle, None, 128);
+GPU_FILL_BENCHMARK(rectangle, Bits4, 128);
+GPU_FILL_BENCHMARK(rectangle, Bits8, 128);
+GPU_FILL_BENCHMARK(rectangle, Bits15, 128);
+GPU_FILL_BENCHMARK(line, None, 256);
+GPU_FILL_BENCHMARK(line, Gouraud, 256);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/GTE.hpp"
+
+// COP2 command word: imm25 bit, sf, lm, then the function
+static constexpr uint32_t gteCommand(GTEFunction funct, uint32_t fields = 0)
+{
+    return 0x4A000000 | (1 << 19) | fields | static_cast<uint32_t>(funct);
+}
+
+// A scene a game could set up: unit rotation, some translation and lighting
+static void setupScene(GTE &gte)
+{
+    // Rotation, light and color matrices
+    for (uint8_t base : {0, 8, 16}) {
+        gte.ctc(base + 0, 0x00001000);
+        gte.ctc(base + 1, 0x00000000);
+        gte.ctc(base + 2, 0x00001000);
+        gte.ctc(base + 3, 0x00000000);
+        gte.ctc(base + 4, 0x00001000);
+    }
+    // Translation, background color and far color
+    for (uint8_t base : {5, 13, 21}) {
+        gte.ctc(base + 0, 0x100);
+        gte.ctc(base + 1, 0x80);
+        gte.ctc(base + 2, 0x400);
+    }
+    gte.ctc(24, 160 << 16);
+    gte.ctc(25, 120 << 16);
+    gte.ctc(26, 200);
+    gte.ctc(27, -0x100);
+    gte.ctc(28, 0x1400000);
+    gte.ctc(29, 0x155);
+    gte.ctc(30, 0x100);
+
+    // V0-V2, RGBC, IR0-IR3
+    gte.mtc(0, (20 << 16) | 10);
+    gte.mtc(1, 300);
+    gte.mtc(2, (static_cast<uint32_t>(static_cast<uint16_t>(-20)) << 16) | 40);
+    gte.mtc(3, 320);
+    gte.mtc(4, (5 << 16) | static_cast<uint16_t>(-30));
+    gte.mtc(5, 340);
+    gte.mtc(6, 0x20808080);
+    gte.mtc(8, 0x800);
+    gte.mtc(9, 0x400);
+    gte.mtc(10, 0x800);
+    gte.mtc(11, 0xC00);
+    // SXY and SZ FIFOs for NCLIP and AVSZ
+    gte.mtc(12, (10 << 16) | 10);
+    gte.mtc(13, (10 << 16) | 100);
+    gte.mtc(14, (90 << 16) | 50);
+    for (uint8_t reg = 16; reg < 20; reg++) {
+        gte.mtc(reg, 1000 + reg * 10);
+    }
+}
+
+static void BM_GteExecute(benchmark::State &state, uint32_t opcode)
+{
+    GTE gte;
+
+    setupScene(gte);
+    for (auto _ : state) {
+        gte.execute(opcode);
+        benchmark::DoNotOptimize(gte.getDataReg(25));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_GteExecute, RTPS, gteCommand(GTEFunction::RTPS));
+BENCHMARK_CAPTURE(BM_GteExecute, RTPT, gteCommand(GTEFunction::RTPT));
+BENCHMARK_CAPTURE(BM_GteExecute, NCLIP, gteCommand(GTEFunction::NCLIP));
+BENCHMARK_CAPTURE(BM_GteExecute, OP, gteCommand(GTEFunction::OP));
+BENCHMARK_CAPTURE(BM_GteExecute, DPCS, gteCommand(GTEFunction::DPCS));
+BENCHMARK_CAPTURE(BM_GteExecute, INTPL, gteCommand(GTEFunction::INTPL));
+// Rotation matrix times V0 plus translation
+BENCHMARK_CAPTURE(BM_GteExecute, MVMVA, gteCommand(GTEFunction::MVMVA));
+BENCHMARK_CAPTURE(BM_GteExecute, NCDS, gteCommand(GTEFunction::NCDS));
+BENCHMARK_CAPTURE(BM_GteExecute, CDP, gteCommand(GTEFunction::CDP));
+BENCHMARK_CAPTURE(BM_GteExecute, NCDT, gteCommand(GTEFunction::NCDT));
+BENCHMARK_CAPTURE(BM_GteExecute, NCCS, gteCommand(GTEFunction::NCCS));
+BENCHMARK_CAPTURE(BM_GteExecute, CC, gteCommand(GTEFunction::CC));
+BENCHMARK_CAPTURE(BM_GteExecute, NCS, gteCommand(GTEFunction::NCS));
+BENCHMARK_CAPTURE(BM_GteExecute, NCT, gteCommand(GTEFunction::NCT));
+BENCHMARK_CAPTURE(BM_GteExecute, SQR, gteCommand(GTEFunction::SQR));
+BENCHMARK_CAPTURE(BM_GteExecute, DCPL, gteCommand(GTEFunction::DCPL));
+BENCHMARK_CAPTURE(BM_GteExecute, DPCT, gteCommand(GTEFunction::DPCT));
+BENCHMARK_CAPTURE(BM_GteExecute, AVSZ3, gteCommand(GTEFunction::AVSZ3));
+BENCHMARK_CAPTURE(BM_GteExecute, AVSZ4, gteCommand(GTEFunction::AVSZ4));
+BENCHMARK_CAPTURE(BM_GteExecute, GPF, gteCommand(GTEFunction::GPF));
+BENCHMARK_CAPTURE(BM_GteExecute, GPL, gteCommand(GTEFunction::GPL));
+BENCHMARK_CAPTURE(BM_GteExecute, NCCT, gteCommand(GTEFunction::NCCT));
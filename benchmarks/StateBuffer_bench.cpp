@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/StateBuffer.hpp"
+#include "Core/System.hpp"
+
+// Whole console state, RAM and VRAM included
+static void BM_StateSave(benchmark::State &state)
+{
+    System system;
+    StateBuffer buf;
+
+    system.init();
+    for (auto _ : state) {
+        buf.clear();
+        system.saveKeyframe(buf);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buf.size()));
+}
+BENCHMARK(BM_StateSave);
+
+static void BM_StateLoad(benchmark::State &state)
+{
+    System system;
+    StateBuffer buf;
+
+    system.init();
+    system.saveKeyframe(buf);
+    for (auto _ : state) {
+        buf.resetCursor();
+        if (!system.loadKeyframe(buf)) {
+            state.SkipWithError("Savestate did not load");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buf.size()));
+}
+BENCHMARK(BM_StateLoad);
+
+static void BM_StateDelta(benchmark::State &state)
+{
+    System system;
+    StateBuffer buf;
+
+    system.init();
+    system.saveKeyframe(buf);
+    for (auto _ : state) {
+        buf.clear();
+        system.saveDelta(buf);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buf.size()));
+}
+BENCHMARK(BM_StateDelta);
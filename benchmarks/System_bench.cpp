@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include "Core/System.hpp"
+#include "Core/GPU.hpp"
+#include "BenchPrograms.hpp"
+
+// Runs the bundled draw loop with no BIOS, items are emulated frames
+static void BM_FramesDrawLoop(benchmark::State &state)
+{
+    System system;
+
+    system.init();
+    system.getCPU()->setEngine(static_cast<CpuEngine>(state.range(0)));
+    loadBenchProgram(*system.getBus(), benchDrawLoop());
+    system.getCPU()->setReg(CpuReg::PC, BENCH_PROGRAM_ADDRESS);
+    for (auto _ : state) {
+        system.update();
+    }
+    (void)system.getBus()->getDevice<GPU>()->getVram();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FramesDrawLoop)
+    ->ArgName("engine")
+    ->Arg(static_cast<int64_t>(CpuEngine::CachedInterpreter))
+    ->Arg(static_cast<int64_t>(CpuEngine::Recompiler))
+    ->Unit(benchmark::kMillisecond);
+
+static std::string envOr(const char *name, const char *fallback)
+{
+    const char *value = std::getenv(name);
+    return value && *value ? value : fallback;
+}
+
+// Boots ROGEM_BENCH_BIOS then the test EXE, each iteration runs that many frames
+static void BM_BootExe(benchmark::State &state)
+{
+    std::string bios = envOr("ROGEM_BENCH_BIOS", "");
+    std::string exe = envOr("ROGEM_BENCH_EXE", ROGEM_SOURCE_DIR "/tests/files/psx.exe");
+
+    if (bios.empty()) {
+        state.SkipWithError("ROGEM_BENCH_BIOS is not set");
+        return;
+    }
+    // Kept outside the loop so each teardown happens while timing is paused
+    std::optional<System> system;
+    for (auto _ : state) {
+        state.PauseTiming();
+        system.reset();
+        system.emplace();
+        system->init();
+        if (!system->loadBios(bios.c_str())) {
+            state.SkipWithError("Cannot load the BIOS");
+            break;
+        }
+        system->setExecutablePath(exe);
+        state.ResumeTiming();
+        for (int64_t frame = 0; frame < state.range(0); frame++) {
+            system->update();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BootExe)->ArgName("frames")->Arg(600)->Unit(benchmark::kMillisecond);
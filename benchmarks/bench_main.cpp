@@ -0,0 +1,30 @@
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+#include <vector>
+
+// Same flags as the stock benchmark main, but the results are also written
+// to rogem_bench.json unless --benchmark_out says otherwise
+int main(int argc, char **argv)
+{
+    static char outFlag[] = "--benchmark_out=rogem_bench.json";
+    static char formatFlag[] = "--benchmark_out_format=json";
+    std::vector<char *> args(argv, argv + argc);
+    bool hasOutput = false;
+
+    for (int i = 1; i < argc; i++) {
+        hasOutput |= std::string_view(argv[i]).starts_with("--benchmark_out=");
+    }
+    if (!hasOutput) {
+        args.push_back(outFlag);
+        args.push_back(formatFlag);
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
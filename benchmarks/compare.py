@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Compares two rogem_bench JSON outputs and fails on regressions.
+
+usage: compare.py base.json new.json [--threshold 0.05]
+
+Benchmarks reporting a rate (items or bytes per second) are compared on it,
+the others on their real time. Benchmarks missing from either side or
+skipped with an error are listed but never fail the comparison.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        results = json.load(file)["benchmarks"]
+    # Repetitions report aggregates, the median is the most stable one
+    by_name = {}
+    for bench in results:
+        if bench.get("aggregate_name") not in (None, "median"):
+            continue
+        by_name[bench.get("run_name", bench["name"])] = bench
+    return by_name
+
+
+def score(bench):
+    """Returns a value where higher is better, and its unit."""
+    for rate in ("items_per_second", "bytes_per_second"):
+        if rate in bench:
+            return bench[rate], rate
+    return -bench["real_time"], bench["time_unit"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("base")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown tolerated before failing (default 0.05)")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+    regressions = 0
+
+    for name in sorted(base.keys() | new.keys()):
+        if name not in base or name not in new:
+            print(f"{name:60} only in {'base' if name in base else 'new'}")
+            continue
+        if base[name].get("error_occurred") or new[name].get("error_occurred"):
+            print(f"{name:60} skipped")
+            continue
+        old_score, unit = score(base[name])
+        new_score, _ = score(new[name])
+        change = (new_score - old_score) / abs(old_score) if old_score else 0.0
+        status = ""
+        if change < -args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        print(f"{name:60} {change:+8.1%} ({unit}) {status}")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) regressed by more than {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -5,11 +5,14 @@
 #include <imgui_impl_opengl3.h>
 
 #include <spdlog/spdlog.h>
+#include <fmt/format.h>
 #include <argparse/argparse.hpp>
 
 #include "Core/GPU.hpp"
 #include "Core/InterruptController.hpp"
 #include "Core/DigitalPad.hpp"
+#include "Core/PerfCounters.hpp"
+#include "Core/Log.hpp"
 #include "GUI/RegisterWindow.hpp"
 #include "GUI/AssemblyWindow.hpp"
 #include "GUI/BreakpointWindow.hpp"
@@ -20,16 +23,21 @@
 const char *glsl_version = "#version 330";
 
 Application::Application() :
-    m_debugger(&m_system)
+    m_traceRing(TRACE_RING_CAPACITY),
+    m_debugger(&m_system),
+    m_keyboardButtons(0xFFFF),
+    m_emulation(m_system)
 {
     m_system.init();
     m_system.setDebuggerCallback([this]() { m_debugger.update(); });
+    Log::setTraceRing(&m_traceRing);
 
     initWindows();
 }
 
 Application::~Application()
 {
+    Log::setTraceRing(nullptr);
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -67,21 +75,51 @@ static void appKeyCallback(GLFWwindow* window, int key, int scancode, int action
 {
     (void)scancode;
     (void)mods;
-    System* system = static_cast<System*>(glfwGetWindowUserPointer(window));
-    if (!system) {
+    Application* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    if (!app) {
+        return;
+    }
+    if (key == GLFW_KEY_TAB && action != GLFW_REPEAT) {
+        app->setFastForward(action == GLFW_PRESS);
         return;
     }
     PadButton padButton = mapKeyToPadButton(key);
     if (padButton == PadButton::PAD_UNKOWN) {
         return;
     }
-    static uint16_t buttonsPort = 0xFFFF;
     if (action == GLFW_PRESS) {
-        buttonsPort &= ~static_cast<uint16_t>(padButton);
+        app->setKeyboardButton(padButton, true);
     } else if (action == GLFW_RELEASE) {
-        buttonsPort |= static_cast<uint16_t>(padButton);
+        app->setKeyboardButton(padButton, false);
+    }
+}
+
+void Application::setKeyboardButton(PadButton button, bool pressed)
+{
+    if (pressed) {
+        m_keyboardButtons &= ~static_cast<uint16_t>(button);
+    } else {
+        m_keyboardButtons |= static_cast<uint16_t>(button);
+    }
+    m_emulation.setPadButtons(m_keyboardButtons);
+}
+
+void Application::setFastForward(bool enabled)
+{
+    if (enabled) {
+        SpeedMode speed = m_emulation.getSpeedMode();
+        if (m_speedBeforeFastForward || speed == SpeedMode::Turbo) {
+            return;
+        }
+        m_speedBeforeFastForward = speed;
+        m_emulation.setSpeedMode(SpeedMode::FastForward);
+    } else if (m_speedBeforeFastForward) {
+        // Keeps a speed picked from the menu while Tab was held
+        if (m_emulation.getSpeedMode() == SpeedMode::FastForward) {
+            m_emulation.setSpeedMode(*m_speedBeforeFastForward);
+        }
+        m_speedBeforeFastForward.reset();
     }
-    system->updatePadInputs(buttonsPort);
 }
 
 int Application::initGlfw()
@@ -100,14 +138,14 @@ int Application::initGlfw()
         return -1;
     }
     glfwMakeContextCurrent(m_window);
-    glfwSwapInterval(0); // VSync Off
+    glfwSwapInterval(1); // VSync On, the emulation thread keeps its own pace
     glfwSetKeyCallback(m_window, appKeyCallback);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         spdlog::error("Failed to initialize GLAD");
         return -1;
     }
-    glfwSetWindowUserPointer(m_window, &m_system);
+    glfwSetWindowUserPointer(m_window, this);
     return 0;
 }
 
@@ -140,6 +178,7 @@ void Application::initWindows()
     m_windows.emplace_back(std::make_unique<AssemblyWindow>(this, &m_debugger));
     m_windows.emplace_back(std::make_unique<BreakpointWindow>(&m_debugger));
     auto logWindow = std::make_unique<LogWindow>(&m_debugger);
+    logWindow->setTraceRing(&m_traceRing);
     m_system.setTtyCallback([window = logWindow.get()](const std::string &log) {
         window->addLog(log);
     });
@@ -168,13 +207,21 @@ int Application::run()
     m_isRunning = true;
     m_system.loadBios(m_config.biosFilePath.c_str());
     m_system.setExecutablePath(m_config.exeFilePath);
+    m_system.getCPU()->setEngine(m_config.cpuEngine);
+    m_system.getBus()->getDevice<GPU>()->setRenderThreads(m_config.renderThreads);
+    m_emulation.setDisplayRate(m_config.displayRate);
+    if (m_config.turbo) {
+        m_emulation.setSpeedMode(SpeedMode::Turbo);
+    }
 
     m_debugger.pause(false);
+    m_emulation.start();
     while (m_isRunning) {
         glfwPollEvents();
         update();
         render();
     }
+    m_emulation.stop();
     return 0;
 }
 
@@ -190,6 +237,24 @@ int Application::loadConfig(int ac, char **av)
     args.add_description("A PSX emulator written in C++ with love");
     args.add_argument("bios").help("The BIOS file to boot the console with").required();
     args.add_argument("exe").help("a PSX-EXE executable file to run after the BIOS boots").default_value("");
+    args.add_argument("--cpu")
+        .help("CPU engine: interpreter, cached or recompiler")
+        .default_value(std::string("recompiler"));
+    args.add_argument("--render-threads")
+        .help("Number of threads rasterizing the GPU draw commands")
+        .default_value(1)
+        .scan<'i', int>();
+    args.add_argument("--turbo")
+        .help("Start uncapped, e.g. to skip through the boot sequence")
+        .default_value(false)
+        .implicit_value(true);
+    args.add_argument("--display-rate")
+        .help("Frames per second shown above normal speed, 0 shows none")
+        .default_value(static_cast<int>(EmulationThread::DEFAULT_DISPLAY_RATE))
+        .scan<'i', int>();
+    args.add_argument("--log-subsystems")
+        .help("Comma separated devices to trace in the log window: gpu, dma, timers, irqc, memctrl, cachectrl, spu or all")
+        .default_value(std::string(""));
 
     try {
         args.parse_args(ac, av);
@@ -200,6 +265,29 @@ int Application::loadConfig(int ac, char **av)
     }
     m_config.biosFilePath = args.get("bios");
     m_config.exeFilePath = args.get("exe");
+    auto cpuEngine = CPU::engineFromName(args.get("--cpu"));
+    if (!cpuEngine) {
+        spdlog::error("Unknown CPU engine: {}", args.get("--cpu"));
+        std::cout << args;
+        return 1;
+    }
+    m_config.cpuEngine = *cpuEngine;
+    int renderThreads = args.get<int>("--render-threads");
+    if (renderThreads < 1) {
+        spdlog::error("Invalid render thread count: {}", renderThreads);
+        return 1;
+    }
+    m_config.renderThreads = static_cast<uint32_t>(renderThreads);
+    m_config.turbo = args.get<bool>("--turbo");
+    int displayRate = args.get<int>("--display-rate");
+    if (displayRate < 0) {
+        spdlog::error("Invalid display rate: {}", displayRate);
+        return 1;
+    }
+    m_config.displayRate = static_cast<uint32_t>(displayRate);
+    if (!Log::enableByName(args.get("--log-subsystems"))) {
+        return 1;
+    }
     return 0;
 }
 
@@ -229,7 +317,6 @@ void Application::update()
         m_isRunning = false;
     }
     pollGamepad();
-    m_system.update();
 }
 
 void Application::pollGamepad()
@@ -267,57 +354,114 @@ void Application::pollGamepad()
     if (state.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] > -0.5f)
         gamepadButtons &= ~static_cast<uint16_t>(PadButton::PAD_R2);
 
-    m_system.updatePadInputs(gamepadButtons);
+    m_emulation.setPadButtons(gamepadButtons & m_keyboardButtons);
 }
 
 void Application::render()
 {
     imguiNewFrame();
     ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport());
-    m_mainMenuBar->draw();
-    for (auto &window : m_windows) {
-        if (window->isVisible()) {
-            window->update();
+    {
+        // The machine only waits while the windows are built, not while they are drawn
+        auto lock = m_emulation.lock();
+        m_mainMenuBar->draw();
+        for (auto &window : m_windows) {
+            if (window->isVisible()) {
+                window->update();
+            }
         }
+        drawDeviceWindows();
+        updateTitle();
     }
     drawScreen();
     imguiRenderFrame();
     glfwSwapBuffers(glfwGetCurrentContext());
 }
 
+template<size_t N>
+static void drawCounterTable(const char *label, const std::array<uint64_t, N> &values, const char *(*name)(size_t))
+{
+    if (!ImGui::CollapsingHeader(label) || !ImGui::BeginTable(label, 2)) {
+        return;
+    }
+    for (size_t i = 0; i < N; i++) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(name(i));
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(values[i]));
+    }
+    ImGui::EndTable();
+}
+
+// Counters of the last emulated frame
+static void drawPerfCounters(const PerfCounters &perf)
+{
+    const PerfFrame &frame = perf.lastFrame();
+    double totalMs = 0.0;
+
+    for (uint64_t ns : frame.hostNs) {
+        totalMs += ns / 1e6;
+    }
+    ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(perf.frameCount()), totalMs);
+    for (size_t i = 0; i < PERF_TIMER_COUNT; i++) {
+        ImGui::Text("%-8s %8.3f ms", PerfCounters::timerName(static_cast<PerfTimer>(i)), frame.hostNs[i] / 1e6);
+    }
+    ImGui::Text("Instructions: %llu", static_cast<unsigned long long>(frame.instructions));
+    ImGui::Separator();
+
+    drawCounterTable("Bus accesses", frame.busAccesses,
+                     [](size_t i) { return PerfCounters::busTargetName(static_cast<PerfBusTarget>(i)); });
+    drawCounterTable("GP0 commands", frame.gp0Commands,
+                     [](size_t i) { return PerfCounters::primitiveName(static_cast<PerfPrimitive>(i)); });
+    drawCounterTable("Pixels drawn", frame.pixels,
+                     [](size_t i) { return PerfCounters::primitiveName(static_cast<PerfPrimitive>(i)); });
+    drawCounterTable("DMA words", frame.dmaWords, &PerfCounters::dmaChannelName);
+    drawCounterTable("IRQs", frame.irqs, &PerfCounters::irqName);
+}
+
+void Application::updateTitle()
+{
+    double now = glfwGetTime();
+    if (now - m_titleTime < 1.0) {
+        return;
+    }
+    m_titleTime = now;
+    const SpeedMeter &meter = m_system.getSpeedMeter();
+    const GuestSpeed &speed = meter.current();
+    std::string title = meter.isPaused() ? "RogEm - Paused"
+        : fmt::format("RogEm - {:.1f} fps, {:.2f} MHz (x{:.2f})", speed.fps, speed.mhz, speed.multiplier);
+    glfwSetWindowTitle(m_window, title.c_str());
+}
+
 void Application::drawScreen()
 {
-    GPU *gpu = m_system.getBus()->getDevice<GPU>();
-    uint8_t *vram = gpu->getVram();
+    // Frames come from the emulation thread, the newest one since the last UI frame
+    if (const VideoFrame *frame = m_emulation.takeFrame()) {
+        m_screenFrame = frame;
+        glBindTexture(GL_TEXTURE_2D, m_vramTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, frame->vram);
+    }
 
     if (ImGui::Begin("Screen")) {
-        glBindTexture(GL_TEXTURE_2D, m_vramTexture);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, vram);
         ImGui::Checkbox("Display Area", &m_showDisplayArea);
         ImVec2 uv0(0.0f, 0.0f);
         ImVec2 uv1(1.0f, 1.0f);
-        if (m_showDisplayArea) {
-            auto displayArea = gpu->getDisplayArea();
-            int width = 0;
-            if (gpu->getGpuStat().hRes2) {
-                width = 368;
-            } else {
-                switch (gpu->getHorizontalRes()) {
-                    case HorizontalRes::RES_256: width = 256; break;
-                    case HorizontalRes::RES_320: width = 320; break;
-                    case HorizontalRes::RES_512: width = 512; break;
-                    case HorizontalRes::RES_640: width = 640; break;
-                }
-            }
-            int height = (gpu->getVerticalRes() == VerticalRes::RES_240) ? 240 : 480;
-            uv0.x = displayArea.halfwordAddress / 1024.0f;
-            uv0.y = displayArea.scanlineAddress / 512.0f;
-            uv1.x = (displayArea.halfwordAddress + width) / 1024.0f;
-            uv1.y = (displayArea.scanlineAddress + height) / 512.0f;
+        if (m_showDisplayArea && m_screenFrame) {
+            uv0.x = m_screenFrame->displayX / 1024.0f;
+            uv0.y = m_screenFrame->displayY / 512.0f;
+            uv1.x = (m_screenFrame->displayX + m_screenFrame->displayWidth) / 1024.0f;
+            uv1.y = (m_screenFrame->displayY + m_screenFrame->displayHeight) / 512.0f;
         }
         ImGui::Image((ImTextureID)(intptr_t)m_vramTexture, ImGui::GetContentRegionAvail(), uv0, uv1);
     }
     ImGui::End();
+}
+
+void Application::drawDeviceWindows()
+{
+    GPU *gpu = m_system.getBus()->getDevice<GPU>();
+    uint8_t *vram = gpu->getVram();
 
     m_vramEditor.DrawWindow("VRAM", vram, GPU_VRAM_1MB_SIZE);
 
@@ -348,6 +492,11 @@ void Application::drawScreen()
     }
     ImGui::End();
 
+    if (ImGui::Begin("Performance")) {
+        drawPerfCounters(m_system.getBus()->getPerfCounters());
+    }
+    ImGui::End();
+
     if (ImGui::Begin("IRQ Controller")) {
         auto irqc = m_system.getBus()->getDevice<InterruptController>();
         ImGui::Text("ISTAT: 0x%08X", irqc->read32(0x1F801070));
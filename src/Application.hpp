@@ -1,12 +1,16 @@
 #ifndef APPLICATION_HPP_
 #define APPLICATION_HPP_
 
+#include <optional>
 #include <string>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include "Core/System.hpp"
+#include "Core/DigitalPad.hpp"
+#include "Core/EmulationThread.hpp"
+#include "Core/TraceRing.hpp"
 #include "Debugger/Debugger.hpp"
 #include "GUI/MainMenuBar.hpp"
 #include "imgui/imgui_memory_editor.h"
@@ -15,6 +19,10 @@ struct EmulatorConfig
 {
     std::string biosFilePath;
     std::string exeFilePath;
+    CpuEngine cpuEngine;
+    uint32_t renderThreads;
+    bool turbo;
+    uint32_t displayRate;
 };
 
 class Application
@@ -30,8 +38,14 @@ class Application
         std::list<std::shared_ptr<IWindow>> &getWindows() { return m_windows; }
         System &getSystem() { return m_system; }
         Debugger &getDebugger() { return m_debugger; }
+        EmulationThread &getEmulation() { return m_emulation; }
+        void setKeyboardButton(PadButton button, bool pressed);
+        void setFastForward(bool enabled);
 
     private:
+        // Device trace messages waiting for the log window
+        static constexpr size_t TRACE_RING_CAPACITY = 1 << 14;
+
         int initGlfw();
         int initImgui();
         void initVramTexture();
@@ -41,21 +55,32 @@ class Application
         void render();
 
         void drawScreen();
+        void drawDeviceWindows();
+        // Shows the guest speed in the window title
+        void updateTitle();
         void pollGamepad();
 
     private:
         bool m_isRunning;
         EmulatorConfig m_config;
+        TraceRing m_traceRing;
 
         System m_system;
         Debugger m_debugger;
+        uint16_t m_keyboardButtons;
+        // Owns the system once running, declared after it to stop first
+        EmulationThread m_emulation;
 
         std::unique_ptr<MainMenuBar> m_mainMenuBar;
         std::list<std::shared_ptr<IWindow>> m_windows;
         MemoryEditor m_vramEditor;
         GLFWwindow* m_window;
         GLuint m_vramTexture;
+        const VideoFrame *m_screenFrame = nullptr;
         bool m_showDisplayArea = true;
+        double m_titleTime = 0.0;
+        // Speed to restore when Tab is released
+        std::optional<SpeedMode> m_speedBeforeFastForward;
 };
 
 #endif /* !APPLICATION_HPP_ */
@@ -0,0 +1,49 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** BlockCache
+*/
+
+#include "BlockCache.hpp"
+
+CachedBlock *BlockCache::find(uint32_t pc) const
+{
+    auto it = m_blocks.find(pc);
+    if (it != m_blocks.end()) {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+CachedBlock *BlockCache::insert(std::unique_ptr<CachedBlock> block)
+{
+    CachedBlock *ptr = block.get();
+
+    m_pageBlocks[block->page].push_back(block->startPc);
+    m_blocks[block->startPc] = std::move(block);
+    return ptr;
+}
+
+void BlockCache::invalidatePage(uint32_t address)
+{
+    auto it = m_pageBlocks.find(address >> PAGE_SHIFT);
+    if (it == m_pageBlocks.end()) {
+        return;
+    }
+    for (auto pc : it->second) {
+        m_blocks.erase(pc);
+    }
+    m_pageBlocks.erase(it);
+}
+
+void BlockCache::clear()
+{
+    m_blocks.clear();
+    m_pageBlocks.clear();
+}
+
+size_t BlockCache::size() const
+{
+    return m_blocks.size();
+}
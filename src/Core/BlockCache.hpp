@@ -0,0 +1,61 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** BlockCache
+*/
+
+#ifndef BLOCKCACHE_HPP_
+#define BLOCKCACHE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Instruction.h"
+
+class CPU;
+
+using InstructionHandler = void (*)(CPU &cpu, const Instruction &instruction);
+// Native translation of a block, returns the number of instructions run
+using JitBlockFunction = uint32_t (*)(CPU *cpu, uint32_t *gpr);
+
+struct DecodedInstruction
+{
+    InstructionHandler handler;
+    Instruction instruction;
+};
+
+// Straight-line run of guest code, decoded once. A block ends after the
+// delay slot of its first branch or at the end of a code page.
+struct CachedBlock
+{
+    uint32_t startPc;
+    uint32_t page;
+    std::vector<DecodedInstruction> instructions;
+    JitBlockFunction code = nullptr;
+};
+
+class BlockCache
+{
+    public:
+        static constexpr uint32_t PAGE_SHIFT = 12; // Matches Memory::WATCH_PAGE_SHIFT
+        static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+        static constexpr uint32_t MAX_BLOCK_SIZE = 256;
+
+        CachedBlock *find(uint32_t pc) const;
+        CachedBlock *insert(std::unique_ptr<CachedBlock> block);
+
+        // Drops every block decoded from the physical page holding address
+        void invalidatePage(uint32_t address);
+        void clear();
+
+        size_t size() const;
+
+    private:
+        std::unordered_map<uint32_t, std::unique_ptr<CachedBlock>> m_blocks;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_pageBlocks;
+};
+
+#endif /* !BLOCKCACHE_HPP_ */
@@ -0,0 +1,168 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** BreakpointSet
+*/
+
+#include "BreakpointSet.hpp"
+
+#include <algorithm>
+
+#include "Bus.hpp"
+#include "CPU.hpp"
+
+bool BreakpointCondition::test(const CPU &cpu, uint32_t accessValue) const
+{
+    if (op == ConditionOp::Always) {
+        return true;
+    }
+    uint32_t left = onValue ? accessValue : cpu.getReg(reg);
+    switch (op) {
+        case ConditionOp::Equal:
+            return left == value;
+        case ConditionOp::NotEqual:
+            return left != value;
+        case ConditionOp::Less:
+            return left < value;
+        case ConditionOp::Greater:
+            return left > value;
+        default:
+            return true;
+    }
+}
+
+BreakpointSet::BreakpointSet() :
+    m_execPages(EXEC_PAGE_COUNT / 64, 0),
+    m_hasWatchpoints(false),
+    m_nextId(1),
+    m_cpu(nullptr),
+    m_bus(nullptr)
+{
+}
+
+BreakpointSet::~BreakpointSet()
+{
+    attach(nullptr, nullptr);
+}
+
+void BreakpointSet::attach(CPU *cpu, Bus *bus)
+{
+    if (m_cpu) {
+        m_cpu->setSingleStep(false);
+    }
+    if (m_bus && m_hasWatchpoints) {
+        m_bus->setBreakpoints(nullptr);
+        m_bus->rebuildPageTable();
+    }
+    m_cpu = cpu;
+    m_bus = bus;
+    m_hit.reset();
+    rebuild();
+}
+
+uint32_t BreakpointSet::add(BreakKind kind, uint32_t address, uint32_t length, const BreakpointCondition &condition)
+{
+    uint32_t id = m_nextId++;
+    m_entries.push_back({id, kind, address & ADDRESS_MASK, std::max<uint32_t>(length, 1), condition});
+    rebuild();
+    return id;
+}
+
+bool BreakpointSet::remove(uint32_t id)
+{
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [id](const Entry &entry) {
+        return entry.id == id;
+    });
+    if (it == m_entries.end()) {
+        return false;
+    }
+    m_entries.erase(it);
+    rebuild();
+    return true;
+}
+
+void BreakpointSet::clear()
+{
+    m_entries.clear();
+    rebuild();
+}
+
+void BreakpointSet::rebuild()
+{
+    bool hadWatchpoints = m_hasWatchpoints;
+
+    std::fill(m_execPages.begin(), m_execPages.end(), 0);
+    m_exec.clear();
+    m_hasWatchpoints = false;
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        const Entry &entry = m_entries[i];
+        if (entry.kind != BreakKind::Exec) {
+            m_hasWatchpoints = true;
+            continue;
+        }
+        uint32_t page = entry.address >> EXEC_PAGE_SHIFT;
+        m_execPages[page >> 6] |= 1ull << (page & 63);
+        m_exec.emplace(entry.address, i);
+    }
+
+    // Stepping one instruction at a time stops on the exact instruction
+    if (m_cpu) {
+        m_cpu->setSingleStep(armed());
+    }
+    if (m_bus && (m_hasWatchpoints || hadWatchpoints)) {
+        m_bus->setBreakpoints(m_hasWatchpoints ? this : nullptr);
+        m_bus->rebuildPageTable();
+    }
+}
+
+bool BreakpointSet::check(uint32_t pc)
+{
+    if (m_hit) {
+        m_lastHit = m_hit;
+        m_hit.reset();
+        return true;
+    }
+
+    pc &= ADDRESS_MASK;
+    uint32_t page = pc >> EXEC_PAGE_SHIFT;
+    if (!(m_execPages[page >> 6] & (1ull << (page & 63)))) {
+        return false;
+    }
+    auto [first, last] = m_exec.equal_range(pc);
+    for (auto it = first; it != last; ++it) {
+        const Entry &entry = m_entries[it->second];
+        if (entry.condition.test(*m_cpu, 0)) {
+            m_lastHit = BreakpointHit{entry.id, BreakKind::Exec, pc, 0};
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BreakpointSet::watches(uint32_t pAddress, uint32_t length) const
+{
+    pAddress &= ADDRESS_MASK;
+    for (const Entry &entry : m_entries) {
+        if (entry.kind != BreakKind::Exec && entry.address < pAddress + length &&
+            pAddress < entry.address + entry.length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BreakpointSet::onAccess(BreakKind kind, uint32_t pAddress, uint32_t size, uint32_t value)
+{
+    if (m_hit) {
+        return;
+    }
+    pAddress &= ADDRESS_MASK;
+    for (const Entry &entry : m_entries) {
+        if (entry.kind == kind && entry.address < pAddress + size && pAddress < entry.address + entry.length &&
+            entry.condition.test(*m_cpu, value)) {
+            m_hit = BreakpointHit{entry.id, kind, pAddress, value};
+            return;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** BreakpointSet
+*/
+
+#ifndef BREAKPOINTSET_HPP_
+#define BREAKPOINTSET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class Bus;
+class CPU;
+enum class CpuReg;
+
+enum class BreakKind : uint8_t
+{
+    Exec,
+    Read,
+    Write
+};
+
+enum class ConditionOp : uint8_t
+{
+    Always,
+    Equal,
+    NotEqual,
+    Less,   // Unsigned
+    Greater // Unsigned
+};
+
+// Compares a CPU register, or the value a watchpoint saw, to a constant
+struct BreakpointCondition
+{
+    ConditionOp op;
+    bool onValue;
+    CpuReg reg;
+    uint32_t value;
+
+    bool test(const CPU &cpu, uint32_t accessValue) const;
+};
+
+struct BreakpointHit
+{
+    uint32_t id;
+    BreakKind kind;
+    uint32_t address;
+    uint32_t value;
+};
+
+// Execution breakpoints and memory watchpoints, on physical addresses.
+// Execution breakpoints are looked up in a bitmap of 4 KiB pages first, only
+// PCs in a flagged page reach the hash map. Watchpoints take the Bus pages
+// they cover off the host memory fast path, so the other pages are not
+// slowed down. Nothing is checked while the set is empty.
+class BreakpointSet
+{
+    public:
+        BreakpointSet();
+        ~BreakpointSet();
+
+        BreakpointSet(const BreakpointSet &) = delete;
+        BreakpointSet &operator=(const BreakpointSet &) = delete;
+
+        // Connects the set to the CPU and bus it breaks, nullptrs detach it
+        void attach(CPU *cpu, Bus *bus);
+
+        // Returns the id of the new breakpoint. length is only used by watchpoints.
+        uint32_t add(BreakKind kind, uint32_t address, uint32_t length = 4,
+                     const BreakpointCondition &condition = {});
+        bool remove(uint32_t id);
+        void clear();
+        size_t size() const { return m_entries.size(); }
+        bool armed() const { return !m_entries.empty(); }
+
+        // Forgets the watchpoint hits, e.g. the ones of debugger memory reads
+        void clearHit() { m_hit.reset(); }
+        // Looks for an execution breakpoint at pc when there was no watchpoint
+        // hit, returns true when the emulation has to stop
+        bool check(uint32_t pc);
+        const std::optional<BreakpointHit> &lastHit() const { return m_lastHit; }
+
+        // Bus side
+        bool watches(uint32_t pAddress, uint32_t length) const;
+        void onAccess(BreakKind kind, uint32_t pAddress, uint32_t size, uint32_t value);
+
+    private:
+        struct Entry
+        {
+            uint32_t id;
+            BreakKind kind;
+            uint32_t address;
+            uint32_t length;
+            BreakpointCondition condition;
+        };
+
+        static constexpr uint32_t ADDRESS_MASK = 0x1FFFFFFF;
+        static constexpr uint32_t EXEC_PAGE_SHIFT = 12;
+        static constexpr size_t EXEC_PAGE_COUNT = (ADDRESS_MASK + 1ull) >> EXEC_PAGE_SHIFT;
+
+        void rebuild();
+
+    private:
+        std::vector<Entry> m_entries;
+        std::vector<uint64_t> m_execPages;
+        std::unordered_multimap<uint32_t, size_t> m_exec;
+        bool m_hasWatchpoints;
+        uint32_t m_nextId;
+
+        std::optional<BreakpointHit> m_hit;
+        std::optional<BreakpointHit> m_lastHit;
+
+        CPU *m_cpu;
+        Bus *m_bus;
+};
+
+#endif /* !BREAKPOINTSET_HPP_ */
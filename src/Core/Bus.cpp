@@ -9,6 +9,9 @@
 #include "StateBuffer.hpp"
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 
 #include "CPU.hpp"
 #include "MemoryMap.hpp"
@@ -25,11 +28,38 @@
 #include "MemoryControl1.hpp"
 #include "CacheControl.hpp"
 #include "Expansion2.hpp"
+#include "TraceRecorder.hpp"
+#include "BreakpointSet.hpp"
 #include "MemoryControl2.hpp"
 
+// Host-backed pages are accessed with plain memcpy, which matches the PSX byte order
+static_assert(std::endian::native == std::endian::little, "Bus: host must be little-endian");
+
+static constexpr BusPage UNMAPPED_PAGE = {nullptr, nullptr, nullptr, nullptr, 0, -1, PerfBusTarget::Other, false};
+
+static PerfBusTarget perfTargetOf(const PsxDevice *device)
+{
+    static const std::unordered_map<std::type_index, PerfBusTarget> targets = {
+        {typeid(RAM), PerfBusTarget::Ram},
+        {typeid(BIOS), PerfBusTarget::Bios},
+        {typeid(ScratchPad), PerfBusTarget::ScratchPad},
+        {typeid(DMA), PerfBusTarget::Dma},
+        {typeid(GPU), PerfBusTarget::Gpu},
+        {typeid(SPU), PerfBusTarget::Spu},
+        {typeid(SerialInterface), PerfBusTarget::SerialInterface},
+        {typeid(Timers), PerfBusTarget::Timers},
+        {typeid(InterruptController), PerfBusTarget::InterruptController},
+    };
+    auto it = targets.find(typeid(*device));
+    return it != targets.end() ? it->second : PerfBusTarget::Other;
+}
+
 Bus::Bus() :
     m_cacheControl(0),
-    m_cpu(nullptr)
+    m_stallCycles(0),
+    m_cpu(nullptr),
+    m_tracer(nullptr),
+    m_breakpoints(nullptr)
 {
     addDevice(std::make_unique<BIOS>(this));
     addDevice(std::make_unique<RAM>(this));
@@ -44,6 +74,13 @@ Bus::Bus() :
     addDevice(std::make_unique<CacheControl>(this));
     addDevice(std::make_unique<Expansion2>(this));
     addDevice(std::make_unique<MemoryControl2>(this));
+
+    m_scheduler.setHandler(SchedulerEvent::GpuVBlank, getDevice<GPU>());
+    m_scheduler.setHandler(SchedulerEvent::Timer0, getDevice<Timers>());
+    m_scheduler.setHandler(SchedulerEvent::Timer1, getDevice<Timers>());
+    m_scheduler.setHandler(SchedulerEvent::Timer2, getDevice<Timers>());
+    m_scheduler.setHandler(SchedulerEvent::Sio0Transfer, getDevice<SerialInterface>());
+    m_scheduler.setHandler(SchedulerEvent::Dma, getDevice<DMA>());
 }
 
 Bus::~Bus()
@@ -52,6 +89,8 @@ Bus::~Bus()
 
 void Bus::reset()
 {
+    m_scheduler.reset();
+    m_stallCycles = 0;
     for (auto &[_, device] : m_devices) {
         device->reset();
     }
@@ -60,6 +99,7 @@ void Bus::reset()
 void Bus::serialize(StateBuffer &buf) const
 {
     buf.write(m_cacheControl);
+    m_scheduler.serialize(buf);
 
     const std::type_index order[] = {
         std::type_index(typeid(RAM)),
@@ -87,6 +127,7 @@ void Bus::serialize(StateBuffer &buf) const
 void Bus::deserialize(StateBuffer &buf)
 {
     buf.read(m_cacheControl);
+    m_scheduler.deserialize(buf);
 
     const std::type_index order[] = {
         std::type_index(typeid(RAM)),
@@ -109,144 +150,293 @@ void Bus::deserialize(StateBuffer &buf)
             it->second->deserialize(buf);
         }
     }
+    // Memory devices may have reallocated their storage
+    rebuildPageTable();
 }
 
 uint32_t Bus::loadWord(uint32_t addr) const
 {
-    uint32_t pAddress = MemoryMap::mapAddress(addr);
-
     if (addr % 4 != 0)
     {
         spdlog::error("Bus: Unaligned word load");
         return 0;
     }
-
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
-            return device->read32(pAddress);
-        }
-    }
-    spdlog::error("Bus: Read word at address 0x{:08X} is not supported", addr);
-    return 0;
+    return load<uint32_t>(addr);
 }
 
 void Bus::storeWord(uint32_t addr, uint32_t value)
 {
-    uint32_t pAddress = MemoryMap::mapAddress(addr);
-
     if (addr % 4 != 0)
     {
         spdlog::error("Bus: Unaligned word store");
         return;
     }
-
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
-            device->write32(value, pAddress);
-            return;
-        }
-    }
-    spdlog::error("Bus: Write word at address 0x{:08X} is not supported", addr);
+    store<uint32_t>(addr, value);
 }
 
 uint16_t Bus::loadHalfWord(uint32_t addr) const
 {
-    uint32_t pAddress = MemoryMap::mapAddress(addr);
-
     if (addr % 2 != 0)
     {
         spdlog::error("Bus: Unaligned halfword load");
         return 0;
     }
-
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
-            return device->read16(pAddress);
-        }
-    }
-    spdlog::error("Bus: Read halfword at address 0x{:08X} is not supported", addr);
-    return 0;
+    return load<uint16_t>(addr);
 }
 
 void Bus::storeHalfWord(uint32_t addr, uint16_t value)
 {
-    uint32_t pAddress = MemoryMap::mapAddress(addr);
-
     if (addr % 2 != 0)
     {
         spdlog::error("Bus: Unaligned halfword store");
         return;
     }
+    store<uint16_t>(addr, value);
+}
 
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
-            device->write16(value, pAddress);
-            return;
-        }
+uint8_t Bus::loadByte(uint32_t addr) const
+{
+    return load<uint8_t>(addr);
+}
+
+void Bus::storeByte(uint32_t addr, uint8_t value)
+{
+    store<uint8_t>(addr, value);
+}
+
+template<typename T>
+static constexpr const char *accessName()
+{
+    if constexpr (sizeof(T) == 4) {
+        return "word";
+    } else if constexpr (sizeof(T) == 2) {
+        return "halfword";
+    } else {
+        return "byte";
     }
-    spdlog::error("Bus: Write halfword at address 0x{:08X} is not supported", addr);
 }
 
-uint8_t Bus::loadByte(uint32_t addr) const
+template<typename T>
+T Bus::load(uint32_t addr) const
+{
+    if (m_tracer) [[unlikely]] {
+        T value = loadUntraced<T>(addr);
+        m_tracer->recordLoad(addr, value, sizeof(T));
+        return value;
+    }
+    return loadUntraced<T>(addr);
+}
+
+template<typename T>
+void Bus::store(uint32_t addr, T value)
+{
+    if (m_tracer) [[unlikely]] {
+        m_tracer->recordStore(addr, value, sizeof(T));
+    }
+    storeUntraced<T>(addr, value);
+}
+
+template<typename T>
+T Bus::loadUntraced(uint32_t addr) const
 {
     uint32_t pAddress = MemoryMap::mapAddress(addr);
+    const BusPage &page = findPage(pAddress);
 
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
-            return device->read8(pAddress);
+    m_perf.frame().busAccesses[static_cast<size_t>(page.perfTarget)]++;
+    if (page.hostRead) {
+        T value;
+        std::memcpy(&value, page.hostRead + (pAddress - page.base), sizeof(T));
+        return value;
+    }
+
+    PsxDevice *device = page.device ? page.device : findUnpagedDevice(pAddress);
+    if (device) {
+        T value;
+        if constexpr (sizeof(T) == 4) {
+            value = device->read32(pAddress);
+        } else if constexpr (sizeof(T) == 2) {
+            value = device->read16(pAddress);
+        } else {
+            value = device->read8(pAddress);
         }
+        if (page.watched) [[unlikely]] {
+            m_breakpoints->onAccess(BreakKind::Read, pAddress, sizeof(T), value);
+        }
+        return value;
     }
-    spdlog::error("Bus: Read byte at address 0x{:08X} is not supported", addr);
+    spdlog::error("Bus: Read {} at address 0x{:08X} is not supported", accessName<T>(), addr);
     return 0;
 }
 
-void Bus::storeByte(uint32_t addr, uint8_t value)
+template<typename T>
+void Bus::storeUntraced(uint32_t addr, T value)
 {
     uint32_t pAddress = MemoryMap::mapAddress(addr);
+    const BusPage &page = findPage(pAddress);
+
+    m_perf.frame().busAccesses[static_cast<size_t>(page.perfTarget)]++;
+    if (page.hostWrite) {
+        uint32_t offset = pAddress - page.base;
+        std::memcpy(page.hostWrite + offset, &value, sizeof(T));
+        if (page.watch[offset >> Memory::WATCH_PAGE_SHIFT]) {
+            auto memoryDev = static_cast<Memory *>(page.device);
+            memoryDev->notifyWrite(memoryDev->mapAddress(pAddress), sizeof(T));
+        }
+        return;
+    }
 
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(pAddress)) {
+    PsxDevice *device = page.device ? page.device : findUnpagedDevice(pAddress);
+    if (device) {
+        if (page.watched) [[unlikely]] {
+            m_breakpoints->onAccess(BreakKind::Write, pAddress, sizeof(T), value);
+        }
+        if constexpr (sizeof(T) == 4) {
+            device->write32(value, pAddress);
+        } else if constexpr (sizeof(T) == 2) {
+            device->write16(value, pAddress);
+        } else {
             device->write8(value, pAddress);
-            return;
         }
+        return;
     }
-    spdlog::error("Bus: Write byte at address 0x{:08X} is not supported", addr);
+    spdlog::error("Bus: Write {} at address 0x{:08X} is not supported", accessName<T>(), addr);
 }
 
-std::vector<uint8_t> *Bus::getMemoryRange(uint32_t addr)
+const BusPage &Bus::findPage(uint32_t pAddress) const
 {
-    auto mappedAddress = MemoryMap::mapAddress(addr);
+    if (pAddress >= MemoryMap::PHYSICAL_SPACE_SIZE) {
+        return UNMAPPED_PAGE;
+    }
 
-    for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(mappedAddress)) {
-            auto memoryDev = dynamic_cast<Memory *>(device.get());
-            if (memoryDev) {
-                return memoryDev->data();
-            }
+    const BusPage &page = m_pages[pAddress >> PAGE_SHIFT];
+    if (page.sharedIndex < 0) {
+        return page;
+    }
+
+    const auto &slots = m_sharedPages[page.sharedIndex];
+    uint32_t slot = (pAddress & PAGE_MASK) >> SLOT_SHIFT;
+    return slot < slots.size() ? slots[slot] : UNMAPPED_PAGE;
+}
+
+PsxDevice *Bus::findUnpagedDevice(uint32_t pAddress) const
+{
+    for (auto device : m_unpagedDevices) {
+        if (device->isAddressed(pAddress)) {
+            return device;
         }
     }
     return nullptr;
 }
 
-const std::vector<uint8_t> *Bus::getMemoryRange(uint32_t addr) const
+void Bus::rebuildPageTable()
 {
-    auto mappedAddress = MemoryMap::mapAddress(addr);
+    m_pages.assign(PAGE_COUNT, UNMAPPED_PAGE);
+    m_sharedPages.clear();
+    m_unpagedDevices.clear();
 
     for (auto &[_, device] : m_devices) {
-        if (device->isAddressed(mappedAddress)) {
-            auto memoryDev = dynamic_cast<Memory *>(device.get());
-            if (memoryDev) {
-                return memoryDev->data();
-            }
+        const auto &range = device->memoryRange();
+
+        if (range.length == 0) {
+            continue;
+        }
+        if (range.start >= MemoryMap::PHYSICAL_SPACE_SIZE) {
+            m_unpagedDevices.push_back(device.get());
+            continue;
+        }
+        mapRange(device.get(), range.start, range.start + range.length);
+    }
+}
+
+void Bus::mapRange(PsxDevice *device, uint32_t start, uint32_t end)
+{
+    for (uint32_t pageBase = start & ~PAGE_MASK; pageBase < end; pageBase += PAGE_SIZE) {
+        BusPage &page = m_pages[pageBase >> PAGE_SHIFT];
+
+        if (page.sharedIndex < 0 && start <= pageBase && end >= pageBase + PAGE_SIZE) {
+            page = makePage(device, pageBase, PAGE_SIZE);
+            continue;
+        }
+
+        // The device only covers part of the page, split it into word slots
+        if (page.sharedIndex < 0) {
+            page.sharedIndex = static_cast<int32_t>(m_sharedPages.size());
+            m_sharedPages.emplace_back();
+        }
+        auto &slots = m_sharedPages[page.sharedIndex];
+        uint32_t slotStart = std::max(start, pageBase);
+        uint32_t slotEnd = std::min(end, pageBase + PAGE_SIZE);
+        uint32_t slotCount = (slotEnd - pageBase + SLOT_SIZE - 1) >> SLOT_SHIFT;
+
+        if (slots.size() < slotCount) {
+            slots.resize(slotCount, UNMAPPED_PAGE);
+        }
+        for (uint32_t addr = slotStart; addr < slotEnd; addr += SLOT_SIZE) {
+            slots[(addr - pageBase) >> SLOT_SHIFT] = makePage(device, addr, SLOT_SIZE);
         }
     }
+}
+
+BusPage Bus::makePage(PsxDevice *device, uint32_t base, uint32_t size) const
+{
+    BusPage page = UNMAPPED_PAGE;
+    page.device = device;
+    page.base = base;
+    page.perfTarget = perfTargetOf(device);
+
+    auto memoryDev = dynamic_cast<Memory *>(device);
+    if (memoryDev) {
+        uint32_t offset = memoryDev->mapAddress(base);
+        uint8_t *host = memoryDev->data()->data() + offset;
+        page.hostRead = host;
+        page.hostWrite = memoryDev->isReadOnly() ? nullptr : host;
+        page.watch = memoryDev->watchFlags() + (offset >> Memory::WATCH_PAGE_SHIFT);
+    }
+    if (m_breakpoints && m_breakpoints->watches(base, size)) {
+        page.hostRead = nullptr;
+        page.hostWrite = nullptr;
+        page.watched = true;
+    }
+    return page;
+}
+
+std::vector<uint8_t> *Bus::getMemoryRange(uint32_t addr)
+{
+    auto memoryDev = dynamic_cast<Memory *>(findPage(MemoryMap::mapAddress(addr)).device);
+    if (memoryDev) {
+        return memoryDev->data();
+    }
+    return nullptr;
+}
+
+const std::vector<uint8_t> *Bus::getMemoryRange(uint32_t addr) const
+{
+    auto memoryDev = dynamic_cast<const Memory *>(findPage(MemoryMap::mapAddress(addr)).device);
+    if (memoryDev) {
+        return memoryDev->data();
+    }
     return nullptr;
 }
 
+Memory *Bus::getMemory(uint32_t addr) const
+{
+    return dynamic_cast<Memory *>(findPage(MemoryMap::mapAddress(addr)).device);
+}
+
 void Bus::updateDevices(int cycles)
 {
-    for (auto &[_, device] : m_devices) {
-        device->update(cycles);
+    // Only the updates running device events are charged to the devices
+    if (m_stallCycles == 0 && m_scheduler.now() + cycles < m_scheduler.nextEventTime()) {
+        m_scheduler.advance(cycles);
+        return;
+    }
+    PerfScope scope(&m_perf, PerfTimer::Devices);
+    m_scheduler.advance(cycles);
+    // Events may stall the CPU further, e.g. the next window of a chopped DMA
+    while (m_stallCycles > 0) {
+        uint64_t stall = m_stallCycles;
+        m_stallCycles = 0;
+        m_scheduler.advance(stall);
     }
 }
 
@@ -15,9 +15,30 @@
 #include <typeindex>
 
 #include "PsxDevice.hpp"
+#include "PerfCounters.hpp"
+#include "Scheduler.hpp"
 
 class CPU;
+class Memory;
 class StateBuffer;
+class TraceRecorder;
+class BreakpointSet;
+
+// Entry of the bus page table. Host-backed pages are accessed directly
+// through hostRead/hostWrite, other pages are forwarded to their device.
+// watch points to the memory write watch flags covering the page.
+// Pages with a watchpoint lose their host pointers and go to the device.
+struct BusPage
+{
+    uint8_t *hostRead;
+    uint8_t *hostWrite;
+    uint8_t *watch;
+    PsxDevice *device;
+    uint32_t base;
+    int32_t sharedIndex;
+    PerfBusTarget perfTarget;
+    bool watched;
+};
 
 class Bus
 {
@@ -39,10 +60,12 @@ class Bus
 
         std::vector<uint8_t> *getMemoryRange(uint32_t addr);
         const std::vector<uint8_t> *getMemoryRange(uint32_t addr) const;
+        Memory *getMemory(uint32_t addr) const;
 
         template<typename T>
         void addDevice(std::unique_ptr<T> device) {
             m_devices[std::type_index(typeid(T))] = std::move(device);
+            rebuildPageTable();
         }
 
         template<typename T>
@@ -54,16 +77,61 @@ class Bus
             return nullptr;
         }
 
+        // Advances the scheduler clock, devices only run when one of their events is due
         void updateDevices(int cycles);
+        Scheduler &getScheduler() { return m_scheduler; }
+
+        PerfCounters &getPerfCounters() { return m_perf; }
+
+        // Cycles the CPU loses to a device owning the bus, paid on the next update
+        void stallCpu(uint32_t cycles) { m_stallCycles += cycles; }
 
         void connectCpu(CPU *cpu);
         CPU *getCpu();
+        // Loads and stores are recorded while a recorder is set
+        void setTraceRecorder(TraceRecorder *recorder) { m_tracer = recorder; }
+        // Watchpoints apply once the page table is rebuilt
+        void setBreakpoints(BreakpointSet *breakpoints) { m_breakpoints = breakpoints; }
+
+        void rebuildPageTable();
 
     private:
+        static constexpr uint32_t PAGE_SHIFT = 16; // 64 KiB pages
+        static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+        static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+        static constexpr uint32_t PAGE_COUNT = MemoryMap::PHYSICAL_SPACE_SIZE >> PAGE_SHIFT;
+        // Pages shared by several devices (scratchpad + I/O ports) are split in word slots
+        static constexpr uint32_t SLOT_SHIFT = 2;
+        static constexpr uint32_t SLOT_SIZE = 1 << SLOT_SHIFT;
+
+        const BusPage &findPage(uint32_t pAddress) const;
+        PsxDevice *findUnpagedDevice(uint32_t pAddress) const;
+        void mapRange(PsxDevice *device, uint32_t start, uint32_t end);
+        BusPage makePage(PsxDevice *device, uint32_t base, uint32_t size) const;
+
+        template<typename T>
+        T load(uint32_t addr) const;
+        template<typename T>
+        void store(uint32_t addr, T value);
+        template<typename T>
+        T loadUntraced(uint32_t addr) const;
+        template<typename T>
+        void storeUntraced(uint32_t addr, T value);
+
+    private:
+        Scheduler m_scheduler;
+        mutable PerfCounters m_perf; // Loads are counted too
         std::unordered_map<std::type_index, std::unique_ptr<PsxDevice>> m_devices;
 
+        std::vector<BusPage> m_pages;
+        std::vector<std::vector<BusPage>> m_sharedPages;
+        std::vector<PsxDevice *> m_unpagedDevices;
+
         uint32_t m_cacheControl;
+        uint64_t m_stallCycles;
         CPU *m_cpu;
+        TraceRecorder *m_tracer;
+        BreakpointSet *m_breakpoints;
 };
 
 #endif /* !BUS_HPP_ */
@@ -7,7 +7,11 @@
 
 #include "CPU.hpp"
 #include "StateBuffer.hpp"
+#include "Memory.hpp"
+#include "TraceRecorder.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cstring>
 #include <spdlog/spdlog.h>
@@ -30,15 +34,93 @@ static bool subOverflow(int32_t a, int32_t b)
     return false;
 }
 
+// Atomic so systems can be constructed from several threads
+static std::atomic<CpuEngine> s_defaultEngine = CpuEngine::Interpreter;
+
 CPU::CPU(Bus *bus) :
+    m_inCompiledBlock(false),
+    m_engine(CpuEngine::Interpreter),
+    m_currentBlock(nullptr),
+    m_blockIndex(0),
+    m_codeInvalidated(false),
+    m_tracer(nullptr),
+    m_singleStep(false),
     m_bus(bus)
 {
     reset();
+    setEngine(s_defaultEngine);
+}
+
+CPU::~CPU()
+{
+    releaseWatchedMemory();
 }
 
 void CPU::step()
 {
+    if (m_tracer) [[unlikely]] {
+        tracedStep();
+        return;
+    }
+    if (m_engine == CpuEngine::Recompiler && runCompiled(m_stepCache, 1)) {
+        return;
+    }
+
+    // Handler and operands are copied: a store may free the current block
+    const DecodedInstruction *decoded = nullptr;
+    if (m_engine != CpuEngine::Interpreter) {
+        decoded = fetchDecoded();
+    }
+    if (decoded) {
+        Instruction instruction = decoded->instruction;
+        executeStep(decoded->handler, instruction);
+    } else {
+        Instruction instruction = fetchInstruction();
+        executeStep(decodeInstruction(instruction), instruction);
+    }
+    m_cycles += 2;
+}
+
+uint32_t CPU::runBlock()
+{
+    if (m_engine == CpuEngine::Recompiler && !m_tracer && !m_singleStep) {
+        uint32_t count = runCompiled(m_blockCache, BlockCache::MAX_BLOCK_SIZE);
+        if (count) {
+            return count;
+        }
+    }
+    step();
+    return 1;
+}
+
+void CPU::tracedStep()
+{
+    uint32_t pc = m_pc;
+    uint64_t cycle = m_cycles;
+
+    // The fetch is not a data access
+    m_bus->setTraceRecorder(nullptr);
     Instruction instruction = fetchInstruction();
+    m_bus->setTraceRecorder(m_tracer);
+
+    m_tracer->recordInstruction(pc, instruction.raw, cycle);
+    executeStep(decodeInstruction(instruction), instruction);
+    m_cycles += 2;
+    m_tracer->recordRegisters(m_gpr);
+}
+
+void CPU::setTraceRecorder(TraceRecorder *recorder)
+{
+    m_tracer = recorder;
+    m_bus->setTraceRecorder(recorder);
+    if (recorder) {
+        // Starting state of the registers
+        recorder->recordRegisters(m_gpr);
+    }
+}
+
+void CPU::executeStep(InstructionHandler handler, const Instruction &instruction)
+{
     m_nextPc = m_pc;
     m_inBranchDelay = m_nextIsBranchDelay;
     if (m_nextIsBranchDelay)
@@ -62,7 +144,7 @@ void CPU::step()
         return;
     }
 
-    executeInstruction(instruction);
+    handler(*this, instruction);
     handleLoadDelay();
     checkTtyOutput();
 
@@ -79,7 +161,58 @@ void CPU::reset()
     std::memset(m_loadDelaySlots, 0, sizeof(m_loadDelaySlots));
     std::memset(m_gpr, 0, NB_GPR * sizeof(m_gpr[0]));
     m_cop0.reset();
+    m_gte.reset();
+    m_cycles = 0;
+    m_gteReadyCycle = 0;
     m_isTtyOutput = false;
+    clearBlocks();
+}
+
+void CPU::setEngine(CpuEngine engine)
+{
+    if (engine == CpuEngine::Recompiler && !Recompiler::isSupported()) {
+        spdlog::warn("CPU: Recompiler is not supported on this host, using the cached interpreter");
+        engine = CpuEngine::CachedInterpreter;
+    }
+    if (engine == m_engine) {
+        return;
+    }
+    m_engine = engine;
+    clearBlocks();
+}
+
+CpuEngine CPU::getEngine() const
+{
+    return m_engine;
+}
+
+const BlockCache &CPU::getBlockCache() const
+{
+    return m_blockCache;
+}
+
+void CPU::setDefaultEngine(CpuEngine engine)
+{
+    s_defaultEngine = engine;
+}
+
+CpuEngine CPU::getDefaultEngine()
+{
+    return s_defaultEngine;
+}
+
+std::optional<CpuEngine> CPU::engineFromName(const std::string &name)
+{
+    if (name == "interpreter") {
+        return CpuEngine::Interpreter;
+    }
+    if (name == "cached") {
+        return CpuEngine::CachedInterpreter;
+    }
+    if (name == "recompiler") {
+        return CpuEngine::Recompiler;
+    }
+    return std::nullopt;
 }
 
 void CPU::serialize(StateBuffer &buf) const
@@ -98,6 +231,9 @@ void CPU::serialize(StateBuffer &buf) const
     buf.write(m_jumpToUnaligned);
     buf.write(m_badVarAddr);
     m_cop0.serialize(buf);
+    m_gte.serialize(buf);
+    buf.write(m_cycles);
+    buf.write(m_gteReadyCycle);
 }
 
 void CPU::deserialize(StateBuffer &buf)
@@ -116,6 +252,15 @@ void CPU::deserialize(StateBuffer &buf)
     buf.read(m_jumpToUnaligned);
     buf.read(m_badVarAddr);
     m_cop0.deserialize(buf);
+    m_gte.deserialize(buf);
+    buf.read(m_cycles);
+    buf.read(m_gteReadyCycle);
+    if (buf.isSnapshot()) {
+        // Snapshots restore RAM page by page, which already invalidates the modified code
+        m_currentBlock = nullptr;
+    } else {
+        clearBlocks();
+    }
 }
 
 void CPU::setTtyOutputFlag(bool ttyOutput)
@@ -138,6 +283,9 @@ std::string CPU::getTtyOutput()
 
 void CPU::checkTtyOutput()
 {
+    if (m_pc != 0xA0 && m_pc != 0xB0) {
+        return;
+    }
     uint32_t t1 = getReg(CpuReg::T1);
     uint32_t programCounter = getReg(CpuReg::PC);
     if ((programCounter == 0xA0 && t1 == 0x3C) || (programCounter == 0xB0 && t1 == 0x3D))
@@ -172,104 +320,260 @@ Instruction CPU::fetchInstruction()
     return Instruction{.raw=instruction};
 }
 
-void CPU::executeInstruction(const Instruction &instruction)
+InstructionHandler CPU::decodeInstruction(const Instruction &instruction) const
 {
     if (instruction.r.opcode & 0x10) {
-        executeCoprocessor(instruction);
-        return;
+        return decodeCoprocessor(instruction);
     }
     switch (static_cast<PrimaryOpCode>(instruction.r.opcode))
     {
     case PrimaryOpCode::LUI:
-        loadUpperImmediate(instruction);
-        break;
+        return &dispatch<&CPU::loadUpperImmediate>;
     case PrimaryOpCode::ORI:
-        orImmediateWord(instruction);
-        break;
+        return &dispatch<&CPU::orImmediateWord>;
     case PrimaryOpCode::SW:
-        storeWord(instruction);
-        break;
+        return &dispatch<&CPU::storeWord>;
     case PrimaryOpCode::ADDIU:
-        addImmediateUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::addImmediateUnsigned>;
     case PrimaryOpCode::ADDI:
-        addImmediate(instruction);
-        break;
+        return &dispatch<&CPU::addImmediate>;
     case PrimaryOpCode::J:
-        jump(instruction);
-        break;
+        return &dispatch<&CPU::jump>;
     case PrimaryOpCode::JAL:
-        jumpAndLink(instruction);
-        break;
+        return &dispatch<&CPU::jumpAndLink>;
     case PrimaryOpCode::LW:
-        loadWord(instruction);
-        break;
+        return &dispatch<&CPU::loadWord>;
     case PrimaryOpCode::SH:
-        storeHalfWord(instruction);
-        break;
+        return &dispatch<&CPU::storeHalfWord>;
     case PrimaryOpCode::LB:
-        loadByte(instruction);
-        break;
+        return &dispatch<&CPU::loadByte>;
     case PrimaryOpCode::LBU:
-        loadByteUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::loadByteUnsigned>;
     case PrimaryOpCode::LHU:
-        loadHalfWordUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::loadHalfWordUnsigned>;
     case PrimaryOpCode::XORI:
-        xorImmediateWord(instruction);
-        break;
+        return &dispatch<&CPU::xorImmediateWord>;
     case PrimaryOpCode::ANDI:
-        andImmediateWord(instruction);
-        break;
+        return &dispatch<&CPU::andImmediateWord>;
     case PrimaryOpCode::SB:
-        storeByte(instruction);
-        break;
+        return &dispatch<&CPU::storeByte>;
     case PrimaryOpCode::LH:
-        loadHalfWord(instruction);
-        break;
+        return &dispatch<&CPU::loadHalfWord>;
     case PrimaryOpCode::SWR:
-        storeWordRight(instruction);
-        break;
+        return &dispatch<&CPU::storeWordRight>;
     case PrimaryOpCode::SWL:
-        storeWordLeft(instruction);
-        break;
+        return &dispatch<&CPU::storeWordLeft>;
     case PrimaryOpCode::LWR:
-        loadWordRight(instruction);
-        break;
+        return &dispatch<&CPU::loadWordRight>;
     case PrimaryOpCode::LWL:
-        loadWordLeft(instruction);
-        break;
+        return &dispatch<&CPU::loadWordLeft>;
     case PrimaryOpCode::BGTZ:
-        branchOnGreaterThanZero(instruction);
-        break;
+        return &dispatch<&CPU::branchOnGreaterThanZero>;
     case PrimaryOpCode::SLTI:
-        setOnLessThanImmediate(instruction);
-        break;
+        return &dispatch<&CPU::setOnLessThanImmediate>;
     case PrimaryOpCode::SLTIU:
-        setOnLessThanImmediateUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::setOnLessThanImmediateUnsigned>;
     case PrimaryOpCode::SPECIAL:
-        specialInstruction(instruction);
-        break;
+        return decodeSpecial(instruction);
     case PrimaryOpCode::BCONDZ:
-        branchOnConditionZero(instruction);
-        break;
+        return decodeConditionZero(instruction);
     case PrimaryOpCode::BNE:
-        branchOnNotEqual(instruction);
-        break;
+        return &dispatch<&CPU::branchOnNotEqual>;
     case PrimaryOpCode::BEQ:
-        branchOnEqual(instruction);
-        break;
+        return &dispatch<&CPU::branchOnEqual>;
     case PrimaryOpCode::BLEZ:
-        branchOnLessThanOrEqualToZero(instruction);
-        break;
+        return &dispatch<&CPU::branchOnLessThanOrEqualToZero>;
     default:
-        illegalInstruction(instruction);
-        break;
+        return &dispatch<&CPU::illegalInstruction>;
+    }
+}
+
+bool CPU::isBranch(const Instruction &instruction)
+{
+    switch (static_cast<PrimaryOpCode>(instruction.r.opcode))
+    {
+    case PrimaryOpCode::BCONDZ:
+    case PrimaryOpCode::J:
+    case PrimaryOpCode::JAL:
+    case PrimaryOpCode::BEQ:
+    case PrimaryOpCode::BNE:
+    case PrimaryOpCode::BLEZ:
+    case PrimaryOpCode::BGTZ:
+        return true;
+    case PrimaryOpCode::SPECIAL:
+        return instruction.r.funct == static_cast<uint8_t>(SecondaryOpCode::JR) ||
+            instruction.r.funct == static_cast<uint8_t>(SecondaryOpCode::JALR);
+    default:
+        return false;
+    }
+}
+
+bool CPU::isLoad(const Instruction &instruction)
+{
+    switch (static_cast<PrimaryOpCode>(instruction.r.opcode))
+    {
+    case PrimaryOpCode::LB:
+    case PrimaryOpCode::LBU:
+    case PrimaryOpCode::LH:
+    case PrimaryOpCode::LHU:
+    case PrimaryOpCode::LW:
+    case PrimaryOpCode::LWL:
+    case PrimaryOpCode::LWR:
+        return true;
+    case PrimaryOpCode::COP2:
+        // MFC2 and CFC2 also go through the load delay slot
+        return instruction.r.rs == static_cast<uint8_t>(CoprocessorOpcode::MFC) ||
+            instruction.r.rs == static_cast<uint8_t>(CoprocessorOpcode::CFC);
+    default:
+        return false;
     }
 }
 
+const DecodedInstruction *CPU::fetchDecoded()
+{
+    if (!m_currentBlock || m_blockIndex >= m_currentBlock->instructions.size() ||
+        m_currentBlock->startPc + (m_blockIndex << 2) != m_pc) {
+        m_currentBlock = m_blockCache.find(m_pc);
+        if (!m_currentBlock) {
+            m_currentBlock = compileBlock(m_blockCache, m_pc, BlockCache::MAX_BLOCK_SIZE);
+        }
+        if (!m_currentBlock) {
+            return nullptr;
+        }
+        m_blockIndex = 0;
+    }
+    return &m_currentBlock->instructions[m_blockIndex++];
+}
+
+CachedBlock *CPU::compileBlock(BlockCache &cache, uint32_t pc, uint32_t maxSize)
+{
+    // Only code living in RAM or BIOS can be cached, anything else is interpreted
+    Memory *memory = pc % 4 == 0 ? m_bus->getMemory(pc) : nullptr;
+    if (!memory) {
+        return nullptr;
+    }
+
+    uint32_t address = MemoryMap::mapAddress(pc);
+    auto block = std::make_unique<CachedBlock>();
+    block->startPc = pc;
+    block->page = address >> BlockCache::PAGE_SHIFT;
+
+    uint32_t blockPc = pc;
+    bool delaySlot = false;
+    while (block->instructions.size() < maxSize) {
+        Instruction instruction{.raw = m_bus->loadWord(blockPc)};
+        block->instructions.push_back({decodeInstruction(instruction), instruction});
+        blockPc += 4;
+        if (delaySlot || blockPc % BlockCache::PAGE_SIZE == 0) {
+            break;
+        }
+        delaySlot = isBranch(instruction);
+    }
+
+    if (!memory->isReadOnly()) {
+        if (std::find(m_watchedMemory.begin(), m_watchedMemory.end(), memory) == m_watchedMemory.end()) {
+            memory->setWatchCallback(MemoryWatch::Code, [this](uint32_t page) {
+                invalidateCode(page);
+            });
+            m_watchedMemory.push_back(memory);
+        }
+        memory->watch(address, MemoryWatch::Code);
+    }
+    return cache.insert(std::move(block));
+}
+
+void CPU::invalidateCode(uint32_t address)
+{
+    m_blockCache.invalidatePage(address);
+    m_stepCache.invalidatePage(address);
+    m_currentBlock = nullptr;
+    m_codeInvalidated = true;
+}
+
+void CPU::clearBlocks()
+{
+    m_blockCache.clear();
+    m_stepCache.clear();
+    m_currentBlock = nullptr;
+    if (m_recompiler) {
+        m_recompiler->flush();
+    }
+}
+
+uint32_t CPU::runCompiled(BlockCache &cache, uint32_t maxSize)
+{
+    // Compiled code expects a plain sequential entry, anything else is interpreted
+    if (m_nextIsBranchDelay || m_jumpToUnaligned || (interruptPending() && interruptsEnabled())) {
+        return 0;
+    }
+
+    CachedBlock *block = cache.find(m_pc);
+    if (!block) {
+        block = compileBlock(cache, m_pc, maxSize);
+        if (!block) {
+            return 0;
+        }
+    }
+    if (!block->code) {
+        if (!m_recompiler) {
+            m_recompiler = std::make_unique<Recompiler>(recompilerLayout(), &CPU::jitStep, &CPU::jitStepBranch);
+        }
+        block->code = m_recompiler->compile(*block);
+        if (!block->code) {
+            // Code buffer is full, start over and interpret this instruction
+            clearBlocks();
+            return 0;
+        }
+    }
+    m_codeInvalidated = false;
+    // Lets the GTE instructions of the block know their own cycle, see currentCycle
+    m_inCompiledBlock = true;
+    m_blockStartPc = m_pc;
+    uint32_t count = block->code(this, m_gpr);
+    m_inCompiledBlock = false;
+    m_cycles += count * 2;
+    return count;
+}
+
+RecompilerLayout CPU::recompilerLayout() const
+{
+    auto offset = [this](const void *field) {
+        return static_cast<int32_t>(static_cast<const uint8_t *>(field) - reinterpret_cast<const uint8_t *>(m_gpr));
+    };
+
+    RecompilerLayout layout;
+    layout.pc = offset(&m_pc);
+    layout.nextPc = offset(&m_nextPc);
+    layout.hi = offset(&m_hi);
+    layout.lo = offset(&m_lo);
+    layout.loadPending = offset(&m_loadDelaySlots[0].pending);
+    return layout;
+}
+
+uint32_t CPU::jitStep(CPU *cpu, InstructionHandler handler, uint32_t instruction)
+{
+    uint32_t pc = cpu->m_pc;
+    cpu->executeStep(handler, Instruction{.raw = instruction});
+    return cpu->m_pc != pc + 4 || cpu->m_nextIsBranchDelay || cpu->m_jumpToUnaligned ||
+        cpu->m_codeInvalidated || (cpu->interruptPending() && cpu->interruptsEnabled());
+}
+
+uint32_t CPU::jitStepBranch(CPU *cpu, InstructionHandler handler, uint32_t instruction)
+{
+    // The delay slot is part of the same block
+    uint32_t pc = cpu->m_pc;
+    cpu->executeStep(handler, Instruction{.raw = instruction});
+    return cpu->m_pc != pc + 4 || cpu->m_codeInvalidated;
+}
+
+void CPU::releaseWatchedMemory()
+{
+    for (auto memory : m_watchedMemory) {
+        memory->setWatchCallback(MemoryWatch::Code, nullptr);
+    }
+    m_watchedMemory.clear();
+}
+
 void CPU::handleLoadDelay()
 {
     if (m_loadDelaySlots[0].pending) {
@@ -287,114 +591,85 @@ bool CPU::interruptsEnabled()
     return (m_cop0.mfc(12) & 0x401) == 0x401;
 }
 
-void CPU::branchOnConditionZero(const Instruction &instruction)
+InstructionHandler CPU::decodeConditionZero(const Instruction &instruction) const
 {
     if ((instruction.i.rt & 0x1E) == 0x10) {
         if (instruction.i.rt & 1) {
-            branchOnGreaterThanOrEqualToZeroAndLink(instruction);
+            return &dispatch<&CPU::branchOnGreaterThanOrEqualToZeroAndLink>;
         } else {
-            branchOnLessThanZeroAndLink(instruction);
+            return &dispatch<&CPU::branchOnLessThanZeroAndLink>;
         }
     } else {
         if (instruction.i.rt & 1) {
-            branchOnGreaterThanOrEqualToZero(instruction);
+            return &dispatch<&CPU::branchOnGreaterThanOrEqualToZero>;
         } else {
-            branchOnLessThanZero(instruction);
+            return &dispatch<&CPU::branchOnLessThanZero>;
         }
     }
 }
 
-void CPU::specialInstruction(const Instruction &instruction)
+InstructionHandler CPU::decodeSpecial(const Instruction &instruction) const
 {
     switch (static_cast<SecondaryOpCode>(instruction.r.funct))
     {
     case SecondaryOpCode::SLL:
-        shiftLeftLogical(instruction);
-        break;
+        return &dispatch<&CPU::shiftLeftLogical>;
     case SecondaryOpCode::OR:
-        orWord(instruction);
-        break;
+        return &dispatch<&CPU::orWord>;
     case SecondaryOpCode::XOR:
-        xorWord(instruction);
-        break;
+        return &dispatch<&CPU::xorWord>;
     case SecondaryOpCode::NOR:
-        norWord(instruction);
-        break;
+        return &dispatch<&CPU::norWord>;
     case SecondaryOpCode::ADDU:
-        addWordUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::addWordUnsigned>;
     case SecondaryOpCode::SUBU:
-        substractWordUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::substractWordUnsigned>;
     case SecondaryOpCode::AND:
-        andWord(instruction);
-        break;
+        return &dispatch<&CPU::andWord>;
     case SecondaryOpCode::SUB:
-        substractWord(instruction);
-        break;
+        return &dispatch<&CPU::substractWord>;
     case SecondaryOpCode::ADD:
-        addWord(instruction);
-        break;
+        return &dispatch<&CPU::addWord>;
     case SecondaryOpCode::SLT:
-        setOnLessThan(instruction);
-        break;
+        return &dispatch<&CPU::setOnLessThan>;
     case SecondaryOpCode::SLTU:
-        setOnLessThanUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::setOnLessThanUnsigned>;
     case SecondaryOpCode::SLLV:
-        shiftLeftLogicalVariable(instruction);
-        break;
+        return &dispatch<&CPU::shiftLeftLogicalVariable>;
     case SecondaryOpCode::SRL:
-        shiftRightLogical(instruction);
-        break;
+        return &dispatch<&CPU::shiftRightLogical>;
     case SecondaryOpCode::SRLV:
-        shiftRightLogicalVariable(instruction);
-        break;
+        return &dispatch<&CPU::shiftRightLogicalVariable>;
     case SecondaryOpCode::SRA:
-        shiftRightArithmetic(instruction);
-        break;
+        return &dispatch<&CPU::shiftRightArithmetic>;
     case SecondaryOpCode::SRAV:
-        shiftRightArithmeticVariable(instruction);
-        break;
+        return &dispatch<&CPU::shiftRightArithmeticVariable>;
     case SecondaryOpCode::MULT:
-        multiply(instruction);
-        break;
+        return &dispatch<&CPU::multiply>;
     case SecondaryOpCode::MULTU:
-        multiplyUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::multiplyUnsigned>;
     case SecondaryOpCode::DIV:
-        divide(instruction);
-        break;
+        return &dispatch<&CPU::divide>;
     case SecondaryOpCode::DIVU:
-        divideUnsigned(instruction);
-        break;
+        return &dispatch<&CPU::divideUnsigned>;
     case SecondaryOpCode::MFHI:
-        moveFromHi(instruction);
-        break;
+        return &dispatch<&CPU::moveFromHi>;
     case SecondaryOpCode::MFLO:
-        moveFromLo(instruction);
-        break;
+        return &dispatch<&CPU::moveFromLo>;
     case SecondaryOpCode::MTHI:
-        moveToHi(instruction);
-        break;
+        return &dispatch<&CPU::moveToHi>;
     case SecondaryOpCode::MTLO:
-        moveToLo(instruction);
-        break;
+        return &dispatch<&CPU::moveToLo>;
     case SecondaryOpCode::JR:
-        jumpRegister(instruction);
-        break;
+        return &dispatch<&CPU::jumpRegister>;
     case SecondaryOpCode::JALR:
-        jumpAndLinkRegister(instruction);
-        break;
+        return &dispatch<&CPU::jumpAndLinkRegister>;
     case SecondaryOpCode::SYSCALL:
-        executeSyscall(instruction);
-        break;
+        return &dispatch<&CPU::executeSyscall>;
     case SecondaryOpCode::BREAK:
-        executeBreak(instruction);
-        break;
+        return &dispatch<&CPU::executeBreak>;
     default:
-        illegalInstruction(instruction);
-        break;
+        return &dispatch<&CPU::illegalInstruction>;
     }
 }
 
@@ -446,6 +721,16 @@ void CPU::setCop0Reg(uint8_t reg, uint32_t val)
     m_cop0.mtc(reg, val);
 }
 
+GTE &CPU::getGte()
+{
+    return m_gte;
+}
+
+uint64_t CPU::getCycles() const
+{
+    return m_cycles;
+}
+
 void CPU::setInterruptPending(bool pending)
 {
     uint32_t cause = m_cop0.mfc(13);
@@ -1059,28 +1344,50 @@ void CPU::branchOnGreaterThanOrEqualToZeroAndLink(const Instruction &instruction
     setReg(CpuReg::RA, m_pc + 8);
 }
 
-void CPU::executeCoprocessor(const Instruction &instruction)
+InstructionHandler CPU::decodeCoprocessor(const Instruction &instruction) const
 {
-    // Obsolete, need to be redone to match specific processors
     auto code = static_cast<CoprocessorOpcode>(instruction.r.rs);
 
-    switch (code)
+    switch (static_cast<PrimaryOpCode>(instruction.r.opcode))
     {
-    case CoprocessorOpcode::MTC:
-        mtc0(instruction);
-        break;
-    case CoprocessorOpcode::MFC:
-        mfc0(instruction);
+    case PrimaryOpCode::COP0:
+        if (code == CoprocessorOpcode::MTC) {
+            return &dispatch<&CPU::mtc0>;
+        }
+        if (code == CoprocessorOpcode::MFC) {
+            return &dispatch<&CPU::mfc0>;
+        }
+        if (instruction.r.rs == 0x10 && instruction.r.funct == 0x10) {
+            return &dispatch<&CPU::returnFromException>;
+        }
         break;
-    default:
-        if (instruction.r.rs == 0x10 && instruction.r.funct == 0x10)
+    case PrimaryOpCode::COP2:
+        // The GTE is a member, its calls are direct and can be inlined
+        if (instruction.r.rs & static_cast<uint8_t>(CoprocessorOpcode::IMM25)) {
+            return &dispatch<&CPU::gteCommand>;
+        }
+        switch (code)
         {
-            returnFromException(instruction);
+        case CoprocessorOpcode::MFC:
+            return &dispatch<&CPU::mfc2>;
+        case CoprocessorOpcode::CFC:
+            return &dispatch<&CPU::cfc2>;
+        case CoprocessorOpcode::MTC:
+            return &dispatch<&CPU::mtc2>;
+        case CoprocessorOpcode::CTC:
+            return &dispatch<&CPU::ctc2>;
+        default:
             break;
         }
-        illegalInstruction(instruction);
+        break;
+    case PrimaryOpCode::LWC2:
+        return &dispatch<&CPU::loadWordCop2>;
+    case PrimaryOpCode::SWC2:
+        return &dispatch<&CPU::storeWordCop2>;
+    default:
         break;
     }
+    return &dispatch<&CPU::illegalInstruction>;
 }
 
 void CPU::mtc0(const Instruction &instruction)
@@ -1099,6 +1406,124 @@ void CPU::mfc0(const Instruction &instruction)
     setReg(reg, data);
 }
 
+bool CPU::checkCop2Usable()
+{
+    if (getCop0Reg(static_cast<uint8_t>(CP0Reg::SR)) & 0x40000000) {
+        return true;
+    }
+    triggerException(ExceptionType::COP_Unusable);
+    // Coprocessor number in the CE field
+    uint32_t cause = getCop0Reg(static_cast<uint8_t>(CP0Reg::CAUSE));
+    setCop0Reg(static_cast<uint8_t>(CP0Reg::CAUSE), cause | (2 << 28));
+    return false;
+}
+
+uint64_t CPU::currentCycle() const
+{
+    // Compiled blocks only add their cycles once they return
+    if (m_inCompiledBlock) {
+        return m_cycles + ((m_pc - m_blockStartPc) >> 2) * 2;
+    }
+    return m_cycles;
+}
+
+void CPU::waitForGte()
+{
+    uint64_t now = currentCycle();
+
+    if (m_gteReadyCycle > now) {
+        uint32_t stall = static_cast<uint32_t>(m_gteReadyCycle - now);
+        m_bus->stallCpu(stall);
+        m_cycles += stall;
+    }
+}
+
+void CPU::mfc2(const Instruction &instruction)
+{
+    if (!checkCop2Usable()) {
+        return;
+    }
+    waitForGte();
+    loadWithDelay(static_cast<CpuReg>(instruction.r.rt), m_gte.mfc(instruction.r.rd));
+}
+
+void CPU::cfc2(const Instruction &instruction)
+{
+    if (!checkCop2Usable()) {
+        return;
+    }
+    waitForGte();
+    loadWithDelay(static_cast<CpuReg>(instruction.r.rt), m_gte.cfc(instruction.r.rd));
+}
+
+void CPU::mtc2(const Instruction &instruction)
+{
+    if (!checkCop2Usable()) {
+        return;
+    }
+    waitForGte();
+    m_gte.mtc(instruction.r.rd, getReg(static_cast<CpuReg>(instruction.r.rt)));
+}
+
+void CPU::ctc2(const Instruction &instruction)
+{
+    if (!checkCop2Usable()) {
+        return;
+    }
+    waitForGte();
+    m_gte.ctc(instruction.r.rd, getReg(static_cast<CpuReg>(instruction.r.rt)));
+}
+
+void CPU::gteCommand(const Instruction &instruction)
+{
+    if (!checkCop2Usable()) {
+        return;
+    }
+    waitForGte();
+    m_gte.execute(instruction.raw);
+    m_gteReadyCycle = currentCycle() + GTE::commandCycles(instruction.raw);
+}
+
+void CPU::loadWordCop2(const Instruction &instruction)
+{
+    int32_t imm = static_cast<int16_t>(instruction.i.immediate);
+    uint32_t address = getReg(static_cast<CpuReg>(instruction.i.rs)) + imm;
+
+    if (!checkCop2Usable()) {
+        return;
+    }
+    if (address % 4 != 0) {
+        m_badVarAddr = address;
+        triggerException(ExceptionType::AddressErrorLoad);
+        return;
+    }
+    uint32_t value = m_bus->loadWord(address);
+    waitForGte();
+    m_gte.mtc(instruction.i.rt, value);
+}
+
+void CPU::storeWordCop2(const Instruction &instruction)
+{
+    int32_t imm = static_cast<int16_t>(instruction.i.immediate);
+    uint32_t address = getReg(static_cast<CpuReg>(instruction.i.rs)) + imm;
+
+    if (!checkCop2Usable()) {
+        return;
+    }
+    if (address % 4 != 0) {
+        m_badVarAddr = address;
+        triggerException(ExceptionType::AddressErrorStore);
+        return;
+    }
+    waitForGte();
+    uint32_t value = m_gte.mfc(instruction.i.rt);
+    // Check if cache is isolated
+    if (getCop0Reg(static_cast<uint8_t>(CP0Reg::SR)) & 0x00010000) {
+        return;
+    }
+    m_bus->storeWord(address, value);
+}
+
 void CPU::executeSyscall(const Instruction &instruction)
 {
     (void)instruction;
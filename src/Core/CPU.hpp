@@ -10,12 +10,17 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include "Instruction.h"
 #include "Bus.hpp"
+#include "BlockCache.hpp"
+#include "Recompiler.hpp"
 #include "SystemControlCop.hpp"
+#include "GTE.hpp"
 
 class StateBuffer;
+class TraceRecorder;
 
 #define RESET_VECTOR (uint32_t)0xBFC00000
 #define NB_GPR 32
@@ -82,6 +87,13 @@ enum class ExceptionType
     Overflow
 };
 
+enum class CpuEngine
+{
+    Interpreter,       // Fetch and decode every instruction
+    CachedInterpreter, // Run pre-decoded blocks from the block cache
+    Recompiler,        // Translate blocks to x86-64 code, x86-64 hosts only
+};
+
 struct LoadDelaySlot
 {
     uint32_t value;
@@ -92,10 +104,26 @@ struct LoadDelaySlot
 class CPU {
     public:
         CPU(Bus *bus);
+        ~CPU();
 
         void step();
+        // Runs a whole compiled block when possible, returns the instructions run
+        uint32_t runBlock();
         void reset();
 
+        void setEngine(CpuEngine engine);
+        CpuEngine getEngine() const;
+        const BlockCache &getBlockCache() const;
+
+        // Engine picked by newly constructed CPUs
+        static void setDefaultEngine(CpuEngine engine);
+        static CpuEngine getDefaultEngine();
+        // Parses the command line name of an engine: interpreter, cached or recompiler
+        static std::optional<CpuEngine> engineFromName(const std::string &name);
+
+        static bool isBranch(const Instruction &instruction);
+        static bool isLoad(const Instruction &instruction);
+
         void serialize(StateBuffer &buf) const;
         void deserialize(StateBuffer &buf);
         void setTtyOutputFlag(bool ttyOutput);
@@ -108,9 +136,43 @@ class CPU {
         void setCop0Reg(uint8_t reg, uint32_t val);
         void setInterruptPending(bool pending);
 
+        GTE &getGte();
+        // Steps go through the interpreter and are recorded while a recorder
+        // is set, the bus records the data accesses. nullptr stops recording.
+        void setTraceRecorder(TraceRecorder *recorder);
+        // Makes runBlock run a single instruction, so breakpoints can be checked after each one
+        void setSingleStep(bool singleStep) { m_singleStep = singleStep; }
+        // CPU cycles run so far, two per instruction plus the GTE stalls
+        uint64_t getCycles() const;
+
     private:
         Instruction fetchInstruction();
-        void executeInstruction(const Instruction &instruction);
+        void tracedStep();
+        void executeStep(InstructionHandler handler, const Instruction &instruction);
+
+        // Decoding
+        InstructionHandler decodeInstruction(const Instruction &instruction) const;
+        InstructionHandler decodeSpecial(const Instruction &instruction) const;
+        InstructionHandler decodeConditionZero(const Instruction &instruction) const;
+        InstructionHandler decodeCoprocessor(const Instruction &instruction) const;
+
+        template<void (CPU::*Handler)(const Instruction &)>
+        static void dispatch(CPU &cpu, const Instruction &instruction) {
+            (cpu.*Handler)(instruction);
+        }
+
+        // Cached interpreter
+        const DecodedInstruction *fetchDecoded();
+        CachedBlock *compileBlock(BlockCache &cache, uint32_t pc, uint32_t maxSize);
+        void invalidateCode(uint32_t address);
+        void clearBlocks();
+        void releaseWatchedMemory();
+
+        // Recompiler
+        uint32_t runCompiled(BlockCache &cache, uint32_t maxSize);
+        RecompilerLayout recompilerLayout() const;
+        static uint32_t jitStep(CPU *cpu, InstructionHandler handler, uint32_t instruction);
+        static uint32_t jitStepBranch(CPU *cpu, InstructionHandler handler, uint32_t instruction);
         void handleLoadDelay();
         bool interruptsEnabled();
         bool interruptPending();
@@ -187,7 +249,6 @@ class CPU {
 
         // Branch instructions
         void executeBranch(const Instruction &instruction);
-        void branchOnConditionZero(const Instruction &instruction);
         void branchOnEqual(const Instruction &instruction); // BEQ
         void branchOnNotEqual(const Instruction &instruction); // BNZ
         void branchOnLessThanOrEqualToZero(const Instruction &instruction); // BLEZ
@@ -198,18 +259,28 @@ class CPU {
         void branchOnGreaterThanOrEqualToZeroAndLink(const Instruction &instruction); // BGEZAL
 
         //COP Instructions
-        void executeCoprocessor(const Instruction &instruction);
         void mtc0(const Instruction &instruction);
         void mfc0(const Instruction &instruction);
         void returnFromException(const Instruction &instruction);
 
+        // GTE (COP2) Instructions
+        bool checkCop2Usable();
+        uint64_t currentCycle() const;
+        void waitForGte();
+        void mfc2(const Instruction &instruction);
+        void cfc2(const Instruction &instruction);
+        void mtc2(const Instruction &instruction);
+        void ctc2(const Instruction &instruction);
+        void gteCommand(const Instruction &instruction);
+        void loadWordCop2(const Instruction &instruction);
+        void storeWordCop2(const Instruction &instruction);
+
         // Exception Instructions
         void triggerException(ExceptionType exception);
         void executeSyscall(const Instruction &instruction);
         void executeBreak(const Instruction &instruction);
 
         void illegalInstruction(const Instruction &instruction);
-        void specialInstruction(const Instruction &instruction);
 
         void checkTtyOutput();
 
@@ -221,6 +292,12 @@ class CPU {
         uint32_t m_lo;
 
         SystemControlCop m_cop0;
+        // Called directly rather than through Coprocessor, see decodeCoprocessor
+        GTE m_gte;
+        uint64_t m_cycles;
+        uint64_t m_gteReadyCycle; // Cycle the running GTE command completes
+        uint32_t m_blockStartPc;
+        bool m_inCompiledBlock;
 
         uint32_t m_nextPc;
 
@@ -236,6 +313,19 @@ class CPU {
         bool m_jumpToUnaligned;
         uint32_t m_badVarAddr;
 
+        CpuEngine m_engine;
+        BlockCache m_blockCache;
+        CachedBlock *m_currentBlock;
+        uint32_t m_blockIndex;
+        std::vector<Memory *> m_watchedMemory;
+
+        std::unique_ptr<Recompiler> m_recompiler;
+        BlockCache m_stepCache; // Single instruction blocks run by step()
+        bool m_codeInvalidated;
+
+        TraceRecorder *m_tracer;
+        bool m_singleStep;
+
         // Bus connection
         Bus *m_bus;
 };
@@ -3,6 +3,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include "Log.hpp"
+
 CacheControl::CacheControl(Bus *bus) :
     PsxDevice(bus),
     m_cacheControl(0)
@@ -32,7 +34,7 @@ void CacheControl::write8(uint8_t value, uint32_t address)
 
 void CacheControl::write16(uint16_t value, uint32_t address)
 {
-    spdlog::trace("Cache Control: Write halfword 0x{:04X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::CacheControl, "Cache Control: Write halfword 0x{:04X} to 0x{:08X}", value, address);
     if (address == 0xFFFE0130) {
         m_cacheControl = (m_cacheControl & 0xFFFF0000) | value;
     } else {
@@ -42,7 +44,7 @@ void CacheControl::write16(uint16_t value, uint32_t address)
 
 void CacheControl::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("Cache Control: Write word 0x{:08X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::CacheControl, "Cache Control: Write word 0x{:08X} to 0x{:08X}", value, address);
     if (address == 0xFFFE0130) {
         m_cacheControl = value;
     } else {
@@ -58,7 +60,7 @@ uint8_t CacheControl::read8(uint32_t address)
 
 uint16_t CacheControl::read16(uint32_t address)
 {
-    spdlog::trace("Cache Control: Read halfword from 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::CacheControl, "Cache Control: Read halfword from 0x{:08X}", address);
     if (address == 0xFFFE0130) {
         return static_cast<uint16_t>(m_cacheControl & 0xFFFF);
     } else {
@@ -69,7 +71,7 @@ uint16_t CacheControl::read16(uint32_t address)
 
 uint32_t CacheControl::read32(uint32_t address)
 {
-    spdlog::trace("Cache Control: Read word from 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::CacheControl, "Cache Control: Read word from 0x{:08X}", address);
     if (address == 0xFFFE0130) {
         return m_cacheControl;
     } else {
@@ -2,14 +2,30 @@
 #include "StateBuffer.hpp"
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
 
 #include "MemoryMap.hpp"
 #include "Bus.hpp"
+#include "Log.hpp"
+#include "GPU.hpp"
+#include "RAM.hpp"
+#include "InterruptController.hpp"
 
 #define GPU_GP0_ADDR 0x1F801810
 #define GPU_GP1_ADDR 0x1F801814
 #define GPU_GPUREAD_ADDR GPU_GP0_ADDR
 #define GPU_GPUSTAT_ADDR GPU_GP1_ADDR
+#define DMA_CHUNK_WORDS 256 // Words copied at once by decrementing transfers
+#define RAM_WORD_MASK ((MemoryMap::RAM_RANGE.length >> 2) - 1) // Addresses wrap around the 2 MiB RAM
+#define DMA_WORD_CYCLES 1 // Bus cycles taken by each transferred word
+
+#define DICR_WRITE_MASK 0x00FF803F
+#define DICR_FORCE_IRQ (1u << 15)
+#define DICR_IRQ_ENABLE_SHIFT 16
+#define DICR_MASTER_ENABLE (1u << 23)
+#define DICR_IRQ_FLAGS_SHIFT 24
+#define DICR_IRQ_FLAGS 0x7F000000
+#define DICR_MASTER_FLAG (1u << 31)
 
 DMA::DMA(Bus *bus) :
     PsxDevice(bus)
@@ -26,6 +42,9 @@ void DMA::reset()
 {
     m_dpcr = 0x07654321;
     m_dicr = 0;
+    m_deadlines.fill(Scheduler::NEVER);
+    m_chopWords.fill(0);
+    m_busyUntil = 0;
 }
 
 void DMA::serialize(StateBuffer &buf) const
@@ -34,6 +53,9 @@ void DMA::serialize(StateBuffer &buf) const
         m_channels[i].serialize(buf);
     buf.write(m_dpcr);
     buf.write(m_dicr);
+    buf.write(m_deadlines);
+    buf.write(m_chopWords);
+    buf.write(m_busyUntil);
 }
 
 void DMA::deserialize(StateBuffer &buf)
@@ -42,6 +64,9 @@ void DMA::deserialize(StateBuffer &buf)
         m_channels[i].deserialize(buf);
     buf.read(m_dpcr);
     buf.read(m_dicr);
+    buf.read(m_deadlines);
+    buf.read(m_chopWords);
+    buf.read(m_busyUntil);
 }
 
 void DMA::write8(uint8_t value, uint32_t address)
@@ -56,7 +81,7 @@ void DMA::write16(uint16_t value, uint32_t address)
 
 void DMA::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("DMA: Write word 0x{:08X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::Dma, "DMA: Write word 0x{:08X} to 0x{:08X}", value, address);
 
     uint32_t offset = m_memoryRange.remap(address);
     uint8_t channelIndex = (offset >> 4) & 0xF;
@@ -69,12 +94,19 @@ void DMA::write32(uint32_t value, uint32_t address)
 
     DMAChannel &channel = m_channels[channelIndex];
     channel.setRegister(static_cast<DMAChannelReg>(channelRegister), value);
+    if (static_cast<DMAChannelReg>(channelRegister) != DMAChannelReg::ChannelControl) {
+        return;
+    }
 
     DMAChannelControl &chcr = channel.channelControl();
-    if (chcr.forceTransferStart || chcr.transferStatus == DMATransferStatus::Started) {
-        executeDmaTransfer(channelIndex);
-        channel.channelControl().transferStatus = DMATransferStatus::Stopped;
-        channel.channelControl().forceTransferStart = false;
+    bool start = chcr.forceTransferStart || chcr.transferStatus == DMATransferStatus::Started;
+    if (m_chopWords[channelIndex] > 0) {
+        // Clearing the start bit aborts a chopped transfer between two windows
+        if (!start) {
+            stopTransfer(channelIndex);
+        }
+    } else if (start) {
+        startTransfer(channelIndex);
     }
 }
 
@@ -92,7 +124,7 @@ uint16_t DMA::read16(uint32_t address)
 
 uint32_t DMA::read32(uint32_t address)
 {
-    spdlog::trace("DMA: Read word at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::Dma, "DMA: Read word at 0x{:08X}", address);
 
     uint32_t offset = m_memoryRange.remap(address);
     uint8_t channelIndex = (offset >> 4) & 0xF;
@@ -124,7 +156,9 @@ void DMA::writeCommonRegisters(uint8_t reg, uint32_t value)
         m_dpcr = value;
         break;
     case 1:
-        m_dicr = value;
+        // Interrupt flags are acknowledged by writing 1, the master flag is read only
+        m_dicr = (value & DICR_WRITE_MASK) | (m_dicr & ~value & DICR_IRQ_FLAGS);
+        updateInterrupt();
         break;
     default:
         break;
@@ -145,122 +179,334 @@ uint32_t DMA::readCommonRegisters(uint8_t reg)
     return 0;
 }
 
-void DMA::executeDmaTransfer(uint8_t channel)
+void DMA::onEvent(SchedulerEvent /* event */)
+{
+    PerfScope scope(perfCounters(), PerfTimer::Dma);
+    uint64_t now = currentTime();
+    std::array<uint8_t, 7> order = {0, 1, 2, 3, 4, 5, 6};
+
+    // Channels due at the same time are served by DPCR priority
+    std::sort(order.begin(), order.end(), [this](uint8_t a, uint8_t b) {
+        return channelPriority(a) < channelPriority(b);
+    });
+    for (uint8_t channel : order) {
+        if (m_deadlines[channel] > now) {
+            continue;
+        }
+        if (m_chopWords[channel] > 0) {
+            runChopWindow(channel);
+        } else {
+            finishTransfer(channel);
+        }
+    }
+    scheduleNextEvent();
+}
+
+void DMA::startTransfer(uint8_t channel)
+{
+    DMAChannelControl &chcr = m_channels[channel].channelControl();
+
+    if (!m_bus) {
+        spdlog::error("DMA: No bus reference!");
+        chcr.transferStatus = DMATransferStatus::Stopped;
+        chcr.forceTransferStart = false;
+        return;
+    }
+    // The previous transfer of the channel is over, even if its interrupt is not due yet
+    if (m_deadlines[channel] != Scheduler::NEVER) {
+        finishTransfer(channel);
+    }
+
+    if (chcr.syncMode == DMASyncMode::Burst && chcr.enableChop) {
+        uint32_t count = m_channels[channel].blockControl().block.count;
+        m_chopWords[channel] = count ? count : 0x10000;
+        chcr.forceTransferStart = false;
+        runChopWindow(channel);
+        return;
+    }
+
+    // Without chopping the CPU waits for the whole transfer, only the interrupt is left
+    PerfScope scope(perfCounters(), PerfTimer::Dma);
+    uint32_t words = executeDmaTransfer(channel);
+    chcr.transferStatus = DMATransferStatus::Stopped;
+    chcr.forceTransferStart = false;
+    perfCounters()->frame().dmaWords[channel] += words;
+    m_deadlines[channel] = occupyBus(words * DMA_WORD_CYCLES);
+    scheduleNextEvent();
+}
+
+void DMA::stopTransfer(uint8_t channel)
+{
+    m_chopWords[channel] = 0;
+    m_deadlines[channel] = Scheduler::NEVER;
+    scheduleNextEvent();
+}
+
+// Moves one window of a chopped burst, then leaves the bus to the CPU
+void DMA::runChopWindow(uint8_t channel)
+{
+    DMAChannel &dmaChannel = m_channels[channel];
+    DMAChannelControl &chcr = dmaChannel.channelControl();
+    uint32_t count = std::min(m_chopWords[channel], 1u << chcr.chopDmaSize);
+
+    m_chopWords[channel] -= count;
+    bool last = m_chopWords[channel] == 0;
+    uint32_t address = dmaChannel.getRegister(DMAChannelReg::MemoryAddress);
+    dmaChannel.setRegister(DMAChannelReg::MemoryAddress, burstTransfer(channel, address, count, last));
+    perfCounters()->frame().dmaWords[channel] += count;
+
+    uint64_t windowEnd = occupyBus(count * DMA_WORD_CYCLES);
+    m_deadlines[channel] = last ? windowEnd : windowEnd + (1u << chcr.chopCpuSize);
+    scheduleNextEvent();
+}
+
+void DMA::finishTransfer(uint8_t channel)
+{
+    DMAChannelControl &chcr = m_channels[channel].channelControl();
+
+    chcr.transferStatus = DMATransferStatus::Stopped;
+    chcr.forceTransferStart = false;
+    m_chopWords[channel] = 0;
+    m_deadlines[channel] = Scheduler::NEVER;
+    if (m_dicr & (1u << (DICR_IRQ_ENABLE_SHIFT + channel))) {
+        m_dicr |= 1u << (DICR_IRQ_FLAGS_SHIFT + channel);
+    }
+    updateInterrupt();
+}
+
+// Reserves the bus after any transfer still in progress and stalls the CPU meanwhile.
+// Returns the time the bus is released.
+uint64_t DMA::occupyBus(uint32_t cycles)
+{
+    m_busyUntil = std::max(currentTime(), m_busyUntil) + cycles;
+    if (m_bus) {
+        m_bus->stallCpu(cycles);
+    }
+    return m_busyUntil;
+}
+
+void DMA::scheduleNextEvent()
+{
+    uint64_t next = *std::min_element(m_deadlines.begin(), m_deadlines.end());
+
+    if (next == Scheduler::NEVER) {
+        schedule(SchedulerEvent::Dma, Scheduler::NEVER);
+    } else {
+        schedule(SchedulerEvent::Dma, next - std::min(next, currentTime()));
+    }
+}
+
+// Lower DPCR values win, ties go to the highest channel
+uint32_t DMA::channelPriority(uint8_t channel) const
+{
+    return (((m_dpcr >> (channel * 4)) & 7) << 3) | (6u - channel);
+}
+
+// IRQ3 fires when the master flag rises
+void DMA::updateInterrupt()
+{
+    uint32_t enabled = (m_dicr >> DICR_IRQ_ENABLE_SHIFT) & 0x7F;
+    uint32_t flags = (m_dicr & DICR_IRQ_FLAGS) >> DICR_IRQ_FLAGS_SHIFT;
+    bool master = (m_dicr & DICR_FORCE_IRQ) || ((m_dicr & DICR_MASTER_ENABLE) && (enabled & flags));
+    bool rising = master && !(m_dicr & DICR_MASTER_FLAG);
+
+    m_dicr = master ? (m_dicr | DICR_MASTER_FLAG) : (m_dicr & ~DICR_MASTER_FLAG);
+    if (rising && m_bus) {
+        m_bus->getDevice<InterruptController>()->triggerIRQ(DeviceIRQ::DMA);
+    }
+}
+
+uint32_t DMA::executeDmaTransfer(uint8_t channel)
 {
     auto channelEnum = static_cast<DMAChannelName>(channel);
     switch (channelEnum)
     {
     case DMAChannelName::OTC:
-        executeDmaOT();
-        break;
+        return executeDmaBurst(channel);
     case DMAChannelName::GPU:
-        executeDmaGpu();
-        break;
+        return executeDmaGpu();
     default:
         spdlog::error("DMA: Unsupported transfer to channel {}", channel);
         break;
     }
+    return 0;
 }
 
-void DMA::executeDmaOT()
+PsxDevice *DMA::channelDevice(uint8_t channel)
 {
-    if (!m_bus) {
-        spdlog::error("DMA: No bus reference!");
-        return;
+    if (static_cast<DMAChannelName>(channel) == DMAChannelName::GPU) {
+        return m_bus->getDevice<GPU>();
     }
+    return nullptr;
+}
 
-    auto &channel = getChannel(DMAChannelName::OTC);
-    uint16_t transferSize = channel.blockControl().block.count;
-    uint32_t startAddr = channel.getRegister(DMAChannelReg::MemoryAddress) & OT_END_TAG;
+uint32_t *DMA::ramWords()
+{
+    return reinterpret_cast<uint32_t *>(m_bus->getDevice<RAM>()->data()->data());
+}
+
+// Lets the RAM watchers (compiled code, snapshots...) see words written by a transfer
+void DMA::notifyRamWrite(uint32_t firstWord, uint32_t count)
+{
+    RAM *ram = m_bus->getDevice<RAM>();
+    while (count > 0) {
+        uint32_t index = firstWord & RAM_WORD_MASK;
+        uint32_t run = std::min(count, RAM_WORD_MASK + 1 - index);
+        ram->notifyWrite(index << 2, run << 2);
+        firstWord += run;
+        count -= run;
+    }
+}
 
-    for (uint32_t i = transferSize - 1; i > 0; i--) {
-        m_bus->storeWord(startAddr, startAddr - 4);
-        startAddr -= 4;
+// Moves words between RAM and a device. Each contiguous part of RAM is
+// handed to the device as is, only decrementing transfers need a copy.
+// Returns the address following the last word.
+uint32_t DMA::transferBlock(PsxDevice *device, uint32_t address, uint32_t count, int step, DMATransferDirection direction)
+{
+    uint32_t *ram = ramWords();
+    bool toDevice = direction == DMATransferDirection::RamToDevice;
+
+    while (count > 0) {
+        uint32_t index = (address >> 2) & RAM_WORD_MASK;
+        uint32_t run;
+        if (step > 0) {
+            run = std::min(count, RAM_WORD_MASK + 1 - index);
+            if (toDevice) {
+                device->dmaWrite(ram + index, run);
+            } else {
+                device->dmaRead(ram + index, run);
+                notifyRamWrite(index, run);
+            }
+        } else {
+            uint32_t buffer[DMA_CHUNK_WORDS];
+            run = std::min({count, index + 1, static_cast<uint32_t>(DMA_CHUNK_WORDS)});
+            if (toDevice) {
+                for (uint32_t i = 0; i < run; i++) {
+                    buffer[i] = ram[index - i];
+                }
+                device->dmaWrite(buffer, run);
+            } else {
+                device->dmaRead(buffer, run);
+                for (uint32_t i = 0; i < run; i++) {
+                    ram[index - i] = buffer[i];
+                }
+                notifyRamWrite(index + 1 - run, run);
+            }
+        }
+        address += static_cast<uint32_t>(step) * run;
+        count -= run;
     }
+    return address;
+}
 
-    m_bus->storeWord(startAddr, OT_END_TAG);
-    channel.channelControl().transferStatus = DMATransferStatus::Stopped;
-    channel.channelControl().forceTransferStart = false;
+// Each entry points to the previous word, the last one of the transfer ends the list
+void DMA::writeOrderingTable(uint32_t address, uint32_t count, bool last)
+{
+    uint32_t *ram = ramWords();
+    uint32_t addr = address & OT_END_TAG;
+
+    for (uint32_t i = 0; i < count; i++) {
+        bool end = last && i + 1 == count;
+        ram[(addr >> 2) & RAM_WORD_MASK] = end ? OT_END_TAG : (addr - 4) & OT_END_TAG;
+        addr -= 4;
+    }
+    notifyRamWrite((addr + 4) >> 2, count);
 }
 
-void DMA::executeDmaGpu()
+// Moves consecutive words of a burst, returns the address following the last one
+uint32_t DMA::burstTransfer(uint8_t channel, uint32_t address, uint32_t count, bool last)
 {
-    if (!m_bus) {
-        spdlog::error("DMA: no bus reference");
-        return;
+    if (static_cast<DMAChannelName>(channel) == DMAChannelName::OTC) {
+        writeOrderingTable(address, count, last);
+        return (address - count * 4) & OT_END_TAG;
     }
+
+    PsxDevice *device = channelDevice(channel);
+    if (!device) {
+        spdlog::error("DMA: Unsupported burst transfer to channel {}", channel);
+        return address;
+    }
+    DMAChannelControl &chcr = m_channels[channel].channelControl();
+    int step = chcr.step == DMAStep::Increment ? 4 : -4;
+    return transferBlock(device, address, count, step, chcr.transferDir);
+}
+
+// Without chopping, MADR keeps the start address of the burst
+uint32_t DMA::executeDmaBurst(uint8_t channel)
+{
+    DMAChannel &dmaChannel = m_channels[channel];
+    // A count of 0 transfers the maximum of 0x10000 words
+    uint32_t count = dmaChannel.blockControl().block.count;
+    count = count ? count : 0x10000;
+
+    burstTransfer(channel, dmaChannel.getRegister(DMAChannelReg::MemoryAddress), count, true);
+    return count;
+}
+
+uint32_t DMA::executeDmaGpu()
+{
     auto syncMode = getChannel(DMAChannelName::GPU).channelControl().syncMode;
 
     switch (syncMode)
     {
+    case DMASyncMode::Burst:
+        return executeDmaBurst(static_cast<uint8_t>(DMAChannelName::GPU));
     case DMASyncMode::LinkedList:
-        executeDmaGpuLinkedList();
-        break;
+        return executeDmaGpuLinkedList();
     case DMASyncMode::Slice:
-        executeDmaGpuRequest();
-        break;
+        return executeDmaBlock(DMAChannelName::GPU, m_bus->getDevice<GPU>());
     default:
         spdlog::error("DMA: GPU SyncMode not supported yet {}", static_cast<uint8_t>(syncMode));
         break;
     }
+    return 0;
 }
 
-void DMA::executeDmaGpuLinkedList()
+uint32_t DMA::executeDmaGpuLinkedList()
 {
-    if (!m_bus) {
-        spdlog::error("DMA: no bus reference");
-        return;
-    }
-
     auto &channel = getChannel(DMAChannelName::GPU);
+    GPU *gpu = m_bus->getDevice<GPU>();
+    const uint32_t *ram = ramWords();
     uint32_t currentAddr = channel.getRegister(DMAChannelReg::MemoryAddress);
+    int step = channel.channelControl().step == DMAStep::Increment ? 4 : -4;
     bool transfer = true;
+    uint32_t words = 0;
 
+    // Each packet reaches the GPU in one piece, read in place from RAM
     while (transfer) {
-        uint32_t currentPacket = m_bus->loadWord(currentAddr);
+        uint32_t currentPacket = ram[(currentAddr >> 2) & RAM_WORD_MASK];
         uint8_t packetSize = currentPacket >> 24;
+        // The header is read like any other word
+        words += packetSize + 1;
 
-        for (uint8_t i = 0; i < packetSize; i++) {
-            currentAddr += channel.channelControl().step == DMAStep::Increment ? 4 : -4;
-            uint32_t command = m_bus->loadWord(currentAddr);
-            m_bus->storeWord(0x1F801810, command);
-            channel.setRegister(DMAChannelReg::MemoryAddress, currentAddr);
+        if (packetSize > 0) {
+            uint32_t end = transferBlock(gpu, currentAddr + step, packetSize, step, DMATransferDirection::RamToDevice);
+            channel.setRegister(DMAChannelReg::MemoryAddress, end - step);
         }
         currentAddr = currentPacket & 0xFFFFFF;
         if (currentAddr == OT_END_TAG) {
             transfer = false;
         }
     }
+    return words;
 }
 
 // Normally, the sent data is split into blocks and only sent once DREQ is received
 // but since I don't know what DREQ (Data REQuest obviously, but how and what it does)
 // I'm going to transfer everything at once I guess
-void DMA::executeDmaGpuRequest()
+uint32_t DMA::executeDmaBlock(DMAChannelName name, PsxDevice *device)
 {
-    if (!m_bus) {
-        spdlog::error("DMA: No bus reference!");
-        return;
-    }
-    auto &channel = getChannel(DMAChannelName::GPU);
+    auto &channel = getChannel(name);
     auto &blockControl = channel.blockControl();
     auto &channelControl = channel.channelControl();
 
     uint32_t transferSize = blockControl.block.size * blockControl.blockAmount;
     uint32_t startAddr = channel.getRegister(DMAChannelReg::MemoryAddress) & OT_END_TAG;
     int step = channelControl.step == DMAStep::Increment ? 4 : -4;
-    // uint32_t srcAddr = channelControl.transferDir == DMATransferDirection::RamToDevice ? GPU_GP0_ADDR : startAddr;
-
-    if (channelControl.transferDir == DMATransferDirection::RamToDevice) {
-        for (uint32_t i = 0; i < transferSize; i++) {
-            uint32_t word = m_bus->loadWord(startAddr);
-            m_bus->storeWord(GPU_GP0_ADDR, word);
-            startAddr += step;
-            channel.setRegister(DMAChannelReg::MemoryAddress, startAddr);
-        }
-    } else {
-        spdlog::error("DMA: GPU to RAM Request transfer mode not supported");
+
+    if (transferSize > 0) {
+        uint32_t end = transferBlock(device, startAddr, transferSize, step, channelControl.transferDir);
+        channel.setRegister(DMAChannelReg::MemoryAddress, end);
     }
-    channelControl.transferStatus = DMATransferStatus::Stopped;
-    channelControl.forceTransferStart = false;
+    return transferSize;
 }
@@ -12,6 +12,8 @@
 
 #include "DMAChannel.hpp"
 
+#include <array>
+
 class StateBuffer;
 
 #define OT_END_TAG 0xFFFFFF
@@ -46,6 +48,9 @@ class DMA : public PsxDevice
         uint16_t read16(uint32_t address) override;
         uint32_t read32(uint32_t address) override;
 
+        // Runs the chopped windows and completions that became due
+        void onEvent(SchedulerEvent event) override;
+
     private:
         DMAChannel &getChannel(DMAChannelName channel);
         const DMAChannel &getChannel(DMAChannelName channel) const;
@@ -53,16 +58,39 @@ class DMA : public PsxDevice
         void writeCommonRegisters(uint8_t reg, uint32_t value);
         uint32_t readCommonRegisters(uint8_t reg);
 
-        void executeDmaTransfer(uint8_t channel);
-        void executeDmaOT();
-        void executeDmaGpu();
-        void executeDmaGpuLinkedList();
-        void executeDmaGpuRequest();
+        // Transfers are timed in bus cycles, the CPU is stalled while the DMA owns the bus
+        void startTransfer(uint8_t channel);
+        void stopTransfer(uint8_t channel);
+        void runChopWindow(uint8_t channel);
+        void finishTransfer(uint8_t channel);
+        uint64_t occupyBus(uint32_t cycles);
+        void scheduleNextEvent();
+        uint32_t channelPriority(uint8_t channel) const;
+        void updateInterrupt();
+
+        // Each execute function moves the data and returns the words read or written
+        uint32_t executeDmaTransfer(uint8_t channel);
+        uint32_t executeDmaGpu();
+        uint32_t executeDmaGpuLinkedList();
+        uint32_t executeDmaBlock(DMAChannelName name, PsxDevice *device);
+        uint32_t executeDmaBurst(uint8_t channel);
+        uint32_t burstTransfer(uint8_t channel, uint32_t address, uint32_t count, bool last);
+        void writeOrderingTable(uint32_t address, uint32_t count, bool last);
+        PsxDevice *channelDevice(uint8_t channel);
+
+        // RAM accessed in place, word addresses wrap around its size
+        uint32_t *ramWords();
+        void notifyRamWrite(uint32_t firstWord, uint32_t count);
+        uint32_t transferBlock(PsxDevice *device, uint32_t address, uint32_t count, int step, DMATransferDirection direction);
 
     private:
         DMAChannel m_channels[7];
         uint32_t m_dpcr;
         uint32_t m_dicr;
+
+        std::array<uint64_t, 7> m_deadlines; // Next chopped window or completion of each channel
+        std::array<uint32_t, 7> m_chopWords; // Words left to a chopped transfer
+        uint64_t m_busyUntil;
 };
 
 #endif /* !DMA_HPP_ */
@@ -59,6 +59,7 @@ class DigitalPad
         void connect() { m_connected = true; }
         void disconnect() { m_connected = false; }
         void updateButtons(uint16_t buttons) { m_buttons = buttons; }
+        uint16_t getButtons() const { return m_buttons; }
 
     private:
         PadSequenceState m_state;
@@ -0,0 +1,133 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** EmulationThread
+*/
+
+#include "EmulationThread.hpp"
+
+#include <cstring>
+
+#include "System.hpp"
+
+EmulationThread::EmulationThread(System &system) :
+    m_system(system),
+    m_lockWaiters(0),
+    m_stopping(false),
+    m_speedMode(SpeedMode::Normal),
+    m_fastForwardSpeed(DEFAULT_FAST_FORWARD_SPEED),
+    m_displayRate(DEFAULT_DISPLAY_RATE),
+    m_padButtons(0xFFFF),
+    m_appliedButtons(0xFFFF),
+    m_frameCount(0)
+{
+}
+
+EmulationThread::~EmulationThread()
+{
+    stop();
+}
+
+void EmulationThread::start()
+{
+    if (m_thread.joinable()) {
+        return;
+    }
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_thread = std::thread(&EmulationThread::loop, this);
+}
+
+void EmulationThread::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_stopping.store(true, std::memory_order_relaxed);
+    m_thread.join();
+}
+
+std::unique_lock<std::mutex> EmulationThread::lock()
+{
+    m_lockWaiters.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_lockWaiters.fetch_sub(1, std::memory_order_relaxed);
+    return lock;
+}
+
+void EmulationThread::loop()
+{
+    m_pacer.reset();
+    m_lastPublish = FramePacer::Clock::time_point();
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        // std::mutex is not fair, uncapped frames would starve the UI
+        while (m_lockWaiters.load(std::memory_order_relaxed) > 0) {
+            std::this_thread::yield();
+        }
+        runFrame();
+        m_pacer.wait();
+    }
+}
+
+void EmulationThread::runFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SpeedMode mode = m_speedMode.load(std::memory_order_relaxed);
+    uint16_t buttons = m_padButtons.load(std::memory_order_relaxed);
+
+    if (buttons != m_appliedButtons) {
+        m_system.updatePadInputs(buttons);
+        m_appliedButtons = buttons;
+    }
+    m_pacer.setRate(m_system.getRefreshRate());
+    switch (mode) {
+        case SpeedMode::Normal:
+            m_pacer.setSpeed(1.0);
+            break;
+        case SpeedMode::FastForward:
+            m_pacer.setSpeed(m_fastForwardSpeed.load(std::memory_order_relaxed));
+            break;
+        case SpeedMode::Turbo:
+            m_pacer.setSpeed(0.0);
+            break;
+    }
+    if (m_system.getState() == SystemState::RUNNING) {
+        m_system.update();
+        m_frameCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Faster than real time, copying every frame would slow the machine down
+    auto now = FramePacer::Clock::now();
+    if (mode != SpeedMode::Normal) {
+        double displayRate = m_displayRate.load(std::memory_order_relaxed);
+        if (displayRate <= 0.0 || now - m_lastPublish < std::chrono::duration<double>(1.0 / displayRate)) {
+            return;
+        }
+    }
+    m_lastPublish = now;
+    publishFrame();
+}
+
+void EmulationThread::publishFrame()
+{
+    GPU *gpu = m_system.getBus()->getDevice<GPU>();
+    VideoFrame &frame = m_frames.back();
+    const VramDisplayArea &area = gpu->getDisplayArea();
+
+    std::memcpy(frame.vram, gpu->getVram(), GPU_VRAM_1MB_SIZE);
+    frame.displayX = area.halfwordAddress;
+    frame.displayY = area.scanlineAddress;
+    if (gpu->getGpuStat().hRes2) {
+        frame.displayWidth = 368;
+    } else {
+        switch (gpu->getHorizontalRes()) {
+            case HorizontalRes::RES_256: frame.displayWidth = 256; break;
+            case HorizontalRes::RES_320: frame.displayWidth = 320; break;
+            case HorizontalRes::RES_512: frame.displayWidth = 512; break;
+            case HorizontalRes::RES_640: frame.displayWidth = 640; break;
+        }
+    }
+    frame.displayHeight = gpu->getVerticalRes() == VerticalRes::RES_240 ? 240 : 480;
+    frame.number = m_frameCount.load(std::memory_order_relaxed);
+    m_frames.publish();
+}
@@ -0,0 +1,105 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** EmulationThread
+*/
+
+#ifndef EMULATIONTHREAD_HPP_
+#define EMULATIONTHREAD_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "FramePacer.hpp"
+#include "GPU.hpp"
+#include "TripleBuffer.hpp"
+
+class System;
+
+enum class SpeedMode : uint8_t
+{
+    Normal,      // Paced to the video mode refresh rate
+    FastForward, // Paced to a multiple of it
+    Turbo        // Uncapped
+};
+
+// A copy of the VRAM handed to the UI
+struct VideoFrame
+{
+    uint16_t vram[GPU_VRAM_HEIGHT][GPU_VRAM_WIDTH];
+    // Displayed rectangle, in VRAM pixels
+    uint16_t displayX;
+    uint16_t displayY;
+    uint16_t displayWidth;
+    uint16_t displayHeight;
+    uint64_t number;
+};
+
+// Runs a system on its own thread, one frame per pacer period, and hands
+// the VRAM to the UI through a triple buffer: a slow UI frame drops video
+// frames instead of slowing the emulated machine down. Faster than real
+// time, the frames handed over are throttled to the display rate.
+class EmulationThread
+{
+    public:
+        static constexpr double DEFAULT_FAST_FORWARD_SPEED = 3.0;
+        static constexpr double DEFAULT_DISPLAY_RATE = 60.0;
+
+        explicit EmulationThread(System &system);
+        ~EmulationThread();
+
+        EmulationThread(const EmulationThread &) = delete;
+        EmulationThread &operator=(const EmulationThread &) = delete;
+
+        void start();
+        void stop();
+        bool isRunning() const { return m_thread.joinable(); }
+
+        // Every other thread touching the system holds this lock. The
+        // emulation thread only releases it between frames, and lets waiting
+        // threads in before taking it back.
+        std::unique_lock<std::mutex> lock();
+
+        void setSpeedMode(SpeedMode mode) { m_speedMode.store(mode, std::memory_order_relaxed); }
+        SpeedMode getSpeedMode() const { return m_speedMode.load(std::memory_order_relaxed); }
+        void setFastForwardSpeed(double speed) { m_fastForwardSpeed.store(speed, std::memory_order_relaxed); }
+        double getFastForwardSpeed() const { return m_fastForwardSpeed.load(std::memory_order_relaxed); }
+        // Frames per second handed to the UI out of normal speed, 0 hands none
+        void setDisplayRate(double rate) { m_displayRate.store(rate, std::memory_order_relaxed); }
+        double getDisplayRate() const { return m_displayRate.load(std::memory_order_relaxed); }
+
+        // Pad 1 buttons, applied before the next frame
+        void setPadButtons(uint16_t buttons) { m_padButtons.store(buttons, std::memory_order_relaxed); }
+
+        // UI side: the newest frame, nullptr when none came since the last call
+        const VideoFrame *takeFrame() { return m_frames.acquire(); }
+        uint64_t getFrameCount() const { return m_frameCount.load(std::memory_order_relaxed); }
+
+    private:
+        void loop();
+        void runFrame();
+        void publishFrame();
+
+    private:
+        System &m_system;
+        std::mutex m_mutex;
+        std::atomic<uint32_t> m_lockWaiters;
+        std::atomic<bool> m_stopping;
+
+        std::atomic<SpeedMode> m_speedMode;
+        std::atomic<double> m_fastForwardSpeed;
+        std::atomic<double> m_displayRate;
+        std::atomic<uint16_t> m_padButtons;
+        uint16_t m_appliedButtons;
+
+        FramePacer m_pacer;
+        FramePacer::Clock::time_point m_lastPublish;
+        TripleBuffer<VideoFrame> m_frames;
+        std::atomic<uint64_t> m_frameCount;
+        std::thread m_thread;
+};
+
+#endif /* !EMULATIONTHREAD_HPP_ */
@@ -0,0 +1,74 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** ExecutableMemory
+*/
+
+#include "ExecutableMemory.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+ExecutableMemory::ExecutableMemory(size_t size) :
+    m_base(nullptr),
+    m_size(0),
+    m_used(0)
+{
+#ifdef _WIN32
+    void *mem = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+#else
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        mem = nullptr;
+    }
+#endif
+    if (!mem) {
+        spdlog::error("ExecutableMemory: Unable to allocate {} bytes of executable memory", size);
+        return;
+    }
+    m_base = static_cast<uint8_t *>(mem);
+    m_size = size;
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if (!m_base) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+    munmap(m_base, m_size);
+#endif
+}
+
+bool ExecutableMemory::isValid() const
+{
+    return m_base != nullptr;
+}
+
+uint8_t *ExecutableMemory::current() const
+{
+    return m_base + m_used;
+}
+
+size_t ExecutableMemory::remaining() const
+{
+    return m_size - m_used;
+}
+
+void ExecutableMemory::commit(size_t size)
+{
+    m_used += size;
+}
+
+void ExecutableMemory::reset()
+{
+    m_used = 0;
+}
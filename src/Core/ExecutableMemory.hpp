@@ -0,0 +1,38 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** ExecutableMemory
+*/
+
+#ifndef EXECUTABLEMEMORY_HPP_
+#define EXECUTABLEMEMORY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// Read/write/execute region handed out with a bump allocator. Code is only
+// released all at once with reset().
+class ExecutableMemory
+{
+    public:
+        ExecutableMemory(size_t size);
+        ~ExecutableMemory();
+
+        ExecutableMemory(const ExecutableMemory &) = delete;
+        ExecutableMemory &operator=(const ExecutableMemory &) = delete;
+
+        bool isValid() const;
+
+        uint8_t *current() const;
+        size_t remaining() const;
+        void commit(size_t size);
+        void reset();
+
+    private:
+        uint8_t *m_base;
+        size_t m_size;
+        size_t m_used;
+};
+
+#endif /* !EXECUTABLEMEMORY_HPP_ */
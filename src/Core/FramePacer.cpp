@@ -0,0 +1,104 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** FramePacer
+*/
+
+#include "FramePacer.hpp"
+
+#include <thread>
+
+// Longest OS sleep overshoot expected, the rest of the wait spins
+static constexpr auto SPIN_MARGIN = std::chrono::microseconds(1500);
+
+class HostTimer : public FramePacer::Timer
+{
+    public:
+        FramePacer::Clock::time_point now() override
+        {
+            return FramePacer::Clock::now();
+        }
+
+        void sleepUntil(FramePacer::Clock::time_point deadline) override
+        {
+            if (deadline - FramePacer::Clock::now() > SPIN_MARGIN) {
+                std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+            }
+            while (FramePacer::Clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+};
+
+FramePacer::Timer &FramePacer::hostTimer()
+{
+    static HostTimer timer;
+    return timer;
+}
+
+FramePacer::FramePacer(Timer &timer) :
+    m_timer(&timer),
+    m_rate(60.0),
+    m_speed(1.0),
+    m_period(0),
+    m_deadline(timer.now()),
+    m_resyncs(0)
+{
+    updatePeriod();
+}
+
+void FramePacer::setRate(double rate)
+{
+    if (rate > 0.0 && rate != m_rate) {
+        m_rate = rate;
+        updatePeriod();
+    }
+}
+
+void FramePacer::setSpeed(double speed)
+{
+    if (speed < 0.0) {
+        speed = 0.0;
+    }
+    if (speed != m_speed) {
+        // Coming back from uncapped, the deadline is far behind
+        if (m_speed == 0.0) {
+            reset();
+        }
+        m_speed = speed;
+        updatePeriod();
+    }
+}
+
+void FramePacer::updatePeriod()
+{
+    if (m_speed == 0.0) {
+        m_period = Clock::duration::zero();
+        return;
+    }
+    m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / (m_rate * m_speed)));
+}
+
+void FramePacer::reset()
+{
+    m_deadline = m_timer->now();
+}
+
+void FramePacer::wait()
+{
+    if (m_speed == 0.0) {
+        return;
+    }
+    m_deadline += m_period;
+
+    auto now = m_timer->now();
+    if (now - m_deadline > m_period * MAX_LAG_FRAMES) {
+        m_deadline = now;
+        m_resyncs++;
+        return;
+    }
+    if (now < m_deadline) {
+        m_timer->sleepUntil(m_deadline);
+    }
+}
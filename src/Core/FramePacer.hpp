@@ -0,0 +1,71 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** FramePacer
+*/
+
+#ifndef FRAMEPACER_HPP_
+#define FRAMEPACER_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+// Paces a loop to a frame rate on absolute deadlines, so a late frame is
+// made up by the next ones instead of shifting all of them. The thread
+// sleeps until shortly before the deadline then spins, OS sleeps overshoot
+// by up to a millisecond. When it falls too far behind, e.g. after a
+// breakpoint, it starts over from now rather than running a burst of frames.
+class FramePacer
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Source of the host time, tests drive a fake one
+        class Timer
+        {
+            public:
+                virtual ~Timer() = default;
+
+                virtual Clock::time_point now() = 0;
+                // Returns at the deadline or as soon as possible after it
+                virtual void sleepUntil(Clock::time_point deadline) = 0;
+        };
+
+        // Deadlines missed by more than this many frames are given up
+        static constexpr uint32_t MAX_LAG_FRAMES = 4;
+
+        // The timer must outlive the pacer
+        explicit FramePacer(Timer &timer = hostTimer());
+
+        // Sleeps on the steady clock, then spins for the OS sleep overshoot
+        static Timer &hostTimer();
+
+        // Frames per second at normal speed
+        void setRate(double rate);
+        double getRate() const { return m_rate; }
+        // Multiplies the rate, 0 uncaps it
+        void setSpeed(double speed);
+        double getSpeed() const { return m_speed; }
+        Clock::duration getPeriod() const { return m_period; }
+
+        // Starts the next frame deadline from now
+        void reset();
+        // Blocks until the end of the current frame
+        void wait();
+        // Number of times the pacer fell behind and started over
+        uint64_t getResyncs() const { return m_resyncs; }
+
+    private:
+        void updatePeriod();
+
+    private:
+        Timer *m_timer;
+        double m_rate;
+        double m_speed;
+        Clock::duration m_period;
+        Clock::time_point m_deadline;
+        uint64_t m_resyncs;
+};
+
+#endif /* !FRAMEPACER_HPP_ */
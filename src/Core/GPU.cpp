@@ -4,12 +4,23 @@
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "Bus.hpp"
+#include "Log.hpp"
+#include "GPUSpan.hpp"
 #include "InterruptController.hpp"
+#include "ThreadPool.hpp"
+
+// Commands queued before the draw list is flushed anyway
+static constexpr size_t DRAW_LIST_CAPACITY = 1024;
+static constexpr size_t MAX_RENDER_THREADS = 32;
 
 GPU::GPU(Bus *bus) :
-    PsxDevice(bus)
+    PsxDevice(bus),
+    m_fieldCount(0),
+    m_renderThreads(1),
+    m_texturedSpan(getTexturedSpanKernel())
 {
     m_memoryRange = MemoryMap::GPU_REGISTERS_RANGE;
     reset();
@@ -19,29 +30,69 @@ GPU::~GPU()
 {
 }
 
-static constexpr float NTSC_CLOCK_MULTIPLIER = 11.0f/7.0f;
-static constexpr uint32_t NTSC_VRES_HEIGHT = 240;
+// The GPU clock runs at about 11/7 of the CPU clock in both video modes,
+// scanline timing is counted in sevenths of GPU cycles
+static constexpr uint32_t GPU_CLOCK_NUMERATOR = 11;
+static constexpr uint32_t GPU_CLOCK_DENOMINATOR = 7;
 static constexpr uint32_t NTSC_SCANLINES = 263;
 static constexpr uint32_t NTSC_HCYCLES = 3413;
+static constexpr uint32_t PAL_SCANLINES = 314;
+static constexpr uint32_t PAL_HCYCLES = 3406;
+
+uint32_t GPU::scanlineCount() const
+{
+    return m_gpuStat.videoMode == VideoMode::PAL ? PAL_SCANLINES : NTSC_SCANLINES;
+}
+
+uint32_t GPU::scanlineUnits() const
+{
+    return (m_gpuStat.videoMode == VideoMode::PAL ? PAL_HCYCLES : NTSC_HCYCLES) * GPU_CLOCK_DENOMINATOR;
+}
+
+double GPU::getFieldCycles() const
+{
+    return static_cast<double>(scanlineCount()) * scanlineUnits() / GPU_CLOCK_NUMERATOR;
+}
 
 void GPU::update(int cycles)
 {
-    m_cycleCount += cycles * NTSC_CLOCK_MULTIPLIER;
-    if (m_cycleCount >= NTSC_HCYCLES) {
-        m_cycleCount = 0.0f;
-        if (m_gpuStat.vInterlace || m_gpuStat.interlaceField) {
+    uint32_t scanlines = scanlineCount();
+    uint32_t lineUnits = scanlineUnits();
+    uint64_t units = m_cycleCount + static_cast<uint64_t>(cycles) * GPU_CLOCK_NUMERATOR;
+    auto lines = units / lineUnits;
+    m_cycleCount = static_cast<uint32_t>(units % lineUnits);
+
+    while (lines > 0) {
+        uint32_t step = static_cast<uint32_t>(std::min<uint64_t>(lines, scanlines - m_scanline));
+        if ((m_gpuStat.vInterlace || m_gpuStat.interlaceField) && (step & 1)) {
             m_gpuStat.interlaceDrawLines = !m_gpuStat.interlaceDrawLines;
         }
-        m_scanline++;
-        if (m_scanline >= NTSC_SCANLINES) {
+        m_scanline += step;
+        lines -= step;
+        if (m_scanline >= scanlines) {
             m_scanline = 0;
             m_gpuStat.interlaceDrawLines = false;
+            m_fieldCount++;
             auto irqc = m_bus->getDevice<InterruptController>();
             irqc->triggerIRQ(DeviceIRQ::VBLANK);
         }
     }
 }
 
+void GPU::onEvent(SchedulerEvent /* event */)
+{
+    // The frame is complete at VBlank
+    flushDrawing();
+    catchUp();
+    scheduleVBlank();
+}
+
+void GPU::scheduleVBlank()
+{
+    uint64_t units = static_cast<uint64_t>(scanlineCount() - m_scanline) * scanlineUnits() - m_cycleCount;
+    schedule(SchedulerEvent::GpuVBlank, (units + GPU_CLOCK_NUMERATOR - 1) / GPU_CLOCK_NUMERATOR);
+}
+
 void GPU::reset()
 {
     // m_statRegister = 0x1C000000;
@@ -55,16 +106,24 @@ void GPU::reset()
     m_gpuStat.interlaceField = true;
     m_gpuStat.rdSendVram = true;
 
-    m_vram.fill(0);
+    m_drawList.clear();
+    m_drawReadLines.reset();
+    m_drawWriteLines.reset();
+    std::memset(m_vram, 0, sizeof(m_vram));
+    m_vramDirty.fill(0xFF);
     m_gpuRead = 0;
     m_currentState = GpuState::WaitingForCommand;
     m_currentCmd.reset();
-    m_cycleCount = 0.0f;
+    m_cycleCount = 0;
     m_scanline = 0;
+    m_lastUpdate = currentTime();
+    scheduleVBlank();
 }
 
 void GPU::serialize(StateBuffer &buf) const
 {
+    // Flushing only moves queued draws to VRAM, the emulated state is unchanged
+    const_cast<GPU *>(this)->flushDrawing();
     buf.write(m_gpuStat);
     buf.write(m_gpuRead);
     buf.write(m_displayArea);
@@ -79,11 +138,17 @@ void GPU::serialize(StateBuffer &buf) const
     buf.write(m_vramCopyData);
     buf.write(m_cycleCount);
     buf.write(m_scanline);
-    buf.write(m_vram.data(), m_vram.size());
+    buf.write(m_lastUpdate);
+    if (!buf.isSnapshot()) {
+        buf.write(m_vram, sizeof(m_vram));
+    }
 }
 
 void GPU::deserialize(StateBuffer &buf)
 {
+    m_drawList.clear();
+    m_drawReadLines.reset();
+    m_drawWriteLines.reset();
     buf.read(m_gpuStat);
     buf.read(m_gpuRead);
     buf.read(m_displayArea);
@@ -98,7 +163,11 @@ void GPU::deserialize(StateBuffer &buf)
     buf.read(m_vramCopyData);
     buf.read(m_cycleCount);
     buf.read(m_scanline);
-    buf.read(m_vram.data(), m_vram.size());
+    buf.read(m_lastUpdate);
+    if (!buf.isSnapshot()) {
+        buf.read(m_vram, sizeof(m_vram));
+        m_vramDirty.fill(0xFF);
+    }
 }
 
 void GPU::write8(uint8_t /* value */, uint32_t /* address */)
@@ -113,13 +182,15 @@ void GPU::write16(uint16_t /* value */, uint32_t /* address */)
 
 void GPU::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("GPU: Write 0x{:08X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::Gpu, "GPU: Write 0x{:08X} to 0x{:08X}", value, address);
     switch (address)
     {
     case 0x1F801810:
         processGP0(value);
         break;
     case 0x1F801814:
+        // Display mode changes only apply to the scanlines after this write
+        catchUp();
         processGP1(value);
         break;
     default:
@@ -146,17 +217,96 @@ uint32_t GPU::read32(uint32_t address)
     uint32_t result = 0;
 
     if (address == 0x1F801814) {
+        // The interlace bit depends on the current scanline
+        catchUp();
         result = gpuStat();
     } else if (address == 0x1F801810) {
+        flushDrawing();
         result = m_gpuRead;
     }
-    spdlog::trace("GPU: Read from 0x{:08X} = 0x{:08X}", address, result);
+    ROGEM_TRACE(LogSubsystem::Gpu, "GPU: Read from 0x{:08X} = 0x{:08X}", address, result);
     return result;
 }
 
+void GPU::dmaWrite(const uint32_t *words, size_t count)
+{
+    submitWords(words, count);
+}
+
+void GPU::dmaRead(uint32_t *words, size_t count)
+{
+    flushDrawing();
+    std::fill_n(words, count, m_gpuRead);
+}
+
 uint8_t *GPU::getVram()
 {
-    return m_vram.data();
+    flushDrawing();
+    return reinterpret_cast<uint8_t *>(m_vram);
+}
+
+uint8_t *GPU::getVramDirtyFlags()
+{
+    flushDrawing();
+    return m_vramDirty.data();
+}
+
+void GPU::setRenderThreads(size_t threads)
+{
+    flushDrawing();
+    m_renderThreads = std::clamp<size_t>(threads, 1, MAX_RENDER_THREADS);
+    m_renderPool.reset();
+    if (m_renderThreads > 1) {
+        m_renderPool = std::make_unique<ThreadPool>(m_renderThreads);
+        m_drawList.reserve(DRAW_LIST_CAPACITY);
+    }
+}
+
+static PerfPrimitive perfPrimitive(DrawType type)
+{
+    switch (type) {
+        case DrawType::Polygon:
+            return PerfPrimitive::Polygon;
+        case DrawType::Rectangle:
+            return PerfPrimitive::Rectangle;
+        case DrawType::Line:
+            return PerfPrimitive::Line;
+        case DrawType::Fill:
+            return PerfPrimitive::Fill;
+    }
+    return PerfPrimitive::Other;
+}
+
+void GPU::flushDrawing()
+{
+    if (m_drawList.empty()) {
+        return;
+    }
+    PerfScope scope(perfCounters(), PerfTimer::Gpu);
+    // Bands hold an even number of lines so threads never share a dirty page flag,
+    // there are at most as many bands as threads
+    int bandHeight = static_cast<int>((GPU_VRAM_HEIGHT + m_renderThreads - 1) / m_renderThreads + 1) & ~1;
+    std::array<std::array<uint64_t, PERF_PRIMITIVE_COUNT>, MAX_RENDER_THREADS> bandPixels{};
+    for (int top = 0; top < GPU_VRAM_HEIGHT; top += bandHeight) {
+        DrawBand band{top, std::min(top + bandHeight, GPU_VRAM_HEIGHT)};
+        auto &pixels = bandPixels[top / bandHeight];
+        m_renderPool->submit([this, band, &pixels] {
+            for (const auto &cmd : m_drawList) {
+                pixels[static_cast<size_t>(perfPrimitive(cmd.type))] += executeDraw(cmd, band);
+            }
+        });
+    }
+    m_renderPool->wait();
+    if (auto perf = perfCounters()) {
+        for (const auto &pixels : bandPixels) {
+            for (size_t i = 0; i < PERF_PRIMITIVE_COUNT; i++) {
+                perf->frame().pixels[i] += pixels[i];
+            }
+        }
+    }
+    m_drawList.clear();
+    m_drawReadLines.reset();
+    m_drawWriteLines.reset();
 }
 
 uint32_t GPU::gpuStat() const
@@ -189,12 +339,20 @@ uint32_t GPU::gpuStat() const
 
 void GPU::setDisplayMode(uint8_t modeBits)
 {
+    VideoMode previousMode = m_gpuStat.videoMode;
+
     m_gpuStat.hRes1 = static_cast<HorizontalRes>(modeBits & 3);
     m_gpuStat.vRes = static_cast<VerticalRes>((modeBits >> 2) & 1);
     m_gpuStat.videoMode = static_cast<VideoMode>((modeBits >> 3) & 1);
     m_gpuStat.colorDepth = static_cast<ColorDepth>((modeBits >> 4) & 1);
     m_gpuStat.vInterlace = (modeBits >> 5) & 1;
     m_gpuStat.hRes2 = (modeBits >> 6) & 1;
+    if (m_gpuStat.videoMode != previousMode) {
+        // The field continues with the new scanline timing
+        m_scanline = std::min(m_scanline, scanlineCount() - 1);
+        m_cycleCount = std::min(m_cycleCount, scanlineUnits() - 1);
+        scheduleVBlank();
+    }
     // GPUSTAT flip screen horizontally ???
     // I don't know which version between v1 and v2 to use here
     // I use v2 so no screen flip :)
@@ -262,6 +420,7 @@ void GPU::processGP0(uint32_t data)
             executeMiscCommand(data);
             break;
         case 0b111:
+            countCommand(PerfPrimitive::Other);
             executeEnvCommand(data);
             break;
         case 0b001: // Draw Polygon
@@ -382,9 +541,11 @@ void GPU::executeMiscCommand(uint32_t cmd)
     switch (cmd >> 24) {
         case 0x00:
             // NOP
+            countCommand(PerfPrimitive::Other);
             break;
         case 0x01:
             // Clear Cache
+            countCommand(PerfPrimitive::Other);
             break;
         case 0x02:
             m_currentCmd.set(cmd);
@@ -414,14 +575,133 @@ static Vec2i getVec(uint32_t param)
     return vec;
 }
 
+// Polygon vertices and the drawing offset are signed 11-bit values
+static int signExtend11(int value)
+{
+    return static_cast<int16_t>(value << 5) >> 5;
+}
+
+static void markLines(std::bitset<GPU_VRAM_HEIGHT> &lines, int first, int count)
+{
+    if (count >= GPU_VRAM_HEIGHT) {
+        lines.set();
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        lines.set((first + i) & (GPU_VRAM_HEIGHT - 1));
+    }
+}
+
+// VRAM lines a draw command may read through texturing and write
+static void drawCommandLines(const DrawCommand &cmd, std::bitset<GPU_VRAM_HEIGHT> &reads, std::bitset<GPU_VRAM_HEIGHT> &writes)
+{
+    switch (cmd.type) {
+        case DrawType::Polygon: {
+            int minY = cmd.verts[0].pos.y;
+            int maxY = cmd.verts[0].pos.y;
+            for (int i = 1; i < cmd.flags.nbVertices; i++) {
+                minY = std::min(minY, cmd.verts[i].pos.y);
+                maxY = std::max(maxY, cmd.verts[i].pos.y);
+            }
+            minY = std::max(0, minY);
+            maxY = std::min(GPU_VRAM_HEIGHT - 1, maxY);
+            if (minY <= maxY) {
+                markLines(writes, minY, maxY - minY + 1);
+            }
+            break;
+        }
+        case DrawType::Line: {
+            int minY = std::min(cmd.verts[0].pos.y, cmd.verts[1].pos.y);
+            int maxY = std::max(cmd.verts[0].pos.y, cmd.verts[1].pos.y);
+            markLines(writes, minY, maxY - minY + 1);
+            break;
+        }
+        case DrawType::Rectangle:
+        case DrawType::Fill:
+            markLines(writes, cmd.verts[0].pos.y, cmd.size.y);
+            break;
+    }
+    if (cmd.type != DrawType::Fill && cmd.flags.textured) {
+        markLines(reads, cmd.texInfo.texPageY * 256, 256);
+        if (cmd.texInfo.colorMode == TexturePageColors::COL_4Bit ||
+            cmd.texInfo.colorMode == TexturePageColors::COL_8Bit) {
+            reads.set(cmd.texInfo.clutY & (GPU_VRAM_HEIGHT - 1));
+        }
+    }
+}
+
+void GPU::submitDraw(const DrawCommand &cmd)
+{
+    if (!m_renderPool) {
+        countPixels(cmd.type, executeDraw(cmd, DrawBand{0, GPU_VRAM_HEIGHT}));
+        return;
+    }
+
+    std::bitset<GPU_VRAM_HEIGHT> reads;
+    std::bitset<GPU_VRAM_HEIGHT> writes;
+    drawCommandLines(cmd, reads, writes);
+    // A command sampling lines it also draws depends on the raster order,
+    // it runs alone on this thread
+    if ((reads & writes).any()) {
+        flushDrawing();
+        countPixels(cmd.type, executeDraw(cmd, DrawBand{0, GPU_VRAM_HEIGHT}));
+        return;
+    }
+    // Another band may still have to read or write the lines this command
+    // depends on, the queued commands have to finish first
+    if ((reads & m_drawWriteLines).any() || (writes & m_drawReadLines).any() ||
+        m_drawList.size() >= DRAW_LIST_CAPACITY) {
+        flushDrawing();
+    }
+    m_drawList.push_back(cmd);
+    m_drawReadLines |= reads;
+    m_drawWriteLines |= writes;
+}
+
+uint32_t GPU::executeDraw(const DrawCommand &cmd, const DrawBand &band)
+{
+    switch (cmd.type) {
+        case DrawType::Polygon: {
+            uint32_t pixels = rasterizePoly3(cmd.verts, cmd, band);
+            if (cmd.flags.nbVertices == 4) {
+                pixels += rasterizePoly3(cmd.verts + 1, cmd, band);
+            }
+            return pixels;
+        }
+        case DrawType::Rectangle:
+            return rasterizeRectangle(cmd, band);
+        case DrawType::Line:
+            return rasterizeLine(cmd.verts[0], cmd.verts[1], band);
+        case DrawType::Fill:
+            return rasterizeFill(cmd, band);
+    }
+    return 0;
+}
+
+void GPU::countPixels(DrawType type, uint64_t pixels)
+{
+    if (auto perf = perfCounters()) {
+        perf->frame().pixels[static_cast<size_t>(perfPrimitive(type))] += pixels;
+    }
+}
+
+void GPU::countCommand(PerfPrimitive kind)
+{
+    if (auto perf = perfCounters()) {
+        perf->frame().gp0Commands[static_cast<size_t>(kind)]++;
+    }
+}
+
 void GPU::drawPolygon()
 {
     auto &flags = m_currentCmd.flags();
     auto &params = m_currentCmd.params();
-    ColorRGBA firstColor;
-    firstColor.fromBGR(params.data()[0]);
-    Vertex verts[4];
-    TextureInfo texInfo;
+    DrawCommand cmd{};
+    cmd.type = DrawType::Polygon;
+    cmd.flags = flags;
+    cmd.color.fromBGR(params.data()[0]);
+    Vertex *verts = cmd.verts;
+    TextureInfo &texInfo = cmd.texInfo;
 
     int step = 1 + flags.shaded + flags.textured;
     for (int i = 0; i < flags.nbVertices; i++) {
@@ -433,9 +713,9 @@ void GPU::drawPolygon()
         }
 
         // Parse position
-        verts[i].pos = getVec(params.data()[paramIndex + 1]);
-        verts[i].pos.x += m_drawOffset.x;
-        verts[i].pos.y += m_drawOffset.y;
+        Vec2i pos = getVec(params.data()[paramIndex + 1]);
+        verts[i].pos.x = signExtend11(pos.x) + signExtend11(m_drawOffset.x);
+        verts[i].pos.y = signExtend11(pos.y) + signExtend11(m_drawOffset.y);
 
         // Parse texture coordinates (if textured)
         if (flags.textured) {
@@ -462,11 +742,7 @@ void GPU::drawPolygon()
         }
     }
 
-    if (flags.nbVertices == 4) {
-        rasterizePoly4(verts, firstColor, texInfo);
-    } else {
-        rasterizePoly3(verts, firstColor, texInfo);
-    }
+    submitDraw(cmd);
     m_currentCmd.reset();
     m_currentState = GpuState::WaitingForCommand;
 }
@@ -475,14 +751,18 @@ void GPU::drawRectangle()
 {
     auto &flags = m_currentCmd.flags();
     auto &params = m_currentCmd.params();
+    DrawCommand cmd{};
+    cmd.type = DrawType::Rectangle;
+    cmd.flags = flags;
     ColorRGBA color;
     color.fromBGR(params.data()[0]);
-    Vec2i size{};
+    Vec2i &size = cmd.size;
     Vec2i topLeft = getVec(params.data()[1]);
-    TextureInfo texInfo{};
+    TextureInfo &texInfo = cmd.texInfo;
     topLeft.x += m_drawOffset.x;
     topLeft.y += m_drawOffset.y;
-    Vertex vert{topLeft, color, 0, 0};
+    Vertex &vert = cmd.verts[0];
+    vert = Vertex{topLeft, color, 0, 0};
 
     if (flags.textured) {
         uint32_t texData = params.data()[2];
@@ -504,7 +784,7 @@ void GPU::drawRectangle()
         size = getVec(params.data()[2 + flags.textured]);
     }
 
-    rasterizeRectangle(vert, size, texInfo);
+    submitDraw(cmd);
     m_currentCmd.reset();
     m_currentState = GpuState::WaitingForCommand;
 }
@@ -512,7 +792,11 @@ void GPU::drawRectangle()
 void GPU::drawLine() {
     auto &params = m_currentCmd.params();
     auto &flags = m_currentCmd.flags();
-    Vertex v0, v1;
+    DrawCommand cmd{};
+    cmd.type = DrawType::Line;
+    cmd.flags = flags;
+    Vertex &v0 = cmd.verts[0];
+    Vertex &v1 = cmd.verts[1];
     int step = 1 + flags.shaded;
 
     v0.color.fromBGR(params.data()[0]);
@@ -522,7 +806,7 @@ void GPU::drawLine() {
         v1.color.fromBGR(params.data()[2]);
     else
         v1.color.fromBGR(params.data()[0]);
-    rasterizeLine(v0, v1);
+    submitDraw(cmd);
     if (flags.polyline) {
         int iteration = params.size() - 1;
         int numSegments = (iteration - (3 + flags.shaded)) / step;
@@ -533,7 +817,7 @@ void GPU::drawLine() {
             else
                 v1.color.fromBGR(params.data()[0]);
             v1.pos = getVec(params.data()[(3 + flags.shaded) + step * i + flags.shaded]);
-            rasterizeLine(v0, v1);
+            submitDraw(cmd);
         }
     }
     m_currentCmd.reset();
@@ -543,6 +827,8 @@ void GPU::drawLine() {
 void GPU::startCpuToVramCopy()
 {
     auto &params = m_currentCmd.params();
+    // The data words are written straight to VRAM, after the queued draws
+    flushDrawing();
     m_currentState = GpuState::ReceivingDataWords;
     m_vramCopyData.startPos = Vec2i{(int)(params.data()[0] & 0x3FF), (int)((params.data()[0] >> 16) & 0x1FF)};
     m_vramCopyData.size = Vec2i{(int)((params.data()[1] - 1) & 0x3FF) + 1, (int)(((params.data()[1] >> 16) - 1) & 0x1FF)};
@@ -552,38 +838,39 @@ void GPU::startCpuToVramCopy()
 void GPU::quickRectFill()
 {
     auto &params = m_currentCmd.params();
-    Vec2i topLeft{(int)(params.data()[1] & 0xFFFF), (int)(params.data()[1] >> 16)};
-    Vec2i size{(int)(params.data()[2] & 0xFFFF), (int)(params.data()[2] >> 16)};
-    ColorRGBA color;
-    color.fromBGR(params.data()[0]);
-    uint16_t abgr = color.toABGR1555();
-
-    for (int y = 0; y < size.y; y++) {
-        for (int x = 0; x < size.x; x++) {
-            for (int pix = 0; pix < 16; pix++) {
-                Vec2i pos{topLeft.x + x, topLeft.y + y};
-                setPixel(pos, abgr);
-            }
-        }
-    }
+    DrawCommand cmd{};
+    cmd.type = DrawType::Fill;
+    // The GPU fills whole 16 pixel blocks, the sizes wrap like its counters
+    cmd.verts[0].pos = Vec2i{(int)(params.data()[1] & 0x3F0), (int)((params.data()[1] >> 16) & 0x1FF)};
+    cmd.size = Vec2i{(int)(((params.data()[2] & 0x3FF) + 0xF) & ~0xF), (int)((params.data()[2] >> 16) & 0x1FF)};
+    cmd.color.fromBGR(params.data()[0]);
+
+    submitDraw(cmd);
     m_currentState = GpuState::WaitingForCommand;
     m_currentCmd.reset();
 }
 
 void GPU::startVramToVramCopy()
 {
-    // The transfer should be affected by the Mask Bit setting
     auto &params = m_currentCmd.params();
-    Vec2i sourceCoord{(int)(params.data()[0] & 0xFFFF), (int)(params.data()[0] >> 16)};
-    Vec2i destCoord{(int)(params.data()[1] & 0xFFFF), (int)(params.data()[1] >> 16)};
-    Vec2i size{(int)(params.data()[2] & 0xFFFF), (int)(params.data()[2] >> 16)};
+    flushDrawing();
+    Vec2i sourceCoord{(int)(params.data()[0] & 0x3FF), (int)((params.data()[0] >> 16) & 0x1FF)};
+    Vec2i destCoord{(int)(params.data()[1] & 0x3FF), (int)((params.data()[1] >> 16) & 0x1FF)};
+    // Sizes wrap like on the hardware, 0 copies the whole width or height
+    Vec2i size{(int)((params.data()[2] - 1) & 0x3FF) + 1, (int)(((params.data()[2] >> 16) - 1) & 0x1FF) + 1};
+    // Rows are copied top to bottom, each one as a whole even when the source
+    // and destination overlap
+    uint16_t rowPixels[GPU_VRAM_WIDTH];
     for (int y = 0; y < size.y; y++) {
-        for (int x = 0; x < size.x; x++) {
-            Vec2i currSourceCoord{sourceCoord.x + x, sourceCoord.y + y};
-            Vec2i currDestCoord{destCoord.x + x, destCoord.y + y};
-            uint16_t color = getPixel(currSourceCoord);
-            setPixel(currDestCoord, color);
+        const uint16_t *source = m_vram[(sourceCoord.y + y) & (GPU_VRAM_HEIGHT - 1)];
+        int destLine = (destCoord.y + y) & (GPU_VRAM_HEIGHT - 1);
+        for (int i = 0; i < size.x;) {
+            int column = (sourceCoord.x + i) & (GPU_VRAM_WIDTH - 1);
+            int part = std::min(size.x - i, GPU_VRAM_WIDTH - column);
+            std::memcpy(rowPixels + i, source + column, part * sizeof(uint16_t));
+            i += part;
         }
+        writeRow(destCoord.x, destLine, rowPixels, size.x);
     }
     m_currentState = GpuState::WaitingForCommand;
     m_currentCmd.reset();
@@ -594,74 +881,146 @@ void GPU::receiveParameter(uint32_t param)
     m_currentCmd.addParam(param);
 
     if (m_currentCmd.expectedParams() == -1 && (param & 0xF000F000) == 0x50005000) {
+        PerfScope scope(perfCounters(), PerfTimer::Gpu);
+        countCommand(PerfPrimitive::Line);
         drawLine();
     }
 
     if (m_currentCmd.params().size() == m_currentCmd.expectedParams()) {
-        switch (m_currentCmd.type()) {
-            case GPUCommandType::DrawPolygon:
-                drawPolygon();
-                break;
-            case GPUCommandType::DrawRectangle:
-                drawRectangle();
-                break;
-            case GPUCommandType::DrawLine:
-                drawLine();
-                break;
-            case GPUCommandType::QuickRectFill:
-                quickRectFill();
-                break;
-            case GPUCommandType::CpuVramCopy:
-                startCpuToVramCopy();
-                break;
-            case GPUCommandType::VramVramCopy:
-                startVramToVramCopy();
-                break;
-            default:
-                break;
-        }
+        executeCommand();
+    }
+}
+
+void GPU::executeCommand()
+{
+    PerfScope scope(perfCounters(), PerfTimer::Gpu);
+
+    switch (m_currentCmd.type()) {
+        case GPUCommandType::DrawPolygon:
+            countCommand(PerfPrimitive::Polygon);
+            drawPolygon();
+            break;
+        case GPUCommandType::DrawRectangle:
+            countCommand(PerfPrimitive::Rectangle);
+            drawRectangle();
+            break;
+        case GPUCommandType::DrawLine:
+            countCommand(PerfPrimitive::Line);
+            drawLine();
+            break;
+        case GPUCommandType::QuickRectFill:
+            countCommand(PerfPrimitive::Fill);
+            quickRectFill();
+            break;
+        case GPUCommandType::CpuVramCopy:
+            countCommand(PerfPrimitive::Transfer);
+            startCpuToVramCopy();
+            break;
+        case GPUCommandType::VramVramCopy:
+            countCommand(PerfPrimitive::Transfer);
+            startVramToVramCopy();
+            break;
+        default:
+            break;
     }
 }
 
 void GPU::receiveDataWord(uint32_t data)
 {
-    for (int i = 0; i < 2; i++) {
-        uint16_t pix = ((data >> (16 * i)) & 0xFFFF);
-        Vec2i pos{
-            m_vramCopyData.currentPos.x + m_vramCopyData.startPos.x,
-            m_vramCopyData.currentPos.y + m_vramCopyData.startPos.y
-        };
-        setPixel(pos, pix);
-        m_vramCopyData.currentPos.x++;
-        if (m_vramCopyData.currentPos.x >= m_vramCopyData.size.x) {
-            m_vramCopyData.currentPos.x = 0;
-            m_vramCopyData.currentPos.y++;
+    uint16_t pixels[2] = {static_cast<uint16_t>(data & 0xFFFF), static_cast<uint16_t>(data >> 16)};
+    uploadPixels(pixels, 2);
+}
+
+// Returns the number of words used by the current CPU to VRAM copy
+size_t GPU::receiveDataWords(const uint32_t *words, size_t count)
+{
+    PerfScope scope(perfCounters(), PerfTimer::Gpu);
+    const VramCopyData &copy = m_vramCopyData;
+    int64_t pixelsLeft = static_cast<int64_t>(copy.size.y + 1 - copy.currentPos.y) * copy.size.x - copy.currentPos.x;
+    size_t used = std::min<size_t>(count, static_cast<size_t>(std::max<int64_t>(1, (pixelsLeft + 1) / 2)));
+    // Each word holds two pixels, low halfword first, which is already their layout in host memory
+    uploadPixels(reinterpret_cast<const uint16_t *>(words), static_cast<int>(used * 2));
+    return used;
+}
+
+void GPU::submitWords(const uint32_t *words, size_t count)
+{
+    while (count > 0) {
+        if (m_currentState == GpuState::ReceivingDataWords) {
+            size_t used = receiveDataWords(words, count);
+            words += used;
+            count -= used;
+            continue;
         }
-        if (m_vramCopyData.currentPos.y >  m_vramCopyData.size.y) {
-            m_currentState = GpuState::WaitingForCommand;
-            m_currentCmd.reset();
-            return;
+
+        uint32_t cmd = *words;
+        uint8_t top = cmd >> 29;
+        bool packet = (top >= 0b001 && top <= 0b101) || (cmd >> 24) == 0x02;
+        if (m_currentState == GpuState::WaitingForCommand && packet) {
+            m_currentCmd.set(cmd);
+            m_currentState = GpuState::ReceivingParameters;
+            words++;
+            count--;
+            // Polylines and packets cut by the end of the words go through processGP0
+            int missing = m_currentCmd.expectedParams() - m_currentCmd.params().size();
+            if (missing >= 0 && static_cast<size_t>(missing) <= count) {
+                m_currentCmd.addParams(words, missing);
+                words += missing;
+                count -= missing;
+                executeCommand();
+            }
+            continue;
         }
+        processGP0(cmd);
+        words++;
+        count--;
     }
 }
 
-static int edgeFunction(const Vec2i& a, const Vec2i& b, const Vec2i& c)
+// Fixed point precision of the edge walking and attribute interpolation
+static constexpr int RASTER_FRAC_BITS = 16;
+static constexpr int64_t RASTER_ONE = int64_t(1) << RASTER_FRAC_BITS;
+static constexpr int64_t RASTER_HALF = RASTER_ONE / 2;
+
+// Per pixel and per line steps of an attribute interpolated over a triangle
+struct RasterGradient
 {
-    return (c.x - a.x) * (b.y - a.y) - (c.y - a.y) * (b.x - a.x);
+    int64_t dx;
+    int64_t dy;
+
+    RasterGradient(int a0, int a1, int a2, const Vec2i &d1, const Vec2i &d2, int64_t area)
+    {
+        dx = (((static_cast<int64_t>(a1 - a0) * d2.y) - (static_cast<int64_t>(a2 - a0) * d1.y)) << RASTER_FRAC_BITS) / area;
+        dy = (((static_cast<int64_t>(a2 - a0) * d1.x) - (static_cast<int64_t>(a1 - a0) * d2.x)) << RASTER_FRAC_BITS) / area;
+    }
+
+    // Value at (x, y), relative to the first vertex, rounded at the pixel center
+    int64_t at(int a0, int x, int y) const
+    {
+        return (static_cast<int64_t>(a0) << RASTER_FRAC_BITS) + dx * x + dy * y + RASTER_HALF;
+    }
+};
+
+// X of an edge at line y, in fixed point
+static int64_t edgeX(const Vec2i &a, const Vec2i &b, int y)
+{
+    return (static_cast<int64_t>(a.x) << RASTER_FRAC_BITS) +
+        ((static_cast<int64_t>(b.x - a.x) << RASTER_FRAC_BITS) * (y - a.y)) / (b.y - a.y);
 }
 
-static ColorRGBA interpolateColor(const ColorRGBA& c0, const ColorRGBA& c1, const ColorRGBA& c2, float alpha, float beta, float gamma)
+static int fixedCeil(int64_t value)
 {
-    ColorRGBA color;
-    color.r = static_cast<uint8_t>(c0.r * alpha + c1.r * beta + c2.r * gamma);
-    color.g = static_cast<uint8_t>(c0.g * alpha + c1.g * beta + c2.g * gamma);
-    color.b = static_cast<uint8_t>(c0.b * alpha + c1.b * beta + c2.b * gamma);
-    color.a = static_cast<uint8_t>(c0.a * alpha + c1.a * beta + c2.a * gamma);
-    return color;
+    return static_cast<int>((value + RASTER_ONE - 1) >> RASTER_FRAC_BITS);
 }
 
-void GPU::rasterizeLine(const Vertex& v0, const Vertex& v1)
+static uint8_t clampColor(int64_t value)
 {
+    return static_cast<uint8_t>(std::clamp<int64_t>(value >> RASTER_FRAC_BITS, 0, 255));
+}
+
+uint32_t GPU::rasterizeLine(const Vertex& v0, const Vertex& v1, const DrawBand &band)
+{
+    uint32_t pixels = 0;
     int x0 = v0.pos.x;
     int y0 = v0.pos.y;
     int x1 = v1.pos.x;
@@ -683,7 +1042,11 @@ void GPU::rasterizeLine(const Vertex& v0, const Vertex& v1)
     ColorRGBA c = v0.color;
 
     while (true) {
-        setPixel(Vec2i(x0, y0), c.toABGR1555());
+        int line = y0 & (GPU_VRAM_HEIGHT - 1);
+        if (line >= band.top && line < band.bottom) {
+            setPixel(Vec2i(x0, y0), c.toABGR1555());
+            pixels++;
+        }
         if (x0 == x1 && y0 == y1)
             break;
 
@@ -702,160 +1065,251 @@ void GPU::rasterizeLine(const Vertex& v0, const Vertex& v1)
         c.b = static_cast<uint8_t>(std::clamp(c.b + db, 0.0f, 255.0f));
         c.a = static_cast<uint8_t>(std::clamp(c.a + da, 0.0f, 255.0f));
     }
+    return pixels;
 }
 
-void GPU::rasterizePoly3(const Vertex *verts, const ColorRGBA &color, const TextureInfo& texInfo)
+static SpanTexture spanTexture(const uint16_t *vram, const TextureInfo &texInfo)
 {
-    auto &flags = m_currentCmd.flags();
+    return SpanTexture{vram, texInfo.texPageX * 64, texInfo.texPageY * 256, texInfo.clutX, texInfo.clutY, texInfo.colorMode};
+}
 
-    int minX = std::max(0, std::min({verts[0].pos.x, verts[1].pos.x, verts[2].pos.x}));
-    int maxX = std::min(GPU_VRAM_WIDTH - 1, std::max({verts[0].pos.x, verts[1].pos.x, verts[2].pos.x}));
-    int minY = std::max(0, std::min({verts[0].pos.y, verts[1].pos.y, verts[2].pos.y}));
-    int maxY = std::min(GPU_VRAM_HEIGHT - 1, std::max({verts[0].pos.y, verts[1].pos.y, verts[2].pos.y}));
+// Walks the triangle edges line by line and only visits the covered spans.
+// Like the real GPU, the top and left edges are drawn but not the bottom and
+// right ones, and colors and texture coordinates step in fixed point.
+uint32_t GPU::rasterizePoly3(const Vertex *verts, const DrawCommand &cmd, const DrawBand &band)
+{
+    auto &flags = cmd.flags;
+    const SpanTexture tex = spanTexture(&m_vram[0][0], cmd.texInfo);
+    const Vertex *v[3] = {&verts[0], &verts[1], &verts[2]};
+    std::sort(v, v + 3, [](const Vertex *a, const Vertex *b) { return a->pos.y < b->pos.y; });
+
+    const Vec2i &p0 = v[0]->pos;
+    const Vec2i &p1 = v[1]->pos;
+    const Vec2i &p2 = v[2]->pos;
+    int minX = std::min({p0.x, p1.x, p2.x});
+    int maxX = std::max({p0.x, p1.x, p2.x});
+    // The GPU skips polygons larger than 1023x511
+    if (maxX - minX >= GPU_VRAM_WIDTH || p2.y - p0.y >= GPU_VRAM_HEIGHT) {
+        return 0;
+    }
 
-    int area = edgeFunction(verts[0].pos, verts[1].pos, verts[2].pos);
-    float invArea = 1.0f / area;
+    Vec2i d1{p1.x - p0.x, p1.y - p0.y};
+    Vec2i d2{p2.x - p0.x, p2.y - p0.y};
+    int64_t area = static_cast<int64_t>(d1.x) * d2.y - static_cast<int64_t>(d2.x) * d1.y;
+    if (area == 0) {
+        return 0;
+    }
+    // Positive area: the middle vertex is right of the long edge
+    bool longEdgeLeft = area > 0;
+
+    RasterGradient r(v[0]->color.r, v[1]->color.r, v[2]->color.r, d1, d2, area);
+    RasterGradient g(v[0]->color.g, v[1]->color.g, v[2]->color.g, d1, d2, area);
+    RasterGradient b(v[0]->color.b, v[1]->color.b, v[2]->color.b, d1, d2, area);
+    RasterGradient u(v[0]->u, v[1]->u, v[2]->u, d1, d2, area);
+    RasterGradient tv(v[0]->v, v[1]->v, v[2]->v, d1, d2, area);
+
+    int top = std::max(p0.y, band.top);
+    int bottom = std::min(p2.y, band.bottom);
+    uint32_t pixels = 0;
+    for (int y = top; y < bottom; y++) {
+        int64_t longX = edgeX(p0, p2, y);
+        int64_t shortX = y < p1.y ? edgeX(p0, p1, y) : edgeX(p1, p2, y);
+        int left = std::max(0, fixedCeil(longEdgeLeft ? longX : shortX));
+        int right = std::min(GPU_VRAM_WIDTH, fixedCeil(longEdgeLeft ? shortX : longX));
+        if (left >= right) {
+            continue;
+        }
+        pixels += right - left;
 
-    if (area == 0)
-        return;
+        int rx = left - p0.x;
+        int ry = y - p0.y;
+        int64_t rAcc = r.at(v[0]->color.r, rx, ry);
+        int64_t gAcc = g.at(v[0]->color.g, rx, ry);
+        int64_t bAcc = b.at(v[0]->color.b, rx, ry);
 
-    ColorRGBA finalColor;
-    for (int y = minY; y < maxY; y++) {
-        for (int x = minX; x < maxX; x++) {
-            Vec2i p = {x, y};
-            int w0 = edgeFunction(verts[1].pos, verts[2].pos, p);
-            int w1 = edgeFunction(verts[2].pos, verts[0].pos, p);
-            int w2 = edgeFunction(verts[0].pos, verts[1].pos, p);
-
-            int pos = (w0 >= 0) && (w1 >= 0) && (w2 >= 0);
-            int neg = (w0 <= 0) && (w1 <= 0) && (w2 <= 0);
-
-            if (pos || neg) {
-                float alpha = w0 * invArea;
-                float beta = w1 * invArea;
-                float gamma = w2 * invArea;
-
-                finalColor = color;
-                if (flags.shaded) {
-                    finalColor = interpolateColor(verts[0].color, verts[1].color, verts[2].color, alpha, beta, gamma);
-                }
-                if (flags.textured) {
-                    float u = alpha * verts[0].u + beta * verts[1].u + gamma * verts[2].u;
-                    float v = alpha * verts[0].v + beta * verts[1].v + gamma * verts[2].v;
-
-                    uint16_t texColor = sampleTexture(static_cast<uint8_t>(u), static_cast<uint8_t>(v), texInfo);
-
-                    if (!texColor) {
-                        continue;
-                    }
-
-                    if (!flags.rawTexture) {
-                        uint16_t texR = (texColor & 0x1F) << 3;
-                        uint16_t texG = ((texColor >> 5) & 0x1F) << 3;
-                        uint16_t texB = ((texColor >> 10) & 0x1F) << 3;
-
-                        finalColor.r = static_cast<uint8_t>((texR * finalColor.r) / 128);
-                        finalColor.g = static_cast<uint8_t>((texG * finalColor.g) / 128);
-                        finalColor.b = static_cast<uint8_t>((texB * finalColor.b) / 128);
-                    } else {
-                        finalColor.r = (texColor & 0x1F) << 3;
-                        finalColor.g = ((texColor >> 5) & 0x1F) << 3;
-                        finalColor.b = ((texColor >> 10) & 0x1F) << 3;
-                    }
-                }
-                setPixel(p, finalColor.toABGR1555());
+        if (flags.textured) {
+            // Values inside the triangle fit in 32 bits, texture coordinates
+            // only need their low bits
+            TexturedSpan span;
+            span.dst = &m_vram[y][left];
+            span.count = right - left;
+            span.u = static_cast<int32_t>(u.at(v[0]->u, rx, ry));
+            span.v = static_cast<int32_t>(tv.at(v[0]->v, rx, ry));
+            span.du = static_cast<int32_t>(u.dx);
+            span.dv = static_cast<int32_t>(tv.dx);
+            if (flags.shaded) {
+                span.r = static_cast<int32_t>(rAcc);
+                span.g = static_cast<int32_t>(gAcc);
+                span.b = static_cast<int32_t>(bAcc);
+                span.dr = static_cast<int32_t>(r.dx);
+                span.dg = static_cast<int32_t>(g.dx);
+                span.db = static_cast<int32_t>(b.dx);
+            } else {
+                span.r = cmd.color.r << RASTER_FRAC_BITS;
+                span.g = cmd.color.g << RASTER_FRAC_BITS;
+                span.b = cmd.color.b << RASTER_FRAC_BITS;
+                span.dr = span.dg = span.db = 0;
             }
+            span.rawTexture = flags.rawTexture;
+            m_texturedSpan(tex, span);
+            markLineDirty(y);
+            continue;
         }
-    }
-}
 
-void GPU::rasterizePoly4(const Vertex *verts, const ColorRGBA &color, const TextureInfo& texInfo)
-{
-    rasterizePoly3(verts, color, texInfo);
-    rasterizePoly3(verts + 1, color, texInfo);
+        for (int x = left; x < right; x++) {
+            ColorRGBA finalColor = cmd.color;
+            if (flags.shaded) {
+                finalColor.r = clampColor(rAcc);
+                finalColor.g = clampColor(gAcc);
+                finalColor.b = clampColor(bAcc);
+            }
+            rAcc += r.dx;
+            gAcc += g.dx;
+            bAcc += b.dx;
+            setPixel(Vec2i{x, y}, finalColor.toABGR1555());
+        }
+    }
+    return pixels;
 }
 
-void GPU::rasterizeRectangle(const Vertex &vert, const Vec2i &size, const TextureInfo& texInfo)
+uint32_t GPU::rasterizeRectangle(const DrawCommand &cmd, const DrawBand &band)
 {
-    auto &flags = m_currentCmd.flags();
+    auto &flags = cmd.flags;
+    const Vertex &vert = cmd.verts[0];
+    const Vec2i &size = cmd.size;
     uint16_t color = vert.color.toABGR1555();
+    const SpanTexture tex = spanTexture(&m_vram[0][0], cmd.texInfo);
+    uint32_t pixels = 0;
 
     for (uint16_t y = 0; y < size.y; y++) {
-        for (uint16_t x = 0; x < size.x; x++) {
-            Vec2i pos{vert.pos.x + x, vert.pos.y + y};
-            uint16_t pixelColor = color;
-
-            if (flags.textured) {
-                uint8_t u = static_cast<uint8_t>(vert.u + x);
-                uint8_t v = static_cast<uint8_t>(vert.v + y);
-
-                pixelColor = sampleTexture(u, v, texInfo);
-
-                if (!pixelColor) {
-                    continue;
-                }
-
-                if (!flags.rawTexture) {
-                    uint8_t texR = (pixelColor & 0x1F) << 3;
-                    uint8_t texG = ((pixelColor >> 5) & 0x1F) << 3;
-                    uint8_t texB = ((pixelColor >> 10) & 0x1F) << 3;
+        int line = (vert.pos.y + y) & (GPU_VRAM_HEIGHT - 1);
+        if (line < band.top || line >= band.bottom) {
+            continue;
+        }
+        pixels += size.x;
+        if (!flags.textured) {
+            for (uint16_t x = 0; x < size.x; x++) {
+                setPixel(Vec2i{vert.pos.x + x, line}, color);
+            }
+            continue;
+        }
 
-                    texR = (texR * vert.color.r) >> 7;
-                    texG = (texG * vert.color.g) >> 7;
-                    texB = (texB * vert.color.b) >> 7;
+        // One span per part of the line on each side of the VRAM wrap around
+        for (int x = 0; x < size.x;) {
+            int column = (vert.pos.x + x) & (GPU_VRAM_WIDTH - 1);
+            TexturedSpan span;
+            span.dst = &m_vram[line][column];
+            span.count = std::min(size.x - x, GPU_VRAM_WIDTH - column);
+            span.u = (vert.u + x) << RASTER_FRAC_BITS;
+            span.v = (vert.v + y) << RASTER_FRAC_BITS;
+            span.du = 1 << RASTER_FRAC_BITS;
+            span.dv = 0;
+            span.r = vert.color.r << RASTER_FRAC_BITS;
+            span.g = vert.color.g << RASTER_FRAC_BITS;
+            span.b = vert.color.b << RASTER_FRAC_BITS;
+            span.dr = span.dg = span.db = 0;
+            span.rawTexture = flags.rawTexture;
+            m_texturedSpan(tex, span);
+            x += span.count;
+        }
+        markLineDirty(line);
+    }
+    return pixels;
+}
 
-                    pixelColor = 0x8000 | ((texB >> 3) << 10) | ((texG >> 3) << 5) | (texR >> 3);
-                }
-            }
-            setPixel(pos, pixelColor);
+uint32_t GPU::rasterizeFill(const DrawCommand &cmd, const DrawBand &band)
+{
+    const Vec2i &topLeft = cmd.verts[0].pos;
+    uint16_t abgr = cmd.color.toABGR1555();
+    uint32_t pixels = 0;
+
+    // Not affected by the mask bit settings
+    for (int y = 0; y < cmd.size.y; y++) {
+        int line = (topLeft.y + y) & (GPU_VRAM_HEIGHT - 1);
+        if (line >= band.top && line < band.bottom) {
+            fillRow(topLeft.x, line, cmd.size.x, abgr);
+            pixels += cmd.size.x;
         }
     }
+    return pixels;
 }
 
+// Coordinates wrap around VRAM like on the real GPU
 void GPU::setPixel(const Vec2i &pos, uint16_t color)
 {
-    int index = (pos.y * 1024 + pos.x) * 2;
-    m_vram[index] = color & 0xFF;
-    m_vram[index + 1] = color >> 8;
+    int line = pos.y & (GPU_VRAM_HEIGHT - 1);
+    m_vram[line][pos.x & (GPU_VRAM_WIDTH - 1)] = color;
+    markLineDirty(line);
 }
 
 uint16_t GPU::getPixel(const Vec2i &pos)
 {
-    int index = (pos.y * 1024 + pos.x) * 2;
-    uint16_t color = 0;
-    color = m_vram[index];
-    color |= m_vram[index + 1] << 8;
-    return color;
+    return m_vram[pos.y & (GPU_VRAM_HEIGHT - 1)][pos.x & (GPU_VRAM_WIDTH - 1)];
 }
 
-uint16_t GPU::sampleTexture(uint8_t u, uint8_t v, const TextureInfo& texInfo)
+void GPU::markLineDirty(int line)
 {
-    uint16_t texPageBaseY = texInfo.texPageY * 256;
-    uint16_t texPageBaseX = texInfo.texPageX * 64;  // Base in VRAM 16-bit words
+    m_vramDirty[(line * GPU_VRAM_WIDTH * 2) >> GPU_VRAM_PAGE_SHIFT] = 0xFF;
+}
 
-    switch (texInfo.colorMode) {
-        case TexturePageColors::COL_4Bit: {
-            uint16_t texelX = texPageBaseX + (u / 4);  // 4 texels per 16-bit word
-            uint16_t texelY = texPageBaseY + v;
-            uint16_t texData = getPixel({static_cast<int>(texelX), static_cast<int>(texelY)});
-            uint8_t index = (texData >> ((u % 4) * 4)) & 0xF;
-            return getPixel({texInfo.clutX + index, texInfo.clutY});
-        }
+void GPU::fillRow(int x, int line, int count, uint16_t color)
+{
+    uint16_t *row = m_vram[line];
+
+    while (count > 0) {
+        int column = x & (GPU_VRAM_WIDTH - 1);
+        int length = std::min(count, GPU_VRAM_WIDTH - column);
+        std::fill_n(row + column, length, color);
+        x += length;
+        count -= length;
+    }
+    markLineDirty(line);
+}
 
-        case TexturePageColors::COL_8Bit: {
-            uint16_t texelX = texPageBaseX + (u / 2);  // 2 texels per 16-bit word
-            uint16_t texelY = texPageBaseY + v;
-            uint16_t texData = getPixel({static_cast<int>(texelX), static_cast<int>(texelY)});
-            uint8_t index = (texData >> ((u % 2) * 8)) & 0xFF;
-            return getPixel({texInfo.clutX + index, texInfo.clutY});
+void GPU::writeRow(int x, int line, const uint16_t *pixels, int count)
+{
+    uint16_t *row = m_vram[line];
+    uint16_t setMask = m_gpuStat.setMaskBitWhenDrawing ? 0x8000 : 0;
+    // Pixels with their mask bit set are protected from the write
+    uint16_t checkMask = m_gpuStat.drawPixels ? 0x8000 : 0;
+
+    while (count > 0) {
+        int column = x & (GPU_VRAM_WIDTH - 1);
+        int length = std::min(count, GPU_VRAM_WIDTH - column);
+        uint16_t *dst = row + column;
+        if (!setMask && !checkMask) {
+            std::memcpy(dst, pixels, length * sizeof(uint16_t));
+        } else {
+            for (int i = 0; i < length; i++) {
+                dst[i] = (dst[i] & checkMask) ? dst[i] : (pixels[i] | setMask);
+            }
         }
+        pixels += length;
+        x += length;
+        count -= length;
+    }
+    markLineDirty(line);
+}
 
-        case TexturePageColors::COL_15Bit: {
-            uint16_t texelX = texPageBaseX + u;
-            uint16_t texelY = texPageBaseY + v;
-            return getPixel({static_cast<int>(texelX), static_cast<int>(texelY)});
+// Writes the pixels of a CPU to VRAM copy, row by row
+void GPU::uploadPixels(const uint16_t *pixels, int count)
+{
+    VramCopyData &copy = m_vramCopyData;
+
+    while (count > 0 && m_currentState == GpuState::ReceivingDataWords) {
+        int length = std::min(count, copy.size.x - copy.currentPos.x);
+        int line = (copy.startPos.y + copy.currentPos.y) & (GPU_VRAM_HEIGHT - 1);
+        writeRow(copy.startPos.x + copy.currentPos.x, line, pixels, length);
+        pixels += length;
+        count -= length;
+        copy.currentPos.x += length;
+        if (copy.currentPos.x >= copy.size.x) {
+            copy.currentPos.x = 0;
+            copy.currentPos.y++;
+        }
+        if (copy.currentPos.y > copy.size.y) {
+            m_currentState = GpuState::WaitingForCommand;
+            m_currentCmd.reset();
         }
-        default:
-            return 0x8000; // Transparent
     }
 }
@@ -9,15 +9,26 @@
 #define GPU_HPP_
 
 #include <array>
+#include <bitset>
+#include <memory>
+#include <vector>
 
 #include "PsxDevice.hpp"
 #include "GPUCommand.hpp"
+#include "PerfCounters.hpp"
 
 class StateBuffer;
+class ThreadPool;
+struct SpanTexture;
+struct TexturedSpan;
+
+using TexturedSpanKernel = void (*)(const SpanTexture &tex, const TexturedSpan &span);
 
 #define GPU_VRAM_WIDTH 1024 // 1024 pixels (2048 bytes)
 #define GPU_VRAM_HEIGHT 512 // 512 lines
 #define GPU_VRAM_1MB_SIZE (GPU_VRAM_WIDTH * 2 * GPU_VRAM_HEIGHT) // 512 lines of 1024 pixels
+#define GPU_VRAM_PAGE_SHIFT 12 // Dirty tracking granularity, 4 KiB (2 lines)
+#define GPU_VRAM_PAGE_COUNT (GPU_VRAM_1MB_SIZE >> GPU_VRAM_PAGE_SHIFT)
 
 struct TexturePageBase
 {
@@ -208,13 +219,50 @@ struct VramCopyData
     Vec2i currentPos;
 };
 
+enum class DrawType : uint8_t
+{
+    Polygon,
+    Rectangle,
+    Line,
+    Fill
+};
+
+// A parsed GP0 draw command, queued in the draw list until it is flushed
+struct DrawCommand
+{
+    DrawType type;
+    GPUCommandFlags flags;
+    Vertex verts[4];
+    Vec2i size;
+    ColorRGBA color;
+    TextureInfo texInfo;
+};
+
+// VRAM lines [top, bottom) a rasterizer call is allowed to write
+struct DrawBand
+{
+    int top;
+    int bottom;
+};
+
 class GPU : public PsxDevice
 {
     public:
         GPU(Bus *bus);
         ~GPU();
 
+        // Draw commands are rasterized by this many threads, each owning a band
+        // of VRAM lines. 1 rasterizes every command as soon as it is received.
+        void setRenderThreads(size_t threads);
+        size_t getRenderThreads() const { return m_renderThreads; }
+        // Rasterizes the queued draw commands
+        void flushDrawing();
+        // Same as writing the words to GP0 one by one, but complete command
+        // packets and CPU to VRAM data are handled in bulk
+        void submitWords(const uint32_t *words, size_t count);
+
         void update(int cycles) override;
+        void onEvent(SchedulerEvent event) override;
         void reset();
 
         void serialize(StateBuffer &buf) const override;
@@ -228,7 +276,16 @@ class GPU : public PsxDevice
         uint16_t read16(uint32_t address) override;
         uint32_t read32(uint32_t address) override;
 
+        // GP0 words and GPUREAD values
+        void dmaWrite(const uint32_t *words, size_t count) override;
+        void dmaRead(uint32_t *words, size_t count) override;
+
+        // Both flush the queued draw commands first. VRAM holds 1024x512
+        // pixels of 16 bits in host byte order.
         uint8_t *getVram();
+        // Every VRAM write sets all the bits of its page, each consumer
+        // clears its own bit, using the MemoryWatch values
+        uint8_t *getVramDirtyFlags();
 
         const GPUStat& getGpuStat() const { return m_gpuStat; }
         uint32_t getGpuStatRaw() const { return gpuStat(); }
@@ -238,9 +295,16 @@ class GPU : public PsxDevice
         HorizontalRes getHorizontalRes() const { return m_gpuStat.hRes1; };
         VerticalRes getVerticalRes() const { return m_gpuStat.vRes; };
         VideoMode getVideoMode() const { return m_gpuStat.videoMode; };
+        // CPU cycles from one VBlank to the next, in the current video mode
+        double getFieldCycles() const;
+        // VBlanks since the GPU was created
+        uint64_t getFieldCount() const { return m_fieldCount; }
 
     private:
         uint32_t gpuStat() const;
+        uint32_t scanlineCount() const;
+        uint32_t scanlineUnits() const;
+        void scheduleVBlank();
         void readInternalRegister(uint8_t reg);
 
         void processGP0(uint32_t data);
@@ -262,18 +326,31 @@ class GPU : public PsxDevice
 
         void receiveParameter(uint32_t param);
         void receiveDataWord(uint32_t data);
+        size_t receiveDataWords(const uint32_t *words, size_t count);
+        void executeCommand();
+        void countCommand(PerfPrimitive kind);
+
+        // Draw list
+        void submitDraw(const DrawCommand &cmd);
+        // Executing a command returns the number of pixels it drew
+        uint32_t executeDraw(const DrawCommand &cmd, const DrawBand &band);
+        void countPixels(DrawType type, uint64_t pixels);
 
         // Rasterization methods
-        void rasterizeLine(const Vertex& v0, const Vertex& v1);
-        void rasterizePoly3(const Vertex *verts, const ColorRGBA& color, const TextureInfo& texInfo);
-        void rasterizePoly4(const Vertex *verts, const ColorRGBA& color, const TextureInfo& texInfo);
-        void rasterizeRectangle(const Vertex &vert, const Vec2i &size, const TextureInfo& texInfo);
+        uint32_t rasterizeLine(const Vertex& v0, const Vertex& v1, const DrawBand &band);
+        uint32_t rasterizePoly3(const Vertex *verts, const DrawCommand &cmd, const DrawBand &band);
+        uint32_t rasterizeRectangle(const DrawCommand &cmd, const DrawBand &band);
+        uint32_t rasterizeFill(const DrawCommand &cmd, const DrawBand &band);
 
         void setPixel(const Vec2i &pos, uint16_t color);
         uint16_t getPixel(const Vec2i &pos);
 
-        // Texture sampling methods
-        uint16_t sampleTexture(uint8_t u, uint8_t v, const TextureInfo& texInfo);
+        // Row operations, x wraps around the line
+        void markLineDirty(int line);
+        void fillRow(int x, int line, int count, uint16_t color);
+        // Both honour the mask bit settings
+        void writeRow(int x, int line, const uint16_t *pixels, int count);
+        void uploadPixels(const uint16_t *pixels, int count);
 
     private:
         GPUStat m_gpuStat;
@@ -291,10 +368,22 @@ class GPU : public PsxDevice
 
         VramCopyData m_vramCopyData;
 
-        std::array<uint8_t, GPU_VRAM_1MB_SIZE> m_vram;
+        alignas(64) uint16_t m_vram[GPU_VRAM_HEIGHT][GPU_VRAM_WIDTH];
+        std::array<uint8_t, GPU_VRAM_PAGE_COUNT> m_vramDirty;
 
-        float m_cycleCount;
+        uint32_t m_cycleCount; // Sevenths of GPU cycles into the current scanline
         uint32_t m_scanline;
+        uint64_t m_fieldCount;
+
+        // Queued draws, with the VRAM lines they read and write to detect
+        // commands that depend on pixels drawn by another band
+        std::vector<DrawCommand> m_drawList;
+        std::bitset<GPU_VRAM_HEIGHT> m_drawReadLines;
+        std::bitset<GPU_VRAM_HEIGHT> m_drawWriteLines;
+        size_t m_renderThreads;
+        std::unique_ptr<ThreadPool> m_renderPool;
+        // Picked once for the host CPU, see GPUSpan.hpp
+        TexturedSpanKernel m_texturedSpan;
 };
 
 #endif /* !GPU_HPP_ */
@@ -22,6 +22,11 @@ void GPUCommand::addParam(uint32_t param)
     m_params.addParam(param);
 }
 
+void GPUCommand::addParams(const uint32_t *params, int count)
+{
+    m_params.addParams(params, count);
+}
+
 static GPUCommandFlags parsePolygonArgs(uint32_t cmd)
 {
     GPUCommandFlags flags{};
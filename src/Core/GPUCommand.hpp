@@ -1,6 +1,7 @@
 #ifndef GPUCOMMAND_HPP_
 #define GPUCOMMAND_HPP_
 
+#include <algorithm>
 #include <cstdint>
 
 class StateBuffer;
@@ -24,6 +25,12 @@ class GPUParamArray
             m_headPtr++;
         }
 
+        void addParams(const uint32_t *params, int count) {
+            count = std::min(count, 32 - m_headPtr);
+            std::copy(params, params + count, m_data + m_headPtr);
+            m_headPtr += count;
+        }
+
         const uint32_t *data() const {
             return m_data;
         }
@@ -98,6 +105,7 @@ class GPUCommand
         void reset();
 
         void addParam(uint32_t param);
+        void addParams(const uint32_t *params, int count);
         const GPUParamArray &params() const { return m_params; }
         const GPUCommandFlags &flags() const { return m_flags; }
         int expectedParams() { return m_nbExpectedParams; }
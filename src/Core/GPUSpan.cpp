@@ -0,0 +1,234 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** GPUSpan
+*/
+
+#include "GPUSpan.hpp"
+
+#include <algorithm>
+
+#ifdef ROGEM_SPAN_AVX2
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define ROGEM_TARGET_AVX2
+    #else
+        #define ROGEM_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+static uint16_t vramPixel(const uint16_t *vram, int x, int y)
+{
+    return vram[(y & (GPU_VRAM_HEIGHT - 1)) * GPU_VRAM_WIDTH + (x & (GPU_VRAM_WIDTH - 1))];
+}
+
+static uint16_t fetchTexel(const SpanTexture &tex, uint8_t u, uint8_t v)
+{
+    int y = tex.pageY + v;
+
+    switch (tex.colorMode) {
+        case TexturePageColors::COL_4Bit: {
+            uint16_t texData = vramPixel(tex.vram, tex.pageX + u / 4, y);
+            uint8_t index = (texData >> ((u % 4) * 4)) & 0xF;
+            return vramPixel(tex.vram, tex.clutX + index, tex.clutY);
+        }
+        case TexturePageColors::COL_8Bit: {
+            uint16_t texData = vramPixel(tex.vram, tex.pageX + u / 2, y);
+            uint8_t index = (texData >> ((u % 2) * 8)) & 0xFF;
+            return vramPixel(tex.vram, tex.clutX + index, tex.clutY);
+        }
+        case TexturePageColors::COL_15Bit:
+            return vramPixel(tex.vram, tex.pageX + u, y);
+        default:
+            return 0x8000;
+    }
+}
+
+// 5 bit texel channel times an 8 bit color, 0x80 being 1.0
+static uint16_t modulate(uint16_t texel, int shift, int32_t color)
+{
+    int c = std::clamp(color >> 16, 0, 255);
+    return static_cast<uint16_t>(std::min(31, (((texel >> shift) & 0x1F) * c) >> 7) << shift);
+}
+
+void drawTexturedSpanScalar(const SpanTexture &tex, const TexturedSpan &span)
+{
+    // Texture coordinates wrap around the page, unsigned math keeps their low bits
+    uint32_t u = static_cast<uint32_t>(span.u);
+    uint32_t v = static_cast<uint32_t>(span.v);
+    int32_t r = span.r;
+    int32_t g = span.g;
+    int32_t b = span.b;
+
+    for (int i = 0; i < span.count; i++) {
+        uint16_t texel = fetchTexel(tex, static_cast<uint8_t>(u >> 16), static_cast<uint8_t>(v >> 16));
+        if (texel) {
+            uint16_t color = texel;
+            if (!span.rawTexture) {
+                color = (texel & 0x8000) | modulate(texel, 0, r) | modulate(texel, 5, g) | modulate(texel, 10, b);
+            }
+            span.dst[i] = color;
+        }
+        u += static_cast<uint32_t>(span.du);
+        v += static_cast<uint32_t>(span.dv);
+        r += span.dr;
+        g += span.dg;
+        b += span.db;
+    }
+}
+
+#ifdef ROGEM_SPAN_AVX2
+
+// 16 bit VRAM pixels at the given indices, as aligned 32 bit loads that never
+// read past the end of VRAM
+ROGEM_TARGET_AVX2 static __m256i gatherPixels(const uint16_t *vram, __m256i index)
+{
+    __m256i offset = _mm256_and_si256(_mm256_slli_epi32(index, 1), _mm256_set1_epi32(~3));
+    __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int *>(vram), offset, 1);
+    __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(1)), 4);
+    return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFFFF));
+}
+
+ROGEM_TARGET_AVX2 static __m256i pixelIndex(__m256i x, __m256i y)
+{
+    x = _mm256_and_si256(x, _mm256_set1_epi32(GPU_VRAM_WIDTH - 1));
+    y = _mm256_and_si256(y, _mm256_set1_epi32(GPU_VRAM_HEIGHT - 1));
+    return _mm256_or_si256(_mm256_slli_epi32(y, 10), x);
+}
+
+ROGEM_TARGET_AVX2 static __m256i modulateChannels(__m256i texel, int shift, __m256i color)
+{
+    __m256i c = _mm256_srai_epi32(color, 16);
+    c = _mm256_min_epi32(_mm256_max_epi32(c, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+    __m256i t = _mm256_and_si256(_mm256_srli_epi32(texel, shift), _mm256_set1_epi32(0x1F));
+    __m256i out = _mm256_min_epi32(_mm256_srli_epi32(_mm256_mullo_epi32(t, c), 7), _mm256_set1_epi32(31));
+    return _mm256_slli_epi32(out, shift);
+}
+
+// Values of 8 consecutive pixels from start, stepping by delta
+ROGEM_TARGET_AVX2 static __m256i lanes(int32_t start, int32_t delta)
+{
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_add_epi32(_mm256_set1_epi32(start), _mm256_mullo_epi32(index, _mm256_set1_epi32(delta)));
+}
+
+// start + delta * count, wrapping like the vector lanes do
+static int32_t advance(int32_t start, int32_t delta, int count)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(start) + static_cast<uint32_t>(delta) * static_cast<uint32_t>(count));
+}
+
+ROGEM_TARGET_AVX2 void drawTexturedSpanAvx2(const SpanTexture &tex, const TexturedSpan &span)
+{
+    if (tex.colorMode == TexturePageColors::RESERVED) {
+        drawTexturedSpanScalar(tex, span);
+        return;
+    }
+
+    __m256i u = lanes(span.u, span.du);
+    __m256i v = lanes(span.v, span.dv);
+    __m256i r = lanes(span.r, span.dr);
+    __m256i g = lanes(span.g, span.dg);
+    __m256i b = lanes(span.b, span.db);
+    const __m256i stepU = _mm256_set1_epi32(advance(0, span.du, 8));
+    const __m256i stepV = _mm256_set1_epi32(advance(0, span.dv, 8));
+    const __m256i stepR = _mm256_set1_epi32(advance(0, span.dr, 8));
+    const __m256i stepG = _mm256_set1_epi32(advance(0, span.dg, 8));
+    const __m256i stepB = _mm256_set1_epi32(advance(0, span.db, 8));
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i pageX = _mm256_set1_epi32(tex.pageX);
+    const __m256i pageY = _mm256_set1_epi32(tex.pageY);
+    const __m256i clutX = _mm256_set1_epi32(tex.clutX);
+    const __m256i clutY = _mm256_set1_epi32(tex.clutY);
+    const __m256i packOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+    int i = 0;
+    for (; i + 8 <= span.count; i += 8) {
+        __m256i texU = _mm256_and_si256(_mm256_srli_epi32(u, 16), byteMask);
+        __m256i texY = _mm256_add_epi32(pageY, _mm256_and_si256(_mm256_srli_epi32(v, 16), byteMask));
+        __m256i texel;
+
+        if (tex.colorMode == TexturePageColors::COL_15Bit) {
+            texel = gatherPixels(tex.vram, pixelIndex(_mm256_add_epi32(pageX, texU), texY));
+        } else {
+            // 4 or 2 CLUT indices per 16 bit word
+            bool is4Bit = tex.colorMode == TexturePageColors::COL_4Bit;
+            int perWordShift = is4Bit ? 2 : 1;
+            __m256i subIndex = _mm256_and_si256(texU, _mm256_set1_epi32(is4Bit ? 3 : 1));
+            __m256i bitShift = _mm256_slli_epi32(subIndex, is4Bit ? 2 : 3);
+            __m256i wordX = _mm256_add_epi32(pageX, _mm256_srli_epi32(texU, perWordShift));
+            __m256i words = gatherPixels(tex.vram, pixelIndex(wordX, texY));
+            __m256i index = _mm256_and_si256(_mm256_srlv_epi32(words, bitShift), _mm256_set1_epi32(is4Bit ? 0xF : 0xFF));
+            texel = gatherPixels(tex.vram, pixelIndex(_mm256_add_epi32(clutX, index), clutY));
+        }
+
+        __m256i color = texel;
+        if (!span.rawTexture) {
+            color = _mm256_and_si256(texel, _mm256_set1_epi32(0x8000));
+            color = _mm256_or_si256(color, modulateChannels(texel, 0, r));
+            color = _mm256_or_si256(color, modulateChannels(texel, 5, g));
+            color = _mm256_or_si256(color, modulateChannels(texel, 10, b));
+        }
+
+        // Transparent texels keep the pixels already in VRAM
+        __m256i transparent = _mm256_cmpeq_epi32(texel, _mm256_setzero_si256());
+        __m128i color16 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_packus_epi32(color, color), packOrder));
+        __m128i keep16 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_packs_epi32(transparent, transparent), packOrder));
+        __m128i *dst = reinterpret_cast<__m128i *>(span.dst + i);
+        _mm_storeu_si128(dst, _mm_blendv_epi8(color16, _mm_loadu_si128(dst), keep16));
+
+        u = _mm256_add_epi32(u, stepU);
+        v = _mm256_add_epi32(v, stepV);
+        r = _mm256_add_epi32(r, stepR);
+        g = _mm256_add_epi32(g, stepG);
+        b = _mm256_add_epi32(b, stepB);
+    }
+
+    if (i < span.count) {
+        TexturedSpan tail = span;
+        tail.dst = span.dst + i;
+        tail.count = span.count - i;
+        tail.u = advance(span.u, span.du, i);
+        tail.v = advance(span.v, span.dv, i);
+        tail.r = advance(span.r, span.dr, i);
+        tail.g = advance(span.g, span.dg, i);
+        tail.b = advance(span.b, span.db, i);
+        drawTexturedSpanScalar(tex, tail);
+    }
+}
+
+#endif
+
+bool hasAvx2SpanKernel()
+{
+#if defined(ROGEM_SPAN_AVX2) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // The OS has to save the AVX registers too
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#elif defined(ROGEM_SPAN_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+TexturedSpanKernel getTexturedSpanKernel()
+{
+#ifdef ROGEM_SPAN_AVX2
+    static const TexturedSpanKernel kernel = hasAvx2SpanKernel() ? drawTexturedSpanAvx2 : drawTexturedSpanScalar;
+    return kernel;
+#else
+    return drawTexturedSpanScalar;
+#endif
+}
@@ -0,0 +1,61 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** GPUSpan
+*/
+
+#ifndef GPUSPAN_HPP_
+#define GPUSPAN_HPP_
+
+#include <cstdint>
+
+#include "GPU.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ROGEM_SPAN_AVX2 1
+#endif
+
+// Texture read by a span, positions in VRAM pixels
+struct SpanTexture
+{
+    const uint16_t *vram;
+    int pageX;
+    int pageY;
+    int clutX;
+    int clutY;
+    TexturePageColors colorMode;
+};
+
+// A run of textured pixels on one VRAM line. Texture coordinates and colors
+// are those of the first pixel and step per pixel, in 16.16 fixed point.
+struct TexturedSpan
+{
+    uint16_t *dst;
+    int count;
+    int32_t u;
+    int32_t v;
+    int32_t du;
+    int32_t dv;
+    int32_t r;
+    int32_t g;
+    int32_t b;
+    int32_t dr;
+    int32_t dg;
+    int32_t db;
+    bool rawTexture;
+};
+
+// TexturedSpanKernel implementations, they sample, modulate and write every
+// texel of the span but the transparent (0x0000) ones
+void drawTexturedSpanScalar(const SpanTexture &tex, const TexturedSpan &span);
+#ifdef ROGEM_SPAN_AVX2
+// 8 pixels per iteration, only call it when hasAvx2SpanKernel() is true
+void drawTexturedSpanAvx2(const SpanTexture &tex, const TexturedSpan &span);
+#endif
+
+bool hasAvx2SpanKernel();
+// Fastest kernel the host CPU supports
+TexturedSpanKernel getTexturedSpanKernel();
+
+#endif /* !GPUSPAN_HPP_ */
@@ -11,9 +11,38 @@
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <array>
 #include <spdlog/spdlog.h>
 #include <fmt/format.h>
 
+// Busy time of each function code, 0 for the unused ones
+static constexpr auto COMMAND_CYCLES = [] {
+    std::array<uint8_t, 64> cycles{};
+    cycles[static_cast<uint8_t>(GTEFunction::RTPS)] = 15;
+    cycles[static_cast<uint8_t>(GTEFunction::NCLIP)] = 8;
+    cycles[static_cast<uint8_t>(GTEFunction::OP)] = 6;
+    cycles[static_cast<uint8_t>(GTEFunction::DPCS)] = 8;
+    cycles[static_cast<uint8_t>(GTEFunction::INTPL)] = 8;
+    cycles[static_cast<uint8_t>(GTEFunction::MVMVA)] = 8;
+    cycles[static_cast<uint8_t>(GTEFunction::NCDS)] = 19;
+    cycles[static_cast<uint8_t>(GTEFunction::CDP)] = 13;
+    cycles[static_cast<uint8_t>(GTEFunction::NCDT)] = 44;
+    cycles[static_cast<uint8_t>(GTEFunction::NCCS)] = 17;
+    cycles[static_cast<uint8_t>(GTEFunction::CC)] = 11;
+    cycles[static_cast<uint8_t>(GTEFunction::NCS)] = 14;
+    cycles[static_cast<uint8_t>(GTEFunction::NCT)] = 30;
+    cycles[static_cast<uint8_t>(GTEFunction::SQR)] = 5;
+    cycles[static_cast<uint8_t>(GTEFunction::DCPL)] = 8;
+    cycles[static_cast<uint8_t>(GTEFunction::DPCT)] = 17;
+    cycles[static_cast<uint8_t>(GTEFunction::AVSZ3)] = 5;
+    cycles[static_cast<uint8_t>(GTEFunction::AVSZ4)] = 6;
+    cycles[static_cast<uint8_t>(GTEFunction::RTPT)] = 23;
+    cycles[static_cast<uint8_t>(GTEFunction::GPF)] = 5;
+    cycles[static_cast<uint8_t>(GTEFunction::GPL)] = 5;
+    cycles[static_cast<uint8_t>(GTEFunction::NCCT)] = 39;
+    return cycles;
+}();
+
 /**
  * @brief Constructs the GTE coprocessor and initializes registers.
  */
@@ -106,153 +135,167 @@ void GTE::execute(uint32_t opcode) {
     decodeAndExecute(opcode);
 }
 
+uint32_t GTE::commandCycles(uint32_t opcode) {
+    return COMMAND_CYCLES[opcode & 0x3F];
+}
+
 /**
- * @brief Decodes the GTE instruction and dispatches to the appropriate handler.
+ * @brief Runs the command instance matching the function code and flag bits of the opcode.
  * @param opcode The 32-bit instruction word.
  */
 void GTE::decodeAndExecute(uint32_t opcode) {
-    GTEFunction funct = static_cast<GTEFunction>(opcode & 0x3F);
-
-    switch (funct) {
-        case GTEFunction::RTPS:
-            executeRTPS(opcode, 0);
-            break;
-        case GTEFunction::NCLIP:
-            executeNCLIP();
-            break;
-        case GTEFunction::OP:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeOP(sf);
-            break;
-        }
-        case GTEFunction::DPCS:
-            executeDPCS(opcode);
-            break;
-        case GTEFunction::INTPL: {
-            Vector3<int32_t> macs(m_dataReg[9] << 12, m_dataReg[10] << 12, m_dataReg[11] << 12);
-            executeINTPL(opcode, macs);
-            break;
-        }
-        case GTEFunction::MVMVA:
-            executeMVMVA(opcode);
-            break;
-        case GTEFunction::NCDS:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCDS(sf);
-            break;
-        }
-        case GTEFunction::CDP:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeCDP(sf);
-            break;
-        }
-        case GTEFunction::NCDT:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCDT(sf);
-            break;
-        }
-        case GTEFunction::NCCS:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCCS(sf);
-            break;
-        }
-        case GTEFunction::CC:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeCC(sf);
-            break;
-        }
-        case GTEFunction::NCS: {
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCCS(sf);
-            break;
-        }
-        case GTEFunction::NCT:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCT(sf);
-            break;
-        }
-        case GTEFunction::SQR: {
-            bool sf = (opcode >> 19) & 0x1;
-            executeSQR(sf);
-            break;
-        }
-        case GTEFunction::DCPL:
-            executeDCPL(opcode);
-            break;
-        case GTEFunction::DPCT:
-            executeDPCT(opcode);
-            break;
-        case GTEFunction::AVSZ3:
-            executeAVSZ3();
-            break;
-        case GTEFunction::AVSZ4:
-            executeAVSZ4();
-            break;
-        case GTEFunction::RTPT:
-            executeRTPT(opcode);
-            break;
-        case GTEFunction::GPF:
-            executeGPF(opcode);
-            break;
-        case GTEFunction::GPL:
-            executeGPL(opcode, true);
-            break;
-        case GTEFunction::NCCT:{
-            bool sf = (opcode >> 19) & 0x1;
-            executeNCCT(sf);
-            break;
-        }
-        default:
-            spdlog::error("GTE: Unimplemented or unknown instruction function: 0x{:02X}", opcode & 0x3F);
-            break;
+    COMMANDS[commandIndex(opcode)](*this, opcode);
+}
+
+/**
+ * @brief Runs one command with its sf bit known at compile time.
+ *
+ * Index is the command table slot: function code in bits 0-5, sf in bit 6.
+ * MVMVA reads its other flags from the opcode to pick its own instance.
+ */
+template <uint32_t Index>
+void GTE::command(GTE &gte, uint32_t opcode)
+{
+    constexpr GTEFunction funct = static_cast<GTEFunction>(Index & 0x3F);
+    constexpr bool sf = (Index >> 6) & 1;
+
+    if constexpr (funct == GTEFunction::RTPS) {
+        gte.executeRTPS<sf>();
+    } else if constexpr (funct == GTEFunction::NCLIP) {
+        gte.executeNCLIP();
+    } else if constexpr (funct == GTEFunction::OP) {
+        gte.executeOP<sf>();
+    } else if constexpr (funct == GTEFunction::DPCS) {
+        gte.executeDPCS<sf>();
+    } else if constexpr (funct == GTEFunction::INTPL) {
+        Vector3<int32_t> macs(gte.m_dataReg[9] << 12, gte.m_dataReg[10] << 12, gte.m_dataReg[11] << 12);
+        gte.executeINTPL<sf>(macs);
+    } else if constexpr (funct == GTEFunction::MVMVA) {
+        MVMVA_COMMANDS[mvmvaIndex(opcode)](gte, opcode);
+    } else if constexpr (funct == GTEFunction::NCDS) {
+        gte.executeNCDS<sf>();
+    } else if constexpr (funct == GTEFunction::CDP) {
+        gte.executeCDP<sf>();
+    } else if constexpr (funct == GTEFunction::NCDT) {
+        gte.executeNCDT<sf>();
+    } else if constexpr (funct == GTEFunction::NCCS) {
+        gte.executeNCCS<sf>();
+    } else if constexpr (funct == GTEFunction::CC) {
+        gte.executeCC<sf>();
+    } else if constexpr (funct == GTEFunction::NCS) {
+        gte.executeNCS<sf>();
+    } else if constexpr (funct == GTEFunction::NCT) {
+        gte.executeNCT<sf>();
+    } else if constexpr (funct == GTEFunction::SQR) {
+        gte.executeSQR<sf>();
+    } else if constexpr (funct == GTEFunction::DCPL) {
+        gte.executeDCPL<sf>();
+    } else if constexpr (funct == GTEFunction::DPCT) {
+        gte.executeDPCT<sf>();
+    } else if constexpr (funct == GTEFunction::AVSZ3) {
+        gte.executeAVSZ3();
+    } else if constexpr (funct == GTEFunction::AVSZ4) {
+        gte.executeAVSZ4();
+    } else if constexpr (funct == GTEFunction::RTPT) {
+        gte.executeRTPT<sf>();
+    } else if constexpr (funct == GTEFunction::GPF) {
+        gte.executeGPF<sf>();
+    } else if constexpr (funct == GTEFunction::GPL) {
+        gte.executeGPL<sf, true>();
+    } else if constexpr (funct == GTEFunction::NCCT) {
+        gte.executeNCCT<sf>();
+    } else {
+        unknownCommand(gte, opcode);
     }
 }
 
-void GTE::executeRTPS(uint32_t opcode, uint8_t vectorNumber)
+/**
+ * @brief Runs MVMVA with all of its flags known at compile time.
+ *
+ * Index is the MVMVA table slot: lm in bit 0, then cv, v, mx and sf.
+ */
+template <uint32_t Index>
+void GTE::mvmvaCommand(GTE &gte, uint32_t)
 {
-    Flag f = getFlags(opcode);
-    Vector3<int16_t> V0 = getVector3FromV(vectorNumber);
-    Mat3x3 rotation = getMat3x3FromMX(0);
-    Vector3<int32_t> translation = extractTranslation(5);
+    gte.executeMVMVA<(Index >> 5) & 3, (Index >> 3) & 3, (Index >> 1) & 3, (Index >> 7) & 1, Index & 1>();
+}
 
-    int32_t ofx = m_ctrlReg[24];
-    int32_t ofy = m_ctrlReg[25];
-    int32_t h = m_ctrlReg[26];
+void GTE::unknownCommand(GTE &, uint32_t opcode)
+{
+    spdlog::error("GTE: Unimplemented or unknown instruction function: 0x{:02X}", opcode & 0x3F);
+}
 
-    int64_t mac1 = (translation.x * 0x1000 + (int64_t)rotation.r11 * V0.x + (int64_t)rotation.r12 * V0.y + (int64_t)rotation.r13 * V0.z) >> (f.sf * 12);
-    int64_t mac2 = (translation.y * 0x1000 + (int64_t)rotation.r21 * V0.x + (int64_t)rotation.r22 * V0.y + (int64_t)rotation.r23 * V0.z) >> (f.sf * 12);
-    int64_t mac3 = (translation.z * 0x1000 + (int64_t)rotation.r31 * V0.x + (int64_t)rotation.r32 * V0.y + (int64_t)rotation.r33 * V0.z) >> (f.sf * 12);
+template <std::size_t... Indices>
+constexpr std::array<GTE::Command, sizeof...(Indices)> GTE::makeCommandTable(std::index_sequence<Indices...>)
+{
+    return {&command<Indices>...};
+}
 
-    m_dataReg[25] = static_cast<int32_t>(mac1); // macs
-    m_dataReg[26] = static_cast<int32_t>(mac2);
-    m_dataReg[27] = static_cast<int32_t>(mac3);
+template <std::size_t... Indices>
+constexpr std::array<GTE::Command, sizeof...(Indices)> GTE::makeMvmvaTable(std::index_sequence<Indices...>)
+{
+    return {&mvmvaCommand<Indices>...};
+}
 
-    m_dataReg[9]  = clampMAC(mac1, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 24, 1 << 24); //irs
-    m_dataReg[10] = clampMAC(mac2, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 23, 1 << 23);
-    m_dataReg[11] = clampMAC(mac3, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 22, 1 << 22);
+const std::array<GTE::Command, 128> GTE::COMMANDS = makeCommandTable(std::make_index_sequence<128>());
+const std::array<GTE::Command, 256> GTE::MVMVA_COMMANDS = makeMvmvaTable(std::make_index_sequence<256>());
 
-    m_dataReg[19] = clampMAC(mac3 >> ((1 - f.sf) * 12), 0xFFFF, 0, 1 << 18, 1 << 18); // sz3
-    int32_t projectScale;
-    if (m_dataReg[19] <= h / 2 || m_dataReg[19] <= 0) {
-        m_dataReg[19] = 0;
-        projectScale = 0x1FFFF;
-        m_ctrlReg[31] |= 1 << 31;
-    } else
-        projectScale = clampMAC((((h * 0x20000 / m_dataReg[19]) + 1) / 2), 0x1FFFF, -0x1FFFF , 1 << 17, 1 << 17);
+template <bool Sf>
+void GTE::executeRTPS()
+{
+    executeRTP<1, Sf>();
+}
 
-    int32_t sx2 = clampMAC(static_cast<int16_t>(projectScale * m_dataReg[9] + ofx)/ 0x10000, 0x03FF, -0x0400, 1 << 14, 1 << 14);
-    int32_t sy2 = clampMAC(static_cast<int16_t>(projectScale * m_dataReg[10] + ofy)/ 0x10000, 0x03FF, -0x0400, 1 << 14, 1 << 14);
-    m_dataReg[14] = (sy2 << 16) | (sx2 & 0xFFFF);
-    int32_t dqa = static_cast<int32_t>(m_ctrlReg[27]);
-    int32_t dqb = static_cast<int32_t>(m_ctrlReg[28]);
-    m_dataReg[24] = projectScale * dqa + dqb;
-    m_dataReg[8] = m_dataReg[24] / 0x1000;
+template <bool Sf>
+void GTE::executeRTPT()
+{
+    executeRTP<3, Sf>();
 }
 
-void GTE::executeRTPT(uint32_t opcode)
+/**
+ * @brief Rotates, translates and projects V0 to VCount-1.
+ *
+ * The rotation, translation and projection registers are loaded once for all
+ * the vertices. Each vertex overwrites the results of the previous one, only
+ * the FLAG bits of every vertex add up, exactly as if RTPS ran on each of them.
+ */
+template <int Count, bool Sf>
+void GTE::executeRTP()
 {
-    for (uint8_t i = 0; i < 3; i++)
-        executeRTPS(opcode, i);
+    GteTransform rotation = makeTransform(getMat3x3FromMX(0), extractTranslation(5));
+
+    int32_t ofx = m_ctrlReg[24];
+    int32_t ofy = m_ctrlReg[25];
+    int32_t h = m_ctrlReg[26];
+    int32_t dqa = static_cast<int32_t>(m_ctrlReg[27]);
+    int32_t dqb = static_cast<int32_t>(m_ctrlReg[28]);
+
+    for (int i = 0; i < Count; i++) {
+        Vector3<int64_t> mac = applyTransform(rotation, getVector3FromV(static_cast<uint8_t>(i)), Sf);
+
+        m_dataReg[25] = static_cast<int32_t>(mac.x); // macs
+        m_dataReg[26] = static_cast<int32_t>(mac.y);
+        m_dataReg[27] = static_cast<int32_t>(mac.z);
+
+        m_dataReg[9]  = clampMAC(mac.x, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 24, 1 << 24); //irs
+        m_dataReg[10] = clampMAC(mac.y, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 23, 1 << 23);
+        m_dataReg[11] = clampMAC(mac.z, IR_LIMIT_HIGH, IR_LIMIT_LOW, 1 << 22, 1 << 22);
+
+        m_dataReg[19] = clampMAC(mac.z >> ((1 - Sf) * 12), 0xFFFF, 0, 1 << 18, 1 << 18); // sz3
+        int32_t projectScale;
+        if (m_dataReg[19] <= h / 2 || m_dataReg[19] <= 0) {
+            m_dataReg[19] = 0;
+            projectScale = 0x1FFFF;
+            m_ctrlReg[31] |= 1 << 31;
+        } else
+            projectScale = clampMAC((((h * 0x20000 / m_dataReg[19]) + 1) / 2), 0x1FFFF, -0x1FFFF , 1 << 17, 1 << 17);
+
+        int32_t sx2 = clampMAC(static_cast<int16_t>(projectScale * m_dataReg[9] + ofx)/ 0x10000, 0x03FF, -0x0400, 1 << 14, 1 << 14);
+        int32_t sy2 = clampMAC(static_cast<int16_t>(projectScale * m_dataReg[10] + ofy)/ 0x10000, 0x03FF, -0x0400, 1 << 14, 1 << 14);
+        m_dataReg[14] = (sy2 << 16) | (sx2 & 0xFFFF);
+        m_dataReg[24] = projectScale * dqa + dqb;
+        m_dataReg[8] = m_dataReg[24] / 0x1000;
+    }
 }
 
 void GTE::executeNCLIP()
@@ -306,7 +349,8 @@ void GTE::executeNCLIP()
  * - Stored in the MAC registers (m_dataReg[25–27])
  * - Clamped to 16-bit signed range and stored in IR1–IR3 (m_dataReg[9–11])
  */
-void GTE::executeOP(bool sf) {
+template <bool Sf>
+void GTE::executeOP() {
     // Read IR1, IR2, IR3
     int32_t ir1 = m_dataReg[9];
     int32_t ir2 = m_dataReg[10];
@@ -318,9 +362,9 @@ void GTE::executeOP(bool sf) {
     int16_t d3 = static_cast<int16_t>(m_ctrlReg[4] >> 16); // RT33
 
     // Cross product computation
-    int64_t mac1 = (static_cast<int64_t>(ir3) * d2 - static_cast<int64_t>(ir2) * d3) >> (sf * 12);
-    int64_t mac2 = (static_cast<int64_t>(ir1) * d3 - static_cast<int64_t>(ir3) * d1) >> (sf * 12);
-    int64_t mac3 = (static_cast<int64_t>(ir2) * d1 - static_cast<int64_t>(ir1) * d2) >> (sf * 12);
+    int64_t mac1 = (static_cast<int64_t>(ir3) * d2 - static_cast<int64_t>(ir2) * d3) >> (Sf * 12);
+    int64_t mac2 = (static_cast<int64_t>(ir1) * d3 - static_cast<int64_t>(ir3) * d1) >> (Sf * 12);
+    int64_t mac3 = (static_cast<int64_t>(ir2) * d1 - static_cast<int64_t>(ir1) * d2) >> (Sf * 12);
 
     // Store to MACs
     m_dataReg[25] = static_cast<int32_t>(mac1);
@@ -350,16 +394,17 @@ void GTE::executeOP(bool sf) {
  * After this, each result is clamped to a signed 16-bit integer range (-32768 to 32767)
  * and stored back into the IR1, IR2, and IR3 registers.
  */
-void GTE::executeSQR(bool sf) {
+template <bool Sf>
+void GTE::executeSQR() {
     // Read input vector
     int32_t ir1 = m_dataReg[9];
     int32_t ir2 = m_dataReg[10];
     int32_t ir3 = m_dataReg[11];
 
     // Calculate MACs
-    int64_t mac1 = (static_cast<int64_t>(ir1) * ir1) >> (sf * 12);
-    int64_t mac2 = (static_cast<int64_t>(ir2) * ir2) >> (sf * 12);
-    int64_t mac3 = (static_cast<int64_t>(ir3) * ir3) >> (sf * 12);
+    int64_t mac1 = (static_cast<int64_t>(ir1) * ir1) >> (Sf * 12);
+    int64_t mac2 = (static_cast<int64_t>(ir2) * ir2) >> (Sf * 12);
+    int64_t mac3 = (static_cast<int64_t>(ir3) * ir3) >> (Sf * 12);
 
     // Store MACs
     m_dataReg[25] = static_cast<int32_t>(mac1);
@@ -407,38 +452,37 @@ Vector3<int16_t> GTE::getVector3FromV(uint8_t v)
     return vec;
 }
 
-Flag GTE::getFlags(uint32_t opcode)
+template <uint8_t Mx, uint8_t V, uint8_t Cv, bool Sf, bool Lm>
+void GTE::executeMVMVA()
 {
-    Flag f;
-    f.sf    = (opcode >> 19) & 0x01;   // Shift flag (bit 19)
-    f.mx = (opcode >> 17) & 0x03;   // Mat3x3 selection (bits 18-17)
-    f.cv = (opcode >> 13) & 0x03;   // Translation vector (bits 14-13)
-    f.v  = (opcode >> 15) & 0x03;   // Vector source (bits 16-15)
-    f.lm    = (opcode >> 10) & 0x01;   // Limit mode (bit 10)
-    return f;
-}
-
-void GTE::executeMVMVA(uint32_t opcode)
-{
-    Flag f = getFlags(opcode);
-    Mat3x3 m = getMat3x3FromMX(f.mx);
-    Vector3<int16_t> vec = getVector3FromV(f.v);
-    Vector3<int32_t> translation = extractTranslation(5 + f.cv * 8);
-
-    int64_t mac1, mac2, mac3;
-    int fc = f.cv != 2;
+    GteTransform t = makeTransform(getMat3x3FromMX(Mx), extractTranslation(5 + Cv * 8));
+
+    if constexpr (Cv == 2) {
+        // The far color translation only keeps the last column of the matrix
+        for (int row = 0; row < 3; row++) {
+            t.m[row][0] = 0;
+            t.m[row][1] = 0;
+            t.translation[row] = 0;
+        }
+    }
+    Vector3<int64_t> mac = applyTransform(t, getVector3FromV(V), Sf);
 
-    mac1 = (static_cast<int64_t>(m.r11) * vec.x * fc + static_cast<int64_t>(m.r12) * vec.y * fc + static_cast<int64_t>(m.r13) * vec.z + translation.x * 0x1000 * fc) >> (12 * f.sf);
-    mac2 = (static_cast<int64_t>(m.r21) * vec.x * fc + static_cast<int64_t>(m.r22) * vec.y * fc + static_cast<int64_t>(m.r23) * vec.z + translation.y * 0x1000 * fc) >> (12 * f.sf);
-    mac3 = (static_cast<int64_t>(m.r31) * vec.x * fc + static_cast<int64_t>(m.r32) * vec.y * fc + static_cast<int64_t>(m.r33) * vec.z + translation.z * 0x1000 * fc) >> (12 * f.sf);
+    m_dataReg[25] = static_cast<int32_t>(mac.x);
+    m_dataReg[26] = static_cast<int32_t>(mac.y);
+    m_dataReg[27] = static_cast<int32_t>(mac.z);
 
-    m_dataReg[25] = static_cast<int32_t>(mac1);
-    m_dataReg[26] = static_cast<int32_t>(mac2);
-    m_dataReg[27] = static_cast<int32_t>(mac3);
+    m_dataReg[9]  = clampMAC(mac.x, IR_LIMIT_HIGH, Lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 24, 1 << 24);
+    m_dataReg[10] = clampMAC(mac.y, IR_LIMIT_HIGH, Lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 23, 1 << 23);
+    m_dataReg[11] = clampMAC(mac.z, IR_LIMIT_HIGH, Lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 22, 1 << 22);
+}
 
-    m_dataReg[9]  = clampMAC(mac1, IR_LIMIT_HIGH, f.lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 24, 1 << 24);
-    m_dataReg[10] = clampMAC(mac2, IR_LIMIT_HIGH, f.lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 23, 1 << 23);
-    m_dataReg[11] = clampMAC(mac3, IR_LIMIT_HIGH, f.lm ? IR_LIMIT_MODE : IR_LIMIT_LOW, 1 << 22, 1 << 22);
+GteTransform GTE::makeTransform(const Mat3x3 &m, const Vector3<int32_t> &translation)
+{
+    return {
+        {{m.r11, m.r12, m.r13}, {m.r21, m.r22, m.r23}, {m.r31, m.r32, m.r33}},
+        {static_cast<int64_t>(translation.x) * 0x1000, static_cast<int64_t>(translation.y) * 0x1000,
+         static_cast<int64_t>(translation.z) * 0x1000},
+    };
 }
 
 void GTE::extractMat3x3(int32_t base, Mat3x3 &Mat3x3)
@@ -504,31 +548,32 @@ void GTE::executeAVSZ4() {
     executeAVSZ(4, 21);
 }
 
-void GTE::executeGPF(uint32_t opcode)
+template <bool Sf>
+void GTE::executeGPF()
 {
-    executeGPL(opcode, false);
+    executeGPL<Sf, false>();
 }
 
-void GTE::executeGPL(uint32_t opcode, bool base)
+template <bool Sf, bool Base>
+void GTE::executeGPL()
 {
     int32_t mac1, mac2, mac3;
-    Flag f = getFlags(opcode);
 
-    mac1 = base * (m_dataReg[25] << (f.sf * 12));
-    mac2 = base * (m_dataReg[26] << (f.sf * 12));
-    mac3 = base * (m_dataReg[27] << (f.sf * 12));
+    mac1 = Base * (m_dataReg[25] << (Sf * 12));
+    mac2 = Base * (m_dataReg[26] << (Sf * 12));
+    mac3 = Base * (m_dataReg[27] << (Sf * 12));
 
     int64_t temp_mac = static_cast<int64_t>(m_dataReg[9]) * m_dataReg[8] + mac1;
     checkMACOverflow(0, temp_mac);
-    mac1 = static_cast<int32_t>(temp_mac >> (f.sf * 12));
+    mac1 = static_cast<int32_t>(temp_mac >> (Sf * 12));
 
     temp_mac = static_cast<int64_t>(m_dataReg[10]) * m_dataReg[8] + mac2;
     checkMACOverflow(1, temp_mac);
-    mac2 = static_cast<int32_t>(temp_mac >> (f.sf * 12));
+    mac2 = static_cast<int32_t>(temp_mac >> (Sf * 12));
 
     temp_mac = static_cast<int64_t>(m_dataReg[11]) * m_dataReg[8] + mac3;
     checkMACOverflow(2, temp_mac);
-    mac3 = static_cast<int32_t>(temp_mac >> (f.sf * 12));
+    mac3 = static_cast<int32_t>(temp_mac >> (Sf * 12));
 
     m_dataReg[9] = mac1;
     m_dataReg[10] = mac2;
@@ -546,23 +591,26 @@ void GTE::executeGPL(uint32_t opcode, bool base)
     pushColorFIFO(fifo);
 }
 
-void GTE::executeDCPL(uint32_t opcode)
+template <bool Sf>
+void GTE::executeDCPL()
 {
     Vector3<int32_t> macs((((m_dataReg[6] >> 16) & 0xFF) * m_dataReg[9]) << 4,
                           (((m_dataReg[6] >> 8) & 0xFF) * m_dataReg[10]) << 4,
                           ((m_dataReg[6] & 0xFF) * m_dataReg[11]) << 4);
-    executeINTPL(opcode, macs);
+    executeINTPL<Sf>(macs);
 }
 
-void GTE::executeDPCS(uint32_t opcode)
+template <bool Sf>
+void GTE::executeDPCS()
 {
     Vector3<int32_t> macs(((m_dataReg[6] >> 16) & 0xFF) << 16,
                           ((m_dataReg[6] >> 8) & 0xFF) << 16,
                           (m_dataReg[6] & 0xFF) << 16);
-    executeINTPL(opcode, macs);
+    executeINTPL<Sf>(macs);
 }
 
-void GTE::executeDPCT(uint32_t opcode) {
+template <bool Sf>
+void GTE::executeDPCT() {
     for (int i = 0; i < 3; ++i) {
         Vector3<int32_t> macs(
             ((m_dataReg[20 + i] >> 16) & 0xFF) << 16,
@@ -570,17 +618,16 @@ void GTE::executeDPCT(uint32_t opcode) {
             (m_dataReg[20 + i] & 0xFF) << 16
         );
 
-        executeINTPL(opcode, macs);
+        executeINTPL<Sf>(macs);
     }
 }
 
-void GTE::executeINTPL(uint32_t opcode, Vector3<int32_t> macs)
+template <bool Sf>
+void GTE::executeINTPL(Vector3<int32_t> macs)
 {
-    Flag f = getFlags(opcode);
-
-    macs.x = (macs.x + (m_ctrlReg[21] - macs.x) * m_dataReg[8]) >> (f.sf * 12);
-    macs.y = (macs.y + (m_ctrlReg[22] - macs.y) * m_dataReg[8]) >> (f.sf * 12);
-    macs.z = (macs.z + (m_ctrlReg[23] - macs.z) * m_dataReg[8]) >> (f.sf * 12);
+    macs.x = (macs.x + (m_ctrlReg[21] - macs.x) * m_dataReg[8]) >> (Sf * 12);
+    macs.y = (macs.y + (m_ctrlReg[22] - macs.y) * m_dataReg[8]) >> (Sf * 12);
+    macs.z = (macs.z + (m_ctrlReg[23] - macs.z) * m_dataReg[8]) >> (Sf * 12);
 
     m_dataReg[9] = macs.x;
     m_dataReg[10] = macs.y;
@@ -620,134 +667,142 @@ Rgbc GTE::getRGB0() const {
  * - CC          (Color Color)
  * - CDP         (Color Depth Cue)
  *
- * The computation flow varies based on the `isNormal`, `color`, and `depth` flags:
+ * The computation flow varies based on the `IsNormal`, `Color`, and `Depth` parameters:
  *
- * 1. If `isNormal` is true, the function begins by transforming the normal vector using
+ * 1. If `IsNormal` is true, the function begins by transforming the normal vector using
  *    the light matrix (LLM), as follows:
  *      MAC1 = dot(LLM_row1, Vn) >> (sf * 12)
  *      MAC2 = dot(LLM_row2, Vn) >> (sf * 12)
  *      MAC3 = dot(LLM_row3, Vn) >> (sf * 12)
  *    The results are stored in MAC1–MAC3 (m_dataReg[25–27]) and clamped into IR1–IR3.
  *
- * 2. Regardless of `isNormal`, the next step applies background color and the color matrix (LCM):
+ * 2. Regardless of `IsNormal`, the next step applies background color and the color matrix (LCM):
  *      MAC = BK * 0x1000 + LCM * IR
  *      IR = MAC >> (sf * 12)
  *    Where BK is extracted from ctrlReg[6–8], and LCM is from ctrlReg[3–5].
  *    The results are written to MAC1–MAC3 and IR1–IR3.
  *
- * 3. If `color` or `depth` is true (NCCx/NCDx/CC/CDP), the function performs:
+ * 3. If `Color` or `Depth` is true (NCCx/NCDx/CC/CDP), the function performs:
  *      MAC = FC_component * IR_component << 4
- *    If `depth` is true (NCDx/CDP), then linear interpolation is applied using IR0:
+ *    If `Depth` is true (NCDx/CDP), then linear interpolation is applied using IR0:
  *      MAC = MAC + (FarColor - MAC) * IR0
  *    Then the MAC values are right-shifted by (sf * 12) and clamped into IR1–IR3.
  *
  * 4. The final RGB color is pushed to the color FIFO, packed from IR1–IR3 (upper 8 bits),
  *    and the original code field (m_dataReg[2]) is preserved in the 4th byte.
+ *
+ * The triple commands run these steps on V0 to V2 in turn. LLM, LCM, BK and FC are
+ * loaded once for the three vectors and only the last one's results reach the registers.
  */
-void GTE::executeNColor(const Vector3<int16_t>& normal, bool sf, bool isNormal, bool color, bool depth) {
-    if (isNormal) {
-        // Step 1: Multiply Light Matrix (LLM) with Normal vector V0
-        int64_t mac1 = dotProductMatrixRow(m_ctrlReg.data(), 0, normal) >> (sf * 12);
-        int64_t mac2 = dotProductMatrixRow(m_ctrlReg.data(), 1, normal) >> (sf * 12);
-        int64_t mac3 = dotProductMatrixRow(m_ctrlReg.data(), 2, normal) >> (sf * 12);
-
-        m_dataReg[25] = static_cast<int32_t>(mac1); // MAC 1
-        m_dataReg[26] = static_cast<int32_t>(mac2); // MAC 2
-        m_dataReg[27] = static_cast<int32_t>(mac3); // MAC 3
-
-        m_dataReg[9]  = clampMAC(mac1, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001); // IR 1
-        m_dataReg[10] = clampMAC(mac2, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002); // IR 2
-        m_dataReg[11] = clampMAC(mac3, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004); // IR 3
-    }
-
-    // Step 2: Background + (ColorMatrix * IR)
-    Vector3<int64_t> intermediate;
-    intermediate.x = static_cast<int64_t>(extractSigned16(m_ctrlReg[6], false)) << 12;
-    intermediate.y = static_cast<int64_t>(extractSigned16(m_ctrlReg[7], false)) << 12;
-    intermediate.z = static_cast<int64_t>(extractSigned16(m_ctrlReg[8], false)) << 12;
-
-    intermediate.x += dotProductMatrixRow(m_ctrlReg.data(), 3, getIRVector());
-    intermediate.y += dotProductMatrixRow(m_ctrlReg.data(), 4, getIRVector());
-    intermediate.z += dotProductMatrixRow(m_ctrlReg.data(), 5, getIRVector());
-
-    intermediate.x >>= (sf * 12);
-    intermediate.y >>= (sf * 12);
-    intermediate.z >>= (sf * 12);
-
-    m_dataReg[25] = static_cast<int32_t>(intermediate.x); // MAC 1
-    m_dataReg[26] = static_cast<int32_t>(intermediate.y); // MAC 2
-    m_dataReg[27] = static_cast<int32_t>(intermediate.z); // MAC 3
-
-    m_dataReg[9]  = clampMAC(intermediate.x, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001); // IR 1
-    m_dataReg[10] = clampMAC(intermediate.y, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002); // IR 2
-    m_dataReg[11] = clampMAC(intermediate.z, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004); // IR 3
-
-    // Step 3 & 4: Multiply by FC and optionally interpolate with IR0
-    if (color || depth)
-    {
-        int64_t r = static_cast<int64_t>(extractSigned16(m_dataReg[0], false)) * m_dataReg[9];
-        int64_t g = static_cast<int64_t>(extractSigned16(m_dataReg[0], true))  * m_dataReg[10];
-        int64_t b = static_cast<int64_t>(extractSigned16(m_dataReg[1], false)) * m_dataReg[11];
-
-        r <<= 4;
-        g <<= 4;
-        b <<= 4;
+template <int Count, bool Sf, bool IsNormal, bool Color, bool Depth>
+void GTE::executeNColor() {
+    GteTransform light = getRegisterTransform(0);
+    GteTransform lightColor = getRegisterTransform(3);
+    lightColor.translation[0] = static_cast<int64_t>(extractSigned16(m_ctrlReg[6], false)) << 12;
+    lightColor.translation[1] = static_cast<int64_t>(extractSigned16(m_ctrlReg[7], false)) << 12;
+    lightColor.translation[2] = static_cast<int64_t>(extractSigned16(m_ctrlReg[8], false)) << 12;
+
+    int64_t fcR = extractSigned16(m_dataReg[0], false);
+    int64_t fcG = extractSigned16(m_dataReg[0], true);
+    int64_t fcB = extractSigned16(m_dataReg[1], false);
+    int32_t ir0 = extractSigned16(m_dataReg[1], true);
+    uint8_t c = static_cast<uint8_t>(m_dataReg[2] & 0xFF); // CODE is the upper 8 bits of RGBC?
 
-        if (depth)
+    // Intermediate MACs and IRs stay in locals, the registers only get the
+    // last values while the FLAG bits of every step add up
+    for (int i = 0; i < Count; i++) {
+        Vector3<int16_t> ir;
+        if constexpr (IsNormal) {
+            // Step 1: Multiply Light Matrix (LLM) with Normal vector Vi
+            Vector3<int64_t> mac = applyTransform(light, getVector3FromV(static_cast<uint8_t>(i)), Sf);
+
+            ir.x = static_cast<int16_t>(clampMAC(mac.x, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001)); // IR 1
+            ir.y = static_cast<int16_t>(clampMAC(mac.y, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002)); // IR 2
+            ir.z = static_cast<int16_t>(clampMAC(mac.z, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004)); // IR 3
+        } else
+            ir = getIRVector();
+
+        // Step 2: Background + (ColorMatrix * IR)
+        Vector3<int64_t> intermediate = applyTransform(lightColor, ir, Sf);
+
+        int32_t mac1 = static_cast<int32_t>(intermediate.x);
+        int32_t mac2 = static_cast<int32_t>(intermediate.y);
+        int32_t mac3 = static_cast<int32_t>(intermediate.z);
+
+        int32_t ir1 = clampMAC(intermediate.x, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001); // IR 1
+        int32_t ir2 = clampMAC(intermediate.y, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002); // IR 2
+        int32_t ir3 = clampMAC(intermediate.z, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004); // IR 3
+
+        // Step 3 & 4: Multiply by FC and optionally interpolate with IR0
+        if constexpr (Color || Depth)
         {
-            int32_t ir0 = extractSigned16(m_dataReg[1], true);
-            r = r + ((m_dataReg[9] - r) * ir0);
-            g = g + ((m_dataReg[10] - g) * ir0);
-            b = b + ((m_dataReg[11] - b) * ir0);
+            int64_t r = fcR * ir1;
+            int64_t g = fcG * ir2;
+            int64_t b = fcB * ir3;
+
+            r <<= 4;
+            g <<= 4;
+            b <<= 4;
+
+            if constexpr (Depth)
+            {
+                r = r + ((ir1 - r) * ir0);
+                g = g + ((ir2 - g) * ir0);
+                b = b + ((ir3 - b) * ir0);
+            }
+
+            r >>= (Sf * 12);
+            g >>= (Sf * 12);
+            b >>= (Sf * 12);
+
+            mac1 = static_cast<int32_t>(r); // MAC 1
+            mac2 = static_cast<int32_t>(g); // MAC 2
+            mac3 = static_cast<int32_t>(b); // MAC 3
+
+            // Only the FLAG bits are kept, IR1–IR3 are overwritten below
+            clampMAC(r, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001); // IR 1
+            clampMAC(g, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002); // IR 2
+            clampMAC(b, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004); // IR 3
         }
 
-        r >>= (sf * 12);
-        g >>= (sf * 12);
-        b >>= (sf * 12);
-
-        m_dataReg[25] = static_cast<int32_t>(r); // MAC 1
-        m_dataReg[26] = static_cast<int32_t>(g); // MAC 2
-        m_dataReg[27] = static_cast<int32_t>(b); // MAC 3
+        // Final Step: Write to Color FIFO and IR
+        uint8_t r = clampMAC(mac1 >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 21, 1 << 21);
+        uint8_t g = clampMAC(mac2 >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 20, 1 << 20);
+        uint8_t b = clampMAC(mac3 >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 19, 1 << 19);
 
-        m_dataReg[9]  = clampMAC(r, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0001, 0x0001); // IR 1
-        m_dataReg[10] = clampMAC(g, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0002, 0x0002); // IR 2
-        m_dataReg[11] = clampMAC(b, IR_LIMIT_HIGH, IR_LIMIT_LOW, 0x0004, 0x0004); // IR 3
-    }
-
-    // Final Step: Write to Color FIFO and IR
-    uint8_t r = clampMAC(m_dataReg[25] >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 21, 1 << 21);
-    uint8_t g = clampMAC(m_dataReg[26] >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 20, 1 << 20);
-    uint8_t b = clampMAC(m_dataReg[27] >> 4, FIFO_LIMIT_HIGH, FIFO_LIMIT_LOW, 1 << 19, 1 << 19);
-    uint8_t c = static_cast<uint8_t>(m_dataReg[2] & 0xFF); // CODE is the upper 8 bits of RGBC?
+        Rgbc fifo = { r, g, b, c };
+        m_dataReg[20] = (fifo.c << 24) | (fifo.r << 16) | (fifo.g << 8) | fifo.b;
 
-    Rgbc fifo = { r, g, b, c };
-    m_dataReg[20] = (fifo.c << 24) | (fifo.r << 16) | (fifo.g << 8) | fifo.b;
+        m_dataReg[25] = mac1; // MAC 1
+        m_dataReg[26] = mac2; // MAC 2
+        m_dataReg[27] = mac3; // MAC 3
 
-    // And store IR1–IR3 = MAC1–MAC3 (used later)
-    m_dataReg[9]  = m_dataReg[25];
-    m_dataReg[10] = m_dataReg[26];
-    m_dataReg[11] = m_dataReg[27];
+        // And store IR1–IR3 = MAC1–MAC3 (used later)
+        m_dataReg[9]  = mac1;
+        m_dataReg[10] = mac2;
+        m_dataReg[11] = mac3;
+    }
 }
 
 /**
- * @brief Computes a dot product between a matrix row from GTE control registers and a 3D vector.
+ * @brief Loads a matrix from GTE control registers.
  *
  * The GTE stores 3x3 matrices (like the Light matrix or Color matrix) across consecutive control
  * registers. Each row spans three 32-bit registers, with the relevant signed 16-bit values stored
  * in the lower half of each register.
  *
- * This function extracts one matrix row by selecting three registers (row * 3 + offset) and
- * retrieving their lower 16-bit signed values. It then computes the dot product between this
- * row and the given vector:
- *
- *     result = Mx * Vx + My * Vy + Mz * Vz
- *
+ * The matrix is loaded once per command, the triple commands then apply it to all of their
+ * vectors without going back to the registers.
  */
-int64_t GTE::dotProductMatrixRow(const int32_t* reg, int row, const Vector3<int16_t>& vec) {
-    int32_t x = static_cast<int32_t>(extractSigned16(reg[row * 3 + 0], false));
-    int32_t y = static_cast<int32_t>(extractSigned16(reg[row * 3 + 1], false));
-    int32_t z = static_cast<int32_t>(extractSigned16(reg[row * 3 + 2], false));
-    return static_cast<int64_t>(x) * vec.x + static_cast<int64_t>(y) * vec.y + static_cast<int64_t>(z) * vec.z;
+GteTransform GTE::getRegisterTransform(int firstRow) {
+    GteTransform t;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            t.m[row][column] = extractSigned16(m_ctrlReg[(firstRow + row) * 3 + column], false);
+        }
+        t.translation[row] = 0;
+    }
+    return t;
 }
 
 Vector3<int16_t> GTE::getIRVector() {
@@ -758,42 +813,44 @@ Vector3<int16_t> GTE::getIRVector() {
     return vec;
 }
 
-void GTE::executeNCS(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, false, false);
+template <bool Sf>
+void GTE::executeNCS() {
+    executeNColor<1, Sf, true, false, false>();
 }
 
-void GTE::executeNCT(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, false, false);
-    executeNColor(getVector3FromV(1), sf, true, false, false);
-    executeNColor(getVector3FromV(2), sf, true, false, false);
+template <bool Sf>
+void GTE::executeNCT() {
+    executeNColor<3, Sf, true, false, false>();
 }
 
-void GTE::executeNCCS(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, true, false);
+template <bool Sf>
+void GTE::executeNCCS() {
+    executeNColor<1, Sf, true, true, false>();
 }
 
-void GTE::executeNCCT(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, true, false);
-    executeNColor(getVector3FromV(1), sf, true, true, false);
-    executeNColor(getVector3FromV(2), sf, true, true, false);
+template <bool Sf>
+void GTE::executeNCCT() {
+    executeNColor<3, Sf, true, true, false>();
 }
 
-void GTE::executeNCDS(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, false, true);
+template <bool Sf>
+void GTE::executeNCDS() {
+    executeNColor<1, Sf, true, false, true>();
 }
 
-void GTE::executeNCDT(bool sf) {
-    executeNColor(getVector3FromV(0), sf, true, false, true);
-    executeNColor(getVector3FromV(1), sf, true, false, true);
-    executeNColor(getVector3FromV(2), sf, true, false, true);
+template <bool Sf>
+void GTE::executeNCDT() {
+    executeNColor<3, Sf, true, false, true>();
 }
 
-void GTE::executeCC(bool sf) {
-    executeNColor(getVector3FromV(0), sf, false, true, false);
+template <bool Sf>
+void GTE::executeCC() {
+    executeNColor<1, Sf, false, true, false>();
 }
 
-void GTE::executeCDP(bool sf) {
-    executeNColor(getVector3FromV(0), sf, false, false, true);
+template <bool Sf>
+void GTE::executeCDP() {
+    executeNColor<1, Sf, false, false, true>();
 }
 
 void GTE::checkMACOverflow(int macIndex, int64_t value) {
@@ -8,8 +8,10 @@
 #ifndef GTE_HPP_
 #define GTE_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <array>
+#include <utility>
 #include "Instruction.h"
 #include "Coprocessor.hpp"
 
@@ -58,6 +60,13 @@ struct Mat3x3
 	int16_t r33;
 };
 
+// Matrix and translation of a command, loaded once and shared by all its vectors
+struct GteTransform
+{
+	int32_t m[3][3];
+	int64_t translation[3]; // Already scaled by 0x1000
+};
+
 /**
  * @class GTE
  * @brief Geometry Transformation Engine (Coprocessor 2) emulation for the PlayStation.
@@ -65,7 +74,7 @@ struct Mat3x3
  * The GTE is a fixed-point math coprocessor designed for 3D transformation and lighting
  * operations. This class provides emulated support for key instructions such as RTPS and RTPT.
  */
-class GTE : public Coprocessor {
+class GTE final : public Coprocessor {
     public:
         GTE();
 
@@ -80,6 +89,13 @@ class GTE : public Coprocessor {
          */
         void execute(uint32_t opcode) override;
 
+        /**
+         * @brief Number of CPU cycles a GTE command keeps the GTE busy.
+         * @param opcode 32-bit encoded instruction.
+         * @return Cycles before the results can be read, 0 for unknown commands.
+         */
+        static uint32_t commandCycles(uint32_t opcode);
+
         /**
          * @brief Move to Coprocessor Data Register (MTC2).
          * @param reg Register index.
@@ -164,18 +180,58 @@ class GTE : public Coprocessor {
          */
         void decodeAndExecute(uint32_t opcode);
 
+        // Command instance with its flag bits fixed at compile time
+        using Command = void (*)(GTE &gte, uint32_t opcode);
+
+        /**
+         * @brief Slot of an opcode in COMMANDS: function code in bits 0-5, sf in bit 6.
+         */
+        static constexpr uint32_t commandIndex(uint32_t opcode) {
+            return (opcode & 0x3F) | ((opcode >> 13) & 0x40);
+        }
+
+        /**
+         * @brief Slot of an MVMVA opcode in MVMVA_COMMANDS: lm in bit 0, then cv, v, mx and sf.
+         */
+        static constexpr uint32_t mvmvaIndex(uint32_t opcode) {
+            return ((opcode >> 10) & 0x01) | ((opcode >> 12) & 0xFE);
+        }
+
+        template <uint32_t Index>
+        static void command(GTE &gte, uint32_t opcode);
+        template <uint32_t Index>
+        static void mvmvaCommand(GTE &gte, uint32_t opcode);
+        static void unknownCommand(GTE &gte, uint32_t opcode);
+
+        template <std::size_t... Indices>
+        static constexpr std::array<Command, sizeof...(Indices)> makeCommandTable(std::index_sequence<Indices...>);
+        template <std::size_t... Indices>
+        static constexpr std::array<Command, sizeof...(Indices)> makeMvmvaTable(std::index_sequence<Indices...>);
+
+        static const std::array<Command, 128> COMMANDS;
+        static const std::array<Command, 256> MVMVA_COMMANDS;
+
         /**
          * @brief Executes the RTPS instruction (Rotate, Translate, Perspective Single).
-         * @param opcode to get flags from
-         * @param vectorNumber to choose value from
+         * @tparam Sf shift flag of the opcode
          */
-        void executeRTPS(uint32_t opcode, uint8_t vectorNumber);
+        template <bool Sf>
+        void executeRTPS();
 
         /**
          * @brief Executes the RTPT instruction (Rotate, Translate, Perspective Triple).
-         * @param opcode to get flags from
+         * @tparam Sf shift flag of the opcode
+         */
+        template <bool Sf>
+        void executeRTPT();
+
+        /**
+         * @brief Shared by RTPS and RTPT, transforms and projects V0 to VCount-1.
+         * @tparam Count number of vertices
+         * @tparam Sf shift flag of the opcode
          */
-        void executeRTPT(uint32_t opcode);
+        template <int Count, bool Sf>
+        void executeRTP();
 
         /**
          * @brief Execute the NCLIP instruction (normal clipping)
@@ -185,12 +241,14 @@ class GTE : public Coprocessor {
         /**
          * @brief Executes SQR (Square Vector) instruction.
          */
-        void executeSQR(bool sf);
+        template <bool Sf>
+        void executeSQR();
 
         /**
          * @brief Executes OP (Cross product of 2 vectors) instruction.
          */
-        void executeOP(bool sf);
+        template <bool Sf>
+        void executeOP();
 
         /**
          * @brief Third party function to simplify AVSZ3 and AVSZ4. Computes the average
@@ -204,9 +262,14 @@ class GTE : public Coprocessor {
         // General Purpose Commands
         /**
          * @brief Executes MVMVA (Multiply vector by Mat3x3 and vector addition) instruction.
-         * @param opcode flag used in the instuction are extracted from the opcode
+         * @tparam Mx matrix, Rotation, Light, Color or the garbage matrix
+         * @tparam V vector, V0 to V2 or IR
+         * @tparam Cv translation, TR, BK, FC or none
+         * @tparam Sf shift flag
+         * @tparam Lm clamp IRs to 0 instead of -0x8000
          */
-        void executeMVMVA(uint32_t opcode);
+        template <uint8_t Mx, uint8_t V, uint8_t Cv, bool Sf, bool Lm>
+        void executeMVMVA();
 
         /**
          * @brief Executes AVSZ3 (Average of Z values) instruction.
@@ -220,42 +283,63 @@ class GTE : public Coprocessor {
 
         /**
          * @brief Execute GPF (General purpose Interpolation)
-         * @param opcode opcode to extract flag from
+         * @tparam Sf shift flag of the opcode
          */
-        void executeGPF(uint32_t opcode);
+        template <bool Sf>
+        void executeGPF();
 
         /**
          * @brief Execute GPL (General Interpolation with base)
-         * @param opcode opcode to extract flag from
-         * @param MAC is a base or not
+         * @tparam Sf shift flag of the opcode
+         * @tparam Base MAC is a base or not
          */
-        void executeGPL(uint32_t opcode, bool base);
+        template <bool Sf, bool Base>
+        void executeGPL();
 
-        void executeDCPL(uint32_t opcode);
-        void executeDPCS(uint32_t opcode);
-        void executeDPCT(uint32_t opcode);
-        void executeINTPL(uint32_t opcode, Vector3<int32_t> macs);
+        template <bool Sf>
+        void executeDCPL();
+        template <bool Sf>
+        void executeDPCS();
+        template <bool Sf>
+        void executeDPCT();
+        template <bool Sf>
+        void executeINTPL(Vector3<int32_t> macs);
 
         /**
          * @brief Third party function to process the pipeline of all Color functions
          *        of the GTE. More details on how it operates in cpp file
          *
-         * @param normal The input normal vector (ignored if isNormal is false).
-         * @param sf     Shift flag: if true, right shift results by 12 (SAR 12).
-         * @param isNormal Whether to perform the lighting (LLM * normal) step.
-         * @param color  Whether to apply FarColor multiplication (NCCx, CC).
-         * @param depth  Whether to apply depth cue interpolation (NCDx, CDP).
+         * @tparam Count Number of vectors, 1 for single and 3 for triple commands.
+         * @tparam Sf     Shift flag: if true, right shift results by 12 (SAR 12).
+         * @tparam IsNormal Whether to perform the lighting (LLM * normal) step.
+         * @tparam Color  Whether to apply FarColor multiplication (NCCx, CC).
+         * @tparam Depth  Whether to apply depth cue interpolation (NCDx, CDP).
+         */
+        template <int Count, bool Sf, bool IsNormal, bool Color, bool Depth>
+        void executeNColor();
+
+        /**
+         * @brief Builds a transform from a matrix and an unscaled translation.
+         */
+        static GteTransform makeTransform(const Mat3x3 &m, const Vector3<int32_t> &translation);
+
+        /**
+         * @brief Loads the matrix whose rows start at control register firstRow * 3.
+         * @param firstRow Index of the first matrix row (0 for LLM, 3 for LCM).
+         * @return The transform, with a null translation.
          */
-        void executeNColor(const Vector3<int16_t>& normal, bool sf, bool isNormal, bool color, bool depth);
+        GteTransform getRegisterTransform(int firstRow);
 
         /**
-         * @brief Computes the dot product between a matrix row and a vector.
-         * @param reg Pointer to the register array (typically m_ctrlReg).
-         * @param row Index of the matrix row (0–5).
-         * @param vec The 3D input vector.
-         * @return The 64-bit result of the dot product.
+         * @brief Computes (translation + M * vec) >> (sf * 12) for the three rows.
          */
-        int64_t dotProductMatrixRow(const int32_t* reg, int row, const Vector3<int16_t>& vec);
+        static Vector3<int64_t> applyTransform(const GteTransform &t, const Vector3<int16_t> &vec, bool sf) {
+            Vector3<int64_t> mac;
+            mac.x = (t.translation[0] + static_cast<int64_t>(t.m[0][0]) * vec.x + static_cast<int64_t>(t.m[0][1]) * vec.y + static_cast<int64_t>(t.m[0][2]) * vec.z) >> (sf * 12);
+            mac.y = (t.translation[1] + static_cast<int64_t>(t.m[1][0]) * vec.x + static_cast<int64_t>(t.m[1][1]) * vec.y + static_cast<int64_t>(t.m[1][2]) * vec.z) >> (sf * 12);
+            mac.z = (t.translation[2] + static_cast<int64_t>(t.m[2][0]) * vec.x + static_cast<int64_t>(t.m[2][1]) * vec.y + static_cast<int64_t>(t.m[2][2]) * vec.z) >> (sf * 12);
+            return mac;
+        }
 
         /**
          * @brief Retrieves the current IR (intermediate result) vector from GTE data registers.
@@ -266,42 +350,50 @@ class GTE : public Coprocessor {
         /**
          * @brief Executes NCS (Normal color single) instruction.
          */
-        void executeNCS(bool sf);
+        template <bool Sf>
+        void executeNCS();
 
         /**
          * @brief Executes NCT (Normal color triple) instruction.
          */
-        void executeNCT(bool sf);
+        template <bool Sf>
+        void executeNCT();
 
         /**
          * @brief Executes NCCS (Normal Color Color Single) instruction.
          */
-        void executeNCCS(bool sf);
+        template <bool Sf>
+        void executeNCCS();
 
         /**
          * @brief Executes NCCT (Normal Color Color Triple) instruction.
          */
-        void executeNCCT(bool sf);
+        template <bool Sf>
+        void executeNCCT();
 
         /**
          * @brief Executes NCDS (Normal color depth cue single) instruction.
          */
-        void executeNCDS(bool sf);
+        template <bool Sf>
+        void executeNCDS();
 
         /**
          * @brief Executes NCDT (Normal color depth cue triple) instruction.
          */
-        void executeNCDT(bool sf);
+        template <bool Sf>
+        void executeNCDT();
 
         /**
          * @brief Executes CC (Color Color) instruction.
          */
-        void executeCC(bool sf);
+        template <bool Sf>
+        void executeCC();
 
         /**
          * @brief Executes CDP (Color Depth Que) instruction.
          */
-        void executeCDP(bool sf);
+        template <bool Sf>
+        void executeCDP();
 
         // Internal helper functions
         /**
@@ -332,13 +424,6 @@ class GTE : public Coprocessor {
          * @return Extracted signed value.
          */
 
-        /**
-         * @brief get all the Flags from the op code
-         * @param opcode opcode to get flages from
-         * @return flag struct with the extracted flags
-         */
-		Flag getFlags(uint32_t opcode);
-
         /**
          * @brief get Mat3x3 depending of MX flag
          * @param mx mx flag
@@ -28,6 +28,7 @@ enum class PrimaryOpCode
     XORI = 0x0E,
     LUI = 0x0F,
     COP0 = 0x10,
+    COP2 = 0x12,
     LB = 0x20,
     LH = 0x21,
     LWL = 0x22,
@@ -40,6 +41,8 @@ enum class PrimaryOpCode
     SWL = 0x2A,
     SW = 0x2B,
     SWR = 0x2E,
+    LWC2 = 0x32,
+    SWC2 = 0x3A,
     SLTI = 0x0A,
     SLTIU = 0x0B,
 };
@@ -91,6 +94,7 @@ enum class CoprocessorOpcode
     MFC = 0b0,
     CFC = 0b01,
     MTC = 0b100,
+    CTC = 0b110,
     BC = 0b1000,
     IMM25 = 0b10000
 };
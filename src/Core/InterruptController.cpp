@@ -2,9 +2,11 @@
 #include "StateBuffer.hpp"
 
 #include <spdlog/spdlog.h>
+#include <bit>
 
 #include "MemoryMap.hpp"
 #include "Bus.hpp"
+#include "Log.hpp"
 #include "CPU.hpp"
 
 InterruptController::InterruptController(Bus *bus) :
@@ -20,7 +22,7 @@ InterruptController::~InterruptController()
 
 void InterruptController::write8(uint8_t value, uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Write byte 0x{:02X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Write byte 0x{:02X} to 0x{:08X}", value, address);
     uint8_t offset = address & 0x7;
 
     switch (offset)
@@ -42,7 +44,7 @@ void InterruptController::write8(uint8_t value, uint32_t address)
 
 void InterruptController::write16(uint16_t value, uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Write halfword 0x{:04X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Write halfword 0x{:04X} to 0x{:08X}", value, address);
     uint8_t offset = address & 0x7;
 
     switch (offset)
@@ -60,7 +62,7 @@ void InterruptController::write16(uint16_t value, uint32_t address)
 
 void InterruptController::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Write word 0x{:08X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Write word 0x{:08X} to 0x{:08X}", value, address);
     uint8_t offset = address & 0x7;
 
     switch (offset)
@@ -76,7 +78,7 @@ void InterruptController::write32(uint32_t value, uint32_t address)
 
 uint8_t InterruptController::read8(uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Read byte at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Read byte at 0x{:08X}", address);
     uint8_t offset = address & 0x7;
     switch (offset)
     {
@@ -96,7 +98,7 @@ uint8_t InterruptController::read8(uint32_t address)
 
 uint16_t InterruptController::read16(uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Read halfword at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Read halfword at 0x{:08X}", address);
     uint8_t offset = address & 0x7;
     switch (offset)
     {
@@ -112,7 +114,7 @@ uint16_t InterruptController::read16(uint32_t address)
 
 uint32_t InterruptController::read32(uint32_t address)
 {
-    spdlog::trace("IRQ Controller: Read word at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::InterruptController, "IRQ Controller: Read word at 0x{:08X}", address);
     uint8_t offset = address & 0x7;
 
     switch (offset)
@@ -145,6 +147,9 @@ void InterruptController::deserialize(StateBuffer &buf)
 void InterruptController::triggerIRQ(DeviceIRQ device)
 {
     m_istat |= static_cast<uint32_t>(device);
+    if (auto perf = perfCounters()) {
+        perf->frame().irqs[std::countr_zero(static_cast<uint32_t>(device))]++;
+    }
     setCpuIrqPending(irqPending());
 }
 
@@ -0,0 +1,74 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** Log
+*/
+
+#include "Log.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include "TraceRing.hpp"
+
+static const char *const SUBSYSTEM_NAMES[LOG_SUBSYSTEM_COUNT] = {
+    "gpu", "dma", "timers", "irqc", "memctrl", "cachectrl", "spu"
+};
+
+// Every subsystem is off until asked for
+std::atomic<uint32_t> Log::s_mask = 0;
+std::atomic<TraceRing *> Log::s_ring = nullptr;
+
+void Log::enable(LogSubsystem subsystem, bool enable)
+{
+    if (enable) {
+        s_mask.fetch_or(bit(subsystem), std::memory_order_relaxed);
+    } else {
+        s_mask.fetch_and(~bit(subsystem), std::memory_order_relaxed);
+    }
+}
+
+void Log::write(int level, LogSubsystem subsystem, std::string_view message)
+{
+    TraceRing *ring = traceRing();
+
+    if (ring) {
+        ring->push(subsystem, message);
+    } else {
+        spdlog::log(static_cast<spdlog::level::level_enum>(level), "{}", message);
+    }
+}
+
+bool Log::enableByName(std::string_view names)
+{
+    uint32_t mask = 0;
+
+    while (!names.empty()) {
+        size_t comma = names.find(',');
+        std::string_view name = names.substr(0, comma);
+        names = comma == std::string_view::npos ? std::string_view() : names.substr(comma + 1);
+        if (name.empty()) {
+            continue;
+        }
+        if (name == "all") {
+            mask = (1u << LOG_SUBSYSTEM_COUNT) - 1;
+            continue;
+        }
+        auto it = std::find(std::begin(SUBSYSTEM_NAMES), std::end(SUBSYSTEM_NAMES), name);
+        if (it == std::end(SUBSYSTEM_NAMES)) {
+            spdlog::error("Log: Unknown subsystem \"{}\"", name);
+            return false;
+        }
+        mask |= bit(static_cast<LogSubsystem>(it - std::begin(SUBSYSTEM_NAMES)));
+    }
+    if (mask && ROGEM_LOG_LEVEL > ROGEM_LOG_LEVEL_TRACE) {
+        spdlog::warn("Log: Trace messages are compiled out of this build, see ROGEM_LOG_LEVEL");
+    }
+    setMask(mask);
+    return true;
+}
+
+const char *Log::subsystemName(LogSubsystem subsystem)
+{
+    return SUBSYSTEM_NAMES[static_cast<size_t>(subsystem)];
+}
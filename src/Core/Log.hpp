@@ -0,0 +1,102 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** Log
+*/
+
+#ifndef LOG_HPP_
+#define LOG_HPP_
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// Same values as spdlog::level
+#define ROGEM_LOG_LEVEL_TRACE 0
+#define ROGEM_LOG_LEVEL_DEBUG 1
+#define ROGEM_LOG_LEVEL_INFO 2
+#define ROGEM_LOG_LEVEL_WARN 3
+#define ROGEM_LOG_LEVEL_ERROR 4
+#define ROGEM_LOG_LEVEL_OFF 6
+
+// Lowest level compiled in, set by the ROGEM_LOG_LEVEL CMake option
+#ifndef ROGEM_LOG_LEVEL
+#define ROGEM_LOG_LEVEL ROGEM_LOG_LEVEL_TRACE
+#endif
+
+class TraceRing;
+
+// Emulated parts the trace messages can be enabled for
+enum class LogSubsystem : uint8_t
+{
+    Gpu,
+    Dma,
+    Timers,
+    InterruptController,
+    MemoryControl,
+    CacheControl,
+    Spu,
+    Count
+};
+
+static constexpr size_t LOG_SUBSYSTEM_COUNT = static_cast<size_t>(LogSubsystem::Count);
+
+// Logging for the device register accesses. The messages below the compiled
+// level disappear from the build, the others cost a single test of the
+// subsystem mask, their arguments are only evaluated once it passed. Enabled
+// messages go to the installed trace ring, or to spdlog when there is none.
+class Log
+{
+    public:
+        static bool enabled(LogSubsystem subsystem)
+        {
+            return s_mask.load(std::memory_order_relaxed) & bit(subsystem);
+        }
+        static void enable(LogSubsystem subsystem, bool enable = true);
+        static void setMask(uint32_t mask) { s_mask.store(mask, std::memory_order_relaxed); }
+        static uint32_t mask() { return s_mask.load(std::memory_order_relaxed); }
+        static constexpr uint32_t bit(LogSubsystem subsystem) { return 1u << static_cast<uint32_t>(subsystem); }
+        // Enables a comma separated list of subsystem names, or "all", and
+        // disables the others. Returns false on an unknown name.
+        static bool enableByName(std::string_view names);
+
+        // The ring must outlive its installation, nullptr goes back to spdlog
+        static void setTraceRing(TraceRing *ring) { s_ring.store(ring, std::memory_order_release); }
+        static TraceRing *traceRing() { return s_ring.load(std::memory_order_acquire); }
+
+        template<typename... Args>
+        static void write(int level, LogSubsystem subsystem, fmt::format_string<Args...> format, Args &&...args)
+        {
+            char buffer[MESSAGE_SIZE];
+            auto result = fmt::format_to_n(buffer, sizeof(buffer), format, std::forward<Args>(args)...);
+            write(level, subsystem, std::string_view(buffer, std::min(result.size, sizeof(buffer))));
+        }
+        static void write(int level, LogSubsystem subsystem, std::string_view message);
+
+        static const char *subsystemName(LogSubsystem subsystem);
+
+    private:
+        static constexpr size_t MESSAGE_SIZE = 128;
+
+        static std::atomic<uint32_t> s_mask;
+        static std::atomic<TraceRing *> s_ring;
+};
+
+#define ROGEM_LOG(level, subsystem, ...) \
+    do { \
+        if constexpr (ROGEM_LOG_LEVEL <= (level)) { \
+            if (Log::enabled(subsystem)) [[unlikely]] { \
+                Log::write(level, subsystem, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define ROGEM_TRACE(subsystem, ...) ROGEM_LOG(ROGEM_LOG_LEVEL_TRACE, subsystem, __VA_ARGS__)
+#define ROGEM_DEBUG(subsystem, ...) ROGEM_LOG(ROGEM_LOG_LEVEL_DEBUG, subsystem, __VA_ARGS__)
+
+#endif /* !LOG_HPP_ */
@@ -7,6 +7,8 @@
 
 #include "Memory.hpp"
 
+#include <bit>
+
 #include "Bus.hpp"
 
 Memory::Memory(Bus *bus, uint32_t size, uint8_t initVal) :
@@ -14,6 +16,7 @@ Memory::Memory(Bus *bus, uint32_t size, uint8_t initVal) :
 {
     m_data.resize(size, initVal);
     m_readOnly = false;
+    m_watchFlags.resize((size + WATCH_PAGE_SIZE - 1) >> WATCH_PAGE_SHIFT, 0);
 }
 
 uint32_t Memory::read32(uint32_t addr)
@@ -50,6 +53,7 @@ void Memory::write32(uint32_t val, uint32_t addr)
     m_data[addr + 1] = val >> 8 & 0xFF;
     m_data[addr + 2] = val >> 16 & 0xFF;
     m_data[addr + 3] = val >> 24 & 0xFF;
+    checkWatch(addr, 4);
 }
 
 void Memory::write16(uint16_t val, uint32_t addr)
@@ -60,6 +64,7 @@ void Memory::write16(uint16_t val, uint32_t addr)
     addr = m_memoryRange.remap(addr);
     m_data[addr] = val & 0xFF;
     m_data[addr + 1] = val >> 8 & 0xFF;
+    checkWatch(addr, 2);
 }
 
 void Memory::write8(uint8_t val, uint32_t addr)
@@ -69,6 +74,7 @@ void Memory::write8(uint8_t val, uint32_t addr)
     }
     addr = m_memoryRange.remap(addr);
     m_data[addr] = val;
+    checkWatch(addr, 1);
 }
 
 std::vector<uint8_t> *Memory::data()
@@ -84,9 +90,50 @@ const std::vector<uint8_t> *Memory::data() const
 void Memory::setReadOnly(bool readOnly)
 {
     m_readOnly = readOnly;
+    if (m_bus) {
+        m_bus->rebuildPageTable();
+    }
 }
 
 bool Memory::isReadOnly() const
 {
     return m_readOnly;
 }
+
+void Memory::watch(uint32_t address, MemoryWatch flag)
+{
+    uint32_t offset = m_memoryRange.remap(address);
+    m_watchFlags[offset >> WATCH_PAGE_SHIFT] |= static_cast<uint8_t>(flag);
+}
+
+void Memory::setWatchCallback(MemoryWatch flag, WatchCallback callback)
+{
+    m_watchCallbacks[std::countr_zero(static_cast<uint8_t>(flag))] = std::move(callback);
+}
+
+void Memory::notifyWrite(uint32_t offset, uint32_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    uint32_t first = offset >> WATCH_PAGE_SHIFT;
+    uint32_t last = (offset + size - 1) >> WATCH_PAGE_SHIFT;
+
+    for (uint32_t page = first; page <= last && page < m_watchFlags.size(); page++) {
+        uint8_t flags = m_watchFlags[page];
+        m_watchFlags[page] = 0;
+
+        while (flags) {
+            int bit = std::countr_zero(flags);
+            flags &= flags - 1;
+            if (m_watchCallbacks[bit]) {
+                m_watchCallbacks[bit](m_memoryRange.start + (page << WATCH_PAGE_SHIFT));
+            }
+        }
+    }
+}
+
+uint8_t *Memory::watchFlags()
+{
+    return m_watchFlags.data();
+}
@@ -8,10 +8,21 @@
 #ifndef MEMORY_HPP_
 #define MEMORY_HPP_
 
+#include <array>
+#include <functional>
 #include <vector>
 
 #include "PsxDevice.hpp"
 
+// Write watch flags, one bit per consumer. A watch is one-shot: the first
+// write to a watched page clears its flags and calls the consumers' callbacks.
+enum class MemoryWatch : uint8_t
+{
+    Code = 1 << 0,
+    Snapshot = 1 << 1,
+    Delta = 1 << 2,
+};
+
 class Memory : public PsxDevice
 {
     public:
@@ -31,9 +42,30 @@ class Memory : public PsxDevice
         void setReadOnly(bool readOnly);
         bool isReadOnly() const;
 
+        static constexpr uint32_t WATCH_PAGE_SHIFT = 12; // 4 KiB pages
+        static constexpr uint32_t WATCH_PAGE_SIZE = 1 << WATCH_PAGE_SHIFT;
+
+        // Callbacks receive the physical address of the written page
+        using WatchCallback = std::function<void(uint32_t address)>;
+
+        void watch(uint32_t address, MemoryWatch flag);
+        void setWatchCallback(MemoryWatch flag, WatchCallback callback);
+        void notifyWrite(uint32_t offset, uint32_t size);
+        uint8_t *watchFlags();
+
+    protected:
+        void checkWatch(uint32_t offset, uint32_t size) {
+            if (m_watchFlags[offset >> WATCH_PAGE_SHIFT]) {
+                notifyWrite(offset, size);
+            }
+        }
+
     protected:
         std::vector<uint8_t> m_data;
         bool m_readOnly;
+
+        std::vector<uint8_t> m_watchFlags;
+        std::array<WatchCallback, 8> m_watchCallbacks;
 };
 
 #endif /* !MEMORY_HPP_ */
@@ -4,6 +4,7 @@
 #include <spdlog/spdlog.h>
 
 #include "Bus.hpp"
+#include "Log.hpp"
 
 MemoryControl1::MemoryControl1(Bus *bus) :
     PsxDevice(bus)
@@ -37,7 +38,7 @@ void MemoryControl1::write16(uint16_t /* value */, uint32_t /* address */)
 
 void MemoryControl1::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("Memory Control 1: Write word 0x{:08X} at 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::MemoryControl, "Memory Control 1: Write word 0x{:08X} at 0x{:08X}", value, address);
     uint32_t offset = mapAddress(address) / 4;
 
     if (offset < m_memoryRange.length / 4) {
@@ -59,7 +60,7 @@ uint16_t MemoryControl1::read16(uint32_t /* address */)
 
 uint32_t MemoryControl1::read32(uint32_t address)
 {
-    spdlog::trace("Memory Control 1: Read word at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::MemoryControl, "Memory Control 1: Read word at 0x{:08X}", address);
     uint32_t offset = mapAddress(address) / 4;
 
     if (offset < m_memoryRange.length / 4) {
@@ -47,6 +47,9 @@ constexpr uint32_t BIOS_BASE_KUSEG = 0x1FC00000;
 constexpr uint32_t BIOS_BASE_KSEG0 = 0x9FC00000;
 constexpr uint32_t BIOS_BASE_KSEG1 = 0xBFC00000;
 
+// Size of the physical address space reachable through KUSEG/KSEG0/KSEG1 (29 bits)
+constexpr uint32_t PHYSICAL_SPACE_SIZE = 0x20000000;
+
 // When adding address spaces, use physical addresses
 // These ranges represent the top-level memory segments of the PS1
 // Sub ranges/mappings are defined below
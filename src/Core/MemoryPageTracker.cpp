@@ -0,0 +1,241 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** MemoryPageTracker
+*/
+
+#include "MemoryPageTracker.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Bus.hpp"
+#include "GPU.hpp"
+#include "MemoryMap.hpp"
+#include "RAM.hpp"
+#include "StateBuffer.hpp"
+
+// Equal bytes shorter than this stay inside a literal run
+static constexpr uint32_t MIN_ZERO_RUN = 4;
+
+static void writeVarint(std::vector<uint8_t> &out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t readVarint(StateBuffer &buf)
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = 0;
+        buf.read(byte);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("MemoryPageTracker: invalid varint");
+}
+
+MemoryPageTracker::MemoryPageTracker(Bus *bus, MemoryWatch consumer) :
+    m_ramDevice(bus->getDevice<RAM>()),
+    m_gpu(bus->getDevice<GPU>()),
+    m_consumer(consumer)
+{
+    m_ram.data = m_ramDevice->data()->data();
+    m_ram.pageCount = static_cast<uint32_t>(m_ramDevice->data()->size() >> PAGE_SHIFT);
+    m_ram.dirtyPages.reserve(m_ram.pageCount);
+    m_ramDirty.assign(m_ram.pageCount, 0);
+
+    m_vram.data = m_gpu->getVram();
+    m_vram.pageCount = GPU_VRAM_PAGE_COUNT;
+    m_vram.dirtyPages.reserve(m_vram.pageCount);
+
+    // Worst case encoding of a page is a single literal run
+    m_scratch.reserve(PAGE_SIZE + 16);
+
+    m_ramDevice->setWatchCallback(m_consumer, [this](uint32_t address) {
+        uint32_t page = (address - MemoryMap::RAM_RANGE.start) >> PAGE_SHIFT;
+        if (!m_ramDirty[page]) {
+            m_ramDirty[page] = 1;
+            m_ram.dirtyPages.push_back(page);
+        }
+    });
+    resetShadow();
+}
+
+MemoryPageTracker::~MemoryPageTracker()
+{
+    m_ramDevice->setWatchCallback(m_consumer, nullptr);
+}
+
+void MemoryPageTracker::collect()
+{
+    const uint8_t bit = static_cast<uint8_t>(m_consumer);
+    const uint8_t *vramFlags = m_gpu->getVramDirtyFlags();
+
+    m_vram.dirtyPages.clear();
+    for (uint32_t page = 0; page < m_vram.pageCount; page++) {
+        if (vramFlags[page] & bit) {
+            m_vram.dirtyPages.push_back(page);
+        }
+    }
+}
+
+void MemoryPageTracker::restoreDirtyPages()
+{
+    for (RegionId id : {RegionId::Ram, RegionId::Vram}) {
+        Region &mem = region(id);
+        for (uint32_t page : mem.dirtyPages) {
+            size_t offset = static_cast<size_t>(page) << PAGE_SHIFT;
+            std::memcpy(mem.data + offset, mem.shadow.data() + offset, PAGE_SIZE);
+            markWritten(id, page);
+        }
+    }
+}
+
+void MemoryPageTracker::rearm()
+{
+    const uint8_t bit = static_cast<uint8_t>(m_consumer);
+
+    for (uint32_t page : m_ram.dirtyPages) {
+        m_ramDirty[page] = 0;
+        m_ramDevice->watch(MemoryMap::RAM_RANGE.start + (page << PAGE_SHIFT), m_consumer);
+    }
+    m_ram.dirtyPages.clear();
+
+    uint8_t *vramFlags = m_gpu->getVramDirtyFlags();
+    for (uint32_t page : m_vram.dirtyPages) {
+        vramFlags[page] &= ~bit;
+    }
+    m_vram.dirtyPages.clear();
+}
+
+void MemoryPageTracker::resetShadow()
+{
+    m_ram.shadow.assign(m_ram.data, m_ram.data + (static_cast<size_t>(m_ram.pageCount) << PAGE_SHIFT));
+    m_vram.shadow.assign(m_vram.data, m_vram.data + (static_cast<size_t>(m_vram.pageCount) << PAGE_SHIFT));
+
+    m_ram.dirtyPages.clear();
+    m_vram.dirtyPages.clear();
+    for (uint32_t page = 0; page < m_ram.pageCount; page++) {
+        m_ram.dirtyPages.push_back(page);
+        m_ramDirty[page] = 1;
+    }
+    for (uint32_t page = 0; page < m_vram.pageCount; page++) {
+        m_vram.dirtyPages.push_back(page);
+    }
+    rearm();
+}
+
+void MemoryPageTracker::markWritten(RegionId id, uint32_t page)
+{
+    if (id == RegionId::Ram) {
+        // Also invalidates the compiled code of the page
+        m_ramDevice->notifyWrite(page << PAGE_SHIFT, PAGE_SIZE);
+    } else {
+        m_gpu->getVramDirtyFlags()[page] = 0xFF;
+    }
+}
+
+void MemoryPageTracker::writeDelta(StateBuffer &buf)
+{
+    collect();
+    buf.write(static_cast<uint32_t>(m_ram.dirtyPages.size() + m_vram.dirtyPages.size()));
+
+    for (RegionId id : {RegionId::Ram, RegionId::Vram}) {
+        Region &mem = region(id);
+        for (uint32_t page : mem.dirtyPages) {
+            size_t offset = static_cast<size_t>(page) << PAGE_SHIFT;
+            encodePage(mem.data + offset, mem.shadow.data() + offset);
+            buf.write(id);
+            buf.write(page);
+            buf.write(m_scratch.data(), m_scratch.size());
+            std::memcpy(mem.shadow.data() + offset, mem.data + offset, PAGE_SIZE);
+        }
+    }
+    rearm();
+}
+
+void MemoryPageTracker::readDelta(StateBuffer &buf)
+{
+    // Pages written since the base state was loaded have to go back to it first
+    collect();
+    restoreDirtyPages();
+
+    uint32_t count = 0;
+    buf.read(count);
+    for (uint32_t i = 0; i < count; i++) {
+        RegionId id;
+        uint32_t page = 0;
+        buf.read(id);
+        buf.read(page);
+        if (id >= RegionId::Count || page >= region(id).pageCount) {
+            throw std::runtime_error("MemoryPageTracker: invalid delta page");
+        }
+        Region &mem = region(id);
+        size_t offset = static_cast<size_t>(page) << PAGE_SHIFT;
+        decodePage(buf, mem.shadow.data() + offset);
+        std::memcpy(mem.data + offset, mem.shadow.data() + offset, PAGE_SIZE);
+        markWritten(id, page);
+    }
+    collect();
+    rearm();
+}
+
+void MemoryPageTracker::encodePage(const uint8_t *data, const uint8_t *shadow)
+{
+    m_scratch.clear();
+    uint32_t i = 0;
+
+    while (i < PAGE_SIZE) {
+        uint32_t zeroStart = i;
+        while (i < PAGE_SIZE && data[i] == shadow[i]) {
+            i++;
+        }
+        uint32_t literalStart = i;
+        while (i < PAGE_SIZE) {
+            if (data[i] != shadow[i]) {
+                i++;
+                continue;
+            }
+            uint32_t run = i;
+            while (run < PAGE_SIZE && run - i < MIN_ZERO_RUN && data[run] == shadow[run]) {
+                run++;
+            }
+            if (run == PAGE_SIZE || run - i >= MIN_ZERO_RUN) {
+                break;
+            }
+            i = run;
+        }
+        writeVarint(m_scratch, literalStart - zeroStart);
+        writeVarint(m_scratch, i - literalStart);
+        for (uint32_t j = literalStart; j < i; j++) {
+            m_scratch.push_back(data[j] ^ shadow[j]);
+        }
+    }
+}
+
+void MemoryPageTracker::decodePage(StateBuffer &buf, uint8_t *shadow)
+{
+    uint32_t i = 0;
+
+    while (i < PAGE_SIZE) {
+        uint32_t zeroRun = readVarint(buf);
+        uint32_t literals = readVarint(buf);
+        if (zeroRun > PAGE_SIZE - i || literals > PAGE_SIZE - i - zeroRun) {
+            throw std::runtime_error("MemoryPageTracker: invalid delta run");
+        }
+        i += zeroRun;
+        for (uint32_t end = i + literals; i < end; i++) {
+            uint8_t value = 0;
+            buf.read(value);
+            shadow[i] ^= value;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** MemoryPageTracker
+*/
+
+#ifndef MEMORYPAGETRACKER_HPP_
+#define MEMORYPAGETRACKER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Memory.hpp"
+
+class Bus;
+class RAM;
+class GPU;
+class StateBuffer;
+
+// Tracks the RAM and VRAM pages written since the last rearm() for one
+// MemoryWatch consumer, next to a shadow copy of their content at that time.
+// RAM pages are reported by the write watch, VRAM ones by the GPU dirty flags.
+class MemoryPageTracker
+{
+    public:
+        static constexpr uint32_t PAGE_SHIFT = 12;
+        static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+
+        enum class RegionId : uint8_t
+        {
+            Ram,
+            Vram,
+            Count
+        };
+
+        struct Region
+        {
+            uint8_t *data;
+            uint32_t pageCount;
+            std::vector<uint8_t> shadow;
+            std::vector<uint32_t> dirtyPages;
+        };
+
+        MemoryPageTracker(Bus *bus, MemoryWatch consumer);
+        ~MemoryPageTracker();
+
+        MemoryPageTracker(const MemoryPageTracker &) = delete;
+        MemoryPageTracker &operator=(const MemoryPageTracker &) = delete;
+
+        // Fills the dirty lists, to call before reading them
+        void collect();
+        // Copies the shadow back over the dirty pages
+        void restoreDirtyPages();
+        // Clears the dirty lists and watches their pages again
+        void rearm();
+        // Copies the whole memory into the shadow and clears the dirty pages
+        void resetShadow();
+        // Lets the other consumers see a page changed behind their back
+        void markWritten(RegionId id, uint32_t page);
+
+        // Delta of the dirty pages against the shadow: XOR then zero run-length
+        // encoded. Both update the shadow and rearm the tracking.
+        void writeDelta(StateBuffer &buf);
+        void readDelta(StateBuffer &buf);
+
+        Region &region(RegionId id) { return id == RegionId::Ram ? m_ram : m_vram; }
+        size_t totalPages() const { return m_ram.pageCount + m_vram.pageCount; }
+
+    private:
+        void encodePage(const uint8_t *data, const uint8_t *shadow);
+        void decodePage(StateBuffer &buf, uint8_t *shadow);
+
+    private:
+        RAM *m_ramDevice;
+        GPU *m_gpu;
+        MemoryWatch m_consumer;
+
+        Region m_ram;
+        Region m_vram;
+        std::vector<uint8_t> m_ramDirty;
+        std::vector<uint8_t> m_scratch;
+};
+
+#endif /* !MEMORYPAGETRACKER_HPP_ */
@@ -0,0 +1,208 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** PerfCounters
+*/
+
+#include "PerfCounters.hpp"
+
+#include <fmt/format.h>
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ROGEM_PERF_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ROGEM_PERF_RDTSC
+#endif
+
+static const char *const TIMER_NAMES[PERF_TIMER_COUNT] = {"cpu", "gpu", "dma", "devices"};
+static const char *const BUS_TARGET_NAMES[PERF_BUS_TARGET_COUNT] = {
+    "ram", "bios", "scratchpad", "dma", "gpu", "spu", "sio", "timers", "irqc", "other"
+};
+static const char *const PRIMITIVE_NAMES[PERF_PRIMITIVE_COUNT] = {
+    "polygon", "line", "rectangle", "fill", "transfer", "other"
+};
+static const char *const DMA_CHANNEL_NAMES[PERF_DMA_CHANNEL_COUNT] = {
+    "mdecIn", "mdecOut", "gpu", "cdrom", "spu", "pio", "otc"
+};
+static const char *const IRQ_NAMES[PERF_IRQ_COUNT] = {
+    "vblank", "gpu", "cdrom", "dma", "timer0", "timer1", "timer2", "pad", "sio", "spu", "lightpen"
+};
+
+template<size_t N>
+static void addCounters(std::array<uint64_t, N> &to, const std::array<uint64_t, N> &from)
+{
+    for (size_t i = 0; i < N; i++) {
+        to[i] += from[i];
+    }
+}
+
+void PerfFrame::add(const PerfFrame &other)
+{
+    instructions += other.instructions;
+    addCounters(busAccesses, other.busAccesses);
+    addCounters(gp0Commands, other.gp0Commands);
+    addCounters(pixels, other.pixels);
+    addCounters(dmaWords, other.dmaWords);
+    addCounters(irqs, other.irqs);
+    addCounters(hostNs, other.hostNs);
+}
+
+PerfCounters::PerfCounters()
+{
+    reset();
+}
+
+void PerfCounters::reset()
+{
+    m_frame = PerfFrame{};
+    m_lastFrame = PerfFrame{};
+    m_total = PerfFrame{};
+    m_frameCount = 0;
+    beginFrame();
+}
+
+void PerfCounters::beginFrame()
+{
+    m_frame = PerfFrame{};
+    m_ticks.fill(0);
+    m_timer = PerfTimer::Cpu;
+    m_mark = timestamp();
+    m_frameStartTicks = m_mark;
+    m_frameStartNs = wallClockNs();
+}
+
+void PerfCounters::endFrame()
+{
+    switchTimer(m_timer);
+    // Timestamp ticks are converted with the wall clock time of the frame
+    uint64_t ticks = m_mark - m_frameStartTicks;
+    uint64_t ns = wallClockNs() - m_frameStartNs;
+    double nsPerTick = ticks ? static_cast<double>(ns) / static_cast<double>(ticks) : 0.0;
+
+    for (size_t i = 0; i < PERF_TIMER_COUNT; i++) {
+        m_frame.hostNs[i] = static_cast<uint64_t>(static_cast<double>(m_ticks[i]) * nsPerTick);
+    }
+    m_lastFrame = m_frame;
+    m_total.add(m_frame);
+    m_frameCount++;
+    beginFrame();
+}
+
+uint64_t PerfCounters::timestamp()
+{
+#ifdef ROGEM_PERF_RDTSC
+    return __rdtsc();
+#else
+    return wallClockNs();
+#endif
+}
+
+uint64_t PerfCounters::wallClockNs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+const char *PerfCounters::timerName(PerfTimer timer)
+{
+    return TIMER_NAMES[static_cast<size_t>(timer)];
+}
+
+const char *PerfCounters::busTargetName(PerfBusTarget target)
+{
+    return BUS_TARGET_NAMES[static_cast<size_t>(target)];
+}
+
+const char *PerfCounters::primitiveName(PerfPrimitive primitive)
+{
+    return PRIMITIVE_NAMES[static_cast<size_t>(primitive)];
+}
+
+const char *PerfCounters::dmaChannelName(size_t channel)
+{
+    return DMA_CHANNEL_NAMES[channel];
+}
+
+const char *PerfCounters::irqName(size_t irq)
+{
+    return IRQ_NAMES[irq];
+}
+
+template<size_t N>
+static void appendJsonObject(std::string &out, const char *key, const char *const (&names)[N],
+                             const std::array<uint64_t, N> &values)
+{
+    out += fmt::format(", \"{}\": {{", key);
+    for (size_t i = 0; i < N; i++) {
+        out += fmt::format("{}\"{}\": {}", i ? ", " : "", names[i], values[i]);
+    }
+    out += "}";
+}
+
+static std::string frameJson(const PerfFrame &counters)
+{
+    std::string out = fmt::format("{{\"instructions\": {}", counters.instructions);
+
+    appendJsonObject(out, "busAccesses", BUS_TARGET_NAMES, counters.busAccesses);
+    appendJsonObject(out, "gp0Commands", PRIMITIVE_NAMES, counters.gp0Commands);
+    appendJsonObject(out, "pixels", PRIMITIVE_NAMES, counters.pixels);
+    appendJsonObject(out, "dmaWords", DMA_CHANNEL_NAMES, counters.dmaWords);
+    appendJsonObject(out, "irqs", IRQ_NAMES, counters.irqs);
+    appendJsonObject(out, "hostNs", TIMER_NAMES, counters.hostNs);
+    out += "}";
+    return out;
+}
+
+std::string PerfCounters::toJson() const
+{
+    return fmt::format("{{\n  \"frames\": {},\n  \"total\": {},\n  \"lastFrame\": {}\n}}\n",
+                       m_frameCount, frameJson(m_total), frameJson(m_lastFrame));
+}
+
+template<size_t N>
+static void appendCsvNames(std::string &out, const char *prefix, const char *const (&names)[N])
+{
+    for (size_t i = 0; i < N; i++) {
+        out += fmt::format(",{}_{}", prefix, names[i]);
+    }
+}
+
+template<size_t N>
+static void appendCsvValues(std::string &out, const std::array<uint64_t, N> &values)
+{
+    for (size_t i = 0; i < N; i++) {
+        out += fmt::format(",{}", values[i]);
+    }
+}
+
+std::string PerfCounters::csvHeader()
+{
+    std::string out = "frame,instructions";
+
+    appendCsvNames(out, "bus", BUS_TARGET_NAMES);
+    appendCsvNames(out, "gp0", PRIMITIVE_NAMES);
+    appendCsvNames(out, "pixels", PRIMITIVE_NAMES);
+    appendCsvNames(out, "dma", DMA_CHANNEL_NAMES);
+    appendCsvNames(out, "irq", IRQ_NAMES);
+    appendCsvNames(out, "ns", TIMER_NAMES);
+    out += "\n";
+    return out;
+}
+
+std::string PerfCounters::csvRow(uint64_t frame, const PerfFrame &counters)
+{
+    std::string out = fmt::format("{},{}", frame, counters.instructions);
+
+    appendCsvValues(out, counters.busAccesses);
+    appendCsvValues(out, counters.gp0Commands);
+    appendCsvValues(out, counters.pixels);
+    appendCsvValues(out, counters.dmaWords);
+    appendCsvValues(out, counters.irqs);
+    appendCsvValues(out, counters.hostNs);
+    out += "\n";
+    return out;
+}
@@ -0,0 +1,153 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** PerfCounters
+*/
+
+#ifndef PERFCOUNTERS_HPP_
+#define PERFCOUNTERS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Parts of the emulator the host time is charged to
+enum class PerfTimer : uint8_t
+{
+    Cpu,
+    Gpu,
+    Dma,
+    Devices,
+    Count
+};
+
+// Targets of the bus accesses
+enum class PerfBusTarget : uint8_t
+{
+    Ram,
+    Bios,
+    ScratchPad,
+    Dma,
+    Gpu,
+    Spu,
+    SerialInterface,
+    Timers,
+    InterruptController,
+    Other,
+    Count
+};
+
+// GP0 command kinds
+enum class PerfPrimitive : uint8_t
+{
+    Polygon,
+    Line,
+    Rectangle,
+    Fill,
+    Transfer,
+    Other,
+    Count
+};
+
+static constexpr size_t PERF_TIMER_COUNT = static_cast<size_t>(PerfTimer::Count);
+static constexpr size_t PERF_BUS_TARGET_COUNT = static_cast<size_t>(PerfBusTarget::Count);
+static constexpr size_t PERF_PRIMITIVE_COUNT = static_cast<size_t>(PerfPrimitive::Count);
+static constexpr size_t PERF_DMA_CHANNEL_COUNT = 7;
+static constexpr size_t PERF_IRQ_COUNT = 11;
+
+struct PerfFrame
+{
+    uint64_t instructions;
+    std::array<uint64_t, PERF_BUS_TARGET_COUNT> busAccesses;
+    std::array<uint64_t, PERF_PRIMITIVE_COUNT> gp0Commands;
+    std::array<uint64_t, PERF_PRIMITIVE_COUNT> pixels;
+    std::array<uint64_t, PERF_DMA_CHANNEL_COUNT> dmaWords;
+    std::array<uint64_t, PERF_IRQ_COUNT> irqs;
+    std::array<uint64_t, PERF_TIMER_COUNT> hostNs;
+
+    void add(const PerfFrame &other);
+};
+
+// Always-on counters of the emulated frame in progress. Counting is a plain
+// increment, host time is read from the timestamp counter when the emulator
+// switches between CPU, GPU, DMA and the other devices.
+class PerfCounters
+{
+    public:
+        PerfCounters();
+        ~PerfCounters() = default;
+
+        void reset();
+
+        // Host time outside of beginFrame/endFrame is not charged to anything
+        void beginFrame();
+        void endFrame();
+
+        PerfFrame &frame() { return m_frame; }
+        const PerfFrame &lastFrame() const { return m_lastFrame; }
+        const PerfFrame &total() const { return m_total; }
+        uint64_t frameCount() const { return m_frameCount; }
+
+        // Charges the time elapsed so far to the running timer, returns it
+        PerfTimer switchTimer(PerfTimer timer) {
+            uint64_t now = timestamp();
+            m_ticks[static_cast<size_t>(m_timer)] += now - m_mark;
+            m_mark = now;
+            PerfTimer previous = m_timer;
+            m_timer = timer;
+            return previous;
+        }
+
+        std::string toJson() const;
+        static std::string csvHeader();
+        static std::string csvRow(uint64_t frame, const PerfFrame &counters);
+
+        static const char *timerName(PerfTimer timer);
+        static const char *busTargetName(PerfBusTarget target);
+        static const char *primitiveName(PerfPrimitive primitive);
+        static const char *dmaChannelName(size_t channel);
+        static const char *irqName(size_t irq);
+
+    private:
+        static uint64_t timestamp();
+        static uint64_t wallClockNs();
+
+    private:
+        PerfFrame m_frame;
+        PerfFrame m_lastFrame;
+        PerfFrame m_total;
+        uint64_t m_frameCount;
+
+        std::array<uint64_t, PERF_TIMER_COUNT> m_ticks;
+        PerfTimer m_timer;
+        uint64_t m_mark;
+        uint64_t m_frameStartTicks;
+        uint64_t m_frameStartNs;
+};
+
+// Charges the host time of a scope to a timer, then goes back to the previous one
+class PerfScope
+{
+    public:
+        PerfScope(PerfCounters *perf, PerfTimer timer) :
+            m_perf(perf),
+            m_previous(perf ? perf->switchTimer(timer) : timer)
+        {
+        }
+        ~PerfScope() {
+            if (m_perf) {
+                m_perf->switchTimer(m_previous);
+            }
+        }
+
+        PerfScope(const PerfScope &) = delete;
+        PerfScope &operator=(const PerfScope &) = delete;
+
+    private:
+        PerfCounters *m_perf;
+        PerfTimer m_previous;
+};
+
+#endif /* !PERFCOUNTERS_HPP_ */
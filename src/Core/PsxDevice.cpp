@@ -0,0 +1,41 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** PsxDevice
+*/
+
+#include "PsxDevice.hpp"
+
+#include <algorithm>
+#include <climits>
+
+#include "Bus.hpp"
+
+void PsxDevice::catchUp()
+{
+    uint64_t now = currentTime();
+
+    while (m_lastUpdate < now) {
+        auto cycles = std::min<uint64_t>(now - m_lastUpdate, INT_MAX);
+        m_lastUpdate += cycles;
+        update(static_cast<int>(cycles));
+    }
+}
+
+void PsxDevice::schedule(SchedulerEvent event, uint64_t cycles)
+{
+    if (m_bus) {
+        m_bus->getScheduler().schedule(event, cycles);
+    }
+}
+
+uint64_t PsxDevice::currentTime() const
+{
+    return m_bus ? m_bus->getScheduler().now() : 0;
+}
+
+PerfCounters *PsxDevice::perfCounters() const
+{
+    return m_bus ? &m_bus->getPerfCounters() : nullptr;
+}
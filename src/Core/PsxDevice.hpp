@@ -8,22 +8,30 @@
 #ifndef PSXDEVICE_HPP_
 #define PSXDEVICE_HPP_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 
 #include "MemoryMap.hpp"
+#include "Scheduler.hpp"
 
 class Bus;
+class PerfCounters;
 class StateBuffer;
 
 class PsxDevice
 {
     public:
-        PsxDevice(Bus *bus) : m_bus(bus) {}
+        PsxDevice(Bus *bus) : m_bus(bus), m_lastUpdate(0) {}
         virtual ~PsxDevice() = default;
 
+        // Advances the device by the given amount of CPU cycles
         virtual void update(int cycles) { (void)cycles; };
         virtual void reset() {};
 
+        // Called by the scheduler when one of the device events is due
+        virtual void onEvent(SchedulerEvent event) { (void)event; }
+
         virtual void serialize(StateBuffer &buf) const { (void)buf; }
         virtual void deserialize(StateBuffer &buf) { (void)buf; }
 
@@ -35,6 +43,10 @@ class PsxDevice
             return m_memoryRange.remap(address);
         }
 
+        const MemoryMap::MemRange &memoryRange() const {
+            return m_memoryRange;
+        }
+
         virtual void write8(uint8_t data, uint32_t address) = 0;
         virtual void write16(uint16_t data, uint32_t address) = 0;
         virtual void write32(uint32_t data, uint32_t address) = 0;
@@ -43,9 +55,21 @@ class PsxDevice
         virtual uint16_t read16(uint32_t address) = 0;
         virtual uint32_t read32(uint32_t address) = 0;
 
+        // DMA transfers of consecutive words, pointing straight into RAM
+        virtual void dmaWrite(const uint32_t *words, size_t count) { (void)words; (void)count; }
+        virtual void dmaRead(uint32_t *words, size_t count) { std::fill_n(words, count, 0); }
+
+    protected:
+        // Runs update() for the cycles elapsed since the last catch up
+        void catchUp();
+        void schedule(SchedulerEvent event, uint64_t cycles);
+        uint64_t currentTime() const;
+        PerfCounters *perfCounters() const;
+
     protected:
         MemoryMap::MemRange m_memoryRange;
         Bus *m_bus;
+        uint64_t m_lastUpdate;
 };
 
 #endif /* !PSXDEVICE_HPP_ */
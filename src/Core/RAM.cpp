@@ -16,16 +16,22 @@ RAM::RAM(Bus *bus) :
 void RAM::reset()
 {
     std::memset(m_data.data(), 0, m_data.size());
+    notifyWrite(0, m_data.size());
 }
 
 void RAM::serialize(StateBuffer &buf) const
 {
-    buf.writeVec(m_data);
+    if (!buf.isSnapshot()) {
+        buf.writeVec(m_data);
+    }
 }
 
 void RAM::deserialize(StateBuffer &buf)
 {
-    buf.readVec(m_data);
+    if (!buf.isSnapshot()) {
+        buf.readVec(m_data);
+        notifyWrite(0, m_data.size());
+    }
 }
 
 void RAM::loadExecutable(uint32_t baseAddr, const std::vector<uint8_t> &code)
@@ -34,5 +40,6 @@ void RAM::loadExecutable(uint32_t baseAddr, const std::vector<uint8_t> &code)
     if (m_memoryRange.contains(mappedBase)) {
         uint32_t physicalAddr = m_memoryRange.remap(mappedBase);
         std::memcpy(&m_data[physicalAddr], &code[0], code.size());
+        notifyWrite(physicalAddr, code.size());
     }
 }
@@ -0,0 +1,356 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** Recompiler
+*/
+
+#include "Recompiler.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include "CPU.hpp"
+#include "X64Emitter.hpp"
+
+#ifdef _WIN32
+static constexpr X64Reg ARG0 = X64Reg::RCX;
+static constexpr X64Reg ARG1 = X64Reg::RDX;
+static constexpr X64Reg ARG2 = X64Reg::R8;
+static constexpr int8_t FRAME_SIZE = 40; // Shadow space + alignment
+#else
+static constexpr X64Reg ARG0 = X64Reg::RDI;
+static constexpr X64Reg ARG1 = X64Reg::RSI;
+static constexpr X64Reg ARG2 = X64Reg::RDX;
+static constexpr int8_t FRAME_SIZE = 8; // Alignment
+#endif
+
+// Pinned for the whole block
+static constexpr X64Reg CPU_REG = X64Reg::R12;
+static constexpr X64Reg GPR_REG = X64Reg::RBX;
+
+// Worst case size of one translated instruction, exits included
+static constexpr size_t MAX_INSTRUCTION_SIZE = 128;
+static constexpr size_t BLOCK_OVERHEAD_SIZE = 64;
+
+static X64Reg hostReg(uint8_t id)
+{
+    return static_cast<X64Reg>(id);
+}
+
+Recompiler::Recompiler(const RecompilerLayout &layout, JitStepHelper step, JitStepHelper branchStep) :
+    m_layout(layout),
+    m_step(step),
+    m_branchStep(branchStep),
+    m_code(isSupported() ? CODE_BUFFER_SIZE : 0)
+{
+}
+
+bool Recompiler::isSupported()
+{
+#ifdef ROGEM_RECOMPILER_X64
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Recompiler::flush()
+{
+    m_code.reset();
+}
+
+void Recompiler::emitGprLoad(X64Emitter &emitter, uint8_t dst, uint8_t reg) const
+{
+    emitter.load32(hostReg(dst), GPR_REG, reg * 4);
+}
+
+void Recompiler::emitGprStore(X64Emitter &emitter, uint8_t reg, uint8_t src) const
+{
+    emitter.store32(GPR_REG, reg * 4, hostReg(src));
+}
+
+bool Recompiler::isNative(const Instruction &instruction) const
+{
+    switch (static_cast<PrimaryOpCode>(instruction.r.opcode))
+    {
+    case PrimaryOpCode::ADDIU:
+    case PrimaryOpCode::ANDI:
+    case PrimaryOpCode::ORI:
+    case PrimaryOpCode::XORI:
+    case PrimaryOpCode::LUI:
+    case PrimaryOpCode::SLTI:
+    case PrimaryOpCode::SLTIU:
+        return true;
+    case PrimaryOpCode::SPECIAL:
+        break;
+    default:
+        return false;
+    }
+
+    switch (static_cast<SecondaryOpCode>(instruction.r.funct))
+    {
+    case SecondaryOpCode::SLL:
+    case SecondaryOpCode::SRL:
+    case SecondaryOpCode::SRA:
+    case SecondaryOpCode::SLLV:
+    case SecondaryOpCode::SRLV:
+    case SecondaryOpCode::SRAV:
+    case SecondaryOpCode::ADDU:
+    case SecondaryOpCode::SUBU:
+    case SecondaryOpCode::AND:
+    case SecondaryOpCode::OR:
+    case SecondaryOpCode::XOR:
+    case SecondaryOpCode::NOR:
+    case SecondaryOpCode::SLT:
+    case SecondaryOpCode::SLTU:
+    case SecondaryOpCode::MFHI:
+    case SecondaryOpCode::MFLO:
+    case SecondaryOpCode::MTHI:
+    case SecondaryOpCode::MTLO:
+    case SecondaryOpCode::MULT:
+    case SecondaryOpCode::MULTU:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void Recompiler::emitNative(X64Emitter &e, const Instruction &instruction) const
+{
+    const uint8_t EAX = static_cast<uint8_t>(X64Reg::RAX);
+    const uint8_t ECX = static_cast<uint8_t>(X64Reg::RCX);
+    const uint8_t EDX = static_cast<uint8_t>(X64Reg::RDX);
+    uint8_t rs = instruction.r.rs;
+    uint8_t rt = instruction.r.rt;
+    uint8_t rd = instruction.r.rd;
+    uint32_t zeroImm = instruction.i.immediate;
+    uint32_t signImm = static_cast<uint32_t>(static_cast<int16_t>(instruction.i.immediate));
+
+    auto primary = static_cast<PrimaryOpCode>(instruction.r.opcode);
+    if (primary != PrimaryOpCode::SPECIAL) {
+        // Writes to $zero are dropped by setReg
+        if (rt == 0) {
+            return;
+        }
+        switch (primary)
+        {
+        case PrimaryOpCode::LUI:
+            e.store32(GPR_REG, rt * 4, zeroImm << 16);
+            return;
+        case PrimaryOpCode::ADDIU:
+            emitGprLoad(e, EAX, rs);
+            e.alu32(X64AluOp::ADD, X64Reg::RAX, signImm);
+            break;
+        case PrimaryOpCode::ANDI:
+            emitGprLoad(e, EAX, rs);
+            e.alu32(X64AluOp::AND, X64Reg::RAX, zeroImm);
+            break;
+        case PrimaryOpCode::ORI:
+            emitGprLoad(e, EAX, rs);
+            e.alu32(X64AluOp::OR, X64Reg::RAX, zeroImm);
+            break;
+        case PrimaryOpCode::XORI:
+            emitGprLoad(e, EAX, rs);
+            e.alu32(X64AluOp::XOR, X64Reg::RAX, zeroImm);
+            break;
+        case PrimaryOpCode::SLTI:
+        case PrimaryOpCode::SLTIU:
+            emitGprLoad(e, EAX, rs);
+            e.alu32(X64AluOp::CMP, X64Reg::RAX, signImm);
+            e.setcc(primary == PrimaryOpCode::SLTI ? X64Condition::L : X64Condition::B, X64Reg::RAX);
+            e.movzx8(X64Reg::RAX, X64Reg::RAX);
+            break;
+        default:
+            return;
+        }
+        emitGprStore(e, rt, EAX);
+        return;
+    }
+
+    auto funct = static_cast<SecondaryOpCode>(instruction.r.funct);
+    switch (funct)
+    {
+    case SecondaryOpCode::MTHI:
+    case SecondaryOpCode::MTLO:
+        emitGprLoad(e, EAX, rs);
+        e.store32(GPR_REG, funct == SecondaryOpCode::MTHI ? m_layout.hi : m_layout.lo, X64Reg::RAX);
+        return;
+    case SecondaryOpCode::MULT:
+    case SecondaryOpCode::MULTU:
+        emitGprLoad(e, EAX, rs);
+        emitGprLoad(e, ECX, rt);
+        if (funct == SecondaryOpCode::MULT) {
+            e.imul32(X64Reg::RCX);
+        } else {
+            e.mul32(X64Reg::RCX);
+        }
+        e.store32(GPR_REG, m_layout.lo, X64Reg::RAX);
+        e.store32(GPR_REG, m_layout.hi, hostReg(EDX));
+        return;
+    default:
+        break;
+    }
+
+    if (rd == 0) {
+        return;
+    }
+    switch (funct)
+    {
+    case SecondaryOpCode::SLL:
+    case SecondaryOpCode::SRL:
+    case SecondaryOpCode::SRA:
+        emitGprLoad(e, EAX, rt);
+        if (instruction.r.shamt) {
+            X64ShiftOp op = funct == SecondaryOpCode::SLL ? X64ShiftOp::SHL :
+                funct == SecondaryOpCode::SRL ? X64ShiftOp::SHR : X64ShiftOp::SAR;
+            e.shift32(op, X64Reg::RAX, instruction.r.shamt);
+        }
+        break;
+    case SecondaryOpCode::SLLV:
+    case SecondaryOpCode::SRLV:
+    case SecondaryOpCode::SRAV: {
+        // x86 masks the count to 5 bits like the R3000A
+        X64ShiftOp op = funct == SecondaryOpCode::SLLV ? X64ShiftOp::SHL :
+            funct == SecondaryOpCode::SRLV ? X64ShiftOp::SHR : X64ShiftOp::SAR;
+        emitGprLoad(e, EAX, rt);
+        emitGprLoad(e, ECX, rs);
+        e.shift32Cl(op, X64Reg::RAX);
+        break;
+    }
+    case SecondaryOpCode::ADDU:
+    case SecondaryOpCode::SUBU:
+    case SecondaryOpCode::AND:
+    case SecondaryOpCode::OR:
+    case SecondaryOpCode::XOR:
+    case SecondaryOpCode::NOR: {
+        X64AluOp op = funct == SecondaryOpCode::ADDU ? X64AluOp::ADD :
+            funct == SecondaryOpCode::SUBU ? X64AluOp::SUB :
+            funct == SecondaryOpCode::AND ? X64AluOp::AND :
+            funct == SecondaryOpCode::XOR ? X64AluOp::XOR : X64AluOp::OR;
+        emitGprLoad(e, EAX, rs);
+        emitGprLoad(e, ECX, rt);
+        e.alu32(op, X64Reg::RAX, X64Reg::RCX);
+        if (funct == SecondaryOpCode::NOR) {
+            e.not32(X64Reg::RAX);
+        }
+        break;
+    }
+    case SecondaryOpCode::SLT:
+    case SecondaryOpCode::SLTU:
+        emitGprLoad(e, EAX, rs);
+        emitGprLoad(e, ECX, rt);
+        e.alu32(X64AluOp::CMP, X64Reg::RAX, X64Reg::RCX);
+        e.setcc(funct == SecondaryOpCode::SLT ? X64Condition::L : X64Condition::B, X64Reg::RAX);
+        e.movzx8(X64Reg::RAX, X64Reg::RAX);
+        break;
+    case SecondaryOpCode::MFHI:
+    case SecondaryOpCode::MFLO:
+        e.load32(X64Reg::RAX, GPR_REG, funct == SecondaryOpCode::MFHI ? m_layout.hi : m_layout.lo);
+        break;
+    default:
+        return;
+    }
+    emitGprStore(e, rd, EAX);
+}
+
+void Recompiler::emitHelper(X64Emitter &e, JitStepHelper helper, const DecodedInstruction &decoded, uint32_t pc) const
+{
+    e.store32(GPR_REG, m_layout.pc, pc);
+    e.mov64(ARG0, CPU_REG);
+    e.mov64(ARG1, reinterpret_cast<uint64_t>(decoded.handler));
+    e.mov32(ARG2, decoded.instruction.raw);
+    e.mov64(X64Reg::RAX, reinterpret_cast<uint64_t>(helper));
+    e.call(X64Reg::RAX);
+}
+
+JitBlockFunction Recompiler::compile(const CachedBlock &block)
+{
+    if (!m_code.isValid()) {
+        return nullptr;
+    }
+    size_t count = block.instructions.size();
+    if (m_code.remaining() < BLOCK_OVERHEAD_SIZE + count * MAX_INSTRUCTION_SIZE) {
+        return nullptr;
+    }
+
+    X64Emitter e(m_code.current(), m_code.remaining());
+    // Exit patch sites, paired with the number of instructions run
+    std::vector<std::pair<size_t, uint32_t>> exits;
+
+    e.push(GPR_REG);
+    e.push(CPU_REG);
+    e.subRsp(FRAME_SIZE);
+    e.mov64(CPU_REG, ARG0);
+    e.mov64(GPR_REG, ARG1);
+
+    bool prevLoad = false;
+    bool prevBranch = false;
+    bool lastNative = false;
+    uint32_t endPc = block.startPc + static_cast<uint32_t>(count) * 4;
+
+    for (size_t i = 0; i < count; i++) {
+        const DecodedInstruction &decoded = block.instructions[i];
+        const Instruction &instruction = decoded.instruction;
+        uint32_t pc = block.startPc + static_cast<uint32_t>(i) * 4;
+        uint32_t executed = static_cast<uint32_t>(i + 1);
+
+        // BIOS TTY hooks and delay slots go through the interpreter
+        bool native = isNative(instruction) && !prevBranch && pc != 0xA0 && pc != 0xB0;
+        bool branch = CPU::isBranch(instruction);
+
+        if (native && i == 0) {
+            // A load from the previous block may still be in its delay slot
+            e.cmp8(GPR_REG, m_layout.loadPending, 0);
+            size_t slowPath = e.jcc(X64Condition::NZ);
+            emitNative(e, instruction);
+            size_t done = e.jmp();
+            e.bind(slowPath);
+            emitHelper(e, m_step, decoded, pc);
+            e.test32(X64Reg::RAX, X64Reg::RAX);
+            exits.emplace_back(e.jcc(X64Condition::NZ), executed);
+            e.bind(done);
+        } else if (native && !prevLoad) {
+            emitNative(e, instruction);
+        } else {
+            native = false;
+            emitHelper(e, branch ? m_branchStep : m_step, decoded, pc);
+            if (i + 1 < count) {
+                e.test32(X64Reg::RAX, X64Reg::RAX);
+                exits.emplace_back(e.jcc(X64Condition::NZ), executed);
+            }
+        }
+        lastNative = native;
+        prevLoad = CPU::isLoad(instruction);
+        prevBranch = branch;
+    }
+
+    if (lastNative) {
+        e.store32(GPR_REG, m_layout.pc, endPc);
+        e.store32(GPR_REG, m_layout.nextPc, endPc);
+    }
+    e.mov32(X64Reg::RAX, static_cast<uint32_t>(count));
+    size_t epilogue = e.size();
+    e.addRsp(FRAME_SIZE);
+    e.pop(CPU_REG);
+    e.pop(GPR_REG);
+    e.ret();
+
+    for (auto &[patch, executed] : exits) {
+        e.bind(patch);
+        e.mov32(X64Reg::RAX, executed);
+        size_t toEpilogue = e.jmp();
+        // Backward jump to the shared epilogue
+        int32_t rel = static_cast<int32_t>(epilogue) - static_cast<int32_t>(toEpilogue + 4);
+        if (!e.overflowed()) {
+            std::memcpy(e.code() + toEpilogue, &rel, sizeof(rel));
+        }
+    }
+
+    if (e.overflowed()) {
+        return nullptr;
+    }
+    auto function = reinterpret_cast<JitBlockFunction>(e.code());
+    m_code.commit(e.size());
+    return function;
+}
@@ -0,0 +1,65 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** Recompiler
+*/
+
+#ifndef RECOMPILER_HPP_
+#define RECOMPILER_HPP_
+
+#include <cstdint>
+
+#include "BlockCache.hpp"
+#include "ExecutableMemory.hpp"
+
+class X64Emitter;
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ROGEM_RECOMPILER_X64 1
+#endif
+
+// Runs one instruction through the interpreter, returns non-zero when the
+// compiled block must stop (exception, pending interrupt, code invalidated...)
+using JitStepHelper = uint32_t (*)(CPU *cpu, InstructionHandler handler, uint32_t instruction);
+
+// Byte offsets of the CPU state from the general purpose registers array
+struct RecompilerLayout
+{
+    int32_t pc;
+    int32_t nextPc;
+    int32_t hi;
+    int32_t lo;
+    int32_t loadPending;
+};
+
+// Translates cached blocks into x86-64 code. Simple ALU instructions run
+// natively, everything else calls back into the interpreter.
+class Recompiler
+{
+    public:
+        Recompiler(const RecompilerLayout &layout, JitStepHelper step, JitStepHelper branchStep);
+
+        static bool isSupported();
+
+        // Returns nullptr when the code buffer is full
+        JitBlockFunction compile(const CachedBlock &block);
+        void flush();
+
+    private:
+        bool isNative(const Instruction &instruction) const;
+        void emitNative(X64Emitter &emitter, const Instruction &instruction) const;
+        void emitHelper(X64Emitter &emitter, JitStepHelper helper, const DecodedInstruction &decoded, uint32_t pc) const;
+        void emitGprLoad(X64Emitter &emitter, uint8_t dst, uint8_t reg) const;
+        void emitGprStore(X64Emitter &emitter, uint8_t reg, uint8_t src) const;
+
+    private:
+        static constexpr size_t CODE_BUFFER_SIZE = 8 * 1024 * 1024;
+
+        RecompilerLayout m_layout;
+        JitStepHelper m_step;
+        JitStepHelper m_branchStep;
+        ExecutableMemory m_code;
+};
+
+#endif /* !RECOMPILER_HPP_ */
@@ -28,6 +28,10 @@ void SIO0::write(SIORegister reg, uint16_t value)
             break;
         case SIORegister::CTRL:
             m_ctrl = value;
+            // Acknowledge
+            if (value & 0x10) {
+                m_irq = false;
+            }
             break;
         case SIORegister::BAUD:
             m_baud = value;
@@ -76,6 +80,7 @@ void SIO0::reset()
         pad.reset();
     }
     m_irq = false;
+    m_baudTimer = 0;
     m_pad[0].connect();
 }
 
@@ -31,6 +31,8 @@ class SIO0 : public SIODevice
         void reset();
 
         bool irq() const { return m_irq; }
+        // CPU cycles left before the current transfer completes
+        int transferCycles() const { return m_baudTimer; }
 
         DigitalPad &getPad(int index) { return m_pad[index]; }
 
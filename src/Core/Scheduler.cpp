@@ -0,0 +1,83 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** Scheduler
+*/
+
+#include "Scheduler.hpp"
+#include "StateBuffer.hpp"
+
+#include <algorithm>
+
+#include "PsxDevice.hpp"
+
+Scheduler::Scheduler()
+{
+    m_handlers.fill(nullptr);
+    reset();
+}
+
+void Scheduler::reset()
+{
+    m_now = 0;
+    m_deadlines.fill(NEVER);
+    m_nextEvent = NEVER;
+}
+
+void Scheduler::serialize(StateBuffer &buf) const
+{
+    buf.write(m_now);
+    buf.write(m_deadlines);
+}
+
+void Scheduler::deserialize(StateBuffer &buf)
+{
+    buf.read(m_now);
+    buf.read(m_deadlines);
+    updateNextEvent();
+}
+
+void Scheduler::setHandler(SchedulerEvent event, PsxDevice *device)
+{
+    m_handlers[static_cast<size_t>(event)] = device;
+}
+
+void Scheduler::schedule(SchedulerEvent event, uint64_t cycles)
+{
+    m_deadlines[static_cast<size_t>(event)] = (cycles == NEVER) ? NEVER : m_now + cycles;
+    updateNextEvent();
+}
+
+void Scheduler::cancel(SchedulerEvent event)
+{
+    m_deadlines[static_cast<size_t>(event)] = NEVER;
+    updateNextEvent();
+}
+
+uint64_t Scheduler::deadline(SchedulerEvent event) const
+{
+    return m_deadlines[static_cast<size_t>(event)];
+}
+
+void Scheduler::runEvents()
+{
+    while (true) {
+        auto it = std::min_element(m_deadlines.begin(), m_deadlines.end());
+        if (*it > m_now) {
+            break;
+        }
+        auto index = static_cast<size_t>(it - m_deadlines.begin());
+        *it = NEVER;
+        // Handlers catch up to the current time and may schedule their next event
+        if (m_handlers[index]) {
+            m_handlers[index]->onEvent(static_cast<SchedulerEvent>(index));
+        }
+    }
+    updateNextEvent();
+}
+
+void Scheduler::updateNextEvent()
+{
+    m_nextEvent = *std::min_element(m_deadlines.begin(), m_deadlines.end());
+}
@@ -0,0 +1,75 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** Scheduler
+*/
+
+#ifndef SCHEDULER_HPP_
+#define SCHEDULER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class PsxDevice;
+class StateBuffer;
+
+enum class SchedulerEvent : uint8_t
+{
+    GpuVBlank,
+    Timer0,
+    Timer1,
+    Timer2,
+    Sio0Transfer,
+    Dma,
+    Count
+};
+
+// Central timestamp of the emulated machine, in CPU cycles.
+// Devices register the time of their next event instead of being polled:
+// the clock only dispatches work once the earliest deadline is reached.
+class Scheduler
+{
+    public:
+        static constexpr uint64_t NEVER = UINT64_MAX;
+        static constexpr size_t EVENT_COUNT = static_cast<size_t>(SchedulerEvent::Count);
+
+        Scheduler();
+        ~Scheduler() = default;
+
+        void reset();
+
+        void serialize(StateBuffer &buf) const;
+        void deserialize(StateBuffer &buf);
+
+        void setHandler(SchedulerEvent event, PsxDevice *device);
+
+        // Schedules the event cycles from now, replacing any previous deadline
+        void schedule(SchedulerEvent event, uint64_t cycles);
+        void cancel(SchedulerEvent event);
+
+        uint64_t now() const { return m_now; }
+        uint64_t nextEventTime() const { return m_nextEvent; }
+        uint64_t deadline(SchedulerEvent event) const;
+
+        // Advances the clock, running every event that became due in timestamp order
+        void advance(uint64_t cycles) {
+            m_now += cycles;
+            if (m_now >= m_nextEvent) {
+                runEvents();
+            }
+        }
+
+    private:
+        void runEvents();
+        void updateNextEvent();
+
+    private:
+        uint64_t m_now;
+        uint64_t m_nextEvent;
+        std::array<uint64_t, EVENT_COUNT> m_deadlines;
+        std::array<PsxDevice *, EVENT_COUNT> m_handlers;
+};
+
+#endif /* !SCHEDULER_HPP_ */
@@ -26,27 +26,37 @@ SerialInterface::~SerialInterface()
 
 void SerialInterface::update(int cycles)
 {
-    m_sio0.update(cycles);
+    bool transferring = m_sio0.transferCycles() > 0;
 
-    if (m_sio0.irq()) {
+    // Interrupt once per completed transfer
+    m_sio0.update(cycles);
+    if (transferring && m_sio0.transferCycles() == 0 && m_sio0.irq()) {
         auto irqc = m_bus->getDevice<InterruptController>();
         irqc->triggerIRQ(DeviceIRQ::CONTROLLER_MEMCARD);
     }
 }
 
+void SerialInterface::onEvent(SchedulerEvent /* event */)
+{
+    catchUp();
+}
+
 void SerialInterface::reset()
 {
     m_sio0.reset();
+    m_lastUpdate = currentTime();
 }
 
 void SerialInterface::serialize(StateBuffer &buf) const
 {
     m_sio0.serialize(buf);
+    buf.write(m_lastUpdate);
 }
 
 void SerialInterface::deserialize(StateBuffer &buf)
 {
     m_sio0.deserialize(buf);
+    buf.read(m_lastUpdate);
 }
 
 void SerialInterface::write8(uint8_t value, uint32_t address)
@@ -64,7 +74,11 @@ void SerialInterface::write16(uint16_t value, uint32_t address)
         writeSIO1(value, address);
         return;
     }
+    catchUp();
     m_sio0.write(static_cast<SIORegister>(offset), value);
+    if (m_sio0.transferCycles() > 0) {
+        schedule(SchedulerEvent::Sio0Transfer, m_sio0.transferCycles());
+    }
 }
 
 void SerialInterface::write32(uint32_t value, uint32_t address)
@@ -86,6 +100,7 @@ uint16_t SerialInterface::read16(uint32_t address)
     if (channel) {
         return readSIO1(address);
     }
+    catchUp();
     return m_sio0.read(static_cast<SIORegister>(offset));
 }
 
@@ -24,6 +24,7 @@ class SerialInterface : public PsxDevice
         void deserialize(StateBuffer &buf) override;
 
         void update(int cycles) override;
+        void onEvent(SchedulerEvent event) override;
         void reset() override;
         DigitalPad &getPad(int index) { return m_sio0.getPad(index); }
 
@@ -0,0 +1,135 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SnapshotRing
+*/
+
+#include "SnapshotRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Bus.hpp"
+#include "CPU.hpp"
+
+SnapshotRing::SnapshotRing(CPU *cpu, Bus *bus, size_t capacity, size_t pageBudget) :
+    m_cpu(cpu),
+    m_bus(bus),
+    m_tracker(bus, MemoryWatch::Snapshot),
+    m_head(0),
+    m_count(0)
+{
+    // A single capture may need every page once all the older slots are dropped
+    size_t totalPages = m_tracker.totalPages();
+    if (pageBudget == 0) {
+        pageBudget = std::max<size_t>(capacity, 1) * DEFAULT_SLOT_PAGES;
+    }
+    size_t poolPages = std::max(pageBudget, totalPages);
+    m_pool.resize(poolPages << PAGE_SHIFT);
+    m_freePages.reserve(poolPages);
+    for (size_t page = poolPages; page > 0; page--) {
+        m_freePages.push_back(static_cast<uint32_t>(page - 1));
+    }
+
+    StateBuffer probe;
+    probe.setSnapshot(true);
+    m_cpu->serialize(probe);
+    m_bus->serialize(probe);
+
+    m_slots.resize(std::max<size_t>(capacity, 1));
+    for (auto &slot : m_slots) {
+        slot.state.setSnapshot(true);
+        slot.state.reserve(probe.size() + PAGE_SIZE);
+        slot.pages.reserve(totalPages);
+    }
+}
+
+SnapshotRing::~SnapshotRing()
+{
+}
+
+void SnapshotRing::capture()
+{
+    m_tracker.collect();
+    size_t needed = m_tracker.region(RegionId::Ram).dirtyPages.size() +
+        m_tracker.region(RegionId::Vram).dirtyPages.size();
+    while (m_count > 0 && (m_count == m_slots.size() || m_freePages.size() < needed)) {
+        dropOldest();
+    }
+
+    Slot &newest = slot(m_count);
+    newest.state.clear();
+    newest.pages.clear();
+    m_cpu->serialize(newest.state);
+    m_bus->serialize(newest.state);
+
+    for (RegionId id : {RegionId::Ram, RegionId::Vram}) {
+        auto &mem = m_tracker.region(id);
+        for (uint32_t page : mem.dirtyPages) {
+            size_t offset = static_cast<size_t>(page) << PAGE_SHIFT;
+            uint32_t index = m_freePages.back();
+            m_freePages.pop_back();
+            std::memcpy(slab(index), mem.shadow.data() + offset, PAGE_SIZE);
+            std::memcpy(mem.shadow.data() + offset, mem.data + offset, PAGE_SIZE);
+            newest.pages.push_back({id, page, index});
+        }
+    }
+    m_count++;
+    m_tracker.rearm();
+}
+
+bool SnapshotRing::rewind(size_t frames)
+{
+    if (frames >= m_count) {
+        return false;
+    }
+    m_tracker.collect();
+    m_tracker.restoreDirtyPages();
+
+    for (size_t i = 0; i < frames; i++) {
+        Slot &newest = slot(m_count - 1);
+        for (const auto &undo : newest.pages) {
+            applyUndo(undo);
+        }
+        newest.pages.clear();
+        m_count--;
+    }
+
+    Slot &target = slot(m_count - 1);
+    target.state.resetCursor();
+    m_cpu->deserialize(target.state);
+    m_bus->deserialize(target.state);
+    m_tracker.collect();
+    m_tracker.rearm();
+    return true;
+}
+
+void SnapshotRing::clear()
+{
+    while (m_count > 0) {
+        dropOldest();
+    }
+}
+
+void SnapshotRing::applyUndo(const UndoPage &undo)
+{
+    auto &mem = m_tracker.region(undo.region);
+    size_t offset = static_cast<size_t>(undo.page) << PAGE_SHIFT;
+
+    std::memcpy(mem.data + offset, slab(undo.slab), PAGE_SIZE);
+    std::memcpy(mem.shadow.data() + offset, slab(undo.slab), PAGE_SIZE);
+    m_freePages.push_back(undo.slab);
+    m_tracker.markWritten(undo.region, undo.page);
+}
+
+void SnapshotRing::dropOldest()
+{
+    Slot &oldest = slot(0);
+    for (const auto &undo : oldest.pages) {
+        m_freePages.push_back(undo.slab);
+    }
+    oldest.pages.clear();
+    m_head = (m_head + 1) % m_slots.size();
+    m_count--;
+}
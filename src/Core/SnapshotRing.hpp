@@ -0,0 +1,87 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SnapshotRing
+*/
+
+#ifndef SNAPSHOTRING_HPP_
+#define SNAPSHOTRING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryPageTracker.hpp"
+#include "StateBuffer.hpp"
+
+class CPU;
+class Bus;
+
+// In-memory ring of per-frame snapshots used for rewind and run-ahead.
+// Devices are serialized into reused buffers without RAM and VRAM. Those are
+// tracked in 4 KiB pages: a shadow copy holds the newest snapshot and each
+// slot keeps the previous content of the pages written during its frame.
+// All the storage is allocated up front, capturing never grows the heap.
+class SnapshotRing
+{
+    public:
+        static constexpr uint32_t PAGE_SHIFT = MemoryPageTracker::PAGE_SHIFT;
+        static constexpr uint32_t PAGE_SIZE = MemoryPageTracker::PAGE_SIZE;
+        static constexpr size_t DEFAULT_SLOT_PAGES = 64;
+
+        // pageBudget is the number of undo pages shared by the slots, 0 picks
+        // DEFAULT_SLOT_PAGES per slot. It is raised to one full copy of RAM and VRAM.
+        SnapshotRing(CPU *cpu, Bus *bus, size_t capacity, size_t pageBudget = 0);
+        ~SnapshotRing();
+
+        SnapshotRing(const SnapshotRing &) = delete;
+        SnapshotRing &operator=(const SnapshotRing &) = delete;
+
+        // Records the current state as the newest snapshot, dropping the
+        // oldest ones when the ring or the page budget is full
+        void capture();
+        // Restores the snapshot taken the given number of captures before the
+        // newest one, newer snapshots are discarded. 0 restores the newest.
+        bool rewind(size_t frames);
+        void clear();
+
+        size_t size() const { return m_count; }
+        size_t capacity() const { return m_slots.size(); }
+        size_t freePages() const { return m_freePages.size(); }
+
+    private:
+        using RegionId = MemoryPageTracker::RegionId;
+
+        struct UndoPage
+        {
+            RegionId region;
+            uint32_t page;
+            uint32_t slab;
+        };
+
+        struct Slot
+        {
+            StateBuffer state;
+            std::vector<UndoPage> pages;
+        };
+
+        void applyUndo(const UndoPage &undo);
+        void dropOldest();
+        Slot &slot(size_t index) { return m_slots[(m_head + index) % m_slots.size()]; }
+        uint8_t *slab(uint32_t index) { return m_pool.data() + (static_cast<size_t>(index) << PAGE_SHIFT); }
+
+    private:
+        CPU *m_cpu;
+        Bus *m_bus;
+        MemoryPageTracker m_tracker;
+
+        std::vector<Slot> m_slots;
+        size_t m_head;
+        size_t m_count;
+
+        std::vector<uint8_t> m_pool;
+        std::vector<uint32_t> m_freePages;
+};
+
+#endif /* !SNAPSHOTRING_HPP_ */
@@ -0,0 +1,82 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SpeedMeter
+*/
+
+#include "SpeedMeter.hpp"
+
+#include "System.hpp"
+
+SpeedMeter::SpeedMeter(double window) :
+    m_window(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(window)))
+{
+    reset();
+}
+
+void SpeedMeter::reset(Clock::time_point now)
+{
+    m_start = now;
+    m_windowStart = now;
+    m_last = now;
+    m_pausedAt = now;
+    m_paused = false;
+    m_windowFrames = 0;
+    m_windowCycles = 0;
+    m_totalFrames = 0;
+    m_totalCycles = 0;
+    m_current = {0.0, 0.0, 0.0};
+}
+
+void SpeedMeter::addFrame(uint64_t cycles, Clock::time_point now)
+{
+    m_windowFrames++;
+    m_windowCycles += cycles;
+    m_totalFrames++;
+    m_totalCycles += cycles;
+    m_last = now;
+    if (now - m_windowStart >= m_window) {
+        m_current = measure(m_windowFrames, m_windowCycles, std::chrono::duration<double>(now - m_windowStart).count());
+        m_windowStart = now;
+        m_windowFrames = 0;
+        m_windowCycles = 0;
+    }
+}
+
+void SpeedMeter::pause(Clock::time_point now)
+{
+    if (m_paused) {
+        return;
+    }
+    m_paused = true;
+    m_pausedAt = now;
+    m_current = {0.0, 0.0, 0.0};
+}
+
+void SpeedMeter::resume(Clock::time_point now)
+{
+    if (!m_paused) {
+        return;
+    }
+    // Shifts the time points as if the pause never happened
+    Clock::duration paused = now - m_pausedAt;
+    m_start += paused;
+    m_windowStart += paused;
+    m_last += paused;
+    m_paused = false;
+}
+
+GuestSpeed SpeedMeter::total() const
+{
+    return measure(m_totalFrames, m_totalCycles, std::chrono::duration<double>(m_last - m_start).count());
+}
+
+GuestSpeed SpeedMeter::measure(uint64_t frames, uint64_t cycles, double seconds)
+{
+    if (seconds <= 0.0) {
+        return {0.0, 0.0, 0.0};
+    }
+    double hz = cycles / seconds;
+    return {frames / seconds, hz / 1e6, hz / System::CPU_CLOCK};
+}
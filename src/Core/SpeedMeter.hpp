@@ -0,0 +1,68 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SpeedMeter
+*/
+
+#ifndef SPEEDMETER_HPP_
+#define SPEEDMETER_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+// Emulated speed against the host clock
+struct GuestSpeed
+{
+    double fps;
+    double mhz;
+    double multiplier; // Of the real CPU clock
+};
+
+// Measures the guest speed over windows of host time, and since the reset
+class SpeedMeter
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr double DEFAULT_WINDOW = 0.5; // Seconds
+
+        explicit SpeedMeter(double window = DEFAULT_WINDOW);
+
+        void reset() { reset(Clock::now()); }
+        void reset(Clock::time_point now);
+        // Counts a frame of the given emulated cycles, ending now
+        void addFrame(uint64_t cycles) { addFrame(cycles, Clock::now()); }
+        void addFrame(uint64_t cycles, Clock::time_point now);
+        // Leaves the host time between pause and resume out of the window
+        // and the total, e.g. while paused or at a breakpoint
+        void pause() { pause(Clock::now()); }
+        void pause(Clock::time_point now);
+        void resume() { resume(Clock::now()); }
+        void resume(Clock::time_point now);
+        bool isPaused() const { return m_paused; }
+
+        // Over the last complete window, zero before the first one and while paused
+        const GuestSpeed &current() const { return m_current; }
+        // Since the reset
+        GuestSpeed total() const;
+        uint64_t frames() const { return m_totalFrames; }
+        uint64_t cycles() const { return m_totalCycles; }
+
+        static GuestSpeed measure(uint64_t frames, uint64_t cycles, double seconds);
+
+    private:
+        Clock::duration m_window;
+        Clock::time_point m_start;
+        Clock::time_point m_windowStart;
+        Clock::time_point m_last;
+        Clock::time_point m_pausedAt;
+        bool m_paused;
+        uint64_t m_windowFrames;
+        uint64_t m_windowCycles;
+        uint64_t m_totalFrames;
+        uint64_t m_totalCycles;
+        GuestSpeed m_current;
+};
+
+#endif /* !SPEEDMETER_HPP_ */
@@ -17,7 +17,7 @@
 class StateBuffer
 {
     public:
-        StateBuffer() : m_cursor(0) {}
+        StateBuffer() : m_cursor(0), m_snapshot(false) {}
         ~StateBuffer() = default;
 
         void write(const void *data, size_t size)
@@ -91,9 +91,23 @@ class StateBuffer
 
         void resetCursor() { m_cursor = 0; }
 
+        // Empties the buffer but keeps its storage, so reused buffers stop allocating
+        void clear()
+        {
+            m_data.clear();
+            m_cursor = 0;
+        }
+
+        void reserve(size_t size) { m_data.reserve(size); }
+
+        // Snapshot buffers leave out RAM and VRAM, which snapshots track page by page
+        void setSnapshot(bool snapshot) { m_snapshot = snapshot; }
+        bool isSnapshot() const { return m_snapshot; }
+
     private:
         std::vector<uint8_t> m_data;
         size_t m_cursor;
+        bool m_snapshot;
 };
 
 #endif /* !STATEBUFFER_HPP_ */
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <fstream>
+#include <stdexcept>
 #include <spdlog/spdlog.h>
 #include <chrono>
 #include <thread>
@@ -14,13 +15,16 @@
 #include "InterruptController.hpp"
 #include "RAM.hpp"
 #include "SerialInterface.hpp"
+#include "TraceRecorder.hpp"
 
 static constexpr uint32_t SAVESTATE_MAGIC = 0x524F4745;
-static constexpr uint32_t SAVESTATE_VERSION = 1;
+static constexpr uint32_t SAVESTATE_VERSION = 3;
+static constexpr uint32_t DELTA_MAGIC = 0x524F4744;
 
 System::System() :
     m_bus(nullptr),
     m_cpu(nullptr),
+    m_deltaSequence(0),
     m_state(SystemState::RUNNING),
     m_executablePath("")
 {
@@ -28,6 +32,7 @@ System::System() :
 
 System::~System()
 {
+    stopTrace();
 }
 
 CPU *System::getCPU()
@@ -45,23 +50,53 @@ void System::setExecutablePath(const std::string &path)
     m_executablePath = path;
 }
 
+void System::setState(SystemState state)
+{
+    if (state == SystemState::RUNNING) {
+        m_speedMeter.resume();
+    } else {
+        m_speedMeter.pause();
+    }
+    m_state = state;
+}
+
 int System::init()
 {
+    stopTrace();
+    m_breakpoints.attach(nullptr, nullptr);
+    m_snapshots.reset();
+    m_deltaTracker.reset();
+    m_speedMeter.reset();
+    if (m_state != SystemState::RUNNING) {
+        m_speedMeter.pause();
+    }
     m_bus = std::make_unique<Bus>();
     m_cpu = std::make_unique<CPU>(m_bus.get());
     m_bus->connectCpu(m_cpu.get());
+    m_breakpoints.attach(m_cpu.get(), m_bus.get());
     return 0;
 }
 
-void System::tick()
+int System::tick()
 {
     if (m_cpu->getReg(CpuReg::PC) == 0x80030000 && !m_executablePath.empty()) {
         loadExecutable(m_executablePath.c_str());
     }
-    m_cpu->step();
-    m_bus->updateDevices(2);
-    if (m_debuggerCallback) {
-        m_debuggerCallback();
+    // Accesses made while paused, e.g. by the debugger, are not hits
+    bool armed = m_breakpoints.armed();
+    if (armed) [[unlikely]] {
+        m_breakpoints.clearHit();
+    }
+    // Devices only run once the scheduler reaches one of their events
+    uint32_t instructions = m_cpu->runBlock();
+    int cycles = static_cast<int>(instructions) * 2;
+    m_bus->getPerfCounters().frame().instructions += instructions;
+    m_bus->updateDevices(cycles);
+    if (armed && m_breakpoints.check(m_cpu->getReg(CpuReg::PC))) [[unlikely]] {
+        setState(SystemState::PAUSED);
+        if (m_debuggerCallback) {
+            m_debuggerCallback();
+        }
     }
     if (m_cpu->getTtyOutputFlag()) {
         auto output = m_cpu->getTtyOutput();
@@ -69,22 +104,107 @@ void System::tick()
             m_ttyCallback(output);
         }
     }
+    return cycles;
 }
 
 void System::update()
 {
-    const int cpuFreq = 33868800;
-    const int cyclesPerFrame = cpuFreq / 60;
-    int cycles = 0;
-
-    while (cycles < cyclesPerFrame) {
-        if (m_state == SystemState::RUNNING) {
-            tick();
+    uint64_t cycles = runFrame();
+    if (m_state == SystemState::RUNNING) {
+        m_speedMeter.addFrame(cycles);
+        if (m_snapshots) {
+            m_snapshots->capture();
         }
-        cycles += 2;
     }
 }
 
+double System::getRefreshRate() const
+{
+    return CPU_CLOCK / m_bus->getDevice<GPU>()->getFieldCycles();
+}
+
+uint64_t System::runFrame()
+{
+    GPU *gpu = m_bus->getDevice<GPU>();
+    auto &scheduler = m_bus->getScheduler();
+    auto &perf = m_bus->getPerfCounters();
+    uint64_t frameStart = scheduler.now();
+    uint64_t field = gpu->getFieldCount();
+
+    if (m_state != SystemState::RUNNING) {
+        return 0;
+    }
+    // A frame ends at the VBlank, so each one holds exactly one guest field
+    perf.beginFrame();
+    while (m_state == SystemState::RUNNING && gpu->getFieldCount() == field) {
+        tick();
+    }
+    perf.endFrame();
+    return scheduler.now() - frameStart;
+}
+
+bool System::startTrace(const std::string &path)
+{
+    stopTrace();
+    auto tracer = std::make_unique<TraceRecorder>();
+    if (!tracer->open(path)) {
+        return false;
+    }
+    m_tracer = std::move(tracer);
+    m_cpu->setTraceRecorder(m_tracer.get());
+    spdlog::info("System: Tracing to \"{}\"", path);
+    return true;
+}
+
+bool System::stopTrace()
+{
+    if (!m_tracer) {
+        return true;
+    }
+    m_cpu->setTraceRecorder(nullptr);
+    bool complete = m_tracer->close();
+    if (complete) {
+        spdlog::info("System: Trace closed, {} records", m_tracer->records());
+    } else {
+        spdlog::error("System: Trace closed incomplete, {} records were not all written", m_tracer->records());
+    }
+    m_tracer.reset();
+    return complete;
+}
+
+void System::enableSnapshots(size_t frames, size_t pageBudget)
+{
+    m_snapshots.reset();
+    if (frames > 0) {
+        m_snapshots = std::make_unique<SnapshotRing>(m_cpu.get(), m_bus.get(), frames, pageBudget);
+        m_snapshots->capture();
+    }
+}
+
+bool System::rewind(size_t frames)
+{
+    if (!m_snapshots) {
+        spdlog::error("System: Snapshots are not enabled");
+        return false;
+    }
+    return m_snapshots->rewind(frames);
+}
+
+bool System::runAhead(uint32_t frames, const std::function<void()> &present)
+{
+    if (!m_snapshots || m_snapshots->size() == 0) {
+        spdlog::error("System: Run-ahead needs snapshots to be enabled");
+        return false;
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+        runFrame();
+    }
+    if (present) {
+        present();
+    }
+    return m_snapshots->rewind(0);
+}
+
 void System::reset()
 {
     m_cpu->reset();
@@ -114,10 +234,10 @@ void System::updatePadInputs(uint16_t buttonsPort)
     m_bus->getDevice<SerialInterface>()->getPad(0).updateButtons(buttonsPort);
 }
 
-void System::loadBios(const char *path)
+bool System::loadBios(const char *path)
 {
     BIOS *bios = m_bus->getDevice<BIOS>();
-    bios->loadFromFile(path);
+    return bios->loadFromFile(path);
 }
 
 void System::setDebuggerCallback(const std::function<void()> &callback)
@@ -130,15 +250,41 @@ void System::setTtyCallback(const std::function<void(const std::string &)> &call
     m_ttyCallback = callback;
 }
 
-bool System::saveState(const std::string &path)
+void System::writeState(StateBuffer &buf) const
 {
-    StateBuffer buf;
-
     buf.write(SAVESTATE_MAGIC);
     buf.write(SAVESTATE_VERSION);
 
     m_cpu->serialize(buf);
     m_bus->serialize(buf);
+}
+
+bool System::readState(StateBuffer &buf)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    buf.read(magic);
+    buf.read(version);
+
+    if (magic != SAVESTATE_MAGIC) {
+        spdlog::error("System: Invalid savestate file (bad magic: 0x{:08X})", magic);
+        return false;
+    }
+    if (version != SAVESTATE_VERSION) {
+        spdlog::error("System: Incompatible savestate version (expected {}, got {})",
+                       SAVESTATE_VERSION, version);
+        return false;
+    }
+
+    m_cpu->deserialize(buf);
+    m_bus->deserialize(buf);
+    return true;
+}
+
+bool System::saveState(const std::string &path)
+{
+    StateBuffer buf;
+    writeState(buf);
 
     std::ofstream file(path, std::ios::out | std::ios::binary);
     if (!file.is_open()) {
@@ -175,25 +321,91 @@ bool System::loadState(const std::string &path)
 
     StateBuffer buf;
     buf.setData(std::move(data));
+    if (!readState(buf)) {
+        return false;
+    }
+
+    spdlog::info("System: State loaded from \"{}\"", path);
+    return true;
+}
 
+void System::resetDeltaTracking()
+{
+    if (m_deltaTracker) {
+        m_deltaTracker->resetShadow();
+    } else {
+        m_deltaTracker = std::make_unique<MemoryPageTracker>(m_bus.get(), MemoryWatch::Delta);
+    }
+    m_deltaSequence = 0;
+}
+
+void System::saveKeyframe(StateBuffer &buf)
+{
+    writeState(buf);
+    resetDeltaTracking();
+}
+
+bool System::saveDelta(StateBuffer &buf)
+{
+    if (!m_deltaTracker) {
+        spdlog::error("System: A keyframe must be saved before deltas");
+        return false;
+    }
+    m_deltaSequence++;
+    buf.write(DELTA_MAGIC);
+    buf.write(SAVESTATE_VERSION);
+    buf.write(m_deltaSequence);
+
+    buf.setSnapshot(true);
+    m_cpu->serialize(buf);
+    m_bus->serialize(buf);
+    buf.setSnapshot(false);
+    m_deltaTracker->writeDelta(buf);
+    return true;
+}
+
+bool System::loadKeyframe(StateBuffer &buf)
+{
+    if (!readState(buf)) {
+        return false;
+    }
+    resetDeltaTracking();
+    return true;
+}
+
+bool System::applyDelta(StateBuffer &buf)
+{
+    if (!m_deltaTracker) {
+        spdlog::error("System: A keyframe must be loaded before deltas");
+        return false;
+    }
     uint32_t magic = 0;
     uint32_t version = 0;
+    uint32_t sequence = 0;
     buf.read(magic);
     buf.read(version);
+    buf.read(sequence);
 
-    if (magic != SAVESTATE_MAGIC) {
-        spdlog::error("System: Invalid savestate file (bad magic: 0x{:08X})", magic);
+    if (magic != DELTA_MAGIC || version != SAVESTATE_VERSION) {
+        spdlog::error("System: Invalid delta savestate (magic 0x{:08X}, version {})", magic, version);
         return false;
     }
-    if (version != SAVESTATE_VERSION) {
-        spdlog::error("System: Incompatible savestate version (expected {}, got {})",
-                       SAVESTATE_VERSION, version);
+    if (sequence != m_deltaSequence + 1) {
+        spdlog::error("System: Delta {} does not follow delta {}", sequence, m_deltaSequence);
         return false;
     }
 
-    m_cpu->deserialize(buf);
-    m_bus->deserialize(buf);
-
-    spdlog::info("System: State loaded from \"{}\"", path);
+    try {
+        buf.setSnapshot(true);
+        m_cpu->deserialize(buf);
+        m_bus->deserialize(buf);
+        buf.setSnapshot(false);
+        m_deltaTracker->readDelta(buf);
+    } catch (const std::runtime_error &e) {
+        buf.setSnapshot(false);
+        spdlog::error("System: Corrupted delta savestate: {}", e.what());
+        return false;
+    }
+    m_deltaSequence = sequence;
     return true;
 }
@@ -8,8 +8,13 @@
 #include "CPU.hpp"
 #include "BIOS.hpp"
 #include "Bus.hpp"
+#include "BreakpointSet.hpp"
+#include "MemoryPageTracker.hpp"
+#include "SnapshotRing.hpp"
+#include "SpeedMeter.hpp"
 
 class Debugger;
+class TraceRecorder;
 
 enum class SystemState
 {
@@ -20,34 +25,80 @@ enum class SystemState
 class System
 {
     public:
+        static constexpr uint32_t CPU_CLOCK = 33868800; // Hz
+
         System();
         ~System();
 
         int init();
-        void tick();
+        int tick();
+        // Runs until the next VBlank
         void update();
         void reset();
-        void setState(SystemState state) { m_state = state; }
+        // Pauses the speed meter outside RUNNING
+        void setState(SystemState state);
         SystemState getState() const { return m_state; }
+        // Fields per second of the current video mode, about 59.29 NTSC or 49.76 PAL
+        double getRefreshRate() const;
+        // Guest speed of the frames run by update, against the host clock
+        SpeedMeter &getSpeedMeter() { return m_speedMeter; }
 
         bool saveState(const std::string &path);
         bool loadState(const std::string &path);
 
+        // Delta savestates: a keyframe holds the whole state, each following
+        // delta the devices and the memory pages written since the previous one
+        void saveKeyframe(StateBuffer &buf);
+        bool saveDelta(StateBuffer &buf);
+        bool loadKeyframe(StateBuffer &buf);
+        bool applyDelta(StateBuffer &buf);
+
+        // Captures a snapshot at the end of every frame, 0 frames disables it
+        void enableSnapshots(size_t frames, size_t pageBudget = 0);
+        SnapshotRing *getSnapshots() { return m_snapshots.get(); }
+        // Goes back the given number of frames, 0 returns to the last frame end
+        bool rewind(size_t frames);
+        // Runs frames ahead of the last snapshot, presents them, then restores it
+        bool runAhead(uint32_t frames, const std::function<void()> &present);
+
+        // Records every instruction and data access to a trace file until
+        // stopTrace, see TraceRecorder. Runs the CPU through the interpreter.
+        bool startTrace(const std::string &path);
+        // False if the trace file misses records
+        bool stopTrace();
+        TraceRecorder *getTraceRecorder() { return m_tracer.get(); }
+
         CPU *getCPU();
         Bus *getBus();
+        // Breakpoints pause the system, they are kept across init
+        BreakpointSet &getBreakpoints() { return m_breakpoints; }
 
         void setExecutablePath(const std::string &path);
 
-        void loadBios(const char *path);
+        bool loadBios(const char *path);
         void loadExecutable(const char *path);
         void updatePadInputs(uint16_t buttonsPort);
 
+        // Called when a breakpoint paused the system
         void setDebuggerCallback(const std::function<void()> &callback);
         void setTtyCallback(const std::function<void(const std::string &)> &callback);
 
+    private:
+        // Returns the cycles run
+        uint64_t runFrame();
+        void writeState(StateBuffer &buf) const;
+        bool readState(StateBuffer &buf);
+        void resetDeltaTracking();
+
     private:
         std::unique_ptr<Bus> m_bus;
         std::unique_ptr<CPU> m_cpu;
+        std::unique_ptr<SnapshotRing> m_snapshots;
+        std::unique_ptr<MemoryPageTracker> m_deltaTracker;
+        std::unique_ptr<TraceRecorder> m_tracer;
+        BreakpointSet m_breakpoints;
+        SpeedMeter m_speedMeter;
+        uint32_t m_deltaSequence;
         std::function<void(const std::string &)> m_ttyCallback;
         std::function<void()> m_debuggerCallback;
 
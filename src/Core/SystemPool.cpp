@@ -0,0 +1,83 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SystemPool
+*/
+
+#include "SystemPool.hpp"
+
+#include <utility>
+
+SystemPool::SystemPool(size_t threadCount) :
+    m_threadPool(threadCount)
+{
+}
+
+SystemPool::~SystemPool()
+{
+    m_threadPool.wait();
+}
+
+size_t SystemPool::addSystem()
+{
+    auto instance = std::make_unique<Instance>();
+    Instance *ptr = instance.get();
+
+    instance->system.init();
+    instance->system.setTtyCallback([ptr](const std::string &output) {
+        std::lock_guard lock(ptr->mutex);
+        ptr->ttyOutput.push_back(output);
+    });
+    m_instances.push_back(std::move(instance));
+    return m_instances.size() - 1;
+}
+
+System &SystemPool::getSystem(size_t index)
+{
+    return m_instances.at(index)->system;
+}
+
+void SystemPool::queueInput(size_t index, uint16_t buttons)
+{
+    auto &instance = *m_instances.at(index);
+    std::lock_guard lock(instance.mutex);
+
+    instance.inputs.push_back(buttons);
+}
+
+std::vector<std::string> SystemPool::takeTtyOutput(size_t index)
+{
+    auto &instance = *m_instances.at(index);
+    std::lock_guard lock(instance.mutex);
+
+    return std::exchange(instance.ttyOutput, {});
+}
+
+void SystemPool::runFrames(uint32_t frames)
+{
+    if (frames == 0) {
+        return;
+    }
+    for (auto &instance : m_instances) {
+        m_threadPool.submit([this, ptr = instance.get(), frames] { runFrame(*ptr, frames); });
+    }
+    m_threadPool.wait();
+}
+
+void SystemPool::runFrame(Instance &instance, uint32_t framesLeft)
+{
+    {
+        std::lock_guard lock(instance.mutex);
+        if (!instance.inputs.empty()) {
+            instance.system.updatePadInputs(instance.inputs.front());
+            instance.inputs.pop_front();
+        }
+    }
+    instance.system.update();
+
+    // The next frame goes to this worker's own queue, idle workers steal it
+    if (--framesLeft > 0) {
+        m_threadPool.submit([this, &instance, framesLeft] { runFrame(instance, framesLeft); });
+    }
+}
@@ -0,0 +1,58 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** SystemPool
+*/
+
+#ifndef SYSTEMPOOL_HPP_
+#define SYSTEMPOOL_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "System.hpp"
+#include "ThreadPool.hpp"
+
+// Owns many independent systems and runs them in parallel, one frame per task.
+// A system only ever runs on one thread at a time, its frames stay in order.
+class SystemPool
+{
+    public:
+        explicit SystemPool(size_t threadCount = std::thread::hardware_concurrency());
+        ~SystemPool();
+
+        // Creates and initializes a system, returns its index
+        size_t addSystem();
+        System &getSystem(size_t index);
+        size_t size() const { return m_instances.size(); }
+
+        // Queues pad states, one is applied before each following frame
+        void queueInput(size_t index, uint16_t buttons);
+        // Returns and clears the TTY lines printed by the system
+        std::vector<std::string> takeTtyOutput(size_t index);
+
+        // Runs every system for the given number of frames, blocks until done
+        void runFrames(uint32_t frames);
+
+    private:
+        struct Instance
+        {
+            System system;
+            std::mutex mutex;
+            std::deque<uint16_t> inputs;
+            std::vector<std::string> ttyOutput;
+        };
+
+        void runFrame(Instance &instance, uint32_t framesLeft);
+
+    private:
+        std::vector<std::unique_ptr<Instance>> m_instances;
+        ThreadPool m_threadPool;
+};
+
+#endif /* !SYSTEMPOOL_HPP_ */
@@ -0,0 +1,125 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** ThreadPool
+*/
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+// Index of the pool worker running on this thread, if any
+static thread_local const ThreadPool *t_pool = nullptr;
+static thread_local size_t t_workerIndex = 0;
+
+ThreadPool::ThreadPool(size_t threadCount) :
+    m_queuedTasks(0),
+    m_pendingTasks(0),
+    m_nextQueue(0),
+    m_stopping(false)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    for (size_t i = 0; i < threadCount; i++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    size_t queue;
+    {
+        std::lock_guard lock(m_mutex);
+        if (t_pool == this) {
+            queue = t_workerIndex;
+        } else {
+            queue = m_nextQueue;
+            m_nextQueue = (m_nextQueue + 1) % m_queues.size();
+        }
+        m_queuedTasks++;
+        m_pendingTasks++;
+    }
+    {
+        std::lock_guard lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+    m_workAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_allDone.wait(lock, [this] { return m_pendingTasks == 0; });
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_workAvailable.wait(lock, [this] { return m_stopping || m_queuedTasks > 0; });
+            if (m_stopping && m_queuedTasks == 0) {
+                return;
+            }
+            // Claim a task before looking for it, so the counters never go negative
+            m_queuedTasks--;
+        }
+
+        Task task;
+        while (!popTask(index, task) && !stealTask(index, task)) {
+            // The claimed task is still being pushed by its submitter
+            std::this_thread::yield();
+        }
+        task();
+
+        std::lock_guard lock(m_mutex);
+        if (--m_pendingTasks == 0) {
+            m_allDone.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(size_t index, Task &task)
+{
+    auto &queue = *m_queues[index];
+    std::lock_guard lock(queue.mutex);
+
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t thief, Task &task)
+{
+    for (size_t i = 1; i < m_queues.size(); i++) {
+        auto &queue = *m_queues[(thief + i) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
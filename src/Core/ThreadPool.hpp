@@ -0,0 +1,65 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** ThreadPool
+*/
+
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool: every worker owns a task deque, pops its own
+// work from the back and steals from the front of the others when idle
+class ThreadPool
+{
+    public:
+        using Task = std::function<void()>;
+
+        explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Tasks submitted from a worker go to its own deque
+        void submit(Task task);
+        // Blocks until every submitted task, including the ones they submitted, is done
+        void wait();
+
+        size_t threadCount() const { return m_workers.size(); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void workerLoop(size_t index);
+        bool popTask(size_t index, Task &task);
+        bool stealTask(size_t thief, Task &task);
+
+    private:
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_allDone;
+        size_t m_queuedTasks;
+        size_t m_pendingTasks;
+        size_t m_nextQueue;
+        bool m_stopping;
+};
+
+#endif /* !THREADPOOL_HPP_ */
@@ -2,32 +2,48 @@
 #include "StateBuffer.hpp"
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
 
 #include "MemoryMap.hpp"
 #include "Bus.hpp"
+#include "Log.hpp"
 #include "InterruptController.hpp"
 
 Timers::Timers(Bus *bus) :
     PsxDevice(bus)
 {
     m_memoryRange = MemoryMap::TIMERS_RANGE;
-    for (auto &timer : m_timers) {
-        memset(&timer, 0, sizeof(timer));
-    }
+    reset();
 }
 
 Timers::~Timers()
 {
 }
 
+void Timers::reset()
+{
+    for (auto &timer : m_timers) {
+        memset(&timer, 0, sizeof(timer));
+    }
+    m_timer2Prescaler = 0;
+    m_lastUpdate = currentTime();
+    for (uint8_t i = 0; i < 3; i++) {
+        scheduleTimer(i);
+    }
+}
+
 void Timers::serialize(StateBuffer &buf) const
 {
     buf.write(m_timers, sizeof(m_timers));
+    buf.write(m_timer2Prescaler);
+    buf.write(m_lastUpdate);
 }
 
 void Timers::deserialize(StateBuffer &buf)
 {
     buf.read(m_timers, sizeof(m_timers));
+    buf.read(m_timer2Prescaler);
+    buf.read(m_lastUpdate);
 }
 
 void Timers::update(int cycles)
@@ -37,6 +53,12 @@ void Timers::update(int cycles)
     }
 }
 
+void Timers::onEvent(SchedulerEvent event)
+{
+    catchUp();
+    scheduleTimer(static_cast<uint8_t>(event) - static_cast<uint8_t>(SchedulerEvent::Timer0));
+}
+
 void Timers::updateTimer(uint8_t index, int cycles)
 {
     Timer &timer = m_timers[index];
@@ -45,28 +67,39 @@ void Timers::updateTimer(uint8_t index, int cycles)
         return;
     }
 
-    timer.currentValue += computeTimerCycles(cycles, index);
-
-    if (timer.currentValue >= (timer.targetValue & 0xFFFF)) {
-        timer.mode.reachedTarget = true;
-
-        if (timer.mode.irqTarget) {
-            triggerIRQ(index);
+    uint32_t ticks = computeTimerCycles(cycles, index);
+    uint32_t target = timer.targetValue & 0xFFFF;
+
+    // Step from one boundary (target or 0xFFFF) to the next
+    while (ticks > 0) {
+        uint32_t boundary = (timer.currentValue < target) ? target : 0xFFFF;
+        uint32_t step = std::min(ticks, boundary - timer.currentValue);
+        timer.currentValue += step;
+        ticks -= step;
+
+        if (timer.currentValue == target) {
+            timer.mode.reachedTarget = true;
+
+            if (timer.mode.irqTarget) {
+                triggerIRQ(index);
+            }
+
+            if (timer.mode.resetCounter) {
+                timer.currentValue = 0;
+                if (target > 0) {
+                    // Whole periods only set flags that are already set
+                    ticks %= target;
+                }
+                continue;
+            }
         }
 
-        if (timer.mode.resetCounter) {
-            timer.currentValue = 0;
-        }
-    }
-
-    if (timer.currentValue >= 0xFFFF) {
-        timer.mode.reachedMax = true;
-
-        if (timer.mode.irqMax) {
-            triggerIRQ(index);
-        }
+        if (timer.currentValue >= 0xFFFF) {
+            timer.mode.reachedMax = true;
 
-        if (!timer.mode.resetCounter) {
+            if (timer.mode.irqMax) {
+                triggerIRQ(index);
+            }
             timer.currentValue = 0;
         }
     }
@@ -77,14 +110,45 @@ int Timers::computeTimerCycles(int cycles, uint8_t index)
     Timer &timer = m_timers[index];
 
     switch (index) {
-        case 0: return (timer.mode.clockSource & 0b01) ? cycles : cycles;
+        case 0: return cycles;
         case 1: return (timer.mode.clockSource & 0b01) ? 0 : cycles;
-        case 2: return (timer.mode.clockSource & 0b10) ? cycles / 8 : cycles;
+        case 2:
+            if (timer.mode.clockSource & 0b10) {
+                cycles += m_timer2Prescaler;
+                m_timer2Prescaler = cycles % 8;
+                return cycles / 8;
+            }
+            return cycles;
         default:
             return 0;
     }
 }
 
+void Timers::scheduleTimer(uint8_t index)
+{
+    const Timer &timer = m_timers[index];
+    auto event = static_cast<SchedulerEvent>(static_cast<uint8_t>(SchedulerEvent::Timer0) + index);
+
+    // Counters are caught up lazily, only interrupts need an event
+    if (timer.paused || (!timer.mode.irqTarget && !timer.mode.irqMax)) {
+        schedule(event, Scheduler::NEVER);
+        return;
+    }
+
+    uint32_t target = timer.targetValue & 0xFFFF;
+    uint64_t ticks = (timer.currentValue < target) ? target - timer.currentValue : 0xFFFF - timer.currentValue;
+    ticks = std::max<uint64_t>(ticks, 1);
+
+    if (index == 1 && (timer.mode.clockSource & 0b01)) {
+        // Counted on HBlank
+        schedule(event, Scheduler::NEVER);
+    } else if (index == 2 && (timer.mode.clockSource & 0b10)) {
+        schedule(event, ticks * 8 - m_timer2Prescaler);
+    } else {
+        schedule(event, ticks);
+    }
+}
+
 void Timers::triggerIRQ(uint8_t index)
 {
     Timer &timer = m_timers[index];
@@ -98,7 +162,7 @@ void Timers::triggerIRQ(uint8_t index)
         timer.mode.irqTarget = false;
         timer.mode.irqMax = false;
     }
-    spdlog::trace("Timers: Timer {} IRQ triggered", index);
+    ROGEM_TRACE(LogSubsystem::Timers, "Timers: Timer {} IRQ triggered", index);
     auto irqc = m_bus->getDevice<InterruptController>();
     if (irqc) {
         auto deviceIrq = DeviceIRQ::TIMER0;
@@ -189,13 +253,13 @@ void Timers::write8(uint8_t value, uint32_t address)
 
 void Timers::write16(uint16_t value, uint32_t address)
 {
-    spdlog::trace("Timers: Write halfword 0x{:04X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::Timers, "Timers: Write halfword 0x{:04X} to 0x{:08X}", value, address);
     writeTimer(address, value);
 }
 
 void Timers::write32(uint32_t value, uint32_t address)
 {
-    spdlog::trace("Timers: Write word 0x{:08X} to 0x{:08X}", value, address);
+    ROGEM_TRACE(LogSubsystem::Timers, "Timers: Write word 0x{:08X} to 0x{:08X}", value, address);
     writeTimer(address, value);
 }
 
@@ -207,18 +271,20 @@ uint8_t Timers::read8(uint32_t address)
 
 uint16_t Timers::read16(uint32_t address)
 {
-    spdlog::trace("Timers: Read halfword at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::Timers, "Timers: Read halfword at 0x{:08X}", address);
     return static_cast<uint16_t>(readTimer(address));
 }
 
 uint32_t Timers::read32(uint32_t address)
 {
-    spdlog::trace("Timers: Read word at 0x{:08X}", address);
+    ROGEM_TRACE(LogSubsystem::Timers, "Timers: Read word at 0x{:08X}", address);
     return readTimer(address);
 }
 
 uint32_t Timers::readTimer(uint32_t address)
 {
+    catchUp();
+
     uint8_t timer = (address & 0x30) >> 4;
     uint8_t offset = address & 0xF;
 
@@ -235,6 +301,8 @@ uint32_t Timers::readTimer(uint32_t address)
 
 void Timers::writeTimer(uint32_t address, uint32_t value)
 {
+    catchUp();
+
     uint8_t timer = (address & 0x30) >> 4;
     uint8_t offset = address & 0xF;
 
@@ -246,4 +314,5 @@ void Timers::writeTimer(uint32_t address, uint32_t value)
         default:
             break;
     }
+    scheduleTimer(timer);
 }
@@ -45,6 +45,8 @@ class Timers : public PsxDevice
         ~Timers();
 
         void update(int cycles) override;
+        void onEvent(SchedulerEvent event) override;
+        void reset() override;
 
         void serialize(StateBuffer &buf) const override;
         void deserialize(StateBuffer &buf) override;
@@ -67,10 +69,12 @@ class Timers : public PsxDevice
         void writeTimer(uint32_t address, uint32_t value);
         void updateTimer(uint8_t index, int cycles);
         int computeTimerCycles(int cycles, uint8_t index);
+        void scheduleTimer(uint8_t index);
         void triggerIRQ(uint8_t index);
 
     private:
         Timer m_timers[3];
+        int m_timer2Prescaler; // System clock cycles not yet counted by timer 2
 };
 
 #endif /* !TIMERS_HPP_ */
@@ -0,0 +1,161 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceFile
+*/
+
+#include "TraceFile.hpp"
+
+#include <cstring>
+
+static constexpr uint8_t KIND_MASK = 0x3;
+static constexpr uint8_t EXTRA_SHIFT = 2;
+
+static void writeVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool readVarint(std::istream &in, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::istream::traits_type::eof()) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return static_cast<int32_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+// 1, 2 and 4 byte accesses fit in two bits
+static uint8_t sizeCode(uint8_t size)
+{
+    return size == 4 ? 2 : size == 2 ? 1 : 0;
+}
+
+TraceEncoder::TraceEncoder() :
+    m_state{}
+{
+}
+
+void TraceEncoder::writeHeader(std::vector<uint8_t> &out)
+{
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(VERSION >> (i * 8)));
+    }
+}
+
+void TraceEncoder::encode(const TraceRecord &record, std::vector<uint8_t> &out)
+{
+    switch (record.kind) {
+        case TraceRecordKind::Instruction:
+            out.push_back(static_cast<uint8_t>(record.kind));
+            writeVarint(out, zigzag(static_cast<int32_t>(record.address - (m_state.pc + 4))));
+            writeVarint(out, record.cycle - m_state.cycle);
+            for (int i = 0; i < 4; i++) {
+                out.push_back(static_cast<uint8_t>(record.value >> (i * 8)));
+            }
+            m_state.pc = record.address;
+            m_state.cycle = record.cycle;
+            break;
+        case TraceRecordKind::Register:
+            out.push_back(static_cast<uint8_t>(record.kind) | (record.reg << EXTRA_SHIFT));
+            writeVarint(out, record.value ^ m_state.registers[record.reg]);
+            m_state.registers[record.reg] = record.value;
+            break;
+        case TraceRecordKind::Load:
+        case TraceRecordKind::Store:
+            out.push_back(static_cast<uint8_t>(record.kind) | (sizeCode(record.size) << EXTRA_SHIFT));
+            writeVarint(out, zigzag(static_cast<int32_t>(record.address - m_state.address)));
+            writeVarint(out, record.value);
+            m_state.address = record.address;
+            break;
+    }
+}
+
+TraceDecoder::TraceDecoder() :
+    m_state{}
+{
+}
+
+bool TraceDecoder::readHeader(std::istream &in)
+{
+    char magic[sizeof(TraceEncoder::MAGIC)];
+    uint8_t version[4];
+
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(version), sizeof(version));
+    if (!in || std::memcmp(magic, TraceEncoder::MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    uint32_t value = version[0] | (version[1] << 8) | (version[2] << 16) | (static_cast<uint32_t>(version[3]) << 24);
+    return value == TraceEncoder::VERSION;
+}
+
+bool TraceDecoder::next(std::istream &in, TraceRecord &record)
+{
+    int tag = in.get();
+    uint64_t first;
+    uint64_t second;
+
+    if (tag == std::istream::traits_type::eof()) {
+        return false;
+    }
+    record = TraceRecord{};
+    record.kind = static_cast<TraceRecordKind>(tag & KIND_MASK);
+    switch (record.kind) {
+        case TraceRecordKind::Instruction: {
+            uint8_t opcode[4];
+            if (!readVarint(in, first) || !readVarint(in, second) ||
+                !in.read(reinterpret_cast<char *>(opcode), sizeof(opcode))) {
+                return false;
+            }
+            m_state.pc += 4 + unzigzag(static_cast<uint32_t>(first));
+            m_state.cycle += second;
+            record.address = m_state.pc;
+            record.cycle = m_state.cycle;
+            record.value = opcode[0] | (opcode[1] << 8) | (opcode[2] << 16) | (static_cast<uint32_t>(opcode[3]) << 24);
+            return true;
+        }
+        case TraceRecordKind::Register:
+            if (!readVarint(in, first)) {
+                return false;
+            }
+            record.reg = static_cast<uint8_t>(tag >> EXTRA_SHIFT) % TRACE_GPR_COUNT;
+            m_state.registers[record.reg] ^= static_cast<uint32_t>(first);
+            record.value = m_state.registers[record.reg];
+            return true;
+        case TraceRecordKind::Load:
+        case TraceRecordKind::Store:
+            if (!readVarint(in, first) || !readVarint(in, second)) {
+                return false;
+            }
+            m_state.address += unzigzag(static_cast<uint32_t>(first));
+            record.address = m_state.address;
+            record.value = static_cast<uint32_t>(second);
+            record.size = static_cast<uint8_t>(1 << ((tag >> EXTRA_SHIFT) & 0x3));
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,79 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceFile
+*/
+
+#ifndef TRACEFILE_HPP_
+#define TRACEFILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+enum class TraceRecordKind : uint8_t
+{
+    Instruction,
+    Register,
+    Load,
+    Store
+};
+
+// One event of an instruction trace. An instruction record comes first, then
+// the data accesses it made and the general purpose registers it changed.
+struct TraceRecord
+{
+    uint64_t cycle;   // Instruction start
+    uint32_t address; // Instruction PC, or memory address of an access
+    uint32_t value;   // Opcode, new register value or value accessed
+    TraceRecordKind kind;
+    uint8_t reg;      // Register changed
+    uint8_t size;     // Access size in bytes
+};
+
+static constexpr size_t TRACE_GPR_COUNT = 32;
+
+// Previous values the records are encoded against
+struct TraceCodecState
+{
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t address;
+    uint32_t registers[TRACE_GPR_COUNT];
+};
+
+// Trace files start with a header, then every record is a tag byte followed
+// by LEB128 varints relative to the previous record of the same kind: a
+// straight-line instruction is 1 tag, 2 small deltas and the opcode.
+class TraceEncoder
+{
+    public:
+        static constexpr char MAGIC[8] = {'R', 'G', 'M', 'T', 'R', 'A', 'C', 'E'};
+        static constexpr uint32_t VERSION = 1;
+
+        TraceEncoder();
+
+        static void writeHeader(std::vector<uint8_t> &out);
+        void encode(const TraceRecord &record, std::vector<uint8_t> &out);
+
+    private:
+        TraceCodecState m_state;
+};
+
+class TraceDecoder
+{
+    public:
+        TraceDecoder();
+
+        // Returns false when the stream is not a trace of a known version
+        bool readHeader(std::istream &in);
+        // Returns false at the end of the stream or on a truncated record
+        bool next(std::istream &in, TraceRecord &record);
+
+    private:
+        TraceCodecState m_state;
+};
+
+#endif /* !TRACEFILE_HPP_ */
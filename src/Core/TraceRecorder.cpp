@@ -0,0 +1,139 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceRecorder
+*/
+
+#include "TraceRecorder.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <vector>
+
+TraceRecorder::TraceRecorder(size_t capacity) :
+    m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+    m_head(0),
+    m_tail(0),
+    m_cachedHead(0),
+    m_records(0),
+    m_stalls(0),
+    m_registers{},
+    m_stopping(false),
+    m_writeFailed(false)
+{
+    m_ring = std::make_unique<TraceRecord[]>(m_mask + 1);
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    close();
+}
+
+bool TraceRecorder::open(const std::string &path)
+{
+    close();
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        spdlog::error("TraceRecorder: Cannot open \"{}\"", path);
+        return false;
+    }
+    std::vector<uint8_t> header;
+    TraceEncoder::writeHeader(header);
+    m_file.write(reinterpret_cast<const char *>(header.data()), header.size());
+
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_cachedHead = 0;
+    m_records = 0;
+    m_stalls = 0;
+    std::fill(std::begin(m_registers), std::end(m_registers), 0);
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_writeFailed = false;
+    m_writer = std::thread(&TraceRecorder::writerLoop, this);
+    return true;
+}
+
+bool TraceRecorder::close()
+{
+    if (!m_writer.joinable()) {
+        return !m_writeFailed;
+    }
+    m_stopping.store(true, std::memory_order_release);
+    m_writer.join();
+    m_file.close();
+    return !m_writeFailed;
+}
+
+void TraceRecorder::recordRegisters(const uint32_t *gpr)
+{
+    for (uint8_t reg = 1; reg < TRACE_GPR_COUNT; reg++) {
+        if (gpr[reg] != m_registers[reg]) {
+            m_registers[reg] = gpr[reg];
+            push({0, 0, gpr[reg], TraceRecordKind::Register, reg, 0});
+        }
+    }
+}
+
+void TraceRecorder::push(const TraceRecord &record)
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+
+    if (tail - m_cachedHead > m_mask) {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        if (tail - m_cachedHead > m_mask) {
+            m_stalls++;
+        }
+        while (tail - m_cachedHead > m_mask) {
+            std::this_thread::yield();
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+    }
+    m_ring[tail & m_mask] = record;
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_records++;
+}
+
+void TraceRecorder::writerLoop()
+{
+    TraceEncoder encoder;
+    std::vector<uint8_t> out;
+    size_t head = m_head.load(std::memory_order_relaxed);
+
+    while (true) {
+        // Read before the tail: the records pushed before stopping are all written
+        bool stopping = m_stopping.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        for (; head != tail; head++) {
+            encoder.encode(m_ring[head & m_mask], out);
+        }
+        m_head.store(head, std::memory_order_release);
+        // After a failure the ring is still drained, the emulation must not wait forever
+        if (!m_writeFailed) {
+            m_file.write(reinterpret_cast<const char *>(out.data()), out.size());
+            checkWrite();
+        }
+        out.clear();
+    }
+    if (!m_writeFailed) {
+        m_file.flush();
+        checkWrite();
+    }
+}
+
+void TraceRecorder::checkWrite()
+{
+    if (!m_file) {
+        spdlog::error("TraceRecorder: Cannot write the trace, the records left are lost");
+        m_writeFailed = true;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceRecorder
+*/
+
+#ifndef TRACERECORDER_HPP_
+#define TRACERECORDER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "TraceFile.hpp"
+
+// Records the instructions run and the data accesses they make to a trace
+// file. The emulation thread fills a single producer, single consumer ring
+// of fixed-size records, a writer thread encodes and writes them. Records
+// are never dropped: a full ring makes the emulation wait for the writer.
+class TraceRecorder
+{
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+        // capacity is rounded up to a power of two
+        explicit TraceRecorder(size_t capacity = DEFAULT_CAPACITY);
+        ~TraceRecorder();
+
+        TraceRecorder(const TraceRecorder &) = delete;
+        TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+        bool open(const std::string &path);
+        // Writes the records left in the ring and closes the file, false if
+        // a write failed and the file misses records
+        bool close();
+        bool isOpen() const { return m_writer.joinable(); }
+
+        void recordInstruction(uint32_t pc, uint32_t opcode, uint64_t cycle)
+        {
+            push({cycle, pc, opcode, TraceRecordKind::Instruction, 0, 0});
+        }
+        void recordLoad(uint32_t address, uint32_t value, uint8_t size)
+        {
+            push({0, address, value, TraceRecordKind::Load, 0, size});
+        }
+        void recordStore(uint32_t address, uint32_t value, uint8_t size)
+        {
+            push({0, address, value, TraceRecordKind::Store, 0, size});
+        }
+        // Records the registers that differ from the previous call
+        void recordRegisters(const uint32_t *gpr);
+
+        uint64_t records() const { return m_records; }
+        // Times the emulation had to wait for the writer
+        uint64_t stalls() const { return m_stalls; }
+
+    private:
+        void push(const TraceRecord &record);
+        void writerLoop();
+        void checkWrite();
+
+    private:
+        std::unique_ptr<TraceRecord[]> m_ring;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_head; // Next record the writer reads
+        alignas(64) std::atomic<size_t> m_tail; // Next record the emulation writes
+        size_t m_cachedHead;
+        uint64_t m_records;
+        uint64_t m_stalls;
+        uint32_t m_registers[TRACE_GPR_COUNT];
+
+        std::atomic<bool> m_stopping;
+        bool m_writeFailed; // Owned by the writer thread until it is joined
+        std::ofstream m_file;
+        std::thread m_writer;
+};
+
+#endif /* !TRACERECORDER_HPP_ */
@@ -0,0 +1,80 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceRing
+*/
+
+#include "TraceRing.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+TraceRing::TraceRing(size_t capacity) :
+    m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+    m_head(0),
+    m_tail(0),
+    m_dropped(0)
+{
+    m_slots = std::make_unique<Slot[]>(m_mask + 1);
+    for (size_t i = 0; i <= m_mask; i++) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Each slot sequence tells whose turn it is: equal to the position when the
+// slot is free for a producer, one past it once the record is readable
+bool TraceRing::push(LogSubsystem subsystem, std::string_view text)
+{
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t length = std::min(text.size(), TEXT_SIZE);
+    slot->record.subsystem = subsystem;
+    slot->record.length = static_cast<uint8_t>(length);
+    std::memcpy(slot->record.text, text.data(), length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool TraceRing::pop(Record &record)
+{
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    record = slot->record;
+    slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceRing
+*/
+
+#ifndef TRACERING_HPP_
+#define TRACERING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+enum class LogSubsystem : uint8_t;
+
+// Bounded lock-free queue of trace messages. Emulation threads push, a
+// debugger or a test drains it. Pushing never waits: a message that does not
+// fit is dropped and counted instead.
+class TraceRing
+{
+    public:
+        static constexpr size_t TEXT_SIZE = 118;
+
+        struct Record
+        {
+            LogSubsystem subsystem;
+            uint8_t length;
+            char text[TEXT_SIZE];
+
+            std::string_view view() const { return {text, length}; }
+        };
+
+        // capacity is rounded up to a power of two
+        explicit TraceRing(size_t capacity);
+        ~TraceRing() = default;
+
+        TraceRing(const TraceRing &) = delete;
+        TraceRing &operator=(const TraceRing &) = delete;
+
+        // Text longer than TEXT_SIZE is truncated
+        bool push(LogSubsystem subsystem, std::string_view text);
+        bool pop(Record &record);
+
+        size_t capacity() const { return m_mask + 1; }
+        uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_head;
+        alignas(64) std::atomic<size_t> m_tail;
+        alignas(64) std::atomic<uint64_t> m_dropped;
+};
+
+#endif /* !TRACERING_HPP_ */
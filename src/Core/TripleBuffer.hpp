@@ -0,0 +1,67 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TripleBuffer
+*/
+
+#ifndef TRIPLEBUFFER_HPP_
+#define TRIPLEBUFFER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Lock-free handoff of the latest value from one producer thread to one
+// consumer thread. Each side owns a buffer and they swap it with the middle
+// one, so neither ever waits: the producer overwrites values the consumer
+// did not take, the consumer keeps the last value while nothing new comes.
+template<typename T>
+class TripleBuffer
+{
+    public:
+        TripleBuffer() :
+            m_buffers(std::make_unique<T[]>(3)),
+            m_back(0),
+            m_middle(1),
+            m_front(2)
+        {
+        }
+
+        TripleBuffer(const TripleBuffer &) = delete;
+        TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+        // Producer side: fill the back buffer, then publish it
+        T &back() { return m_buffers[m_back]; }
+        void publish()
+        {
+            uint8_t previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+            m_back = previous & INDEX_MASK;
+        }
+
+        // Consumer side: returns the newest published value, nullptr when
+        // nothing was published since the last call
+        const T *acquire()
+        {
+            if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) {
+                return nullptr;
+            }
+            uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & INDEX_MASK;
+            return &m_buffers[m_front];
+        }
+        // Last value acquired
+        const T &front() const { return m_buffers[m_front]; }
+
+    private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        static constexpr uint8_t FRESH = 0x4;
+
+    private:
+        std::unique_ptr<T[]> m_buffers;
+        alignas(64) uint8_t m_back;
+        alignas(64) std::atomic<uint8_t> m_middle;
+        alignas(64) uint8_t m_front;
+};
+
+#endif /* !TRIPLEBUFFER_HPP_ */
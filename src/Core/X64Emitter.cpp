@@ -0,0 +1,269 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** X64Emitter
+*/
+
+#include "X64Emitter.hpp"
+
+#include <cstring>
+
+static uint8_t regId(X64Reg reg)
+{
+    return static_cast<uint8_t>(reg);
+}
+
+X64Emitter::X64Emitter(uint8_t *buffer, size_t capacity) :
+    m_buffer(buffer),
+    m_capacity(capacity),
+    m_size(0),
+    m_overflow(false)
+{
+}
+
+void X64Emitter::emit8(uint8_t value)
+{
+    if (m_size >= m_capacity) {
+        m_overflow = true;
+        return;
+    }
+    m_buffer[m_size++] = value;
+}
+
+void X64Emitter::emit32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        emit8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void X64Emitter::emit64(uint64_t value)
+{
+    emit32(static_cast<uint32_t>(value));
+    emit32(static_cast<uint32_t>(value >> 32));
+}
+
+void X64Emitter::rex(bool wide, uint8_t reg, uint8_t rm, bool byteRegs)
+{
+    uint8_t prefix = 0x40;
+    if (wide) {
+        prefix |= 0x08;
+    }
+    if (reg & 8) {
+        prefix |= 0x04;
+    }
+    if (rm & 8) {
+        prefix |= 0x01;
+    }
+    // SPL/BPL/SIL/DIL need an empty REX to be addressable as bytes
+    if (prefix != 0x40 || (byteRegs && (reg >= 4 || rm >= 4))) {
+        emit8(prefix);
+    }
+}
+
+void X64Emitter::modrm(uint8_t mod, uint8_t reg, uint8_t rm)
+{
+    emit8(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
+}
+
+void X64Emitter::memOperand(uint8_t reg, X64Reg base, int32_t disp)
+{
+    uint8_t rm = regId(base);
+    modrm(2, reg, rm);
+    if ((rm & 7) == 4) {
+        emit8(0x24); // SIB: base only
+    }
+    emit32(static_cast<uint32_t>(disp));
+}
+
+void X64Emitter::load32(X64Reg dst, X64Reg base, int32_t disp)
+{
+    rex(false, regId(dst), regId(base));
+    emit8(0x8B);
+    memOperand(regId(dst), base, disp);
+}
+
+void X64Emitter::store32(X64Reg base, int32_t disp, X64Reg src)
+{
+    rex(false, regId(src), regId(base));
+    emit8(0x89);
+    memOperand(regId(src), base, disp);
+}
+
+void X64Emitter::store32(X64Reg base, int32_t disp, uint32_t imm)
+{
+    rex(false, 0, regId(base));
+    emit8(0xC7);
+    memOperand(0, base, disp);
+    emit32(imm);
+}
+
+void X64Emitter::cmp8(X64Reg base, int32_t disp, uint8_t imm)
+{
+    rex(false, 0, regId(base));
+    emit8(0x80);
+    memOperand(7, base, disp);
+    emit8(imm);
+}
+
+void X64Emitter::mov32(X64Reg dst, uint32_t imm)
+{
+    rex(false, 0, regId(dst));
+    emit8(static_cast<uint8_t>(0xB8 + (regId(dst) & 7)));
+    emit32(imm);
+}
+
+void X64Emitter::mov64(X64Reg dst, uint64_t imm)
+{
+    rex(true, 0, regId(dst));
+    emit8(static_cast<uint8_t>(0xB8 + (regId(dst) & 7)));
+    emit64(imm);
+}
+
+void X64Emitter::mov64(X64Reg dst, X64Reg src)
+{
+    rex(true, regId(src), regId(dst));
+    emit8(0x89);
+    modrm(3, regId(src), regId(dst));
+}
+
+void X64Emitter::alu32(X64AluOp op, X64Reg dst, X64Reg src)
+{
+    rex(false, regId(src), regId(dst));
+    emit8(static_cast<uint8_t>((static_cast<uint8_t>(op) << 3) | 0x01));
+    modrm(3, regId(src), regId(dst));
+}
+
+void X64Emitter::alu32(X64AluOp op, X64Reg dst, uint32_t imm)
+{
+    rex(false, 0, regId(dst));
+    emit8(0x81);
+    modrm(3, static_cast<uint8_t>(op), regId(dst));
+    emit32(imm);
+}
+
+void X64Emitter::not32(X64Reg reg)
+{
+    rex(false, 0, regId(reg));
+    emit8(0xF7);
+    modrm(3, 2, regId(reg));
+}
+
+void X64Emitter::shift32(X64ShiftOp op, X64Reg reg, uint8_t amount)
+{
+    rex(false, 0, regId(reg));
+    emit8(0xC1);
+    modrm(3, static_cast<uint8_t>(op), regId(reg));
+    emit8(amount);
+}
+
+void X64Emitter::shift32Cl(X64ShiftOp op, X64Reg reg)
+{
+    rex(false, 0, regId(reg));
+    emit8(0xD3);
+    modrm(3, static_cast<uint8_t>(op), regId(reg));
+}
+
+void X64Emitter::setcc(X64Condition cond, X64Reg dst)
+{
+    rex(false, 0, regId(dst), true);
+    emit8(0x0F);
+    emit8(static_cast<uint8_t>(0x90 | static_cast<uint8_t>(cond)));
+    modrm(3, 0, regId(dst));
+}
+
+void X64Emitter::movzx8(X64Reg dst, X64Reg src)
+{
+    rex(false, regId(dst), regId(src), true);
+    emit8(0x0F);
+    emit8(0xB6);
+    modrm(3, regId(dst), regId(src));
+}
+
+void X64Emitter::imul32(X64Reg src)
+{
+    rex(false, 0, regId(src));
+    emit8(0xF7);
+    modrm(3, 5, regId(src));
+}
+
+void X64Emitter::mul32(X64Reg src)
+{
+    rex(false, 0, regId(src));
+    emit8(0xF7);
+    modrm(3, 4, regId(src));
+}
+
+void X64Emitter::test32(X64Reg a, X64Reg b)
+{
+    rex(false, regId(b), regId(a));
+    emit8(0x85);
+    modrm(3, regId(b), regId(a));
+}
+
+void X64Emitter::push(X64Reg reg)
+{
+    rex(false, 0, regId(reg));
+    emit8(static_cast<uint8_t>(0x50 + (regId(reg) & 7)));
+}
+
+void X64Emitter::pop(X64Reg reg)
+{
+    rex(false, 0, regId(reg));
+    emit8(static_cast<uint8_t>(0x58 + (regId(reg) & 7)));
+}
+
+void X64Emitter::addRsp(int8_t imm)
+{
+    emit8(0x48);
+    emit8(0x83);
+    modrm(3, 0, regId(X64Reg::RSP));
+    emit8(static_cast<uint8_t>(imm));
+}
+
+void X64Emitter::subRsp(int8_t imm)
+{
+    emit8(0x48);
+    emit8(0x83);
+    modrm(3, 5, regId(X64Reg::RSP));
+    emit8(static_cast<uint8_t>(imm));
+}
+
+void X64Emitter::call(X64Reg target)
+{
+    rex(false, 0, regId(target));
+    emit8(0xFF);
+    modrm(3, 2, regId(target));
+}
+
+void X64Emitter::ret()
+{
+    emit8(0xC3);
+}
+
+size_t X64Emitter::jcc(X64Condition cond)
+{
+    emit8(0x0F);
+    emit8(static_cast<uint8_t>(0x80 | static_cast<uint8_t>(cond)));
+    size_t patch = m_size;
+    emit32(0);
+    return patch;
+}
+
+size_t X64Emitter::jmp()
+{
+    emit8(0xE9);
+    size_t patch = m_size;
+    emit32(0);
+    return patch;
+}
+
+void X64Emitter::bind(size_t patch)
+{
+    if (m_overflow) {
+        return;
+    }
+    int32_t rel = static_cast<int32_t>(m_size - (patch + 4));
+    std::memcpy(m_buffer + patch, &rel, sizeof(rel));
+}
@@ -0,0 +1,102 @@
+/*
+** EPITECH PROJECT, 2025
+** rogem
+** File description:
+** X64Emitter
+*/
+
+#ifndef X64EMITTER_HPP_
+#define X64EMITTER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+enum class X64Reg : uint8_t
+{
+    RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+enum class X64AluOp : uint8_t
+{
+    ADD = 0,
+    OR = 1,
+    AND = 4,
+    SUB = 5,
+    XOR = 6,
+    CMP = 7
+};
+
+enum class X64ShiftOp : uint8_t
+{
+    SHL = 4,
+    SHR = 5,
+    SAR = 7
+};
+
+enum class X64Condition : uint8_t
+{
+    B = 0x2,  // Unsigned less than
+    NZ = 0x5,
+    L = 0xC   // Signed less than
+};
+
+// Minimal x86-64 encoder for the recompiler. Memory operands are always
+// [base + disp32], 32-bit operations unless the name says otherwise.
+class X64Emitter
+{
+    public:
+        X64Emitter(uint8_t *buffer, size_t capacity);
+
+        uint8_t *code() const { return m_buffer; }
+        size_t size() const { return m_size; }
+        bool overflowed() const { return m_overflow; }
+
+        void load32(X64Reg dst, X64Reg base, int32_t disp);
+        void store32(X64Reg base, int32_t disp, X64Reg src);
+        void store32(X64Reg base, int32_t disp, uint32_t imm);
+        void cmp8(X64Reg base, int32_t disp, uint8_t imm);
+
+        void mov32(X64Reg dst, uint32_t imm);
+        void mov64(X64Reg dst, uint64_t imm);
+        void mov64(X64Reg dst, X64Reg src);
+
+        void alu32(X64AluOp op, X64Reg dst, X64Reg src);
+        void alu32(X64AluOp op, X64Reg dst, uint32_t imm);
+        void not32(X64Reg reg);
+        void shift32(X64ShiftOp op, X64Reg reg, uint8_t amount);
+        void shift32Cl(X64ShiftOp op, X64Reg reg);
+        void setcc(X64Condition cond, X64Reg dst);
+        void movzx8(X64Reg dst, X64Reg src);
+        void imul32(X64Reg src); // edx:eax = eax * src (signed)
+        void mul32(X64Reg src);  // edx:eax = eax * src (unsigned)
+        void test32(X64Reg a, X64Reg b);
+
+        void push(X64Reg reg);
+        void pop(X64Reg reg);
+        void addRsp(int8_t imm);
+        void subRsp(int8_t imm);
+        void call(X64Reg target);
+        void ret();
+
+        // Jumps return the offset of their rel32 field, patched with bind()
+        size_t jcc(X64Condition cond);
+        size_t jmp();
+        void bind(size_t patch);
+
+    private:
+        void emit8(uint8_t value);
+        void emit32(uint32_t value);
+        void emit64(uint64_t value);
+        void rex(bool wide, uint8_t reg, uint8_t rm, bool byteRegs = false);
+        void modrm(uint8_t mod, uint8_t reg, uint8_t rm);
+        void memOperand(uint8_t reg, X64Reg base, int32_t disp);
+
+    private:
+        uint8_t *m_buffer;
+        size_t m_capacity;
+        size_t m_size;
+        bool m_overflow;
+};
+
+#endif /* !X64EMITTER_HPP_ */
@@ -15,6 +15,7 @@ Debugger::Debugger(System *system) :
     m_system(system)
 {
     loadBreakpointsFromFile();
+    syncBreakpoints();
 }
 
 Debugger::~Debugger()
@@ -78,6 +79,24 @@ Disassembler &Debugger::getDisassembler()
 }
 
 //The following functions are required for nlohmann-json to work, but are called automatically upon conversion
+void to_json(nlohmann::json& j, const BreakpointCondition& c)
+{
+    j = nlohmann::json {
+        {"op", static_cast<int>(c.op)},
+        {"onValue", c.onValue},
+        {"reg", static_cast<int>(c.reg)},
+        {"value", c.value}
+    };
+}
+
+void from_json(const nlohmann::json& j, BreakpointCondition& c)
+{
+    c.op = static_cast<ConditionOp>(j.at("op").get<int>());
+    c.onValue = j.at("onValue").get<bool>();
+    c.reg = static_cast<CpuReg>(j.at("reg").get<int>());
+    c.value = j.at("value").get<uint32_t>();
+}
+
 void to_json(nlohmann::json& j, const Breakpoint& b)
 {
     j = nlohmann::json {
@@ -86,6 +105,9 @@ void to_json(nlohmann::json& j, const Breakpoint& b)
         {"label", b.label},
         {"enabled", b.enabled}
     };
+    if (b.condition.op != ConditionOp::Always) {
+        j["condition"] = b.condition;
+    }
 }
 
 void from_json(const nlohmann::json& j, Breakpoint& b)
@@ -94,11 +116,28 @@ void from_json(const nlohmann::json& j, Breakpoint& b)
     b.instructionType = static_cast<BreakpointType>(j.at("instructionType").get<int>());
     b.label = j.at("label").get<std::string>();
     b.enabled = j.at("enabled").get<bool>();
+    b.isRunTo = false;
+    // Files saved before conditions existed have none
+    b.condition = j.contains("condition") ? j.at("condition").get<BreakpointCondition>() : BreakpointCondition{};
+}
+
+static BreakKind breakKind(BreakpointType type)
+{
+    switch (type) {
+        case BreakpointType::READ:
+            return BreakKind::Read;
+        case BreakpointType::WRITE:
+            return BreakKind::Write;
+        default:
+            return BreakKind::Exec;
+    }
 }
 
-void Debugger::addBreakpoint(uint32_t addr, BreakpointType type, const std::string &label, bool isRunTo)
+void Debugger::addBreakpoint(uint32_t addr, BreakpointType type, const std::string &label, bool isRunTo,
+                             const BreakpointCondition &condition)
 {
-    m_breakpoints.push_back({addr, type, label, true, isRunTo});
+    m_breakpoints.push_back({addr, type, label, true, isRunTo, condition});
+    syncBreakpoints();
     saveBreakpointsToFile();
 }
 
@@ -127,6 +166,7 @@ void Debugger::toggleBreakpoint(long index, bool enable)
         return;
     }
     m_breakpoints[index].enabled = enable;
+    syncBreakpoints();
 }
 
 void Debugger::removeBreakpoint(long index)
@@ -135,6 +175,7 @@ void Debugger::removeBreakpoint(long index)
         return;
     }
     m_breakpoints.erase(m_breakpoints.begin() + index);
+    syncBreakpoints();
     saveBreakpointsToFile();
 }
 
@@ -163,25 +204,33 @@ std::vector<Breakpoint> &Debugger::getBreakpoints()
 }
 
 
-void Debugger::update()
+void Debugger::syncBreakpoints()
 {
-    uint32_t pc = getCpuReg(CpuReg::PC) & 0x1FFFFFFF;
+    BreakpointSet &set = m_system->getBreakpoints();
 
-    for (auto bp : m_breakpoints) {
-        if (!bp.enabled) {
-            continue;
-        }
-        if ((bp.addr & 0x1FFFFFFF) == pc) {
-            if (bp.instructionType == BreakpointType::EXEC) {
-                m_system->setState(SystemState::PAUSED);
-                if (bp.isRunTo == true) {
-                    removeBreakpoint(getBreakpointIndex(bp.addr));
-                }
-            }
+    set.clear();
+    m_breakpointIds.clear();
+    for (size_t i = 0; i < m_breakpoints.size(); i++) {
+        const Breakpoint &bp = m_breakpoints[i];
+        if (bp.enabled) {
+            uint32_t id = set.add(breakKind(bp.instructionType), bp.addr, 4, bp.condition);
+            m_breakpointIds[id] = i;
         }
     }
 }
 
+void Debugger::update()
+{
+    const auto &hit = m_system->getBreakpoints().lastHit();
+    if (!hit) {
+        return;
+    }
+    auto it = m_breakpointIds.find(hit->id);
+    if (it != m_breakpointIds.end() && m_breakpoints[it->second].isRunTo) {
+        removeBreakpoint(static_cast<long>(it->second));
+    }
+}
+
 void Debugger::pause(bool pause)
 {
     m_system->setState(pause ? SystemState::PAUSED : SystemState::RUNNING);
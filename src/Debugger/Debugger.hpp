@@ -4,12 +4,14 @@
 #include <list>
 #include <memory>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 #include <nlohmann/json.hpp>
 
 #include "Disassembler.hpp"
 #include "Core/CPU.hpp"
+#include "Core/BreakpointSet.hpp"
 
 class IWindow;
 class System;
@@ -28,6 +30,7 @@ struct Breakpoint
     std::string label;
     bool enabled;
     bool isRunTo;
+    BreakpointCondition condition;
 };
 
 class Debugger
@@ -36,6 +39,7 @@ class Debugger
         Debugger(System *system);
         ~Debugger();
 
+        // Called by the system when a breakpoint paused it
         void update();
 
         void pause(bool pause);
@@ -54,7 +58,8 @@ class Debugger
         uint32_t readWord(uint32_t addr) const;
 
         // Breakpoints
-        void addBreakpoint(uint32_t addr, BreakpointType type, const std::string &label, bool isRunTo);
+        void addBreakpoint(uint32_t addr, BreakpointType type, const std::string &label, bool isRunTo,
+                           const BreakpointCondition &condition = {});
         void removeBreakpoint(long index);
         void toggleBreakpoint(long index, bool enable);
         bool isBreakpointEnabled(long index);
@@ -67,12 +72,17 @@ class Debugger
 
         Disassembler &getDisassembler();
 
+    private:
+        // Hands the enabled breakpoints to the system breakpoint set
+        void syncBreakpoints();
+
     private:
         System *m_system;
 
         uint32_t m_currentMemAddr;
 
         std::vector<Breakpoint> m_breakpoints;
+        std::unordered_map<uint32_t, size_t> m_breakpointIds; // Set id to index
         std::string breakpointsFilePath = "breakpoints.json";
 
         Disassembler m_disassembler;
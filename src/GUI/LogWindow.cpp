@@ -1,10 +1,16 @@
 #include "LogWindow.hpp"
 
 #include <cstdint>
+#include <fmt/format.h>
 #include "imgui.h"
 
+#include "Core/Log.hpp"
+#include "Core/TraceRing.hpp"
+
 LogWindow::LogWindow(Debugger *debugger) :
-    m_debugger(debugger)
+    m_autoScroll(false),
+    m_debugger(debugger),
+    m_traceRing(nullptr)
 {
     setTitle("Logs");
 }
@@ -15,11 +21,28 @@ LogWindow::~LogWindow()
 
 void LogWindow::addLog(const std::string &log)
 {
+    // Traces can flood the window, the oldest lines go first
+    if (m_logs.size() >= MAX_LOGS) {
+        m_logs.erase(m_logs.begin(), m_logs.begin() + MAX_LOGS / 10);
+    }
     m_logs.push_back(log);
 }
 
+void LogWindow::drainTraceRing()
+{
+    TraceRing::Record record;
+
+    if (!m_traceRing) {
+        return;
+    }
+    while (m_traceRing->pop(record)) {
+        addLog(fmt::format("[{}] {}", Log::subsystemName(record.subsystem), record.view()));
+    }
+}
+
 void LogWindow::update()
 {
+    drainTraceRing();
     if (ImGui::Begin("Logs"))
     {
         drawTopBar();
@@ -42,6 +65,11 @@ void LogWindow::drawTopBar()
     {
         m_autoScroll = true;
     }
+    if (m_traceRing && m_traceRing->dropped())
+    {
+        ImGui::SameLine();
+        ImGui::Text("%llu trace messages dropped", static_cast<unsigned long long>(m_traceRing->dropped()));
+    }
     ImGui::EndGroup();
 }
 
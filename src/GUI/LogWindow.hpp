@@ -7,6 +7,7 @@
 #include <string>
 
 class Debugger;
+class TraceRing;
 
 class LogWindow : public IWindow
 {
@@ -15,13 +16,19 @@ class LogWindow : public IWindow
         ~LogWindow();
 
         void addLog(const std::string &log);
+        // Device trace messages are drained from the ring into the logs
+        void setTraceRing(TraceRing *ring) { m_traceRing = ring; }
         void update() override;
     private:
+        static constexpr size_t MAX_LOGS = 100000;
+
+        void drainTraceRing();
         void drawTopBar();
         void drawLogsWindow();
 
         bool m_autoScroll;
         Debugger *m_debugger;
+        TraceRing *m_traceRing;
         std::vector<std::string> m_logs;
 };
 
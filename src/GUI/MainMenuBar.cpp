@@ -2,6 +2,7 @@
 #include "Debugger/Debugger.hpp"
 #include "Application.hpp"
 #include "GUI/IWindow.hpp"
+#include "Core/Log.hpp"
 #include <fmt/format.h>
 
 #include <iostream>
@@ -79,6 +80,19 @@ void MainMenuBar::drawEmulationMenu()
         if (ImGui::MenuItem("Reset", "Ctrl+R")) {
             m_application->getSystem().reset();
         }
+        ImGui::Separator();
+        EmulationThread &emulation = m_application->getEmulation();
+        SpeedMode speed = emulation.getSpeedMode();
+        if (ImGui::MenuItem("Normal Speed", nullptr, speed == SpeedMode::Normal)) {
+            emulation.setSpeedMode(SpeedMode::Normal);
+        }
+        std::string fastForward = fmt::format("Fast Forward (x{:g})", emulation.getFastForwardSpeed());
+        if (ImGui::MenuItem(fastForward.c_str(), "Tab", speed == SpeedMode::FastForward)) {
+            emulation.setSpeedMode(SpeedMode::FastForward);
+        }
+        if (ImGui::MenuItem("Turbo", nullptr, speed == SpeedMode::Turbo)) {
+            emulation.setSpeedMode(SpeedMode::Turbo);
+        }
         ImGui::EndMenu();
     }
 }
@@ -86,6 +100,16 @@ void MainMenuBar::drawEmulationMenu()
 void MainMenuBar::drawDebugMenu()
 {
     if (ImGui::BeginMenu("Debug")) {
+        if (ImGui::BeginMenu("Device Traces")) {
+            for (size_t i = 0; i < LOG_SUBSYSTEM_COUNT; i++) {
+                auto subsystem = static_cast<LogSubsystem>(i);
+                bool enabled = Log::enabled(subsystem);
+                if (ImGui::MenuItem(Log::subsystemName(subsystem), nullptr, &enabled)) {
+                    Log::enable(subsystem, enabled);
+                }
+            }
+            ImGui::EndMenu();
+        }
         ImGui::Separator();
 
         if (ImGui::BeginMenu("Breakpoints")) {
@@ -0,0 +1,237 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** HeadlessRunner
+*/
+
+#include "HeadlessRunner.hpp"
+
+#include <spdlog/spdlog.h>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "Core/GPU.hpp"
+#include "Core/Log.hpp"
+#include "ImageWriter.hpp"
+
+HeadlessRunner::HeadlessRunner() :
+    m_patternFound(false)
+{
+    m_system.init();
+    m_system.setTtyCallback([this](const std::string &output) { onTtyOutput(output); });
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+}
+
+int HeadlessRunner::loadConfig(int ac, char **av)
+{
+    argparse::ArgumentParser args("rogem-headless");
+
+    args.add_description("Runs RogEm without a window, for batch and regression runs");
+    args.add_argument("bios").help("The BIOS file to boot the console with").required();
+    args.add_argument("exe").help("a PSX-EXE executable file to run after the BIOS boots").default_value("");
+    args.add_argument("--cpu")
+        .help("CPU engine: interpreter, cached or recompiler")
+        .default_value(std::string("recompiler"));
+    args.add_argument("--render-threads")
+        .help("Number of threads rasterizing the GPU draw commands")
+        .default_value(1)
+        .scan<'i', int>();
+    args.add_argument("--frames")
+        .help("Number of frames to run")
+        .default_value(600)
+        .scan<'i', int>();
+    args.add_argument("--until")
+        .help("Stop as soon as this text appears in the TTY output")
+        .default_value(std::string(""));
+    args.add_argument("--vram")
+        .help("Write the final VRAM to this file (.png or .ppm)")
+        .default_value(std::string(""));
+    args.add_argument("--tty")
+        .help("Write the TTY output to this file")
+        .default_value(std::string(""));
+    args.add_argument("--perf")
+        .help("Write the performance counters to this file (.json totals or .csv frames)")
+        .default_value(std::string(""));
+    args.add_argument("--trace")
+        .help("Record every instruction to this trace file, read it back with rogem-tracedump")
+        .default_value(std::string(""));
+    args.add_argument("--log-subsystems")
+        .help("Comma separated devices to trace: gpu, dma, timers, irqc, memctrl, cachectrl, spu or all")
+        .default_value(std::string(""));
+    args.add_argument("--speed-interval")
+        .help("Log the guest speed every this many seconds, 0 only logs it at the end")
+        .default_value(0)
+        .scan<'i', int>();
+
+    try {
+        args.parse_args(ac, av);
+    } catch(const std::exception& e) {
+        spdlog::error("{}", e.what());
+        std::cout << args;
+        return 1;
+    }
+    m_config.biosFilePath = args.get("bios");
+    m_config.exeFilePath = args.get("exe");
+    auto cpuEngine = CPU::engineFromName(args.get("--cpu"));
+    if (!cpuEngine) {
+        spdlog::error("Unknown CPU engine: {}", args.get("--cpu"));
+        std::cout << args;
+        return 1;
+    }
+    m_config.cpuEngine = *cpuEngine;
+    int renderThreads = args.get<int>("--render-threads");
+    if (renderThreads < 1) {
+        spdlog::error("Invalid render thread count: {}", renderThreads);
+        return 1;
+    }
+    m_config.renderThreads = static_cast<uint32_t>(renderThreads);
+    int frames = args.get<int>("--frames");
+    if (frames < 0) {
+        spdlog::error("Invalid frame count: {}", frames);
+        return 1;
+    }
+    m_config.frames = static_cast<uint32_t>(frames);
+    m_config.ttyPattern = args.get("--until");
+    m_config.vramOutputPath = args.get("--vram");
+    m_config.ttyOutputPath = args.get("--tty");
+    m_config.perfOutputPath = args.get("--perf");
+    m_config.traceOutputPath = args.get("--trace");
+    int speedInterval = args.get<int>("--speed-interval");
+    if (speedInterval < 0) {
+        spdlog::error("Invalid speed interval: {}", speedInterval);
+        return 1;
+    }
+    m_config.speedInterval = static_cast<uint32_t>(speedInterval);
+    if (!Log::enableByName(args.get("--log-subsystems"))) {
+        return 1;
+    }
+    // Without a trace ring the messages go to spdlog
+    if (Log::mask()) {
+        spdlog::set_level(spdlog::level::trace);
+    }
+    return 0;
+}
+
+int HeadlessRunner::run()
+{
+    if (!m_system.loadBios(m_config.biosFilePath.c_str())) {
+        return 1;
+    }
+    m_system.setExecutablePath(m_config.exeFilePath);
+    m_system.getCPU()->setEngine(m_config.cpuEngine);
+    m_system.getBus()->getDevice<GPU>()->setRenderThreads(m_config.renderThreads);
+    if (!m_config.traceOutputPath.empty() && !m_system.startTrace(m_config.traceOutputPath)) {
+        return 1;
+    }
+
+    // Runs uncapped, the speed is the emulator throughput
+    auto &perf = m_system.getBus()->getPerfCounters();
+    auto &speedMeter = m_system.getSpeedMeter();
+    auto start = std::chrono::steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(m_config.speedInterval);
+    uint32_t frame = 0;
+    speedMeter.reset();
+    while (frame < m_config.frames && !m_patternFound) {
+        m_system.update();
+        if (!m_config.perfOutputPath.empty()) {
+            m_perfRows += PerfCounters::csvRow(frame, perf.lastFrame());
+        }
+        frame++;
+        if (m_config.speedInterval && std::chrono::steady_clock::now() >= nextReport) {
+            nextReport += std::chrono::seconds(m_config.speedInterval);
+            logSpeed(frame, speedMeter.current());
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    bool success = m_system.stopTrace();
+    spdlog::info("Headless: Ran {} frames in {:.3f}s", frame, elapsed.count());
+    logSpeed(frame, speedMeter.total());
+
+    if (!m_config.vramOutputPath.empty()) {
+        success &= writeVram(m_config.vramOutputPath);
+    }
+    if (!m_config.ttyOutputPath.empty()) {
+        success &= writeTtyLog(m_config.ttyOutputPath);
+    }
+    if (!m_config.perfOutputPath.empty()) {
+        success &= writePerf(m_config.perfOutputPath);
+    }
+    if (!success) {
+        return 1;
+    }
+    if (!m_config.ttyPattern.empty() && !m_patternFound) {
+        spdlog::error("Headless: \"{}\" not found in the TTY output after {} frames", m_config.ttyPattern, frame);
+        return 2;
+    }
+    return 0;
+}
+
+void HeadlessRunner::logSpeed(uint32_t frame, const GuestSpeed &speed) const
+{
+    spdlog::info("Headless: Frame {}: {:.1f} fps, {:.2f} MHz, x{:.2f} real time",
+                 frame, speed.fps, speed.mhz, speed.multiplier);
+}
+
+void HeadlessRunner::onTtyOutput(const std::string &output)
+{
+    // The pattern may span several lines, only search the new text
+    size_t overlap = m_config.ttyPattern.size();
+    size_t from = m_ttyLog.size() > overlap ? m_ttyLog.size() - overlap : 0;
+
+    m_ttyLog += output;
+    m_ttyLog += '\n';
+    if (!m_config.ttyPattern.empty() && m_ttyLog.find(m_config.ttyPattern, from) != std::string::npos) {
+        m_patternFound = true;
+    }
+}
+
+bool HeadlessRunner::writeVram(const std::string &path)
+{
+    const uint8_t *vram = m_system.getBus()->getDevice<GPU>()->getVram();
+    std::vector<uint8_t> rgb(GPU_VRAM_WIDTH * GPU_VRAM_HEIGHT * 3);
+
+    // VRAM pixels are 15-bit BGR, red in the low bits
+    for (size_t i = 0; i < GPU_VRAM_WIDTH * GPU_VRAM_HEIGHT; i++) {
+        uint16_t pixel = static_cast<uint16_t>(vram[i * 2] | (vram[i * 2 + 1] << 8));
+        for (int c = 0; c < 3; c++) {
+            uint8_t value = (pixel >> (c * 5)) & 0x1F;
+            rgb[i * 3 + c] = static_cast<uint8_t>((value << 3) | (value >> 2));
+        }
+    }
+    ImageWriter image(GPU_VRAM_WIDTH, GPU_VRAM_HEIGHT, std::move(rgb));
+    return image.write(path);
+}
+
+bool HeadlessRunner::writeTtyLog(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+
+    if (!file.is_open()) {
+        spdlog::error("Headless: Cannot open file \"{}\"", path);
+        return false;
+    }
+    file << m_ttyLog;
+    return !file.fail();
+}
+
+bool HeadlessRunner::writePerf(const std::string &path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+
+    if (!file.is_open()) {
+        spdlog::error("Headless: Cannot open file \"{}\"", path);
+        return false;
+    }
+    if (path.ends_with(".csv")) {
+        file << PerfCounters::csvHeader() << m_perfRows;
+    } else {
+        file << m_system.getBus()->getPerfCounters().toJson();
+    }
+    return !file.fail();
+}
@@ -0,0 +1,58 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** HeadlessRunner
+*/
+
+#ifndef HEADLESSRUNNER_HPP_
+#define HEADLESSRUNNER_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "Core/System.hpp"
+
+struct HeadlessConfig
+{
+    std::string biosFilePath;
+    std::string exeFilePath;
+    CpuEngine cpuEngine;
+    uint32_t renderThreads;
+    uint32_t frames;
+    std::string ttyPattern;
+    std::string vramOutputPath;
+    std::string ttyOutputPath;
+    std::string perfOutputPath;
+    std::string traceOutputPath;
+    uint32_t speedInterval;
+};
+
+// Runs the emulator without any window or GL context, for batch and CI runs
+class HeadlessRunner
+{
+    public:
+        HeadlessRunner();
+        ~HeadlessRunner();
+
+        int loadConfig(int ac, char **av);
+        // Returns 0 when the run completed, 2 when the TTY pattern never appeared
+        int run();
+
+    private:
+        void onTtyOutput(const std::string &output);
+        void logSpeed(uint32_t frame, const GuestSpeed &speed) const;
+        bool writeVram(const std::string &path);
+        bool writeTtyLog(const std::string &path) const;
+        // Writes the performance counters, JSON totals or one CSV line per frame
+        bool writePerf(const std::string &path);
+
+    private:
+        HeadlessConfig m_config;
+        System m_system;
+        std::string m_ttyLog;
+        std::string m_perfRows;
+        bool m_patternFound;
+};
+
+#endif /* !HEADLESSRUNNER_HPP_ */
@@ -0,0 +1,136 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** ImageWriter
+*/
+
+#include "ImageWriter.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+ImageWriter::ImageWriter(uint32_t width, uint32_t height, std::vector<uint8_t> rgb) :
+    m_width(width),
+    m_height(height),
+    m_rgb(std::move(rgb))
+{
+}
+
+bool ImageWriter::write(const std::string &path) const
+{
+    if (path.ends_with(".png")) {
+        return writePNG(path);
+    }
+    if (path.ends_with(".ppm")) {
+        return writePPM(path);
+    }
+    spdlog::error("ImageWriter: Unknown image format for \"{}\", expected .png or .ppm", path);
+    return false;
+}
+
+bool ImageWriter::writePPM(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+
+    if (!file.is_open()) {
+        spdlog::error("ImageWriter: Cannot open file \"{}\"", path);
+        return false;
+    }
+    file << "P6\n" << m_width << " " << m_height << "\n255\n";
+    file.write(reinterpret_cast<const char *>(m_rgb.data()), m_rgb.size());
+    return !file.fail();
+}
+
+static uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0)
+{
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void appendBE32(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void appendChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data)
+{
+    appendBE32(out, static_cast<uint32_t>(data.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBE32(out, crc32(out.data() + start, out.size() - start));
+}
+
+bool ImageWriter::writePNG(const std::string &path) const
+{
+    static const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> png(signature, signature + sizeof(signature));
+
+    std::vector<uint8_t> header;
+    appendBE32(header, m_width);
+    appendBE32(header, m_height);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, no interlacing
+    appendChunk(png, "IHDR", header);
+
+    // Scanlines prefixed with filter type 0
+    std::vector<uint8_t> raw;
+    size_t stride = static_cast<size_t>(m_width) * 3;
+    raw.reserve((stride + 1) * m_height);
+    for (uint32_t y = 0; y < m_height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), m_rgb.begin() + y * stride, m_rgb.begin() + (y + 1) * stride);
+    }
+
+    // zlib stream made of stored deflate blocks, no compression needed
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t a = 1;
+    uint32_t b = 0;
+    size_t offset = 0;
+    do {
+        size_t size = std::min<size_t>(raw.size() - offset, 0xFFFF);
+        bool last = offset + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(size));
+        zlib.push_back(static_cast<uint8_t>(size >> 8));
+        zlib.push_back(static_cast<uint8_t>(~size));
+        zlib.push_back(static_cast<uint8_t>(~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+        for (size_t i = offset; i < offset + size; i++) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        offset += size;
+    } while (offset < raw.size());
+    appendBE32(zlib, (b << 16) | a);
+    appendChunk(png, "IDAT", zlib);
+    appendChunk(png, "IEND", {});
+
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        spdlog::error("ImageWriter: Cannot open file \"{}\"", path);
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(png.data()), png.size());
+    return !file.fail();
+}
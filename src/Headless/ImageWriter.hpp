@@ -0,0 +1,33 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** ImageWriter
+*/
+
+#ifndef IMAGEWRITER_HPP_
+#define IMAGEWRITER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Writes 24-bit RGB images without any external dependency
+class ImageWriter
+{
+    public:
+        ImageWriter(uint32_t width, uint32_t height, std::vector<uint8_t> rgb);
+        ~ImageWriter() = default;
+
+        // Picks the format from the file extension: .png or .ppm
+        bool write(const std::string &path) const;
+        bool writePPM(const std::string &path) const;
+        bool writePNG(const std::string &path) const;
+
+    private:
+        uint32_t m_width;
+        uint32_t m_height;
+        std::vector<uint8_t> m_rgb;
+};
+
+#endif /* !IMAGEWRITER_HPP_ */
@@ -0,0 +1,14 @@
+#include <spdlog/spdlog.h>
+
+#include "HeadlessRunner.hpp"
+
+int main(int ac, char **av)
+{
+    spdlog::set_level(spdlog::level::info);
+    HeadlessRunner runner;
+
+    if (runner.loadConfig(ac, av)) {
+        return 1;
+    }
+    return runner.run();
+}
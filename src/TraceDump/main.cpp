@@ -0,0 +1,96 @@
+/*
+** EPITECH PROJECT, 2026
+** rogem
+** File description:
+** TraceDump
+*/
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <argparse/argparse.hpp>
+#include <fstream>
+#include <iostream>
+
+#include "Core/TraceFile.hpp"
+#include "Debugger/Disassembler.hpp"
+
+static const char *accessName(uint8_t size)
+{
+    return size == 4 ? "word" : size == 2 ? "half" : "byte";
+}
+
+int main(int ac, char **av)
+{
+    argparse::ArgumentParser args("rogem-tracedump");
+
+    args.add_description("Prints the instructions of a trace recorded with rogem-headless --trace");
+    args.add_argument("trace").help("The trace file to print").required();
+    args.add_argument("--skip")
+        .help("Number of instructions to skip")
+        .default_value(0)
+        .scan<'i', int>();
+    args.add_argument("--count")
+        .help("Number of instructions to print, 0 prints them all")
+        .default_value(0)
+        .scan<'i', int>();
+    args.add_argument("--no-data")
+        .help("Only print the instructions, not their memory accesses and register changes")
+        .default_value(false)
+        .implicit_value(true);
+
+    try {
+        args.parse_args(ac, av);
+    } catch(const std::exception& e) {
+        spdlog::error("{}", e.what());
+        std::cout << args;
+        return 1;
+    }
+
+    std::ifstream file(args.get("trace"), std::ios::in | std::ios::binary);
+    TraceDecoder decoder;
+    if (!file || !decoder.readHeader(file)) {
+        spdlog::error("TraceDump: \"{}\" is not a trace file", args.get("trace"));
+        return 1;
+    }
+
+    Disassembler disassembler;
+    int64_t skip = args.get<int>("--skip");
+    int64_t count = args.get<int>("--count");
+    bool showData = !args.get<bool>("--no-data");
+    int64_t instructions = 0;
+    TraceRecord record;
+
+    while (decoder.next(file, record)) {
+        if (record.kind == TraceRecordKind::Instruction) {
+            instructions++;
+            if (count > 0 && instructions > skip + count) {
+                break;
+            }
+        }
+        if (skip > 0 && instructions <= skip) {
+            continue;
+        }
+        switch (record.kind) {
+            case TraceRecordKind::Instruction: {
+                InstructionData data = disassembler.disasm(record.value, record.address);
+                fmt::print("{:>12} {:08x}  {:08x}  {} {}\n", record.cycle, record.address, record.value,
+                           data.mnemonic, data.operands);
+                break;
+            }
+            case TraceRecordKind::Register:
+                if (showData) {
+                    fmt::print("{:>34}{} = {:08x}\n", "", disassembler.cpuRegName(record.reg), record.value);
+                }
+                break;
+            case TraceRecordKind::Load:
+            case TraceRecordKind::Store:
+                if (showData) {
+                    fmt::print("{:>34}{} {} [{:08x}] = {:0{}x}\n", "",
+                               record.kind == TraceRecordKind::Load ? "load" : "store",
+                               accessName(record.size), record.address, record.value, record.size * 2);
+                }
+                break;
+        }
+    }
+    return 0;
+}
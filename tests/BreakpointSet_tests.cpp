@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "Core/System.hpp"
+
+static constexpr uint32_t PROGRAM_BASE = 0x80010000;
+static constexpr uint32_t DATA = 0x80020000;
+
+class BreakpointSetTest : public testing::Test
+{
+    protected:
+        System system;
+
+        BreakpointSetTest()
+        {
+            system.init();
+            // loop: addiu t0, t0, 1; lui t1, 0x8002; sw t0, 0(t1); lw t2, 4(t1); j loop; nop
+            const uint32_t program[] = {0x25080001, 0x3C098002, 0xAD280000, 0x8D2A0004, 0x08004000, 0};
+            for (size_t i = 0; i < std::size(program); i++) {
+                system.getBus()->storeWord(PROGRAM_BASE + static_cast<uint32_t>(i) * 4, program[i]);
+            }
+            system.getCPU()->setReg(CpuReg::PC, PROGRAM_BASE);
+        }
+
+        // Ticks until the system pauses, returns the ticks run
+        int runUntilPaused(int maxTicks = 1000)
+        {
+            for (int i = 1; i <= maxTicks; i++) {
+                system.tick();
+                if (system.getState() == SystemState::PAUSED) {
+                    return i;
+                }
+            }
+            return 0;
+        }
+};
+
+TEST_F(BreakpointSetTest, EmptySetIsNotArmed)
+{
+    BreakpointSet &breakpoints = system.getBreakpoints();
+    EXPECT_FALSE(breakpoints.armed());
+
+    uint32_t id = breakpoints.add(BreakKind::Exec, PROGRAM_BASE);
+    EXPECT_TRUE(breakpoints.armed());
+    EXPECT_TRUE(breakpoints.remove(id));
+    EXPECT_FALSE(breakpoints.remove(id));
+    EXPECT_FALSE(breakpoints.armed());
+}
+
+TEST_F(BreakpointSetTest, ExecBreakpointStopsBeforeTheInstruction)
+{
+    int callbacks = 0;
+    system.setDebuggerCallback([&callbacks]() { callbacks++; });
+    uint32_t id = system.getBreakpoints().add(BreakKind::Exec, PROGRAM_BASE + 12);
+
+    EXPECT_EQ(runUntilPaused(), 3);
+    EXPECT_EQ(system.getCPU()->getReg(CpuReg::PC), PROGRAM_BASE + 12);
+    EXPECT_EQ(callbacks, 1);
+    ASSERT_TRUE(system.getBreakpoints().lastHit());
+    EXPECT_EQ(system.getBreakpoints().lastHit()->id, id);
+}
+
+TEST_F(BreakpointSetTest, ExecBreakpointMatchesAnySegment)
+{
+    system.getBreakpoints().add(BreakKind::Exec, 0xA0010004);
+
+    EXPECT_EQ(runUntilPaused(), 1);
+}
+
+TEST_F(BreakpointSetTest, ExecBreakpointStopsInsideCompiledBlocks)
+{
+    system.getCPU()->setEngine(CpuEngine::Recompiler);
+    system.getBreakpoints().add(BreakKind::Exec, PROGRAM_BASE + 8);
+
+    EXPECT_EQ(runUntilPaused(), 2);
+    EXPECT_EQ(system.getCPU()->getReg(CpuReg::PC), PROGRAM_BASE + 8);
+}
+
+TEST_F(BreakpointSetTest, ConditionalBreakpoint)
+{
+    BreakpointCondition condition{ConditionOp::Equal, false, CpuReg::T0, 3};
+    system.getBreakpoints().add(BreakKind::Exec, PROGRAM_BASE, 4, condition);
+
+    runUntilPaused();
+    EXPECT_EQ(system.getCPU()->getReg(CpuReg::T0), 3);
+    EXPECT_EQ(system.getCPU()->getReg(CpuReg::PC), PROGRAM_BASE);
+}
+
+TEST_F(BreakpointSetTest, WriteWatchpoint)
+{
+    BreakpointCondition condition{ConditionOp::Greater, true, CpuReg::ZERO, 1};
+    uint32_t id = system.getBreakpoints().add(BreakKind::Write, DATA, 4, condition);
+
+    runUntilPaused();
+    const auto &hit = system.getBreakpoints().lastHit();
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->id, id);
+    EXPECT_EQ(hit->kind, BreakKind::Write);
+    EXPECT_EQ(hit->address, DATA & 0x1FFFFFFF);
+    EXPECT_EQ(hit->value, 2);
+    // Stops right after the store, which went through
+    EXPECT_EQ(system.getCPU()->getReg(CpuReg::PC), PROGRAM_BASE + 12);
+    EXPECT_EQ(system.getBus()->loadWord(DATA), 2);
+}
+
+TEST_F(BreakpointSetTest, ReadWatchpointIgnoresOtherAddressesOfThePage)
+{
+    system.getBreakpoints().add(BreakKind::Read, DATA + 4, 4);
+    system.getBus()->storeWord(DATA + 4, 0x1234);
+    system.getBus()->loadWord(DATA + 8);
+
+    EXPECT_EQ(runUntilPaused(), 4);
+    EXPECT_EQ(system.getBreakpoints().lastHit()->value, 0x1234);
+}
+
+TEST_F(BreakpointSetTest, AccessesWhilePausedAreNotHits)
+{
+    system.getBreakpoints().add(BreakKind::Read, DATA + 4, 4);
+    system.setState(SystemState::PAUSED);
+    system.getBus()->loadWord(DATA + 4);
+    system.setState(SystemState::RUNNING);
+
+    EXPECT_EQ(runUntilPaused(), 4);
+}
+
+TEST_F(BreakpointSetTest, RemovingWatchpointsRestoresTheFastPath)
+{
+    BreakpointSet &breakpoints = system.getBreakpoints();
+    uint32_t id = breakpoints.add(BreakKind::Write, DATA, 4);
+    EXPECT_TRUE(breakpoints.watches(DATA, 4));
+    breakpoints.remove(id);
+
+    EXPECT_FALSE(breakpoints.watches(DATA, 4));
+    EXPECT_EQ(runUntilPaused(50), 0);
+    EXPECT_GT(system.getBus()->loadWord(DATA), 0);
+}
+
+TEST_F(BreakpointSetTest, BreakpointsSurviveInit)
+{
+    system.getBreakpoints().add(BreakKind::Write, DATA, 4);
+    system.init();
+    system.getBus()->storeWord(DATA, 1);
+
+    EXPECT_TRUE(system.getBreakpoints().check(0));
+}
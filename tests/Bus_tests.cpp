@@ -163,3 +163,53 @@ TEST(BusTest, getDeviceSuccess)
     auto device = bus.getDevice<BIOS>();
     EXPECT_NE(device, nullptr);
 }
+
+TEST(BusTests, RamSegmentsShareStorage)
+{
+    Bus bus;
+
+    bus.storeWord(0x80001000, 0xDEADBEEF);
+    EXPECT_EQ(bus.loadWord(0x00001000), 0xDEADBEEF);
+    EXPECT_EQ(bus.loadWord(0xA0001000), 0xDEADBEEF);
+    EXPECT_EQ(bus.loadHalfWord(0x80001002), 0xDEAD);
+    EXPECT_EQ(bus.loadByte(0x80001000), 0xEF);
+}
+
+TEST(BusTests, RamLastWord)
+{
+    Bus bus;
+
+    bus.storeWord(0x801FFFFC, 0x12345678);
+    EXPECT_EQ(bus.loadWord(0x001FFFFC), 0x12345678);
+    EXPECT_EQ(bus.loadWord(0x80200000), 0);
+}
+
+TEST(BusTests, BiosIsReadOnly)
+{
+    Bus bus;
+
+    bus.storeWord(0xBFC00000, 0xDEADBEEF);
+    EXPECT_EQ(bus.loadWord(0xBFC00000), 0);
+}
+
+TEST(BusTests, ScratchPadAndIoSharePage)
+{
+    Bus bus;
+
+    bus.storeWord(0x1F800000, 0xCAFEBABE);
+    bus.storeWord(0x1F8003FC, 0x01020304);
+    bus.storeWord(0x1F801074, 0x7FF);
+
+    EXPECT_EQ(bus.loadWord(0x1F800000), 0xCAFEBABE);
+    EXPECT_EQ(bus.loadWord(0x1F8003FC), 0x01020304);
+    EXPECT_EQ(bus.loadWord(0x1F801074), 0x7FF);
+    EXPECT_EQ(bus.loadWord(0x1F800400), 0);
+}
+
+TEST(BusTests, CacheControlOutsidePhysicalSpace)
+{
+    Bus bus;
+
+    bus.storeWord(0xFFFE0130, 0x1E988);
+    EXPECT_EQ(bus.loadWord(0xFFFE0130), 0x1E988);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "Core/RAM.hpp"
+
+class CpuCachedInterpreterTest : public testing::Test
+{
+    protected:
+        Bus bus;
+        CPU cpu;
+
+        CpuCachedInterpreterTest() :
+            cpu(&bus)
+        {
+            cpu.reset();
+            cpu.setEngine(CpuEngine::CachedInterpreter);
+            cpu.setReg(CpuReg::PC, 0x10000);
+        }
+
+        static uint32_t addiu(CpuReg rt, CpuReg rs, int16_t imm)
+        {
+            Instruction i;
+            i.i.opcode = static_cast<uint8_t>(PrimaryOpCode::ADDIU);
+            i.i.rs = static_cast<uint8_t>(rs);
+            i.i.rt = static_cast<uint8_t>(rt);
+            i.i.immediate = static_cast<uint16_t>(imm);
+            return i.raw;
+        }
+
+        static uint32_t sw(CpuReg rt, CpuReg rs, int16_t imm)
+        {
+            Instruction i;
+            i.i.opcode = static_cast<uint8_t>(PrimaryOpCode::SW);
+            i.i.rs = static_cast<uint8_t>(rs);
+            i.i.rt = static_cast<uint8_t>(rt);
+            i.i.immediate = static_cast<uint16_t>(imm);
+            return i.raw;
+        }
+
+        static uint32_t j(uint32_t target)
+        {
+            Instruction i;
+            i.j.opcode = static_cast<uint8_t>(PrimaryOpCode::J);
+            i.j.address = (target >> 2) & 0x3FFFFFF;
+            return i.raw;
+        }
+};
+
+TEST_F(CpuCachedInterpreterTest, BlockIsDecodedOnce)
+{
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 1));
+    bus.storeWord(0x10004, j(0x10000));
+    bus.storeWord(0x10008, 0);
+
+    for (int i = 0; i < 9; i++) {
+        cpu.step();
+    }
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 3);
+    EXPECT_EQ(cpu.getBlockCache().size(), 1);
+}
+
+TEST_F(CpuCachedInterpreterTest, BlockEndsAfterDelaySlot)
+{
+    bus.storeWord(0x10000, j(0x20000));
+    bus.storeWord(0x10004, addiu(CpuReg::T0, CpuReg::ZERO, 7));
+    bus.storeWord(0x10008, addiu(CpuReg::T1, CpuReg::ZERO, 9));
+
+    cpu.step();
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::PC), 0x20000);
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 7);
+    EXPECT_EQ(cpu.getReg(CpuReg::T1), 0);
+}
+
+TEST_F(CpuCachedInterpreterTest, BusWriteInvalidatesBlock)
+{
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 1));
+    cpu.step();
+
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 5));
+    cpu.setReg(CpuReg::PC, 0x10000);
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 6);
+}
+
+TEST_F(CpuCachedInterpreterTest, MirroredSegmentWriteInvalidatesBlock)
+{
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 1));
+    cpu.setReg(CpuReg::PC, 0x80010000);
+    cpu.step();
+
+    bus.storeWord(0xA0010000, addiu(CpuReg::T0, CpuReg::T0, 5));
+    cpu.setReg(CpuReg::PC, 0x80010000);
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 6);
+}
+
+TEST_F(CpuCachedInterpreterTest, StoreInsideBlockInvalidatesNextInstruction)
+{
+    cpu.setReg(CpuReg::T1, addiu(CpuReg::T0, CpuReg::ZERO, 42));
+    cpu.setReg(CpuReg::T2, 0x10000);
+    bus.storeWord(0x10000, sw(CpuReg::T1, CpuReg::T2, 0x0008));
+    bus.storeWord(0x10004, 0);
+    bus.storeWord(0x10008, addiu(CpuReg::T0, CpuReg::ZERO, 1));
+
+    cpu.step();
+    cpu.step();
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 42);
+}
+
+TEST_F(CpuCachedInterpreterTest, DeviceWriteInvalidatesBlock)
+{
+    auto ram = bus.getDevice<RAM>();
+
+    ram->write32(addiu(CpuReg::T0, CpuReg::ZERO, 1), 0x10000);
+    cpu.step();
+
+    ram->write32(addiu(CpuReg::T0, CpuReg::ZERO, 2), 0x10000);
+    cpu.setReg(CpuReg::PC, 0x10000);
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 2);
+}
+
+TEST_F(CpuCachedInterpreterTest, LoadExecutableInvalidatesBlock)
+{
+    auto ram = bus.getDevice<RAM>();
+    uint32_t code = addiu(CpuReg::T0, CpuReg::ZERO, 3);
+    std::vector<uint8_t> exe(reinterpret_cast<uint8_t *>(&code), reinterpret_cast<uint8_t *>(&code) + 4);
+
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::ZERO, 1));
+    cpu.step();
+
+    ram->loadExecutable(0x80010000, exe);
+    cpu.setReg(CpuReg::PC, 0x10000);
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 3);
+}
+
+TEST_F(CpuCachedInterpreterTest, WriteToOtherPageKeepsBlock)
+{
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 1));
+    cpu.step();
+
+    bus.storeWord(0x11000, 0xFFFFFFFF);
+    cpu.setReg(CpuReg::PC, 0x10000);
+    cpu.step();
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 2);
+    EXPECT_EQ(cpu.getBlockCache().size(), 1);
+}
+
+TEST_F(CpuCachedInterpreterTest, SwitchingEngineClearsCache)
+{
+    bus.storeWord(0x10000, addiu(CpuReg::T0, CpuReg::T0, 1));
+    cpu.step();
+    EXPECT_EQ(cpu.getBlockCache().size(), 1);
+
+    cpu.setEngine(CpuEngine::Interpreter);
+    EXPECT_EQ(cpu.getBlockCache().size(), 0);
+
+    cpu.setReg(CpuReg::PC, 0x10000);
+    cpu.step();
+    EXPECT_EQ(cpu.getReg(CpuReg::T0), 2);
+    EXPECT_EQ(cpu.getBlockCache().size(), 0);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+
+class CpuCop2Test : public testing::Test
+{
+    protected:
+        Bus bus;
+        CPU cpu;
+
+        static constexpr uint32_t CU2 = 0x40000000;
+        static constexpr uint32_t RTPT = 0x30;
+        static constexpr uint32_t SQR = 0x28;
+        static constexpr uint8_t IR1 = 9;
+        static constexpr uint8_t MAC1 = 25;
+
+        CpuCop2Test() :
+            cpu(&bus)
+        {
+            cpu.setReg(CpuReg::PC, 0x10000);
+            cpu.setCop0Reg(static_cast<uint8_t>(CP0Reg::SR), CU2);
+        }
+
+        uint32_t move(CoprocessorOpcode code, CpuReg rt, uint8_t rd)
+        {
+            Instruction i{};
+            i.r.opcode = static_cast<uint8_t>(PrimaryOpCode::COP2);
+            i.r.rs = static_cast<uint8_t>(code);
+            i.r.rt = static_cast<uint8_t>(rt);
+            i.r.rd = rd;
+            return i.raw;
+        }
+
+        uint32_t transfer(PrimaryOpCode opcode, uint8_t rt, CpuReg rs, int16_t imm)
+        {
+            Instruction i{};
+            i.i.opcode = static_cast<uint8_t>(opcode);
+            i.i.rt = rt;
+            i.i.rs = static_cast<uint8_t>(rs);
+            i.i.immediate = static_cast<uint16_t>(imm);
+            return i.raw;
+        }
+
+        uint32_t command(uint32_t funct)
+        {
+            return (static_cast<uint32_t>(PrimaryOpCode::COP2) << 26) | (1 << 25) | funct;
+        }
+
+        void run(std::initializer_list<uint32_t> program)
+        {
+            uint32_t pc = cpu.getReg(CpuReg::PC);
+            for (uint32_t word : program) {
+                bus.storeWord(pc, word);
+                pc += 4;
+            }
+            for (size_t i = 0; i < program.size(); i++) {
+                cpu.step();
+            }
+        }
+};
+
+TEST_F(CpuCop2Test, MTC2_MFC2)
+{
+    cpu.setReg(CpuReg::T0, 0x12345678);
+    run({move(CoprocessorOpcode::MTC, CpuReg::T0, 0), move(CoprocessorOpcode::MFC, CpuReg::T1, 0)});
+
+    // Value lands after the load delay slot
+    EXPECT_EQ(cpu.getReg(CpuReg::T1), 0);
+    run({0});
+    EXPECT_EQ(cpu.getReg(CpuReg::T1), 0x12345678);
+    EXPECT_EQ(cpu.getGte().getDataReg(0), 0x12345678);
+}
+
+TEST_F(CpuCop2Test, CTC2_CFC2)
+{
+    cpu.setReg(CpuReg::T0, 0xCAFEBABE);
+    run({move(CoprocessorOpcode::CTC, CpuReg::T0, 24), move(CoprocessorOpcode::CFC, CpuReg::T1, 24), 0});
+
+    EXPECT_EQ(cpu.getReg(CpuReg::T1), 0xCAFEBABE);
+}
+
+TEST_F(CpuCop2Test, LWC2_SWC2)
+{
+    bus.storeWord(0x20000, 0xDEADBEEF);
+    cpu.setReg(CpuReg::T0, 0x20000);
+    run({transfer(PrimaryOpCode::LWC2, 3, CpuReg::T0, 0), transfer(PrimaryOpCode::SWC2, 3, CpuReg::T0, 8)});
+
+    EXPECT_EQ(cpu.getGte().getDataReg(3), static_cast<int32_t>(0xDEADBEEF));
+    EXPECT_EQ(bus.loadWord(0x20008), 0xDEADBEEF);
+}
+
+TEST_F(CpuCop2Test, LWC2_Unaligned)
+{
+    cpu.setReg(CpuReg::T0, 0x20002);
+    run({transfer(PrimaryOpCode::LWC2, 3, CpuReg::T0, 0)});
+
+    uint32_t cause = cpu.getCop0Reg(static_cast<uint8_t>(CP0Reg::CAUSE));
+    EXPECT_EQ((cause >> 2) & 0x1F, static_cast<uint32_t>(ExceptionType::AddressErrorLoad));
+    EXPECT_EQ(cpu.getReg(CpuReg::PC), static_cast<uint32_t>(ExceptionVector::GENERAL));
+}
+
+TEST_F(CpuCop2Test, Command)
+{
+    cpu.getGte().setDataReg(IR1, 3);
+    run({command(SQR)});
+
+    EXPECT_EQ(cpu.getGte().getDataReg(MAC1), 9);
+}
+
+TEST_F(CpuCop2Test, CommandUnusable)
+{
+    cpu.setCop0Reg(static_cast<uint8_t>(CP0Reg::SR), 0);
+    cpu.getGte().setDataReg(IR1, 3);
+    run({command(SQR)});
+
+    uint32_t cause = cpu.getCop0Reg(static_cast<uint8_t>(CP0Reg::CAUSE));
+    EXPECT_EQ((cause >> 2) & 0x1F, static_cast<uint32_t>(ExceptionType::COP_Unusable));
+    EXPECT_EQ((cause >> 28) & 0x3, 2);
+    EXPECT_EQ(cpu.getReg(CpuReg::PC), static_cast<uint32_t>(ExceptionVector::GENERAL));
+    EXPECT_EQ(cpu.getGte().getDataReg(MAC1), 0);
+}
+
+TEST_F(CpuCop2Test, EarlyReadStalls)
+{
+    run({command(RTPT), move(CoprocessorOpcode::MFC, CpuReg::T1, 14)});
+    bus.updateDevices(0);
+
+    // RTPT takes 23 cycles, the read comes 2 cycles after it
+    EXPECT_EQ(cpu.getCycles(), 4 + 21);
+    EXPECT_EQ(bus.getScheduler().now(), 21);
+}
+
+TEST_F(CpuCop2Test, LateReadDoesNotStall)
+{
+    run({command(SQR), 0, 0, move(CoprocessorOpcode::MFC, CpuReg::T1, MAC1)});
+    bus.updateDevices(0);
+
+    EXPECT_EQ(cpu.getCycles(), 8);
+    EXPECT_EQ(bus.getScheduler().now(), 0);
+}
+
+TEST_F(CpuCop2Test, CommandWaitsForPreviousCommand)
+{
+    run({command(SQR), command(SQR)});
+    bus.updateDevices(0);
+
+    EXPECT_EQ(bus.getScheduler().now(), 3);
+}
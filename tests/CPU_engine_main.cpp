@@ -0,0 +1,11 @@
+#include <gtest/gtest.h>
+
+#include "Core/CPU.hpp"
+
+// Runs the CPU test suites on top of the engine picked by the build
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    CPU::setDefaultEngine(CpuEngine::ROGEM_TEST_CPU_ENGINE);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "Core/RAM.hpp"
+
+static constexpr uint32_t PROGRAM_BASE = 0x80010000;
+static constexpr uint32_t DATA_BASE = 0x80040000;
+static constexpr uint8_t DATA_REG = 20;
+
+static uint32_t rType(SecondaryOpCode funct, uint8_t rd, uint8_t rs, uint8_t rt, uint8_t shamt = 0)
+{
+    Instruction i;
+    i.raw = 0;
+    i.r.opcode = static_cast<uint8_t>(PrimaryOpCode::SPECIAL);
+    i.r.funct = static_cast<uint8_t>(funct);
+    i.r.rd = rd;
+    i.r.rs = rs;
+    i.r.rt = rt;
+    i.r.shamt = shamt;
+    return i.raw;
+}
+
+static uint32_t iType(PrimaryOpCode opcode, uint8_t rt, uint8_t rs, uint16_t imm)
+{
+    Instruction i;
+    i.i.opcode = static_cast<uint8_t>(opcode);
+    i.i.rt = rt;
+    i.i.rs = rs;
+    i.i.immediate = imm;
+    return i.raw;
+}
+
+static uint32_t jType(PrimaryOpCode opcode, uint32_t target)
+{
+    Instruction i;
+    i.j.opcode = static_cast<uint8_t>(opcode);
+    i.j.address = (target >> 2) & 0x3FFFFFF;
+    return i.raw;
+}
+
+// Runs the same program on the interpreter and the recompiler, comparing
+// the whole CPU state after every compiled block
+class CpuRecompilerTest : public testing::Test
+{
+    protected:
+        Bus refBus;
+        CPU reference;
+        Bus jitBus;
+        CPU recompiled;
+
+        CpuRecompilerTest() :
+            reference(&refBus),
+            recompiled(&jitBus)
+        {
+            reference.setEngine(CpuEngine::Interpreter);
+            recompiled.setEngine(CpuEngine::Recompiler);
+            forBoth([](Bus &, CPU &cpu) {
+                cpu.setReg(CpuReg::HI, 0);
+                cpu.setReg(CpuReg::LO, 0);
+                cpu.setReg(CpuReg::PC, PROGRAM_BASE);
+            });
+        }
+
+        void SetUp() override
+        {
+            if (recompiled.getEngine() != CpuEngine::Recompiler) {
+                GTEST_SKIP() << "Recompiler is not supported on this host";
+            }
+        }
+
+        template<typename F>
+        void forBoth(F func)
+        {
+            func(refBus, reference);
+            func(jitBus, recompiled);
+        }
+
+        void loadProgram(uint32_t base, const std::vector<uint32_t> &program)
+        {
+            forBoth([&](Bus &bus, CPU &) {
+                for (size_t i = 0; i < program.size(); i++) {
+                    bus.storeWord(base + static_cast<uint32_t>(i) * 4, program[i]);
+                }
+            });
+        }
+
+        void setReg(CpuReg reg, uint32_t value)
+        {
+            forBoth([&](Bus &, CPU &cpu) { cpu.setReg(reg, value); });
+        }
+
+        void expectSameState(uint32_t block)
+        {
+            for (uint8_t r = 0; r < NB_GPR; r++) {
+                ASSERT_EQ(reference.getReg(static_cast<CpuReg>(r)), recompiled.getReg(static_cast<CpuReg>(r)))
+                    << "r" << +r << " differs after block " << block;
+            }
+            ASSERT_EQ(reference.getReg(CpuReg::PC), recompiled.getReg(CpuReg::PC)) << "block " << block;
+            ASSERT_EQ(reference.getReg(CpuReg::HI), recompiled.getReg(CpuReg::HI)) << "block " << block;
+            ASSERT_EQ(reference.getReg(CpuReg::LO), recompiled.getReg(CpuReg::LO)) << "block " << block;
+            for (auto reg : {CP0Reg::SR, CP0Reg::CAUSE, CP0Reg::EPC}) {
+                auto id = static_cast<uint8_t>(reg);
+                ASSERT_EQ(reference.getCop0Reg(id), recompiled.getCop0Reg(id))
+                    << "cop0 r" << +id << " differs after block " << block;
+            }
+        }
+
+        // Returns the number of instructions run by the recompiler
+        uint32_t runLockstep(uint32_t instructions)
+        {
+            uint32_t executed = 0;
+            uint32_t block = 0;
+            uint32_t longest = 0;
+
+            while (executed < instructions) {
+                uint32_t count = recompiled.runBlock();
+                for (uint32_t i = 0; i < count; i++) {
+                    reference.step();
+                }
+                executed += count;
+                longest = std::max(longest, count);
+                expectSameState(block++);
+                if (testing::Test::HasFatalFailure()) {
+                    break;
+                }
+            }
+            return longest;
+        }
+};
+
+TEST_F(CpuRecompilerTest, StraightLineCodeRunsAsOneBlock)
+{
+    loadProgram(PROGRAM_BASE, {
+        iType(PrimaryOpCode::ADDIU, 8, 0, 0x1234),
+        iType(PrimaryOpCode::LUI, 9, 0, 0xCAFE),
+        iType(PrimaryOpCode::ORI, 9, 9, 0xBABE),
+        rType(SecondaryOpCode::ADDU, 10, 8, 9),
+        rType(SecondaryOpCode::SRA, 11, 9, 0, 4),
+        rType(SecondaryOpCode::MULT, 0, 9, 8),
+        rType(SecondaryOpCode::MFHI, 12, 0, 0),
+        jType(PrimaryOpCode::J, PROGRAM_BASE),
+        rType(SecondaryOpCode::NOR, 13, 10, 11),
+    });
+
+    EXPECT_EQ(runLockstep(200), 9u);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T2), 0xCAFECCF2);
+}
+
+TEST_F(CpuRecompilerTest, LoadDelaySlotAcrossNativeCode)
+{
+    setReg(static_cast<CpuReg>(DATA_REG), DATA_BASE);
+    loadProgram(DATA_BASE, {0x11223344, 0x55667788});
+    loadProgram(PROGRAM_BASE, {
+        iType(PrimaryOpCode::ADDIU, 8, 0, 1),
+        iType(PrimaryOpCode::LW, 8, DATA_REG, 0),
+        iType(PrimaryOpCode::ADDIU, 9, 8, 1),      // Sees the old value
+        iType(PrimaryOpCode::ADDIU, 10, 8, 1),     // Sees the loaded value
+        iType(PrimaryOpCode::LW, 11, DATA_REG, 4),
+        iType(PrimaryOpCode::ADDIU, 11, 0, 7),     // Cancels the pending load
+        iType(PrimaryOpCode::LWL, 12, DATA_REG, 5),
+        iType(PrimaryOpCode::LWR, 12, DATA_REG, 2),
+        jType(PrimaryOpCode::J, PROGRAM_BASE),
+        iType(PrimaryOpCode::LW, 8, DATA_REG, 4),  // Load in the delay slot
+    });
+
+    runLockstep(100);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T1), 2u);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T2), 0x11223345u);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T3), 7u);
+}
+
+TEST_F(CpuRecompilerTest, ExceptionsLeaveTheBlock)
+{
+    setReg(CpuReg::T0, 0x7FFFFFFF);
+    loadProgram(0x80000080, {
+        iType(PrimaryOpCode::ADDIU, 16, 16, 1),
+        jType(PrimaryOpCode::J, PROGRAM_BASE + 8),
+        0,
+    });
+    loadProgram(PROGRAM_BASE, {
+        iType(PrimaryOpCode::ADDIU, 9, 0, 1),
+        rType(SecondaryOpCode::ADD, 10, 8, 8),     // Overflow
+        iType(PrimaryOpCode::ADDIU, 11, 11, 1),
+        iType(PrimaryOpCode::LW, 12, 9, 0),        // Unaligned load
+        rType(SecondaryOpCode::SYSCALL, 0, 0, 0),
+        jType(PrimaryOpCode::J, PROGRAM_BASE),
+        0,
+    });
+
+    runLockstep(300);
+    EXPECT_GT(recompiled.getReg(CpuReg::S0), 0u);
+}
+
+TEST_F(CpuRecompilerTest, InterruptEnabledInsideBlock)
+{
+    forBoth([](Bus &, CPU &cpu) {
+        cpu.setCop0Reg(static_cast<uint8_t>(CP0Reg::SR), 0);
+        cpu.setInterruptPending(true);
+    });
+    setReg(CpuReg::T0, 0x401);
+    loadProgram(0x80000080, {
+        iType(PrimaryOpCode::ADDIU, 16, 16, 1),
+        jType(PrimaryOpCode::J, 0x80000080),
+        0,
+    });
+    loadProgram(PROGRAM_BASE, {
+        iType(PrimaryOpCode::ADDIU, 9, 0, 1),
+        0x40886000,                                // MTC0 $t0, SR
+        iType(PrimaryOpCode::ADDIU, 10, 0, 1),     // Never runs
+        iType(PrimaryOpCode::ADDIU, 11, 0, 1),
+    });
+
+    runLockstep(20);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T2), 0u);
+    EXPECT_EQ(recompiled.getCop0Reg(static_cast<uint8_t>(CP0Reg::EPC)), PROGRAM_BASE + 8);
+}
+
+TEST_F(CpuRecompilerTest, SelfModifyingCodeInsideBlock)
+{
+    setReg(CpuReg::T1, iType(PrimaryOpCode::ADDIU, 10, 0, 42));
+    setReg(CpuReg::T2, PROGRAM_BASE);
+    loadProgram(PROGRAM_BASE, {
+        iType(PrimaryOpCode::SW, 9, 10, 12),
+        iType(PrimaryOpCode::ADDIU, 8, 8, 1),
+        iType(PrimaryOpCode::ADDIU, 8, 8, 1),
+        iType(PrimaryOpCode::ADDIU, 10, 0, 1),     // Patched by the store
+        iType(PrimaryOpCode::ADDIU, 11, 10, 0),
+    });
+
+    runLockstep(5);
+    EXPECT_EQ(recompiled.getReg(CpuReg::T3), 42u);
+}
+
+TEST_F(CpuRecompilerTest, RandomPrograms)
+{
+    static const SecondaryOpCode aluOps[] = {
+        SecondaryOpCode::ADDU, SecondaryOpCode::SUBU, SecondaryOpCode::AND, SecondaryOpCode::OR,
+        SecondaryOpCode::XOR, SecondaryOpCode::NOR, SecondaryOpCode::SLT, SecondaryOpCode::SLTU,
+        SecondaryOpCode::SLLV, SecondaryOpCode::SRLV, SecondaryOpCode::SRAV, SecondaryOpCode::ADD,
+        SecondaryOpCode::SUB,
+    };
+    static const SecondaryOpCode shiftOps[] = {
+        SecondaryOpCode::SLL, SecondaryOpCode::SRL, SecondaryOpCode::SRA,
+    };
+    static const SecondaryOpCode hiLoOps[] = {
+        SecondaryOpCode::MULT, SecondaryOpCode::MULTU, SecondaryOpCode::DIV, SecondaryOpCode::DIVU,
+        SecondaryOpCode::MFHI, SecondaryOpCode::MFLO, SecondaryOpCode::MTHI, SecondaryOpCode::MTLO,
+    };
+    static const PrimaryOpCode immOps[] = {
+        PrimaryOpCode::ADDIU, PrimaryOpCode::ADDI, PrimaryOpCode::ANDI, PrimaryOpCode::ORI,
+        PrimaryOpCode::XORI, PrimaryOpCode::SLTI, PrimaryOpCode::SLTIU, PrimaryOpCode::LUI,
+    };
+    static const PrimaryOpCode memOps[] = {
+        PrimaryOpCode::LW, PrimaryOpCode::LH, PrimaryOpCode::LHU, PrimaryOpCode::LB,
+        PrimaryOpCode::LBU, PrimaryOpCode::LWL, PrimaryOpCode::LWR, PrimaryOpCode::SW,
+        PrimaryOpCode::SH, PrimaryOpCode::SB, PrimaryOpCode::SWL, PrimaryOpCode::SWR,
+    };
+    static const PrimaryOpCode branchOps[] = {
+        PrimaryOpCode::BEQ, PrimaryOpCode::BNE, PrimaryOpCode::BLEZ, PrimaryOpCode::BGTZ,
+    };
+
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+        std::mt19937 rng(seed);
+        auto pick = [&rng](uint32_t count) { return static_cast<uint32_t>(rng() % count); };
+        auto reg = [&pick]() { return static_cast<uint8_t>(1 + pick(15)); };
+
+        std::vector<uint32_t> program;
+        for (int i = 0; i < 400; i++) {
+            switch (pick(6))
+            {
+            case 0:
+                program.push_back(rType(aluOps[pick(std::size(aluOps))], reg(), reg(), reg()));
+                break;
+            case 1:
+                program.push_back(rType(shiftOps[pick(3)], reg(), 0, reg(), static_cast<uint8_t>(pick(32))));
+                break;
+            case 2:
+                program.push_back(rType(hiLoOps[pick(std::size(hiLoOps))], reg(), reg(), reg()));
+                break;
+            case 3:
+                program.push_back(iType(immOps[pick(std::size(immOps))], reg(), reg(), static_cast<uint16_t>(rng())));
+                break;
+            case 4:
+                program.push_back(iType(memOps[pick(std::size(memOps))], reg(), DATA_REG, static_cast<uint16_t>(pick(64))));
+                break;
+            default:
+                program.push_back(iType(branchOps[pick(4)], reg(), reg(), static_cast<uint16_t>(1 + pick(4))));
+                break;
+            }
+        }
+        program.push_back(jType(PrimaryOpCode::J, PROGRAM_BASE));
+        program.push_back(0);
+
+        forBoth([&](Bus &, CPU &cpu) {
+            cpu.reset();
+            cpu.setReg(CpuReg::HI, 0);
+            cpu.setReg(CpuReg::LO, 0);
+            cpu.setReg(CpuReg::PC, PROGRAM_BASE);
+            for (uint8_t r = 1; r < 16; r++) {
+                cpu.setReg(static_cast<CpuReg>(r), r * 0x01234567u);
+            }
+            cpu.setReg(static_cast<CpuReg>(DATA_REG), DATA_BASE);
+        });
+        // Exceptions restart the program
+        loadProgram(0x80000080, {jType(PrimaryOpCode::J, PROGRAM_BASE), 0});
+        loadProgram(PROGRAM_BASE, program);
+
+        SCOPED_TRACE(testing::Message() << "seed " << seed);
+        runLockstep(5000);
+        if (HasFatalFailure()) {
+            return;
+        }
+        for (uint32_t offset = 0; offset < 128; offset += 4) {
+            ASSERT_EQ(refBus.loadWord(DATA_BASE + offset), jitBus.loadWord(DATA_BASE + offset));
+        }
+    }
+}
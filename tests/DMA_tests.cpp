@@ -24,8 +24,8 @@ TEST(DMA, readWriteCommonRegisters)
 
     dma.write32(value, 0x1F8010F0); // DPCR register
     EXPECT_EQ(dma.read32(0x1F8010F0), value);
-    dma.write32(value, 0x1F8010F4); // DICR register
-    EXPECT_EQ(dma.read32(0x1F8010F4), value);
+    dma.write32(value, 0x1F8010F4); // DICR register, flags are acknowledged and bit 15 forces the master flag
+    EXPECT_EQ(dma.read32(0x1F8010F4), 0x80FE803E);
     dma.write32(value, 0x1F8010F8); // Unknown register
     EXPECT_EQ(dma.read32(0x1F8010F8), 0);
 }
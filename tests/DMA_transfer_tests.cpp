@@ -191,10 +191,12 @@ TEST_F(DMATransferTest, DMA_CommonRegisters) {
     dma->write32(dpcr_value, dpcr_addr);
     EXPECT_EQ(dma->read32(dpcr_addr), dpcr_value);
 
-    // Test DICR (DMA Interrupt Control)
-    uint32_t dicr_value = 0x80000000;
+    // Test DICR (DMA Interrupt Control), the master flag is read only
+    uint32_t dicr_value = 0x00FF003F;
     dma->write32(dicr_value, dicr_addr);
     EXPECT_EQ(dma->read32(dicr_addr), dicr_value);
+    dma->write32(0x80000000, dicr_addr);
+    EXPECT_EQ(dma->read32(dicr_addr), 0);
 }
 
 // Test DMA channel memory address register (24-bit mask)
@@ -364,3 +366,125 @@ TEST_F(DMATransferTest, GPU_DMA_LinkedList_MaxPacketSize) {
     // Verify completed
     EXPECT_EQ(dma->read32(gpu_chcr) & 0x01000000, 0);
 }
+
+// Test OTC DMA building the ordering table in RAM
+TEST_F(DMATransferTest, OTC_DMA_BuildsOrderingTable) {
+    uint32_t otc_madr = 0x1F8010E0;
+    uint32_t otc_bcr = 0x1F8010E4;
+    uint32_t otc_chcr = 0x1F8010E8;
+
+    dma->write32(0x8010000C, otc_madr);
+    dma->write32(4, otc_bcr);
+    dma->write32(0x11000002, otc_chcr);
+
+    EXPECT_EQ(bus->loadWord(0x8010000C), 0x00100008);
+    EXPECT_EQ(bus->loadWord(0x80100008), 0x00100004);
+    EXPECT_EQ(bus->loadWord(0x80100004), 0x00100000);
+    EXPECT_EQ(bus->loadWord(0x80100000), OT_END_TAG);
+    EXPECT_EQ(dma->read32(otc_chcr) & 0x01000000, 0);
+}
+
+// Test GPU DMA reading a block that wraps around the end of RAM
+TEST_F(DMATransferTest, GPU_DMA_Request_WrapsAroundRam) {
+    uint32_t gpu_madr = 0x1F8010A0;
+    uint32_t gpu_bcr = 0x1F8010A4;
+    uint32_t gpu_chcr = 0x1F8010A8;
+
+    // CPU to VRAM copy of 4x1 pixels, its last data word is at the start of RAM
+    bus->storeWord(0x801FFFF0, 0xA0000000);
+    bus->storeWord(0x801FFFF4, 0x00000000);
+    bus->storeWord(0x801FFFF8, 0x00010004);
+    bus->storeWord(0x801FFFFC, 0x22221111);
+    bus->storeWord(0x80000000, 0x44443333);
+
+    dma->write32(0x801FFFF0, gpu_madr);
+    dma->write32(0x00010005, gpu_bcr);
+    dma->write32(0x01000201, gpu_chcr);
+
+    const uint16_t *vram = reinterpret_cast<const uint16_t *>(gpu->getVram());
+    EXPECT_EQ(vram[0], 0x1111);
+    EXPECT_EQ(vram[1], 0x2222);
+    EXPECT_EQ(vram[2], 0x3333);
+    EXPECT_EQ(vram[3], 0x4444);
+    EXPECT_EQ(dma->read32(gpu_madr), 0x200004);
+}
+
+// Test GPU DMA from the GPU to RAM, each word reads GPUREAD
+TEST_F(DMATransferTest, GPU_DMA_Request_GpuToRam) {
+    uint32_t gpu_madr = 0x1F8010A0;
+    uint32_t gpu_bcr = 0x1F8010A4;
+    uint32_t gpu_chcr = 0x1F8010A8;
+
+    // GP1(10h): read the GPU version
+    gpu->write32(0x10000007, 0x1F801814);
+    dma->write32(0x80009000, gpu_madr);
+    dma->write32(0x00010003, gpu_bcr);
+    dma->write32(0x01000200, gpu_chcr);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(bus->loadWord(0x80009000 + i * 4), 2);
+    }
+    EXPECT_EQ(bus->loadWord(0x8000900C), 0);
+}
+
+// Test the completion interrupt, raised once the bus cycles of the transfer elapsed
+TEST_F(DMATransferTest, GPU_DMA_RaisesInterruptOnCompletion) {
+    uint32_t gpu_madr = 0x1F8010A0;
+    uint32_t gpu_bcr = 0x1F8010A4;
+    uint32_t gpu_chcr = 0x1F8010A8;
+    uint32_t dicr_addr = 0x1F8010F4;
+    uint32_t i_stat = 0x1F801070;
+
+    for (uint32_t i = 0; i < 16; i++) {
+        bus->storeWord(0x80004000 + i * 4, 0x00000000);
+    }
+    // Master enable and GPU channel enable
+    dma->write32(0x00840000, dicr_addr);
+    dma->write32(0x80004000, gpu_madr);
+    dma->write32(0x00020008, gpu_bcr);
+    dma->write32(0x01000201, gpu_chcr);
+
+    // The CPU waits for the transfer, the interrupt comes once it is over
+    EXPECT_EQ(dma->read32(gpu_chcr) & 0x01000000, 0);
+    EXPECT_EQ(dma->read32(dicr_addr) & 0x84000000, 0);
+    bus->updateDevices(0);
+    EXPECT_EQ(bus->getScheduler().now(), 16);
+    EXPECT_EQ(dma->read32(dicr_addr) & 0x84000000, 0x84000000);
+    EXPECT_EQ(bus->loadWord(i_stat) & 0x8, 0x8);
+
+    // Writing the flag back acknowledges it
+    dma->write32(0x04840000, dicr_addr);
+    EXPECT_EQ(dma->read32(dicr_addr), 0x00840000);
+}
+
+// Test chopped OTC DMA, the CPU gets the bus back between windows
+TEST_F(DMATransferTest, OTC_DMA_ChoppedWindows) {
+    uint32_t otc_madr = 0x1F8010E0;
+    uint32_t otc_bcr = 0x1F8010E4;
+    uint32_t otc_chcr = 0x1F8010E8;
+
+    // 10 entries, windows of 4 words and 8 CPU cycles
+    dma->write32(0x80100024, otc_madr);
+    dma->write32(10, otc_bcr);
+    dma->write32(0x11320102, otc_chcr);
+
+    auto &scheduler = bus->getScheduler();
+    bus->updateDevices(0);
+    EXPECT_EQ(scheduler.now(), 4);
+    EXPECT_EQ(dma->read32(otc_madr), 0x100014);
+    EXPECT_EQ(dma->read32(otc_chcr) & 0x01000000, 0x01000000);
+
+    bus->updateDevices(8);
+    EXPECT_EQ(scheduler.now(), 16);
+    EXPECT_EQ(dma->read32(otc_madr), 0x100004);
+    EXPECT_EQ(dma->read32(otc_chcr) & 0x01000000, 0x01000000);
+
+    bus->updateDevices(8);
+    EXPECT_EQ(scheduler.now(), 26);
+    EXPECT_EQ(dma->read32(otc_chcr) & 0x01000000, 0);
+
+    for (uint32_t addr = 0x80100024; addr > 0x80100000; addr -= 4) {
+        EXPECT_EQ(bus->loadWord(addr), (addr - 4) & 0xFFFFFF);
+    }
+    EXPECT_EQ(bus->loadWord(0x80100000), OT_END_TAG);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "SystemStateHelpers.hpp"
+
+TEST(DeltaSavestateTest, DeltaChainReplaysTheRecordedStates)
+{
+    System recorder;
+    recorder.init();
+    loadStoreLoopProgram(recorder);
+    runFrame(recorder, 0);
+
+    StateBuffer keyframe;
+    recorder.saveKeyframe(keyframe);
+    std::vector<StateBuffer> deltas(4);
+    std::vector<std::vector<uint8_t>> states;
+    for (uint32_t frame = 1; frame <= deltas.size(); frame++) {
+        runFrame(recorder, frame);
+        ASSERT_TRUE(recorder.saveDelta(deltas[frame - 1]));
+        states.push_back(fullState(recorder));
+        EXPECT_LT(deltas[frame - 1].size() * 10, keyframe.size());
+    }
+
+    System player;
+    player.init();
+    keyframe.resetCursor();
+    ASSERT_TRUE(player.loadKeyframe(keyframe));
+    for (size_t i = 0; i < deltas.size(); i++) {
+        // Frames run by the player are overwritten by the next delta
+        runFrame(player, 100 + static_cast<uint32_t>(i));
+        deltas[i].resetCursor();
+        ASSERT_TRUE(player.applyDelta(deltas[i]));
+        EXPECT_TRUE(fullState(player) == states[i]);
+    }
+}
+
+TEST(DeltaSavestateTest, RejectsDeltasOutOfOrder)
+{
+    System recorder;
+    recorder.init();
+    loadStoreLoopProgram(recorder);
+
+    StateBuffer delta;
+    EXPECT_FALSE(recorder.saveDelta(delta));
+
+    StateBuffer keyframe;
+    recorder.saveKeyframe(keyframe);
+    StateBuffer first;
+    StateBuffer second;
+    runFrame(recorder, 1);
+    ASSERT_TRUE(recorder.saveDelta(first));
+    runFrame(recorder, 2);
+    ASSERT_TRUE(recorder.saveDelta(second));
+
+    System player;
+    player.init();
+    keyframe.resetCursor();
+    ASSERT_TRUE(player.loadKeyframe(keyframe));
+    EXPECT_FALSE(player.applyDelta(second));
+    first.resetCursor();
+    EXPECT_TRUE(player.applyDelta(first));
+    second.resetCursor();
+    EXPECT_TRUE(player.applyDelta(second));
+    EXPECT_TRUE(fullState(player) == fullState(recorder));
+}
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "Core/EmulationThread.hpp"
+#include "Core/InterruptController.hpp"
+#include "Core/SerialInterface.hpp"
+#include "Core/System.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(TripleBufferTest, HandsOverTheLatestValue)
+{
+    TripleBuffer<int> buffer;
+    EXPECT_EQ(buffer.acquire(), nullptr);
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+    const int *value = buffer.acquire();
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 2);
+    EXPECT_EQ(buffer.acquire(), nullptr);
+    EXPECT_EQ(buffer.front(), 2);
+
+    buffer.back() = 3;
+    buffer.publish();
+    EXPECT_EQ(*buffer.acquire(), 3);
+}
+
+TEST(TripleBufferTest, ValuesAreNeverTorn)
+{
+    struct Pair { uint64_t a; uint64_t b; };
+    TripleBuffer<Pair> buffer;
+    constexpr uint64_t COUNT = 200000;
+
+    std::thread producer([&buffer]() {
+        for (uint64_t i = 1; i <= COUNT; i++) {
+            buffer.back() = {i, ~i};
+            buffer.publish();
+        }
+    });
+    uint64_t last = 0;
+    while (last != COUNT) {
+        if (const Pair *pair = buffer.acquire()) {
+            ASSERT_EQ(pair->b, ~pair->a);
+            ASSERT_GT(pair->a, last);
+            last = pair->a;
+        }
+    }
+    producer.join();
+}
+
+// Host time that only moves when the test or a wait moves it
+class FakeTimer : public FramePacer::Timer
+{
+    public:
+        FramePacer::Clock::time_point time;
+        uint32_t sleeps = 0;
+
+        FramePacer::Clock::time_point now() override { return time; }
+
+        void sleepUntil(FramePacer::Clock::time_point deadline) override
+        {
+            sleeps++;
+            time = std::max(time, deadline);
+        }
+};
+
+TEST(FramePacerTest, KeepsTheRate)
+{
+    FakeTimer timer;
+    FramePacer pacer(timer);
+    pacer.setRate(200.0);
+    EXPECT_EQ(pacer.getPeriod(), std::chrono::duration_cast<FramePacer::Clock::duration>(5ms));
+
+    auto start = timer.time;
+    pacer.reset();
+    for (int i = 0; i < 20; i++) {
+        // Frames taking part of the period do not shift the deadlines
+        timer.time += 2ms;
+        pacer.wait();
+        EXPECT_EQ(timer.time, start + (i + 1) * 5ms);
+    }
+    EXPECT_EQ(timer.sleeps, 20);
+    EXPECT_EQ(pacer.getResyncs(), 0);
+}
+
+TEST(FramePacerTest, SpeedScalesThePeriod)
+{
+    FakeTimer timer;
+    FramePacer pacer(timer);
+    pacer.setRate(50.0);
+    pacer.setSpeed(2.0);
+    EXPECT_EQ(pacer.getPeriod(), std::chrono::duration_cast<FramePacer::Clock::duration>(10ms));
+
+    pacer.setSpeed(0.0);
+    auto start = timer.time;
+    for (int i = 0; i < 1000; i++) {
+        pacer.wait();
+    }
+    EXPECT_EQ(timer.time, start);
+    EXPECT_EQ(timer.sleeps, 0);
+
+    // Back from uncapped, the deadlines start over from now
+    timer.time += 1s;
+    pacer.setSpeed(1.0);
+    pacer.wait();
+    EXPECT_EQ(timer.time, start + 1s + 20ms);
+    EXPECT_EQ(pacer.getResyncs(), 0);
+}
+
+TEST(FramePacerTest, CatchesUpThenStartsOver)
+{
+    FakeTimer timer;
+    FramePacer pacer(timer);
+    pacer.setRate(100.0);
+    auto start = timer.time;
+    pacer.reset();
+
+    // A short stall is made up by the next frame
+    timer.time += 15ms;
+    pacer.wait();
+    EXPECT_EQ(timer.time, start + 15ms);
+    EXPECT_EQ(timer.sleeps, 0);
+    pacer.wait();
+    EXPECT_EQ(timer.time, start + 20ms);
+    EXPECT_EQ(pacer.getResyncs(), 0);
+
+    // A long one is given up
+    timer.time += 100ms;
+    pacer.wait();
+    EXPECT_EQ(timer.time, start + 120ms);
+    EXPECT_EQ(pacer.getResyncs(), 1);
+    pacer.wait();
+    EXPECT_EQ(timer.time, start + 130ms);
+    EXPECT_EQ(pacer.getResyncs(), 1);
+}
+
+class EmulationThreadTest : public testing::Test
+{
+    protected:
+        System system;
+
+        EmulationThreadTest()
+        {
+            system.init();
+            // loop: addiu t0, t0, 1; j loop; nop
+            system.getBus()->storeWord(0x80010000, 0x25080001);
+            system.getBus()->storeWord(0x80010004, 0x08004000);
+            system.getBus()->storeWord(0x80010008, 0);
+            system.getCPU()->setReg(CpuReg::PC, 0x80010000);
+        }
+
+        const VideoFrame *waitFrame(EmulationThread &emulation)
+        {
+            auto deadline = std::chrono::steady_clock::now() + 2s;
+            while (std::chrono::steady_clock::now() < deadline) {
+                if (const VideoFrame *frame = emulation.takeFrame()) {
+                    return frame;
+                }
+                std::this_thread::sleep_for(1ms);
+            }
+            return nullptr;
+        }
+};
+
+TEST_F(EmulationThreadTest, RefreshRateFollowsTheVideoMode)
+{
+    EXPECT_NEAR(system.getRefreshRate(), 59.29, 0.01);
+    system.getBus()->getDevice<GPU>()->write32(0x08000008, 0x1F801814);
+    EXPECT_NEAR(system.getRefreshRate(), 49.76, 0.01);
+}
+
+// Every frame holds one field: the pacer never shows a field twice or skips one
+static void expectOneVBlankPerFrame(System &system)
+{
+    GPU *gpu = system.getBus()->getDevice<GPU>();
+    InterruptController *irqc = system.getBus()->getDevice<InterruptController>();
+    double fieldCycles = gpu->getFieldCycles();
+
+    for (int i = 0; i < 4; i++) {
+        uint64_t field = gpu->getFieldCount();
+        uint64_t start = system.getBus()->getScheduler().now();
+        irqc->write32(0, 0x1F801070);
+        system.update();
+        uint64_t cycles = system.getBus()->getScheduler().now() - start;
+
+        EXPECT_EQ(gpu->getFieldCount(), field + 1);
+        EXPECT_EQ(irqc->read32(0x1F801070) & 1, 1);
+        // Both ends are a VBlank, give or take the last CPU block
+        if (i > 0) {
+            EXPECT_NEAR(static_cast<double>(cycles), fieldCycles, 64.0);
+        }
+    }
+}
+
+TEST_F(EmulationThreadTest, NtscFramesEndAtVBlank)
+{
+    expectOneVBlankPerFrame(system);
+}
+
+TEST_F(EmulationThreadTest, PalFramesEndAtVBlank)
+{
+    system.getBus()->getDevice<GPU>()->write32(0x08000008, 0x1F801814);
+    system.update();
+    expectOneVBlankPerFrame(system);
+}
+
+TEST_F(EmulationThreadTest, HandsFramesToTheUi)
+{
+    EmulationThread emulation(system);
+    emulation.start();
+
+    const VideoFrame *frame = waitFrame(emulation);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->displayWidth, 256);
+    EXPECT_EQ(frame->displayHeight, 240);
+    frame = waitFrame(emulation);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_GT(frame->number, 0);
+    emulation.stop();
+    EXPECT_FALSE(emulation.isRunning());
+}
+
+TEST_F(EmulationThreadTest, LockStopsTheMachine)
+{
+    EmulationThread emulation(system);
+    emulation.setSpeedMode(SpeedMode::Turbo);
+    emulation.setPadButtons(0xFFFE);
+    emulation.start();
+    waitFrame(emulation);
+
+    {
+        auto lock = emulation.lock();
+        uint32_t t0 = system.getCPU()->getReg(CpuReg::T0);
+        std::this_thread::sleep_for(20ms);
+        EXPECT_EQ(system.getCPU()->getReg(CpuReg::T0), t0);
+        EXPECT_EQ(system.getBus()->getDevice<SerialInterface>()->getPad(0).getButtons(), 0xFFFE);
+    }
+    emulation.stop();
+}
@@ -0,0 +1,87 @@
+#ifndef GP0STREAMGENERATOR_HPP_
+#define GP0STREAMGENERATOR_HPP_
+
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+inline constexpr uint32_t GP0 = 0x1F801810;
+
+struct Gp0StreamOptions
+{
+    bool polylines = false;
+    bool uploads = false; // CPU to VRAM transfers, with odd pixel counts
+};
+
+// Random GP0 stream mixing every draw command with texturing from drawn
+// areas and VRAM copies, so that commands depend on each other
+inline std::vector<uint32_t> randomGp0Stream(uint32_t seed, int commands, const Gp0StreamOptions &options = {})
+{
+    std::mt19937 rng(seed);
+    auto rand = [&rng](uint32_t max) { return static_cast<uint32_t>(rng() % max); };
+    auto color = [&rng] { return static_cast<uint32_t>(rng() & 0xFFFFFF); };
+    uint32_t center = 0;
+    auto vertex = [&] { return center + ((rand(64) << 16) | rand(64)); };
+    auto texCoord = [&](uint32_t high) { return (high << 16) | (rand(256) << 8) | rand(256); };
+    auto texPage = [&] { return (rand(3) << 7) | (rand(2) << 4) | rand(16); };
+    auto clut = [&] { return (rand(512) << 6) | rand(64); };
+    std::vector<uint32_t> kinds = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    if (options.polylines) {
+        kinds.push_back(9);
+    }
+    if (options.uploads) {
+        kinds.push_back(10);
+    }
+    std::vector<uint32_t> words;
+
+    for (int i = 0; i < commands; i++) {
+        // Primitives stay around a random point to keep them small
+        center = (rand(448) << 16) | rand(960);
+        switch (kinds[rand(static_cast<uint32_t>(kinds.size()))]) {
+            case 0: // Quick fill
+                words.insert(words.end(), {0x02000000 | color(), vertex(), (rand(64) << 16) | rand(64)});
+                break;
+            case 1: // Flat triangle
+                words.insert(words.end(), {0x20000000 | color(), vertex(), vertex(), vertex()});
+                break;
+            case 2: // Shaded quad
+                words.insert(words.end(), {0x38000000 | color(), vertex(), color(), vertex(), color(), vertex(), color(), vertex()});
+                break;
+            case 3: // Textured triangle
+                words.insert(words.end(), {0x24000000 | color(), vertex(), texCoord(clut()), vertex(), texCoord(texPage()), vertex(), texCoord(0)});
+                break;
+            case 4: // Variable size rectangle
+                words.insert(words.end(), {0x60000000 | color(), vertex(), (rand(128) << 16) | rand(128)});
+                break;
+            case 5: // Textured 16x16 rectangle
+                words.insert(words.end(), {0xE1000000 | texPage(), 0x7C000000 | color(), vertex(), texCoord(clut())});
+                break;
+            case 6: // Shaded line
+                words.insert(words.end(), {0x50000000 | color(), vertex(), color(), vertex()});
+                break;
+            case 7: // VRAM to VRAM copy
+                words.insert(words.end(), {0x80000000, vertex(), vertex(), (rand(32) << 16) | rand(32)});
+                break;
+            case 8: // Raw textured quad
+                words.insert(words.end(), {0x2C000000 | color(), vertex(), texCoord(clut()), vertex(), texCoord(texPage()),
+                    vertex(), texCoord(0), vertex(), texCoord(0)});
+                break;
+            case 9: // Shaded polyline
+                words.insert(words.end(), {0x58000000 | color(), vertex(), color(), vertex(), color(), vertex(), 0x55555555});
+                break;
+            case 10: { // CPU to VRAM upload
+                uint32_t width = rand(20) + 1;
+                uint32_t height = rand(20) + 1;
+                words.insert(words.end(), {0xA0000000, vertex(), (height << 16) | width});
+                for (uint32_t w = 0; w < (width * height + 1) / 2; w++) {
+                    words.push_back(static_cast<uint32_t>(rng()));
+                }
+                break;
+            }
+        }
+    }
+    return words;
+}
+
+#endif /* !GP0STREAMGENERATOR_HPP_ */
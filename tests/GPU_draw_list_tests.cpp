@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Core/GPU.hpp"
+#include "Core/Bus.hpp"
+#include "GP0StreamGenerator.hpp"
+
+static std::vector<uint8_t> renderScene(size_t threads, const std::vector<uint32_t> &words)
+{
+    Bus bus;
+    GPU *gpu = bus.getDevice<GPU>();
+    gpu->setRenderThreads(threads);
+    for (uint32_t word : words) {
+        gpu->write32(word, GP0);
+    }
+    const uint8_t *vram = gpu->getVram();
+    return std::vector<uint8_t>(vram, vram + GPU_VRAM_1MB_SIZE);
+}
+
+TEST(GpuDrawListTest, BandsMatchSingleThreadRendering)
+{
+    auto words = randomGp0Stream(1234, 1500);
+    auto reference = renderScene(1, words);
+
+    for (size_t threads : {2, 3, 8}) {
+        auto vram = renderScene(threads, words);
+        EXPECT_TRUE(vram == reference) << threads << " threads";
+    }
+}
+
+TEST(GpuDrawListTest, FlushesBeforeCpuToVramCopy)
+{
+    Bus bus;
+    GPU *gpu = bus.getDevice<GPU>();
+    gpu->setRenderThreads(4);
+
+    // Fill then overwrite one pixel of the filled area through a CPU copy
+    gpu->write32(0x020000FF, GP0);
+    gpu->write32(0x00000000, GP0);
+    gpu->write32(0x00100010, GP0);
+    gpu->write32(0xA0000000, GP0);
+    gpu->write32(0x00000000, GP0);
+    gpu->write32(0x00010002, GP0);
+    gpu->write32(0x7FFF1234, GP0);
+
+    const uint8_t *vram = gpu->getVram();
+    uint16_t pixels[3];
+    std::memcpy(pixels, vram, sizeof(pixels));
+    EXPECT_EQ(pixels[0], 0x1234);
+    EXPECT_EQ(pixels[1], 0x7FFF);
+    EXPECT_EQ(pixels[2], 0x801F);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "Core/GPU.hpp"
+#include "Core/Bus.hpp"
+
+constexpr uint32_t GP0 = 0x1F801810;
+
+class GpuRasterizerTest : public testing::Test
+{
+    protected:
+        Bus bus;
+        GPU *gpu;
+
+        GpuRasterizerTest() :
+            gpu(bus.getDevice<GPU>())
+        {
+        }
+
+        void send(std::initializer_list<uint32_t> words)
+        {
+            for (uint32_t word : words) {
+                gpu->write32(word, GP0);
+            }
+        }
+
+        uint16_t pixel(int x, int y)
+        {
+            uint16_t value;
+            std::memcpy(&value, gpu->getVram() + (y * GPU_VRAM_WIDTH + x) * 2, sizeof(value));
+            return value;
+        }
+
+        int countDrawn(int width, int height)
+        {
+            int count = 0;
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    count += pixel(x, y) != 0;
+                }
+            }
+            return count;
+        }
+};
+
+static uint32_t vertex(int x, int y)
+{
+    return ((static_cast<uint32_t>(y) & 0x7FF) << 16) | (static_cast<uint32_t>(x) & 0x7FF);
+}
+
+TEST_F(GpuRasterizerTest, DrawsTopLeftEdgesOnly)
+{
+    send({0x200000FF, vertex(0, 0), vertex(4, 0), vertex(0, 4)});
+
+    EXPECT_EQ(countDrawn(16, 16), 4 + 3 + 2 + 1);
+    EXPECT_EQ(pixel(0, 0), 0x801F);
+    EXPECT_EQ(pixel(3, 0), 0x801F);
+    EXPECT_EQ(pixel(0, 3), 0x801F);
+    EXPECT_EQ(pixel(4, 0), 0);
+    EXPECT_EQ(pixel(0, 4), 0);
+    EXPECT_EQ(pixel(1, 3), 0);
+}
+
+TEST_F(GpuRasterizerTest, QuadCoversItsAreaExactly)
+{
+    send({0x280000FF, vertex(0, 0), vertex(8, 0), vertex(0, 8), vertex(8, 8)});
+
+    EXPECT_EQ(countDrawn(16, 16), 64);
+    EXPECT_EQ(pixel(7, 7), 0x801F);
+    EXPECT_EQ(pixel(8, 0), 0);
+    EXPECT_EQ(pixel(0, 8), 0);
+}
+
+TEST_F(GpuRasterizerTest, ShadingStepsAcrossTheSpan)
+{
+    // Red goes from 0 on the left edge to 248 at x = 32
+    send({0x38000000, vertex(0, 0), 0x0000F8, vertex(32, 0), 0x000000, vertex(0, 32), 0x0000F8, vertex(32, 32)});
+    send({0x38000000, vertex(0, 40), 0x0000F8, vertex(32, 40), 0x000000, vertex(0, 72), 0x0000F8, vertex(32, 72)});
+
+    EXPECT_EQ(pixel(0, 0) & 0x1F, 0);
+    EXPECT_EQ(pixel(16, 4) & 0x1F, 15);
+    EXPECT_EQ(pixel(31, 0) & 0x1F, 30);
+    int previous = 0;
+    for (int x = 0; x < 32; x++) {
+        int red = pixel(x, 40) & 0x1F;
+        EXPECT_GE(red, previous);
+        previous = red;
+    }
+}
+
+TEST_F(GpuRasterizerTest, ClipsNegativeCoordinates)
+{
+    send({0x200000FF, vertex(-4, 0), vertex(4, 0), vertex(-4, 8)});
+
+    EXPECT_EQ(pixel(0, 0), 0x801F);
+    EXPECT_EQ(pixel(3, 0), 0x801F);
+    EXPECT_EQ(pixel(4, 0), 0);
+    EXPECT_EQ(pixel(1023, 0), 0);
+}
+
+TEST_F(GpuRasterizerTest, SkipsOversizedPolygons)
+{
+    send({0x200000FF, vertex(0, 0), vertex(1023, 0), vertex(0, 4)});
+    EXPECT_EQ(pixel(0, 0), 0x801F);
+
+    send({0x2000001F, vertex(-1, 0), vertex(1023, 0), vertex(0, 4)});
+    EXPECT_EQ(pixel(0, 0), 0x801F);
+}
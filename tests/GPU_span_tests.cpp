@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "Core/GPUSpan.hpp"
+
+static void putPixel(std::vector<uint16_t> &vram, int x, int y, uint16_t color)
+{
+    vram[y * GPU_VRAM_WIDTH + x] = color;
+}
+
+static uint16_t pixelAt(const std::vector<uint16_t> &vram, int x, int y)
+{
+    return vram[y * GPU_VRAM_WIDTH + x];
+}
+
+static TexturedSpan makeSpan(std::vector<uint16_t> &vram, int x, int y, int count)
+{
+    TexturedSpan span{};
+    span.dst = &vram[y * GPU_VRAM_WIDTH + x];
+    span.count = count;
+    span.du = 1 << 16;
+    span.r = span.g = span.b = 0x80 << 16;
+    return span;
+}
+
+TEST(GpuSpanTest, ModulatesAndSkipsTransparentTexels)
+{
+    std::vector<uint16_t> vram(GPU_VRAM_WIDTH * GPU_VRAM_HEIGHT, 0);
+    putPixel(vram, 0, 0, 0x8421);
+    putPixel(vram, 1, 0, 0x0000);
+    putPixel(vram, 2, 0, 0x7FFF);
+    putPixel(vram, 1, 10, 0x1234);
+
+    SpanTexture tex{vram.data(), 0, 0, 0, 0, TexturePageColors::COL_15Bit};
+    TexturedSpan span = makeSpan(vram, 0, 10, 3);
+    drawTexturedSpanScalar(tex, span);
+
+    EXPECT_EQ(pixelAt(vram, 0, 10), 0x8421);
+    EXPECT_EQ(pixelAt(vram, 1, 10), 0x1234);
+    EXPECT_EQ(pixelAt(vram, 2, 10), 0x7FFF);
+
+    // Colors above 0x80 brighten the texel up to the channel maximum
+    span.r = 0xFF << 16;
+    span.g = 0x40 << 16;
+    span.b = 0x00;
+    drawTexturedSpanScalar(tex, span);
+    EXPECT_EQ(pixelAt(vram, 0, 10), 0x8001);
+    EXPECT_EQ(pixelAt(vram, 2, 10), 0x01FF);
+}
+
+TEST(GpuSpanTest, ReadsClutIndices)
+{
+    std::vector<uint16_t> vram(GPU_VRAM_WIDTH * GPU_VRAM_HEIGHT, 0);
+    putPixel(vram, 64, 0, 0x3210);
+    putPixel(vram, 128, 0, 0x0201);
+    for (int i = 0; i < 4; i++) {
+        putPixel(vram, 16 + i, 480, static_cast<uint16_t>(0x8000 | (i + 1)));
+    }
+
+    SpanTexture tex{vram.data(), 64, 0, 16, 480, TexturePageColors::COL_4Bit};
+    TexturedSpan span = makeSpan(vram, 0, 100, 4);
+    span.rawTexture = true;
+    drawTexturedSpanScalar(tex, span);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(pixelAt(vram, i, 100), 0x8000 | (i + 1));
+    }
+
+    tex.pageX = 128;
+    tex.colorMode = TexturePageColors::COL_8Bit;
+    span = makeSpan(vram, 0, 101, 2);
+    span.rawTexture = true;
+    drawTexturedSpanScalar(tex, span);
+    EXPECT_EQ(pixelAt(vram, 0, 101), 0x8002);
+    EXPECT_EQ(pixelAt(vram, 1, 101), 0x8003);
+}
+
+TEST(GpuSpanTest, Avx2MatchesScalar)
+{
+#ifdef ROGEM_SPAN_AVX2
+    if (!hasAvx2SpanKernel()) {
+        GTEST_SKIP() << "AVX2 not supported";
+    }
+
+    std::mt19937 rng(42);
+    auto rand = [&rng](int min, int max) { return min + static_cast<int>(rng() % static_cast<uint32_t>(max - min + 1)); };
+    std::vector<uint16_t> source(GPU_VRAM_WIDTH * GPU_VRAM_HEIGHT);
+    for (auto &pixel : source) {
+        // Plenty of transparent texels
+        pixel = rng() % 4 ? static_cast<uint16_t>(rng()) : 0;
+    }
+
+    // Each span draws over its own buffer of random pixels
+    SpanTexture tex{source.data(), 0, 0, 0, 0, TexturePageColors::COL_15Bit};
+    for (int i = 0; i < 5000; i++) {
+        tex.pageX = rand(0, 15) * 64;
+        tex.pageY = rand(0, 1) * 256;
+        tex.clutX = rand(0, 63) * 16;
+        tex.clutY = rand(0, 511);
+        tex.colorMode = static_cast<TexturePageColors>(rand(0, 3));
+        TexturedSpan span{};
+        span.count = rand(0, 40);
+        span.u = rand(-0x1000000, 0x1000000);
+        span.v = rand(-0x1000000, 0x1000000);
+        span.du = rand(-0x30000, 0x30000);
+        span.dv = rand(-0x30000, 0x30000);
+        span.r = rand(-0x100000, 0x1100000);
+        span.g = rand(-0x100000, 0x1100000);
+        span.b = rand(-0x100000, 0x1100000);
+        span.dr = rand(-0x80000, 0x80000);
+        span.dg = rand(-0x80000, 0x80000);
+        span.db = rand(-0x80000, 0x80000);
+        span.rawTexture = rand(0, 1);
+
+        std::vector<uint16_t> scalar(span.count);
+        for (auto &pixel : scalar) {
+            pixel = static_cast<uint16_t>(rng());
+        }
+        std::vector<uint16_t> avx2 = scalar;
+        span.dst = scalar.data();
+        drawTexturedSpanScalar(tex, span);
+        span.dst = avx2.data();
+        drawTexturedSpanAvx2(tex, span);
+
+        ASSERT_TRUE(scalar == avx2) << "span " << i;
+    }
+#else
+    GTEST_SKIP() << "No AVX2 kernel on this architecture";
+#endif
+}
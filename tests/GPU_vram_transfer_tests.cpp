@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "Core/GPU.hpp"
+#include "Core/Bus.hpp"
+
+constexpr uint32_t GP0 = 0x1F801810;
+
+class GpuVramTransferTest : public testing::Test
+{
+    protected:
+        Bus bus;
+        GPU *gpu;
+
+        GpuVramTransferTest() :
+            gpu(bus.getDevice<GPU>())
+        {
+        }
+
+        void send(std::initializer_list<uint32_t> words)
+        {
+            for (uint32_t word : words) {
+                gpu->write32(word, GP0);
+            }
+        }
+
+        uint16_t pixel(int x, int y)
+        {
+            uint16_t value;
+            std::memcpy(&value, gpu->getVram() + (y * GPU_VRAM_WIDTH + x) * 2, sizeof(value));
+            return value;
+        }
+};
+
+TEST_F(GpuVramTransferTest, UploadWrapsAroundVram)
+{
+    // 4x2 pixels at (1022, 511)
+    send({0xA0000000, 0x01FF03FE, 0x00020004});
+    send({0x00020001, 0x00040003, 0x00060005, 0x00080007});
+
+    EXPECT_EQ(pixel(1022, 511), 1);
+    EXPECT_EQ(pixel(1023, 511), 2);
+    EXPECT_EQ(pixel(0, 511), 3);
+    EXPECT_EQ(pixel(1, 511), 4);
+    EXPECT_EQ(pixel(1022, 0), 5);
+    EXPECT_EQ(pixel(1, 0), 8);
+    EXPECT_EQ(pixel(2, 0), 0);
+}
+
+TEST_F(GpuVramTransferTest, UploadHonoursMaskBit)
+{
+    send({0xA0000000, 0x00000000, 0x00010002, 0x00018001});
+
+    // Check the mask bit and set it on the written pixels
+    send({0xE6000003});
+    send({0xA0000000, 0x00000000, 0x00010002, 0x00220011});
+
+    EXPECT_EQ(pixel(0, 0), 0x8001);
+    EXPECT_EQ(pixel(1, 0), 0x8022);
+}
+
+TEST_F(GpuVramTransferTest, CopyMovesOverlappingRows)
+{
+    send({0xA0000000, 0x00000000, 0x00010008});
+    send({0x00020001, 0x00040003, 0x00060005, 0x00080007});
+
+    send({0x80000000, 0x00000000, 0x00000002, 0x00010008});
+
+    EXPECT_EQ(pixel(0, 0), 1);
+    EXPECT_EQ(pixel(1, 0), 2);
+    for (int x = 0; x < 8; x++) {
+        EXPECT_EQ(pixel(x + 2, 0), x + 1);
+    }
+}
+
+TEST_F(GpuVramTransferTest, CopyAndFillWrapAroundVram)
+{
+    send({0x020000FF, 0x01FE03F0, 0x00040020});
+
+    for (int x : {1008, 1023, 0, 15}) {
+        EXPECT_EQ(pixel(x, 510), 0x801F);
+        EXPECT_EQ(pixel(x, 1), 0x801F);
+    }
+    EXPECT_EQ(pixel(16, 0), 0);
+
+    send({0x80000000, 0x000003FF, 0x00100010, 0x00020002});
+    EXPECT_EQ(pixel(16, 16), 0x801F);
+    EXPECT_EQ(pixel(17, 17), 0x801F);
+    EXPECT_EQ(pixel(18, 16), 0);
+}
+
+TEST_F(GpuVramTransferTest, FillMasksItsRectangle)
+{
+    // x is rounded down and the width up to 16 pixels
+    send({0x020000FF, 0x00000007, 0x00010009});
+    EXPECT_EQ(pixel(0, 0), 0x801F);
+    EXPECT_EQ(pixel(15, 0), 0x801F);
+    EXPECT_EQ(pixel(16, 0), 0);
+
+    // Oversize values wrap: 1024x511 from (1008, 511)
+    send({0x0200FF00, 0xFFFFFFFF, 0xFFFFFFFF});
+    EXPECT_EQ(pixel(1008, 511), 0x83E0);
+    EXPECT_EQ(pixel(1007, 509), 0x83E0);
+    EXPECT_EQ(pixel(500, 510), 0);
+}
+
+TEST_F(GpuVramTransferTest, CopyMasksItsRectangle)
+{
+    send({0xA0000000, 0x00000000, 0x00010001, 0x00001234});
+
+    // A size of 0 is the whole VRAM, each row moves one pixel right
+    send({0x80000000, 0x00000000, 0x02000401, 0x00000000});
+    EXPECT_EQ(pixel(1, 0), 0x1234);
+    EXPECT_EQ(pixel(0, 0), 0);
+
+    // Oversize values wrap to 1023x511, row 511 goes to row 1
+    send({0x80000000, 0xFFFF0001, 0x00010000, 0xFFFFFFFF});
+    EXPECT_EQ(pixel(0, 2), 0x1234);
+}
@@ -286,3 +286,16 @@ TEST_F(GteColorTest, NCDS_SaturatesNegativeMACs) {
 
     gte.execute(0x00080013); // NCDS with sf=1
 }
+
+TEST_F(GteColorTest, NCS_DoesNotMultiplyByFarColor) {
+    gte.ctc(0, 0x1000); // LLM 1.0 on the first row
+    gte.ctc(9, 0x1000); // LCM 1.0 on the first row
+
+    gte.mtc(0, 0x0200); // V0.x
+
+    gte.execute(0x0008001E); // NCS with sf=1
+    EXPECT_EQ(gte.mfc(25), 0x200u);
+
+    gte.execute(0x0008001B); // NCCS with sf=1
+    EXPECT_EQ(gte.mfc(25), 0x400u);
+}
@@ -255,3 +255,46 @@ TEST_F(GteCoordinateTest, Rtpt_Basic_test)
         mac0_ir0
     );
 }
+
+TEST_F(GteCoordinateTest, Rtpt_LastVertexResultsWithFlagsOfAll)
+{
+    Vector3<int16_t> v0(0x7000, 0, 0x100);
+    setVector(0, v0);
+    Vector3<int16_t> v1(10, 20, 0x100);
+    setVector(2, v1);
+    Vector3<int16_t> v2(30, 40, 0x200);
+    setVector(4, v2);
+
+    Mat3x3 rotation(0x2000, 0, 0, 0, 0x2000, 0, 0, 0, 0x2000);
+    setMatrix(0, rotation);
+    gte.ctc(26, 1); // H
+
+    gte.execute(0x4A000030 | (1 << 19)); // RTPT, sf
+
+    // Only V0 saturates IR1, the registers hold the results of V2
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(25)), 60);
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(26)), 80);
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(27)), 0x400);
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(9)), 60);
+    EXPECT_NE(gte.cfc(31) & (1 << 24), 0u);
+}
+
+TEST_F(GteCoordinateTest, Rtps_LargeTranslationDoesNotWrap)
+{
+    Vector3<int16_t> v0(0, 0, 0);
+    setVector(0, v0);
+
+    Mat3x3 rotation(0x1000, 0, 0, 0, 0x1000, 0, 0, 0, 0x1000);
+    setMatrix(0, rotation);
+
+    // TRX * 0x1000 does not fit in 32 bits
+    Vector3<int32_t> translation(0x100000, 0, 0x400);
+    setTranslation(5, translation);
+    gte.ctc(26, 1); // H
+
+    gte.execute(0x4A000001 | (1 << 19)); // RTPS, sf
+
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(25)), 0x100000);
+    EXPECT_EQ(static_cast<int32_t>(gte.mfc(9)), 0x7FFF);
+    EXPECT_NE(gte.cfc(31) & (1 << 24), 0u);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "Core/Bus.hpp"
+#include "Core/Log.hpp"
+#include "Core/TraceRing.hpp"
+
+class LogTest : public testing::Test
+{
+    protected:
+        TraceRing ring{16};
+
+        LogTest()
+        {
+            Log::setMask(0);
+            Log::setTraceRing(&ring);
+        }
+
+        ~LogTest() override
+        {
+            Log::setMask(0);
+            Log::setTraceRing(nullptr);
+        }
+};
+
+TEST_F(LogTest, SubsystemsStartDisabled)
+{
+    for (size_t i = 0; i < LOG_SUBSYSTEM_COUNT; i++) {
+        EXPECT_FALSE(Log::enabled(static_cast<LogSubsystem>(i)));
+    }
+}
+
+TEST_F(LogTest, EnableOnlyTouchesOneSubsystem)
+{
+    Log::enable(LogSubsystem::Dma);
+    Log::enable(LogSubsystem::Timers);
+    Log::enable(LogSubsystem::Dma, false);
+
+    EXPECT_FALSE(Log::enabled(LogSubsystem::Dma));
+    EXPECT_TRUE(Log::enabled(LogSubsystem::Timers));
+    EXPECT_EQ(Log::mask(), Log::bit(LogSubsystem::Timers));
+}
+
+TEST_F(LogTest, EnableByName)
+{
+    EXPECT_TRUE(Log::enableByName("gpu,dma"));
+    EXPECT_EQ(Log::mask(), Log::bit(LogSubsystem::Gpu) | Log::bit(LogSubsystem::Dma));
+
+    EXPECT_TRUE(Log::enableByName("all"));
+    for (size_t i = 0; i < LOG_SUBSYSTEM_COUNT; i++) {
+        EXPECT_TRUE(Log::enabled(static_cast<LogSubsystem>(i)));
+    }
+
+    // A bad list leaves the mask alone
+    EXPECT_FALSE(Log::enableByName("spu,cdrom"));
+    EXPECT_TRUE(Log::enabled(LogSubsystem::Gpu));
+    EXPECT_TRUE(Log::enableByName(""));
+    EXPECT_EQ(Log::mask(), 0);
+}
+
+TEST_F(LogTest, DisabledMessageDoesNotEvaluateArguments)
+{
+    int evaluated = 0;
+    ROGEM_TRACE(LogSubsystem::Gpu, "{}", ++evaluated);
+
+    EXPECT_EQ(evaluated, 0);
+    TraceRing::Record record;
+    EXPECT_FALSE(ring.pop(record));
+}
+
+TEST_F(LogTest, DeviceAccessGoesToTheRing)
+{
+    if (ROGEM_LOG_LEVEL > ROGEM_LOG_LEVEL_TRACE) {
+        GTEST_SKIP() << "trace messages are compiled out";
+    }
+    Bus bus;
+    Log::enable(LogSubsystem::Timers);
+
+    bus.storeWord(0x1F801108, 0x5);
+    bus.storeWord(0x1F8010F0, 0x5);
+
+    TraceRing::Record record;
+    ASSERT_TRUE(ring.pop(record));
+    EXPECT_EQ(record.subsystem, LogSubsystem::Timers);
+    EXPECT_EQ(record.view(), "Timers: Write word 0x00000005 to 0x1F801108");
+    EXPECT_FALSE(ring.pop(record));
+}
+
+TEST(TraceRingTest, CapacityIsAPowerOfTwo)
+{
+    EXPECT_EQ(TraceRing(5).capacity(), 8);
+    EXPECT_EQ(TraceRing(64).capacity(), 64);
+}
+
+TEST(TraceRingTest, DropsWhenFull)
+{
+    TraceRing ring(4);
+    for (int i = 0; i < 6; i++) {
+        ring.push(LogSubsystem::Spu, std::to_string(i));
+    }
+    EXPECT_EQ(ring.dropped(), 2);
+
+    TraceRing::Record record;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.pop(record));
+        EXPECT_EQ(record.view(), std::to_string(i));
+    }
+    EXPECT_FALSE(ring.pop(record));
+    EXPECT_TRUE(ring.push(LogSubsystem::Spu, "again"));
+}
+
+TEST(TraceRingTest, TruncatesLongMessages)
+{
+    TraceRing ring(2);
+    ring.push(LogSubsystem::Gpu, std::string(200, 'x'));
+
+    TraceRing::Record record;
+    ASSERT_TRUE(ring.pop(record));
+    EXPECT_EQ(record.view(), std::string(TraceRing::TEXT_SIZE, 'x'));
+}
+
+TEST(TraceRingTest, ConcurrentProducersKeepEveryMessage)
+{
+    TraceRing ring(4096);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+        producers.emplace_back([&ring, t] {
+            for (int i = 0; i < 500; i++) {
+                ring.push(static_cast<LogSubsystem>(t), "message");
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    size_t counts[4] = {};
+    TraceRing::Record record;
+    while (ring.pop(record)) {
+        counts[static_cast<size_t>(record.subsystem)]++;
+    }
+    for (size_t count : counts) {
+        EXPECT_EQ(count, 500);
+    }
+    EXPECT_EQ(ring.dropped(), 0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "Core/Bus.hpp"
+#include "Core/GPU.hpp"
+#include "Core/InterruptController.hpp"
+#include "Core/PerfCounters.hpp"
+
+constexpr uint32_t GP0 = 0x1F801810;
+
+TEST(PerfCountersTest, CountsDeviceActivity)
+{
+    Bus bus;
+    PerfCounters &perf = bus.getPerfCounters();
+    perf.beginFrame();
+
+    bus.storeWord(0x80000000, 0);
+    bus.loadWord(0xBFC00000);
+    bus.storeWord(GP0, 0xE1000000);
+    EXPECT_EQ(perf.frame().busAccesses[static_cast<size_t>(PerfBusTarget::Ram)], 1);
+    EXPECT_EQ(perf.frame().busAccesses[static_cast<size_t>(PerfBusTarget::Bios)], 1);
+    EXPECT_EQ(perf.frame().busAccesses[static_cast<size_t>(PerfBusTarget::Gpu)], 1);
+
+    // 4x2 fill (16 pixels wide on the GPU), then a flat triangle covering 8 pixels
+    GPU *gpu = bus.getDevice<GPU>();
+    for (uint32_t word : {0x02000000u, 0x00000000u, 0x00020004u, 0x20FFFFFFu, 0x00000000u, 0x00000004u, 0x00040000u}) {
+        gpu->write32(word, GP0);
+    }
+    EXPECT_EQ(perf.frame().gp0Commands[static_cast<size_t>(PerfPrimitive::Other)], 1);
+    EXPECT_EQ(perf.frame().gp0Commands[static_cast<size_t>(PerfPrimitive::Fill)], 1);
+    EXPECT_EQ(perf.frame().gp0Commands[static_cast<size_t>(PerfPrimitive::Polygon)], 1);
+    EXPECT_EQ(perf.frame().pixels[static_cast<size_t>(PerfPrimitive::Fill)], 32);
+    EXPECT_EQ(perf.frame().pixels[static_cast<size_t>(PerfPrimitive::Polygon)], 10);
+
+    // OTC clear of 16 entries
+    bus.storeWord(0x1F8010E0, 0x80001000);
+    bus.storeWord(0x1F8010E4, 16);
+    bus.storeWord(0x1F8010E8, 0x11000002);
+    EXPECT_EQ(perf.frame().dmaWords[6], 16);
+
+    bus.getDevice<InterruptController>()->triggerIRQ(DeviceIRQ::DMA);
+    EXPECT_EQ(perf.frame().irqs[3], 1);
+}
+
+TEST(PerfCountersTest, EndFrameKeepsTotals)
+{
+    PerfCounters perf;
+
+    for (int i = 0; i < 3; i++) {
+        perf.beginFrame();
+        perf.frame().instructions += 100;
+        perf.frame().dmaWords[2] += i;
+        PerfScope scope(&perf, PerfTimer::Gpu);
+        perf.endFrame();
+    }
+    EXPECT_EQ(perf.frameCount(), 3);
+    EXPECT_EQ(perf.lastFrame().instructions, 100);
+    EXPECT_EQ(perf.lastFrame().dmaWords[2], 2);
+    EXPECT_EQ(perf.total().instructions, 300);
+    EXPECT_EQ(perf.total().dmaWords[2], 3);
+    EXPECT_EQ(perf.frame().instructions, 0);
+
+    std::string json = perf.toJson();
+    EXPECT_NE(json.find("\"frames\": 3"), std::string::npos);
+    EXPECT_NE(json.find("\"instructions\": 300"), std::string::npos);
+    EXPECT_NE(json.find("\"dmaWords\": {\"mdecIn\": 0, \"mdecOut\": 0, \"gpu\": 3"), std::string::npos);
+
+    // Each row has as many columns as the header
+    std::string header = PerfCounters::csvHeader();
+    std::string row = PerfCounters::csvRow(2, perf.lastFrame());
+    EXPECT_EQ(std::count(header.begin(), header.end(), ','), std::count(row.begin(), row.end(), ','));
+    EXPECT_EQ(row.rfind("2,100,", 0), 0);
+}
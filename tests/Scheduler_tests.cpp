@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "Core/GPU.hpp"
+#include "Core/Timers.hpp"
+#include "Core/SerialInterface.hpp"
+#include "Core/InterruptController.hpp"
+
+class RecordingDevice : public PsxDevice
+{
+    public:
+        RecordingDevice(Bus *bus) : PsxDevice(bus) {}
+
+        void onEvent(SchedulerEvent event) override { events.push_back(event); }
+
+        void write8(uint8_t, uint32_t) override {}
+        void write16(uint16_t, uint32_t) override {}
+        void write32(uint32_t, uint32_t) override {}
+        uint8_t read8(uint32_t) override { return 0; }
+        uint16_t read16(uint32_t) override { return 0; }
+        uint32_t read32(uint32_t) override { return 0; }
+
+        std::vector<SchedulerEvent> events;
+};
+
+TEST(SchedulerTest, RunsDueEventsInTimestampOrder)
+{
+    Scheduler scheduler;
+    RecordingDevice device(nullptr);
+
+    scheduler.setHandler(SchedulerEvent::Timer0, &device);
+    scheduler.setHandler(SchedulerEvent::Timer1, &device);
+    scheduler.setHandler(SchedulerEvent::GpuVBlank, &device);
+    scheduler.schedule(SchedulerEvent::Timer1, 30);
+    scheduler.schedule(SchedulerEvent::Timer0, 10);
+    scheduler.schedule(SchedulerEvent::GpuVBlank, 100);
+    EXPECT_EQ(scheduler.nextEventTime(), 10u);
+
+    scheduler.advance(9);
+    EXPECT_TRUE(device.events.empty());
+
+    scheduler.advance(40);
+    ASSERT_EQ(device.events.size(), 2u);
+    EXPECT_EQ(device.events[0], SchedulerEvent::Timer0);
+    EXPECT_EQ(device.events[1], SchedulerEvent::Timer1);
+    EXPECT_EQ(scheduler.now(), 49u);
+    EXPECT_EQ(scheduler.nextEventTime(), 100u);
+}
+
+TEST(SchedulerTest, RescheduleAndCancel)
+{
+    Scheduler scheduler;
+    RecordingDevice device(nullptr);
+
+    scheduler.setHandler(SchedulerEvent::Timer2, &device);
+    scheduler.schedule(SchedulerEvent::Timer2, 10);
+    scheduler.schedule(SchedulerEvent::Timer2, 50);
+    EXPECT_EQ(scheduler.deadline(SchedulerEvent::Timer2), 50u);
+
+    scheduler.advance(20);
+    EXPECT_TRUE(device.events.empty());
+
+    scheduler.cancel(SchedulerEvent::Timer2);
+    EXPECT_EQ(scheduler.nextEventTime(), Scheduler::NEVER);
+    scheduler.advance(100);
+    EXPECT_TRUE(device.events.empty());
+}
+
+class SchedulerBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        bus = std::make_unique<Bus>();
+        cpu = std::make_unique<CPU>(bus.get());
+        bus->connectCpu(cpu.get());
+        irqc = bus->getDevice<InterruptController>();
+    }
+
+    bool irqRaised(DeviceIRQ irq) {
+        return irqc->read32(0x1F801070) & static_cast<uint32_t>(irq);
+    }
+
+    std::unique_ptr<Bus> bus;
+    std::unique_ptr<CPU> cpu;
+    InterruptController *irqc;
+};
+
+TEST_F(SchedulerBusTest, VBlankEventOncePerFrame)
+{
+    auto &scheduler = bus->getScheduler();
+    uint64_t vblank = scheduler.deadline(SchedulerEvent::GpuVBlank);
+
+    // 263 scanlines of 3413 GPU cycles at 11/7 of the CPU clock
+    EXPECT_EQ(vblank, (263ull * 3413 * 7 + 10) / 11);
+
+    bus->updateDevices(static_cast<int>(vblank - 1));
+    EXPECT_FALSE(irqRaised(DeviceIRQ::VBLANK));
+    bus->updateDevices(1);
+    EXPECT_TRUE(irqRaised(DeviceIRQ::VBLANK));
+    EXPECT_GT(scheduler.deadline(SchedulerEvent::GpuVBlank), vblank);
+}
+
+TEST_F(SchedulerBusTest, TimerCatchesUpWhenRead)
+{
+    auto timers = bus->getDevice<Timers>();
+
+    timers->write16(0, 0x1F801100);
+    EXPECT_EQ(bus->getScheduler().deadline(SchedulerEvent::Timer0), Scheduler::NEVER);
+
+    bus->updateDevices(1234);
+    EXPECT_EQ(timers->read16(0x1F801100), 1234);
+}
+
+TEST_F(SchedulerBusTest, TimerTargetInterruptIsScheduled)
+{
+    auto timers = bus->getDevice<Timers>();
+
+    timers->write16(0, 0x1F801120);
+    timers->write16(100, 0x1F801128);
+    // System clock / 8, IRQ on target, reset on target
+    timers->write16(0x0218, 0x1F801124);
+    EXPECT_EQ(bus->getScheduler().deadline(SchedulerEvent::Timer2), 800u);
+
+    bus->updateDevices(799);
+    EXPECT_FALSE(irqRaised(DeviceIRQ::TIMER2));
+    bus->updateDevices(1);
+    EXPECT_TRUE(irqRaised(DeviceIRQ::TIMER2));
+    EXPECT_EQ(timers->read16(0x1F801120), 0);
+}
+
+TEST_F(SchedulerBusTest, Sio0TransferInterrupt)
+{
+    auto sio = bus->getDevice<SerialInterface>();
+
+    sio->write16(0x01, 0x1F801040);
+    EXPECT_NE(bus->getScheduler().deadline(SchedulerEvent::Sio0Transfer), Scheduler::NEVER);
+
+    bus->updateDevices(200);
+    EXPECT_TRUE(irqRaised(DeviceIRQ::CONTROLLER_MEMCARD));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "SystemStateHelpers.hpp"
+
+TEST(SnapshotRingTest, RewindRestoresEarlierFrames)
+{
+    System system;
+    system.init();
+    loadStoreLoopProgram(system);
+    system.enableSnapshots(8);
+
+    std::vector<std::vector<uint8_t>> states = {fullState(system)};
+    for (uint32_t frame = 1; frame <= 6; frame++) {
+        runFrame(system, frame);
+        states.push_back(fullState(system));
+    }
+    EXPECT_EQ(system.getSnapshots()->size(), 7u);
+
+    ASSERT_TRUE(system.rewind(2));
+    EXPECT_EQ(system.getSnapshots()->size(), 5u);
+    EXPECT_TRUE(fullState(system) == states[4]);
+
+    // Running again from the restored frame replays the same frames
+    runFrame(system, 5);
+    EXPECT_TRUE(fullState(system) == states[5]);
+
+    ASSERT_TRUE(system.rewind(5));
+    EXPECT_TRUE(fullState(system) == states[0]);
+    EXPECT_FALSE(system.rewind(1));
+}
+
+TEST(SnapshotRingTest, DropsOldestSnapshotsWhenFull)
+{
+    System system;
+    system.init();
+    loadStoreLoopProgram(system);
+    system.enableSnapshots(3);
+
+    std::vector<std::vector<uint8_t>> states = {fullState(system)};
+    for (uint32_t frame = 1; frame <= 5; frame++) {
+        runFrame(system, frame);
+        states.push_back(fullState(system));
+    }
+    auto *snapshots = system.getSnapshots();
+    EXPECT_EQ(snapshots->size(), 3u);
+    EXPECT_FALSE(system.rewind(3));
+
+    ASSERT_TRUE(system.rewind(2));
+    EXPECT_TRUE(fullState(system) == states[3]);
+
+    // Every undo page goes back to the pool once the ring is empty
+    snapshots->clear();
+    system.update();
+    snapshots->clear();
+    EXPECT_EQ(snapshots->size(), 0u);
+    EXPECT_EQ(snapshots->freePages(), (2048u * 1024 + 1024 * 1024) / SnapshotRing::PAGE_SIZE);
+}
+
+TEST(SnapshotRingTest, RunAheadRestoresTheLastFrame)
+{
+    System system;
+    system.init();
+    loadStoreLoopProgram(system);
+    system.enableSnapshots(4);
+
+    runFrame(system, 1);
+    runFrame(system, 2);
+    auto state = fullState(system);
+    uint32_t count = system.getCPU()->getReg(CpuReg::T0);
+
+    uint32_t presentedCount = 0;
+    ASSERT_TRUE(system.runAhead(2, [&] {
+        presentedCount = system.getCPU()->getReg(CpuReg::T0);
+    }));
+    EXPECT_GT(presentedCount, count);
+    EXPECT_TRUE(fullState(system) == state);
+    EXPECT_EQ(system.getSnapshots()->size(), 3u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "Core/SpeedMeter.hpp"
+#include "Core/System.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(SpeedMeterTest, RealTimeIsOne)
+{
+    GuestSpeed speed = SpeedMeter::measure(60, System::CPU_CLOCK, 1.0);
+
+    EXPECT_DOUBLE_EQ(speed.fps, 60.0);
+    EXPECT_DOUBLE_EQ(speed.mhz, 33.8688);
+    EXPECT_DOUBLE_EQ(speed.multiplier, 1.0);
+    EXPECT_DOUBLE_EQ(SpeedMeter::measure(10, 100, 0.0).fps, 0.0);
+}
+
+TEST(SpeedMeterTest, WindowsAndTotal)
+{
+    SpeedMeter meter(0.5);
+    auto start = SpeedMeter::Clock::now();
+    meter.reset(start);
+
+    // 4x real time: 60 frames of 1/60 s of cycles in 0.25 s
+    for (int i = 1; i <= 60; i++) {
+        meter.addFrame(System::CPU_CLOCK / 60, start + i * 250ms / 60);
+    }
+    EXPECT_EQ(meter.current().fps, 0.0);
+    EXPECT_NEAR(meter.total().multiplier, 4.0, 1e-6);
+
+    // Then real time until the window ends
+    for (int i = 1; i <= 15; i++) {
+        meter.addFrame(System::CPU_CLOCK / 60, start + 250ms + i * 250ms / 15);
+    }
+    EXPECT_NEAR(meter.current().fps, 150.0, 1e-6);
+    EXPECT_NEAR(meter.current().multiplier, 2.5, 1e-6);
+    EXPECT_EQ(meter.frames(), 75);
+    EXPECT_EQ(meter.cycles(), 75 * (System::CPU_CLOCK / 60));
+}
+
+TEST(SpeedMeterTest, PausedTimeIsLeftOut)
+{
+    SpeedMeter meter(0.5);
+    auto start = SpeedMeter::Clock::now();
+    meter.reset(start);
+
+    // Real time for 0.5 s, a 10 s pause, then real time again
+    for (int i = 1; i <= 30; i++) {
+        meter.addFrame(System::CPU_CLOCK / 60, start + i * 500ms / 30);
+    }
+    EXPECT_NEAR(meter.current().multiplier, 1.0, 1e-6);
+    meter.pause(start + 500ms);
+    EXPECT_TRUE(meter.isPaused());
+    EXPECT_EQ(meter.current().fps, 0.0);
+    meter.resume(start + 10500ms);
+    for (int i = 1; i <= 30; i++) {
+        meter.addFrame(System::CPU_CLOCK / 60, start + 10500ms + i * 500ms / 30);
+    }
+    EXPECT_NEAR(meter.current().multiplier, 1.0, 1e-6);
+    EXPECT_NEAR(meter.total().multiplier, 1.0, 1e-6);
+    EXPECT_NEAR(meter.total().fps, 60.0, 1e-6);
+}
+
+TEST(SpeedMeterTest, SystemCountsRunningFrames)
+{
+    System system;
+    system.init();
+    system.getCPU()->setReg(CpuReg::PC, 0x80010000);
+
+    system.update();
+    system.update();
+    system.setState(SystemState::PAUSED);
+    system.update();
+
+    const SpeedMeter &meter = system.getSpeedMeter();
+    EXPECT_TRUE(meter.isPaused());
+    EXPECT_EQ(meter.frames(), 2);
+    EXPECT_NEAR(static_cast<double>(meter.cycles()), 2 * System::CPU_CLOCK / system.getRefreshRate(), 64.0);
+    EXPECT_GT(meter.total().mhz, 0.0);
+    system.setState(SystemState::RUNNING);
+    EXPECT_FALSE(meter.isPaused());
+}
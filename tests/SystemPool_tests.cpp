@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "Core/SystemPool.hpp"
+#include "Core/SerialInterface.hpp"
+
+static constexpr uint32_t PROGRAM_BASE = 0x80010000;
+
+// Counts in $t0 and prints '0' + seed through the BIOS putchar vector on each loop
+static void loadCounterProgram(System &system, uint32_t seed)
+{
+    Bus *bus = system.getBus();
+    const uint32_t program[] = {
+        0x3C0803E0,             // lui   $t0, 0x03E0
+        0x35080008,             // ori   $t0, $t0, 0x0008 (jr $ra)
+        0xAC0800A0,             // sw    $t0, 0xA0($zero)
+        0xAC0000A4,             // sw    $zero, 0xA4($zero)
+        0x00004021,             // addu  $t0, $zero, $zero
+        0x240A00A0,             // li    $t2, 0xA0
+        0x2409003C,             // li    $t1, 0x3C
+        0x24040030 + seed,      // li    $a0, '0' + seed
+        // loop:
+        0x25080001,             // addiu $t0, $t0, 1
+        0x31010FFF,             // andi  $at, $t0, 0x0FFF
+        0x14200004,             // bnez  $at, skip
+        0x00000000,             // nop
+        0x0140F809,             // jalr  $t2
+        0x00000000,             // nop
+        0x2404000A,             // li    $a0, '\n'
+        // skip:
+        0x08004008,             // j     loop
+        0x00000000,             // nop
+    };
+
+    for (size_t i = 0; i < std::size(program); i++) {
+        bus->storeWord(PROGRAM_BASE + static_cast<uint32_t>(i) * 4, program[i]);
+    }
+    system.getCPU()->setReg(CpuReg::PC, PROGRAM_BASE);
+}
+
+TEST(ThreadPoolTest, RunsNestedTasks)
+{
+    ThreadPool pool(4);
+    std::atomic<int> counter = 0;
+
+    for (int i = 0; i < 64; i++) {
+        pool.submit([&pool, &counter] {
+            counter++;
+            pool.submit([&counter] { counter++; });
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(counter, 128);
+}
+
+TEST(SystemPoolTest, MatchesSequentialRuns)
+{
+    const size_t count = 6;
+    const uint32_t frames = 3;
+    SystemPool pool(3);
+    std::vector<std::unique_ptr<System>> reference;
+
+    for (size_t i = 0; i < count; i++) {
+        auto index = pool.addSystem();
+        loadCounterProgram(pool.getSystem(index), static_cast<uint32_t>(i));
+
+        reference.push_back(std::make_unique<System>());
+        reference.back()->init();
+        loadCounterProgram(*reference.back(), static_cast<uint32_t>(i));
+    }
+
+    pool.runFrames(frames);
+    for (auto &system : reference) {
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            system->update();
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        auto *cpu = pool.getSystem(i).getCPU();
+        EXPECT_NE(cpu->getReg(CpuReg::T0), 0u);
+        EXPECT_EQ(cpu->getReg(CpuReg::T0), reference[i]->getCPU()->getReg(CpuReg::T0));
+        EXPECT_EQ(cpu->getReg(CpuReg::PC), reference[i]->getCPU()->getReg(CpuReg::PC));
+    }
+}
+
+TEST(SystemPoolTest, PerInstanceQueues)
+{
+    SystemPool pool(2);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        loadCounterProgram(pool.getSystem(pool.addSystem()), i);
+    }
+    pool.queueInput(0, 0xFFF7);
+    pool.queueInput(0, 0xBFFF);
+    pool.queueInput(1, 0x7FFF);
+
+    pool.runFrames(1);
+    auto pad0 = &pool.getSystem(0).getBus()->getDevice<SerialInterface>()->getPad(0);
+    auto pad1 = &pool.getSystem(1).getBus()->getDevice<SerialInterface>()->getPad(0);
+    EXPECT_EQ(pad0->getButtons(), 0xFFF7);
+    EXPECT_EQ(pad1->getButtons(), 0x7FFF);
+
+    pool.runFrames(1);
+    EXPECT_EQ(pad0->getButtons(), 0xBFFF);
+    EXPECT_EQ(pad1->getButtons(), 0x7FFF);
+
+    auto tty0 = pool.takeTtyOutput(0);
+    auto tty1 = pool.takeTtyOutput(1);
+    ASSERT_FALSE(tty0.empty());
+    ASSERT_FALSE(tty1.empty());
+    EXPECT_EQ(tty0.front(), "0");
+    EXPECT_EQ(tty1.front(), "1");
+    EXPECT_TRUE(pool.takeTtyOutput(0).empty());
+}
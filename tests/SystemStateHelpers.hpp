@@ -0,0 +1,53 @@
+#ifndef SYSTEMSTATEHELPERS_HPP_
+#define SYSTEMSTATEHELPERS_HPP_
+
+#include <vector>
+
+#include "Core/System.hpp"
+#include "Core/StateBuffer.hpp"
+
+// Shared by the snapshot and delta savestate tests
+
+inline constexpr uint32_t PROGRAM_BASE = 0x80010000;
+inline constexpr uint32_t GP0_ADDRESS = 0x1F801810;
+
+// Counts in $t0 and stores the count across 8 pages of RAM
+inline void loadStoreLoopProgram(System &system)
+{
+    Bus *bus = system.getBus();
+    const uint32_t program[] = {
+        // loop:
+        0x25080001,             // addiu $t0, $t0, 1
+        0x31017FFC,             // andi  $at, $t0, 0x7FFC
+        0x3C098002,             // lui   $t1, 0x8002
+        0x01214821,             // addu  $t1, $t1, $at
+        0xAD280000,             // sw    $t0, 0($t1)
+        0x08004000,             // j     loop
+        0x00000000,             // nop
+    };
+
+    for (size_t i = 0; i < std::size(program); i++) {
+        bus->storeWord(PROGRAM_BASE + static_cast<uint32_t>(i) * 4, program[i]);
+    }
+    system.getCPU()->setReg(CpuReg::PC, PROGRAM_BASE);
+}
+
+// Runs a frame after filling a 16x16 VRAM square that depends on the frame
+inline void runFrame(System &system, uint32_t frame)
+{
+    Bus *bus = system.getBus();
+    bus->storeWord(GP0_ADDRESS, 0x02000000 | (frame * 0x102030 & 0xFFFFFF));
+    bus->storeWord(GP0_ADDRESS, ((frame % 4) * 64) << 16);
+    bus->storeWord(GP0_ADDRESS, 0x00100010);
+    system.update();
+}
+
+inline std::vector<uint8_t> fullState(System &system)
+{
+    StateBuffer buf;
+    system.getCPU()->serialize(buf);
+    system.getBus()->serialize(buf);
+    return buf.data();
+}
+
+#endif /* !SYSTEMSTATEHELPERS_HPP_ */
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "Core/Bus.hpp"
+#include "Core/CPU.hpp"
+#include "Core/TraceFile.hpp"
+#include "Core/TraceRecorder.hpp"
+
+static std::vector<TraceRecord> decodeAll(std::istream &in)
+{
+    TraceDecoder decoder;
+    std::vector<TraceRecord> records;
+    TraceRecord record;
+
+    EXPECT_TRUE(decoder.readHeader(in));
+    while (decoder.next(in, record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+static void expectRecord(const TraceRecord &record, TraceRecordKind kind, uint32_t address, uint32_t value)
+{
+    EXPECT_EQ(record.kind, kind);
+    EXPECT_EQ(record.address, address);
+    EXPECT_EQ(record.value, value);
+}
+
+TEST(TraceFileTest, RoundTrip)
+{
+    std::vector<TraceRecord> records = {
+        {0, 0, 0x12345678, TraceRecordKind::Register, 8, 0},
+        {100, 0xBFC00000, 0x3C080013, TraceRecordKind::Instruction, 0, 0},
+        {102, 0xBFC00004, 0x3508243F, TraceRecordKind::Instruction, 0, 0},
+        {0, 0x1F801010, 0x0013243F, TraceRecordKind::Store, 0, 4},
+        {0, 0, 0x12345679, TraceRecordKind::Register, 8, 0},
+        {130, 0x80001000, 0x8D090000, TraceRecordKind::Instruction, 0, 0},
+        {0, 0x80000FFE, 0xBEEF, TraceRecordKind::Load, 0, 2},
+        {0, 0x1F801040, 0x7F, TraceRecordKind::Load, 0, 1},
+        {132, 0x80000800, 0, TraceRecordKind::Instruction, 0, 0},
+    };
+    TraceEncoder encoder;
+    std::vector<uint8_t> bytes;
+    TraceEncoder::writeHeader(bytes);
+    for (const TraceRecord &record : records) {
+        encoder.encode(record, bytes);
+    }
+
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::vector<TraceRecord> decoded = decodeAll(in);
+    ASSERT_EQ(decoded.size(), records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(decoded[i].kind, records[i].kind) << i;
+        EXPECT_EQ(decoded[i].cycle, records[i].cycle) << i;
+        EXPECT_EQ(decoded[i].address, records[i].address) << i;
+        EXPECT_EQ(decoded[i].value, records[i].value) << i;
+        EXPECT_EQ(decoded[i].reg, records[i].reg) << i;
+        EXPECT_EQ(decoded[i].size, records[i].size) << i;
+    }
+}
+
+TEST(TraceFileTest, SequentialInstructionsAreSmall)
+{
+    TraceEncoder encoder;
+    std::vector<uint8_t> bytes;
+    encoder.encode({0, 0x80010000, 0, TraceRecordKind::Instruction, 0, 0}, bytes);
+    bytes.clear();
+
+    encoder.encode({2, 0x80010004, 0, TraceRecordKind::Instruction, 0, 0}, bytes);
+    EXPECT_EQ(bytes.size(), 7);
+}
+
+TEST(TraceFileTest, RejectsOtherFiles)
+{
+    std::istringstream in("RGMSTATE\x01\x00\x00\x00");
+    TraceDecoder decoder;
+
+    EXPECT_FALSE(decoder.readHeader(in));
+}
+
+class TraceRecorderTest : public testing::Test
+{
+    protected:
+        Bus bus;
+        CPU cpu;
+        std::string path;
+
+        TraceRecorderTest() :
+            cpu(&bus),
+            path((std::filesystem::temp_directory_path() / "rogem_trace_test.rgt").string())
+        {
+            cpu.setReg(CpuReg::PC, 0x10000);
+        }
+
+        ~TraceRecorderTest() override
+        {
+            std::filesystem::remove(path);
+        }
+
+        void load(std::initializer_list<uint32_t> program)
+        {
+            uint32_t pc = cpu.getReg(CpuReg::PC);
+            for (uint32_t word : program) {
+                bus.storeWord(pc, word);
+                pc += 4;
+            }
+        }
+
+        std::vector<TraceRecord> readTrace()
+        {
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            return decodeAll(file);
+        }
+};
+
+TEST_F(TraceRecorderTest, RecordsInstructionsAccessesAndRegisters)
+{
+    // addiu t0, zero, 0x40; sw t0, 0x100(zero); lw t1, 0x100(zero); nop
+    load({0x24080040, 0xAC080100, 0x8C090100, 0});
+    cpu.setReg(CpuReg::S0, 7);
+    TraceRecorder recorder;
+    ASSERT_TRUE(recorder.open(path));
+
+    cpu.setTraceRecorder(&recorder);
+    for (int i = 0; i < 4; i++) {
+        cpu.step();
+    }
+    cpu.setTraceRecorder(nullptr);
+    recorder.close();
+
+    std::vector<TraceRecord> records = readTrace();
+    ASSERT_EQ(records.size(), 9);
+    EXPECT_EQ(records[0].reg, static_cast<uint8_t>(CpuReg::S0));
+    expectRecord(records[0], TraceRecordKind::Register, 0, 7);
+    expectRecord(records[1], TraceRecordKind::Instruction, 0x10000, 0x24080040);
+    EXPECT_EQ(records[1].cycle, 0);
+    expectRecord(records[2], TraceRecordKind::Register, 0, 0x40);
+    expectRecord(records[3], TraceRecordKind::Instruction, 0x10004, 0xAC080100);
+    expectRecord(records[4], TraceRecordKind::Store, 0x100, 0x40);
+    EXPECT_EQ(records[4].size, 4);
+    expectRecord(records[5], TraceRecordKind::Instruction, 0x10008, 0x8C090100);
+    expectRecord(records[6], TraceRecordKind::Load, 0x100, 0x40);
+    // The loaded value lands after the delay slot
+    expectRecord(records[7], TraceRecordKind::Instruction, 0x1000C, 0);
+    EXPECT_EQ(records[7].cycle, 6);
+    expectRecord(records[8], TraceRecordKind::Register, 0, 0x40);
+    EXPECT_EQ(records[8].reg, static_cast<uint8_t>(CpuReg::T1));
+}
+
+TEST_F(TraceRecorderTest, FullRingWaitsForTheWriter)
+{
+    // addiu t0, t0, 1; j 0x10000; nop
+    load({0x25080001, 0x08004000, 0});
+    TraceRecorder recorder(16);
+    ASSERT_TRUE(recorder.open(path));
+
+    cpu.setTraceRecorder(&recorder);
+    for (int i = 0; i < 3000; i++) {
+        cpu.step();
+    }
+    cpu.setTraceRecorder(nullptr);
+    EXPECT_TRUE(recorder.close());
+
+    std::vector<TraceRecord> records = readTrace();
+    EXPECT_EQ(records.size(), recorder.records());
+    // Counted once per blocked record, not per retry
+    EXPECT_LE(recorder.stalls(), recorder.records());
+    size_t instructions = std::count_if(records.begin(), records.end(), [](const TraceRecord &record) {
+        return record.kind == TraceRecordKind::Instruction;
+    });
+    EXPECT_EQ(instructions, 3000);
+    EXPECT_EQ(records.back().address, 0x10008);
+}
+
+TEST_F(TraceRecorderTest, DetachedBusDoesNotRecord)
+{
+    TraceRecorder recorder;
+    ASSERT_TRUE(recorder.open(path));
+
+    cpu.setTraceRecorder(&recorder);
+    cpu.setTraceRecorder(nullptr);
+    bus.storeWord(0x100, 1);
+    recorder.close();
+
+    EXPECT_TRUE(readTrace().empty());
+}
+
+TEST_F(TraceRecorderTest, WriteErrorsAreReported)
+{
+    // addiu t0, t0, 1; j 0x10000; nop
+    load({0x25080001, 0x08004000, 0});
+    TraceRecorder recorder(16);
+    if (!recorder.open("/dev/full")) {
+        GTEST_SKIP() << "No /dev/full on this host";
+    }
+
+    cpu.setTraceRecorder(&recorder);
+    for (int i = 0; i < 3000; i++) {
+        cpu.step();
+    }
+    cpu.setTraceRecorder(nullptr);
+    EXPECT_FALSE(recorder.close());
+    EXPECT_FALSE(recorder.close());
+}